@@ -16,6 +16,10 @@ int main() {
     std::cerr << "engine_scene_smoke: render scene extraction smoke test failed\n";
     return 1;
   }
+  if (!teng::engine::run_incremental_render_scene_extraction_smoke_test()) {
+    std::cerr << "engine_scene_smoke: incremental render scene extraction smoke test failed\n";
+    return 1;
+  }
   if (!teng::engine::run_fps_camera_system_smoke_test()) {
     std::cerr << "engine_scene_smoke: fps camera system smoke test failed\n";
     return 1;
@@ -0,0 +1,200 @@
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "core/Diagnostic.hpp"
+#include "core/JobSystem.hpp"
+#include "engine/render/RenderScene.hpp"
+#include "engine/render/RenderSceneExtractor.hpp"
+#include "engine/scene/ComponentRegistry.hpp"
+#include "engine/scene/CoreComponentRegistrar.hpp"
+#include "engine/scene/Scene.hpp"
+#include "engine/scene/SceneComponentContext.hpp"
+#include "engine/scene/SceneComponents.hpp"
+#include "engine/scene/SceneIds.hpp"
+
+// Times full render scene extraction, serial against parallel, on scenes of 10k, 100k and 1M
+// renderables (3/4 meshes, 1/4 sprites, plus a few cameras and lights), and checks both produce
+// the same lists.
+
+namespace {
+
+using namespace teng;
+using namespace teng::engine;
+
+struct Options {
+  uint32_t frames{20};
+  uint32_t max_renderables{1'000'000};
+};
+
+void usage(const char* argv0) {
+  std::cout << "usage: " << argv0 << " [--frames <n>] [--max-renderables <n>]\n"
+            << "  --frames           Extractions per run (default 20)\n"
+            << "  --max-renderables  Skip scene sizes above this (default 1000000)\n"
+            << "  -h, --help         Show this help\n";
+}
+
+bool parse_u32(std::string_view text, uint32_t& out) {
+  const char* const end = text.data() + text.size();
+  const auto result = std::from_chars(text.data(), end, out, 10);
+  return !text.empty() && result.ptr == end && result.ec == std::errc{};
+}
+
+std::optional<Options> parse_options(int argc, char* argv[]) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if ((arg == "--frames" || arg == "--max-renderables") && i + 1 < argc) {
+      uint32_t& out = arg == "--frames" ? options.frames : options.max_renderables;
+      if (!parse_u32(argv[++i], out)) {
+        std::cerr << argv[0] << ": " << arg << " requires a 32-bit integer value\n";
+        return std::nullopt;
+      }
+    } else if (arg == "-h" || arg == "--help") {
+      usage(argv[0]);
+      std::exit(0);
+    } else {
+      std::cerr << argv[0] << ": unknown option: " << arg << '\n';
+      usage(argv[0]);
+      return std::nullopt;
+    }
+  }
+  if (options.frames == 0) {
+    usage(argv[0]);
+    return std::nullopt;
+  }
+  return options;
+}
+
+using Clock = std::chrono::steady_clock;
+
+struct ComponentContexts {
+  std::unique_ptr<scene::ComponentRegistry> registry;
+  FlecsComponentContext flecs;
+};
+
+std::optional<ComponentContexts> make_component_contexts() {
+  scene::ComponentRegistryBuilder registry_builder;
+  register_core_components(registry_builder);
+  ComponentContexts contexts{.registry = std::make_unique<scene::ComponentRegistry>()};
+  core::DiagnosticReport report;
+  if (!registry_builder.try_freeze(*contexts.registry, report)) {
+    std::cerr << "failed to freeze component registry: " << report.to_string() << '\n';
+    return std::nullopt;
+  }
+  FlecsComponentContextBuilder flecs_builder{*contexts.registry};
+  register_flecs_core_components(flecs_builder);
+  if (!flecs_builder.try_freeze(contexts.flecs, report)) {
+    std::cerr << "failed to freeze scene component context: " << report.to_string() << '\n';
+    return std::nullopt;
+  }
+  return contexts;
+}
+
+// GUIDs are shuffled so the sorts do real work; a few sorting layers and a handful of model and
+// texture assets spread entities over several tables' worth of values.
+void populate_scene(Scene& scene, uint32_t renderables) {
+  std::mt19937_64 rng{renderables};
+  const AssetId models[] = {AssetId::from_path("models/a.gltf"),
+                            AssetId::from_path("models/b.gltf"),
+                            AssetId::from_path("models/c.gltf")};
+  const AssetId textures[] = {AssetId::from_path("textures/a.ktx2"),
+                              AssetId::from_path("textures/b.ktx2")};
+  for (uint32_t i = 0; i < renderables; ++i) {
+    const flecs::entity entity = scene.create_entity(EntityGuid{(rng() | 1) & ~(1ull << 63)});
+    Transform transform;
+    transform.translation = {static_cast<float>(i % 1000), 0.f, static_cast<float>(i / 1000)};
+    entity.set<Transform>(transform);
+    if (i % 4 != 3) {
+      entity.set<MeshRenderable>({.model = models[i % 3]});
+    } else {
+      entity.set<SpriteRenderable>({
+          .texture = textures[i % 2],
+          .sorting_layer = static_cast<int>(rng() % 4) - 1,
+          .sorting_order = static_cast<int>(rng() % 64),
+      });
+    }
+  }
+  for (uint32_t i = 0; i < 4; ++i) {
+    scene.create_entity(EntityGuid{rng() | 1}).set<Camera>({.primary = i == 2});
+    scene.create_entity(EntityGuid{rng() | 1}).set<DirectionalLight>({});
+  }
+  // Computes LocalToWorld.
+  scene.tick(0.f);
+}
+
+bool same_output(const RenderScene& a, const RenderScene& b) {
+  const auto same_guids = [](const auto& x, const auto& y) {
+    if (x.size() != y.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < x.size(); ++i) {
+      if (x[i].entity != y[i].entity) {
+        return false;
+      }
+    }
+    return true;
+  };
+  return same_guids(a.cameras, b.cameras) &&
+         same_guids(a.directional_lights, b.directional_lights) &&
+         same_guids(a.meshes, b.meshes) && same_guids(a.sprites, b.sprites);
+}
+
+double run(Scene& scene, bool parallel, uint32_t frames, uint64_t& sink) {
+  RenderSceneExtractOptions options{.parallel = parallel};
+  // Warm up the queries and scratch buffers.
+  sink += extract_render_scene(scene, options).meshes.size();
+  const auto start = Clock::now();
+  for (uint32_t frame = 0; frame < frames; ++frame) {
+    options.frame.frame_index = frame;
+    const RenderScene output = extract_render_scene(scene, options);
+    sink += output.meshes.size() + output.sprites.size();
+  }
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / frames;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const std::optional<Options> options = parse_options(argc, argv);
+  if (!options) {
+    return 1;
+  }
+  std::optional<ComponentContexts> contexts = make_component_contexts();
+  if (!contexts) {
+    return 1;
+  }
+
+  std::cout << std::format("{} frames, {} job workers\n", options->frames,
+                           JobSystem::get().worker_count());
+  std::cout << std::format("{:>12} {:>14} {:>14} {:>9}\n", "renderables", "serial ms/frm",
+                           "parallel ms/frm", "speedup");
+  uint64_t sink = 0;
+  for (const uint32_t renderables : {10'000u, 100'000u, 1'000'000u}) {
+    if (renderables > options->max_renderables) {
+      continue;
+    }
+    Scene scene(contexts->flecs);
+    populate_scene(scene, renderables);
+    if (!same_output(extract_render_scene(scene, {.parallel = false}),
+                     extract_render_scene(scene, {.parallel = true}))) {
+      std::cerr << std::format("{} renderables: serial and parallel output differ\n",
+                               renderables);
+      return 1;
+    }
+    const double serial = run(scene, false, options->frames, sink);
+    const double parallel = run(scene, true, options->frames, sink);
+    std::cout << std::format("{:>12} {:>14.2f} {:>14.2f} {:>8.2f}x\n", renderables, serial,
+                             parallel, serial / parallel);
+  }
+  std::cout << std::format("checksum {}\n", sink);
+  return 0;
+}
@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "core/FlatHashMap.hpp"
+#include "core/Hash.hpp"
+
+// Compares std::unordered_map + tuple_hash (the previous render graph / residency setup) against
+// FlatHashMap + hash_combine64 on synthetic workloads shaped like the map accesses of
+// RenderGraph::bake() and the render residency reconcile. It does not run either code path, so
+// it bounds the container cost only. For the end-to-end effect on bakes, replay the same capture
+// through rg-bench on builds from before and after the switch; reconcile has no standalone
+// benchmark.
+
+namespace {
+
+using namespace teng;
+
+struct Options {
+  uint32_t resources{512};
+  uint32_t entities{100'000};
+  uint32_t frames{200};
+};
+
+void usage(const char* argv0) {
+  std::cout << "usage: " << argv0 << " [--resources <n>] [--entities <n>] [--frames <n>]\n"
+            << "  --resources  Transient resources per simulated bake (default 512)\n"
+            << "  --entities   Render entities per simulated reconcile (default 100000)\n"
+            << "  --frames     Frames per run (default 200)\n"
+            << "  -h, --help   Show this help\n";
+}
+
+bool parse_u32(std::string_view text, uint32_t& out) {
+  const char* const end = text.data() + text.size();
+  const auto result = std::from_chars(text.data(), end, out, 10);
+  return !text.empty() && result.ptr == end && result.ec == std::errc{};
+}
+
+std::optional<Options> parse_options(int argc, char* argv[]) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if ((arg == "--resources" || arg == "--entities" || arg == "--frames") && i + 1 < argc) {
+      uint32_t& out = arg == "--resources"  ? options.resources
+                      : arg == "--entities" ? options.entities
+                                            : options.frames;
+      if (!parse_u32(argv[++i], out)) {
+        std::cerr << argv[0] << ": " << arg << " requires a 32-bit integer value\n";
+        return std::nullopt;
+      }
+    } else if (arg == "-h" || arg == "--help") {
+      usage(argv[0]);
+      std::exit(0);
+    } else {
+      std::cerr << argv[0] << ": unknown option: " << arg << '\n';
+      usage(argv[0]);
+      return std::nullopt;
+    }
+  }
+  if (options.resources == 0 || options.entities == 0 || options.frames == 0) {
+    usage(argv[0]);
+    return std::nullopt;
+  }
+  return options;
+}
+
+// Same shape as the render graph's TexPoolKey: attachment description plus derived usage.
+struct PoolKey {
+  uint32_t width{};
+  uint32_t height{};
+  uint32_t mip_levels{};
+  uint32_t array_layers{};
+  uint32_t format{};
+  uint32_t usage{};
+  bool operator==(const PoolKey&) const = default;
+};
+
+struct PoolKeyTupleHash {
+  size_t operator()(const PoolKey& k) const {
+    auto h = std::make_tuple(k.width, k.height, k.mip_levels, k.array_layers, k.format, k.usage);
+    return util::hash::tuple_hash<decltype(h)>{}(h);
+  }
+};
+
+struct PoolKeyFastHash {
+  using is_avalanching = void;
+  size_t operator()(const PoolKey& k) const {
+    const uint64_t dims = k.width | (static_cast<uint64_t>(k.height) << 32);
+    const uint64_t levels = k.mip_levels | (static_cast<uint64_t>(k.array_layers) << 32);
+    const uint64_t bits = k.format | (static_cast<uint64_t>(k.usage) << 32);
+    return util::hash::hash_combine64(util::hash::hash_combine64(dims, levels), bits);
+  }
+};
+
+// Same shape as the barrier pass's RgSubresourceStateKey.
+struct StateKey {
+  uint32_t type{};
+  uint32_t idx{};
+  int32_t mip{};
+  int32_t slice{};
+  bool operator==(const StateKey&) const = default;
+};
+
+struct StateKeyTupleHash {
+  size_t operator()(const StateKey& k) const {
+    auto h = std::make_tuple(k.type, k.idx, k.mip, k.slice);
+    return util::hash::tuple_hash<decltype(h)>{}(h);
+  }
+};
+
+struct StateKeyFastHash {
+  using is_avalanching = void;
+  size_t operator()(const StateKey& k) const {
+    const uint64_t sub = static_cast<uint32_t>(k.mip) |
+                         (static_cast<uint64_t>(static_cast<uint32_t>(k.slice)) << 32);
+    return util::hash::hash_combine64(k.idx | (static_cast<uint64_t>(k.type) << 32), sub);
+  }
+};
+
+struct State {
+  uint32_t access{};
+  uint32_t stage{};
+  uint32_t layout{};
+  uint32_t last_pass{};
+};
+
+struct Instance {
+  uint64_t model{};
+  float local_to_world[16]{};
+  uint32_t gpu_handle{};
+};
+
+struct StdMaps {
+  template <typename K, typename V, typename H>
+  using Map = std::unordered_map<K, V, H>;
+  template <typename K>
+  using Set = std::unordered_set<K>;
+  using PoolHash = PoolKeyTupleHash;
+  using StateHash = StateKeyTupleHash;
+  using EntityHash = std::hash<uint64_t>;
+};
+
+struct FlatMaps {
+  template <typename K, typename V, typename H>
+  using Map = FlatHashMap<K, V, H>;
+  template <typename K>
+  using Set = FlatHashSet<K>;
+  using PoolHash = PoolKeyFastHash;
+  using StateHash = StateKeyFastHash;
+  using EntityHash = util::hash::FastHash<uint64_t>;
+};
+
+using Clock = std::chrono::steady_clock;
+
+double elapsed_us(Clock::time_point start, uint32_t frames) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count() /
+         static_cast<double>(frames);
+}
+
+// Transient pool: every resource is returned after execute and reacquired by the next bake
+// (find, pop, erase the key once its list is empty), like free_atts_ / free_bufs_.
+template <typename Maps>
+double run_pool(const Options& options, uint64_t& sink) {
+  std::mt19937 rng{1};
+  std::vector<PoolKey> keys(options.resources);
+  for (PoolKey& key : keys) {
+    // Few distinct descriptions, as in a real frame: many passes share target sizes/formats.
+    key = PoolKey{.width = 1920u >> (rng() % 4),
+                  .height = 1080u >> (rng() % 4),
+                  .mip_levels = 1 + static_cast<uint32_t>(rng() % 3),
+                  .array_layers = 1,
+                  .format = static_cast<uint32_t>(rng() % 8),
+                  .usage = 1u << (rng() % 4)};
+  }
+  typename Maps::template Map<PoolKey, std::vector<uint32_t>, typename Maps::PoolHash> pool;
+  const auto start = Clock::now();
+  for (uint32_t frame = 0; frame < options.frames; ++frame) {
+    for (uint32_t i = 0; i < options.resources; ++i) {
+      pool[keys[i]].push_back(i);
+    }
+    for (uint32_t i = 0; i < options.resources; ++i) {
+      auto it = pool.find(keys[i]);
+      if (it != pool.end()) {
+        sink += it->second.back();
+        it->second.pop_back();
+        if (it->second.empty()) {
+          pool.erase(it);
+        }
+      }
+    }
+  }
+  return elapsed_us(start, options.frames);
+}
+
+// Barrier pass: per-subresource state built from scratch every bake, mostly find-or-insert.
+template <typename Maps>
+double run_states(const Options& options, uint64_t& sink) {
+  std::mt19937 rng{2};
+  std::vector<StateKey> uses;
+  const uint32_t use_count = options.resources * 8;
+  uses.reserve(use_count);
+  for (uint32_t i = 0; i < use_count; ++i) {
+    const uint32_t idx = rng() % options.resources;
+    uses.push_back(StateKey{.type = idx % 3,
+                            .idx = idx,
+                            .mip = static_cast<int32_t>(rng() % 4) - 1,
+                            .slice = -1});
+  }
+  const auto start = Clock::now();
+  for (uint32_t frame = 0; frame < options.frames; ++frame) {
+    typename Maps::template Map<StateKey, State, typename Maps::StateHash> states;
+    for (uint32_t pass = 0; pass < use_count; ++pass) {
+      auto [it, inserted] = states.try_emplace(uses[pass]);
+      if (!inserted) {
+        sink += it->second.last_pass;
+      }
+      it->second.last_pass = pass;
+    }
+    sink += states.size();
+  }
+  return elapsed_us(start, options.frames);
+}
+
+// Residency reconcile: look up every drawn entity, rebuild the seen set, then scan the instance
+// map for entities that disappeared. 1% of entities are replaced each frame.
+template <typename Maps>
+double run_reconcile(const Options& options, uint64_t& sink) {
+  std::mt19937_64 rng{3};
+  std::vector<uint64_t> entities(options.entities);
+  for (uint64_t& e : entities) {
+    e = rng() | 1;
+  }
+  typename Maps::template Map<uint64_t, Instance, typename Maps::EntityHash> instances;
+  typename Maps::template Set<uint64_t> seen;
+  std::vector<uint64_t> removed;
+  const uint32_t churn = std::max(1u, options.entities / 100);
+  const auto start = Clock::now();
+  for (uint32_t frame = 0; frame < options.frames; ++frame) {
+    for (uint32_t i = 0; i < churn; ++i) {
+      entities[rng() % entities.size()] = rng() | 1;
+    }
+    for (const uint64_t e : entities) {
+      if (!instances.contains(e)) {
+        instances.try_emplace(e, Instance{.model = e >> 48, .local_to_world = {}, .gpu_handle = 0});
+      }
+    }
+    seen.clear();
+    seen.reserve(entities.size());
+    for (const uint64_t e : entities) {
+      seen.insert(e);
+      sink += instances.find(e)->second.model;
+    }
+    removed.clear();
+    for (const auto& [e, instance] : instances) {
+      (void)instance;
+      if (!seen.contains(e)) {
+        removed.push_back(e);
+      }
+    }
+    for (const uint64_t e : removed) {
+      instances.erase(e);
+    }
+  }
+  return elapsed_us(start, options.frames);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const std::optional<Options> options = parse_options(argc, argv);
+  if (!options) {
+    return 1;
+  }
+  std::cout << std::format("{} resources, {} entities, {} frames\n", options->resources,
+                           options->entities, options->frames);
+  std::cout << std::format("{:<12} {:>16} {:>16} {:>9}\n", "workload", "unordered us/frm",
+                           "flat us/frm", "speedup");
+  uint64_t sink = 0;
+  const auto row = [](std::string_view name, double before, double after) {
+    std::cout << std::format("{:<12} {:>16.1f} {:>16.1f} {:>8.2f}x\n", name, before, after,
+                             before / after);
+  };
+  row("pool", run_pool<StdMaps>(*options, sink), run_pool<FlatMaps>(*options, sink));
+  row("bake states", run_states<StdMaps>(*options, sink), run_states<FlatMaps>(*options, sink));
+  row("reconcile", run_reconcile<StdMaps>(*options, sink),
+      run_reconcile<FlatMaps>(*options, sink));
+  std::cout << std::format("checksum {}\n", sink);
+  return 0;
+}
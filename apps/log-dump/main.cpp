@@ -0,0 +1,21 @@
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "core/Logger.hpp"
+
+// Prints a binary log (written by Logger::open_binary_file, e.g. metalrender --log-file) as text.
+
+int main(int argc, char* argv[]) {
+  if (argc != 2 || std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help") {
+    std::cout << "usage: " << argv[0] << " <file.tlog>\n";
+    return argc == 2 ? 0 : 1;
+  }
+  const teng::Result<std::string> text = teng::read_binary_log(std::filesystem::path(argv[1]));
+  if (!text) {
+    std::cerr << "log-dump: " << text.error() << '\n';
+    return 1;
+  }
+  std::cout << *text;
+  return 0;
+}
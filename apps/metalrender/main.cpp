@@ -7,8 +7,9 @@
 #include <optional>
 #include <string>
 #include <string_view>
-#include <tracy/Tracy.hpp>
 
+#include "core/Logger.hpp"
+#include "core/Profiler.hpp"
 #include "engine/Engine.hpp"
 #include "engine/ImGuiOverlayLayer.hpp"
 
@@ -16,13 +17,21 @@ namespace {
 
 struct RuntimeOptions {
   std::filesystem::path scene_path;
+  std::filesystem::path log_file;
   std::optional<std::uint32_t> quit_after_frames;
+  bool null_gfx{false};
+  bool render_thread{false};
 };
 
 void usage(const char* argv0) {
-  std::cout << "usage: " << argv0 << " [--scene <path>] [--quit-after-frames <n>]\n"
+  std::cout << "usage: " << argv0
+            << " [--scene <path>] [--quit-after-frames <n>] [--null-gfx] [--render-thread]"
+            << " [--log-file <path>]\n"
             << "  --scene              Load a canonical JSON scene instead of project startup_scene\n"
             << "  --quit-after-frames  Exit after completing n frames (n >= 1)\n"
+            << "  --null-gfx           Run headless on the null device (no GPU work, no window)\n"
+            << "  --render-thread      Bake and submit frames on a render thread\n"
+            << "  --log-file           Also write a binary log (print it with log-dump)\n"
             << "  -h, --help           Show this help\n";
 }
 
@@ -47,6 +56,8 @@ std::optional<RuntimeOptions> parse_options(int argc, char* argv[]) {
     const std::string arg = argv[i];
     if (arg == "--scene" && i + 1 < argc) {
       options.scene_path = argv[++i];
+    } else if (arg == "--log-file" && i + 1 < argc) {
+      options.log_file = argv[++i];
     } else if (arg == "--quit-after-frames" && i + 1 < argc) {
       std::uint32_t frame_count{};
       if (!parse_u32(std::string_view(argv[++i]), frame_count)) {
@@ -54,6 +65,10 @@ std::optional<RuntimeOptions> parse_options(int argc, char* argv[]) {
         return std::nullopt;
       }
       options.quit_after_frames = frame_count;
+    } else if (arg == "--null-gfx") {
+      options.null_gfx = true;
+    } else if (arg == "--render-thread") {
+      options.render_thread = true;
     } else if (arg == "-h" || arg == "--help") {
       usage(argv[0]);
       std::exit(0);
@@ -75,17 +90,26 @@ int main(int argc, char* argv[]) {
   if (!options) {
     return 1;
   }
+  if (!options->log_file.empty()) {
+    const teng::Result<void> opened = teng::Logger::get().open_binary_file(options->log_file);
+    if (!opened) {
+      std::cerr << "metalrender: " << opened.error() << '\n';
+      return 1;
+    }
+  }
 
   teng::engine::Engine engine(teng::engine::EngineConfig{
       .resource_dir = {},
       .app_name = "metalrender",
-      .preferred_gfx_api = teng::engine::EngineGfxApi::PlatformDefault,
+      .preferred_gfx_api = options->null_gfx ? teng::engine::EngineGfxApi::Null
+                                             : teng::engine::EngineGfxApi::PlatformDefault,
       .initial_window_width = -1,
       .initial_window_height = -1,
       .initial_window_position = {500, 0},
       .floating_window = false,
       .vsync = true,
-      .enable_imgui = true,
+      .enable_imgui = !options->null_gfx,
+      .render_thread = options->render_thread,
       .quit_after_frames = options->quit_after_frames,
   });
   teng::Result<teng::engine::SceneLoadResult> loaded =
@@ -95,7 +119,9 @@ int main(int argc, char* argv[]) {
     std::cerr << "metalrender: failed to load scene: " << loaded.error() << '\n';
     return 1;
   }
-  engine.layers().push_layer(std::make_unique<teng::engine::ImGuiOverlayLayer>());
+  if (!engine.headless()) {
+    engine.layers().push_layer(std::make_unique<teng::engine::ImGuiOverlayLayer>());
+  }
   engine.run();
   return 0;
 }
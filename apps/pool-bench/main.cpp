@@ -0,0 +1,225 @@
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "core/Handle.hpp"
+#include "core/Pool.hpp"
+
+// Compares handle lookups across Pool, BlockPool and AtomicBlockPool: single-threaded, then with
+// reader threads hammering get() while one thread churns alloc/destroy on the same pool.
+
+namespace {
+
+using namespace teng;
+
+struct Payload {
+  uint64_t size{};
+  uint64_t gpu_address{};
+  uint32_t bindless_idx{};
+  uint32_t flags{};
+  void* native{};
+};
+using PayloadHandle = GenerationalHandle<Payload>;
+
+struct Options {
+  uint32_t live{4096};
+  uint32_t lookups{20'000'000};
+  uint32_t threads{std::max(2u, std::thread::hardware_concurrency()) - 1};
+};
+
+void usage(const char* argv0) {
+  std::cout << "usage: " << argv0 << " [--live <n>] [--lookups <n>] [--threads <n>]\n"
+            << "  --live     Live handles in each pool (default 4096)\n"
+            << "  --lookups  get() calls per thread per run (default 20000000)\n"
+            << "  --threads  Reader threads in the contended run (default cores - 1)\n"
+            << "  -h, --help Show this help\n";
+}
+
+bool parse_u32(std::string_view text, uint32_t& out) {
+  const char* const end = text.data() + text.size();
+  const auto result = std::from_chars(text.data(), end, out, 10);
+  return !text.empty() && result.ptr == end && result.ec == std::errc{};
+}
+
+std::optional<Options> parse_options(int argc, char* argv[]) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if ((arg == "--live" || arg == "--lookups" || arg == "--threads") && i + 1 < argc) {
+      uint32_t& out = arg == "--live"      ? options.live
+                      : arg == "--lookups" ? options.lookups
+                                           : options.threads;
+      if (!parse_u32(argv[++i], out)) {
+        std::cerr << argv[0] << ": " << arg << " requires a 32-bit integer value\n";
+        return std::nullopt;
+      }
+    } else if (arg == "-h" || arg == "--help") {
+      usage(argv[0]);
+      std::exit(0);
+    } else {
+      std::cerr << argv[0] << ": unknown option: " << arg << '\n';
+      usage(argv[0]);
+      return std::nullopt;
+    }
+  }
+  if (options.live == 0 || options.lookups == 0 || options.threads == 0) {
+    usage(argv[0]);
+    return std::nullopt;
+  }
+  return options;
+}
+
+// Random lookup order, shared by every pool so they do the same work.
+std::vector<uint32_t> make_lookup_order(uint32_t live, uint32_t seed) {
+  std::vector<uint32_t> order(64 * 1024);
+  std::mt19937 rng{seed};
+  std::uniform_int_distribution<uint32_t> dist(0, live - 1);
+  for (uint32_t& i : order) {
+    i = dist(rng);
+  }
+  return order;
+}
+
+template <typename PoolT>
+uint64_t lookup_loop(PoolT& pool, const std::vector<PayloadHandle>& handles,
+                     const std::vector<uint32_t>& order, uint32_t lookups) {
+  uint64_t sum = 0;
+  const size_t mask = order.size() - 1;
+  for (uint32_t i = 0; i < lookups; ++i) {
+    if (const Payload* p = pool.get(handles[order[i & mask]])) {
+      sum += p->size;
+    }
+  }
+  return sum;
+}
+
+struct RunResult {
+  double single_ns{};
+  double contended_ns{};
+  uint64_t churn_ops{};
+  uint64_t checksum{};
+};
+
+template <typename PoolT>
+RunResult run(PoolT& pool, const Options& options) {
+  using Clock = std::chrono::steady_clock;
+  std::vector<PayloadHandle> handles;
+  handles.reserve(options.live);
+  for (uint32_t i = 0; i < options.live; ++i) {
+    handles.push_back(pool.alloc(Payload{.size = i}));
+  }
+  // Grow once for the writer's churn so vector-backed pools do not reallocate mid-run.
+  {
+    std::vector<PayloadHandle> warm;
+    for (uint32_t i = 0; i < 64; ++i) {
+      warm.push_back(pool.alloc());
+    }
+    for (const PayloadHandle h : warm) {
+      pool.destroy(h);
+    }
+  }
+  RunResult result;
+  std::atomic<uint64_t> sink{0};
+
+  {
+    const std::vector<uint32_t> order = make_lookup_order(options.live, 1);
+    const auto start = Clock::now();
+    sink += lookup_loop(pool, handles, order, options.lookups);
+    const auto end = Clock::now();
+    result.single_ns = std::chrono::duration<double, std::nano>(end - start).count() /
+                       static_cast<double>(options.lookups);
+  }
+
+  {
+    std::atomic<bool> go{false};
+    std::atomic<uint32_t> readers_done{0};
+    std::vector<std::thread> readers;
+    std::vector<double> reader_ns(options.threads);
+    for (uint32_t t = 0; t < options.threads; ++t) {
+      readers.emplace_back([&, t] {
+        const std::vector<uint32_t> order = make_lookup_order(options.live, t + 2);
+        while (!go.load(std::memory_order_acquire)) {
+        }
+        const auto start = Clock::now();
+        sink += lookup_loop(pool, handles, order, options.lookups);
+        const auto end = Clock::now();
+        reader_ns[t] = std::chrono::duration<double, std::nano>(end - start).count() /
+                       static_cast<double>(options.lookups);
+        readers_done.fetch_add(1, std::memory_order_release);
+      });
+    }
+    // Writer: allocates and destroys handles the readers never touch, like resources being
+    // created and retired mid-frame while the renderer resolves others.
+    std::thread writer([&] {
+      std::vector<PayloadHandle> churn;
+      while (!go.load(std::memory_order_acquire)) {
+      }
+      while (readers_done.load(std::memory_order_acquire) < options.threads) {
+        for (uint32_t i = 0; i < 64; ++i) {
+          churn.push_back(pool.alloc(Payload{.size = i}));
+        }
+        for (const PayloadHandle h : churn) {
+          pool.destroy(h);
+        }
+        churn.clear();
+        result.churn_ops += 128;
+      }
+    });
+    go.store(true, std::memory_order_release);
+    for (auto& reader : readers) {
+      reader.join();
+    }
+    writer.join();
+    for (const double ns : reader_ns) {
+      result.contended_ns += ns;
+    }
+    result.contended_ns /= static_cast<double>(options.threads);
+  }
+
+  for (const PayloadHandle h : handles) {
+    pool.destroy(h);
+  }
+  result.checksum = sink.load();
+  return result;
+}
+
+void print_result(std::string_view name, const RunResult& r) {
+  std::cout << std::format("{:<16} {:>12.2f} {:>16.2f} {:>14}\n", name, r.single_ns,
+                           r.contended_ns, r.churn_ops);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const std::optional<Options> options = parse_options(argc, argv);
+  if (!options) {
+    return 1;
+  }
+  std::cout << std::format("{} live handles, {} lookups per thread, {} reader threads + 1 writer\n",
+                           options->live, options->lookups, options->threads);
+  std::cout << std::format("{:<16} {:>12} {:>16} {:>14}\n", "pool", "1T ns/get",
+                           "contended ns/get", "writer ops");
+  {
+    Pool<PayloadHandle, Payload> pool;
+    print_result("Pool", run(pool, *options));
+  }
+  {
+    BlockPool<PayloadHandle, Payload> pool{128, 1, true};
+    print_result("BlockPool", run(pool, *options));
+  }
+  {
+    AtomicBlockPool<PayloadHandle, Payload> pool{128, 1, true};
+    print_result("AtomicBlockPool", run(pool, *options));
+  }
+  return 0;
+}
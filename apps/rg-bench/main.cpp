@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gfx/RenderGraph.Capture.hpp"
+#include "gfx/RenderGraph.hpp"
+#include "gfx/renderer/RendererCVars.hpp"
+#include "gfx/rhi/Device.hpp"
+#include "gfx/rhi/Swapchain.hpp"
+
+// Replays a render graph capture (rg_capture_*.json, written next to render graph JSON dumps)
+// through bake() on the headless null device and reports bake timings.
+
+namespace {
+
+using namespace teng;
+
+struct Options {
+  std::filesystem::path capture_path;
+  std::uint32_t iterations{5000};
+  std::uint32_t warmup{16};
+  bool bake_cache{true};
+};
+
+void usage(const char* argv0) {
+  std::cout << "usage: " << argv0 << " <capture.json> [--iterations <n>] [--warmup <n>]"
+            << " [--no-bake-cache]\n"
+            << "  --iterations     Timed bakes (default 5000)\n"
+            << "  --warmup         Untimed bakes first, so pools and history are populated\n"
+            << "  --no-bake-cache  Run the full bake every frame instead of reusing the cached plan\n"
+            << "  -h, --help       Show this help\n";
+}
+
+bool parse_u32(std::string_view text, std::uint32_t& out) {
+  const char* const end = text.data() + text.size();
+  const auto result = std::from_chars(text.data(), end, out, 10);
+  return !text.empty() && result.ptr == end && result.ec == std::errc{};
+}
+
+std::optional<Options> parse_options(int argc, char* argv[]) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if ((arg == "--iterations" || arg == "--warmup") && i + 1 < argc) {
+      std::uint32_t& out = arg == "--iterations" ? options.iterations : options.warmup;
+      if (!parse_u32(argv[++i], out)) {
+        std::cerr << argv[0] << ": " << arg << " requires a 32-bit integer value\n";
+        return std::nullopt;
+      }
+    } else if (arg == "--no-bake-cache") {
+      options.bake_cache = false;
+    } else if (arg == "-h" || arg == "--help") {
+      usage(argv[0]);
+      std::exit(0);
+    } else if (!arg.starts_with("-") && options.capture_path.empty()) {
+      options.capture_path = arg;
+    } else {
+      std::cerr << argv[0] << ": unknown option: " << arg << '\n';
+      usage(argv[0]);
+      return std::nullopt;
+    }
+  }
+  if (options.capture_path.empty() || options.iterations == 0) {
+    usage(argv[0]);
+    return std::nullopt;
+  }
+  return options;
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+  const auto i = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+  return sorted[i];
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const std::optional<Options> options = parse_options(argc, argv);
+  if (!options) {
+    return 1;
+  }
+  Result<gfx::RGCapture> capture = gfx::read_rg_capture(options->capture_path);
+  if (!capture) {
+    std::cerr << "rg-bench: " << capture.error() << '\n';
+    return 1;
+  }
+  gfx::renderer_cv::developer_render_graph_bake_cache.set(options->bake_cache ? 1 : 0);
+  CVarSystem::get().apply_pending_changes();
+
+  std::unique_ptr<gfx::rhi::Device> device = gfx::rhi::create_device(gfx::rhi::GfxAPI::Null);
+  device->init(gfx::rhi::Device::InitInfo{
+      .shader_lib_dir = {},
+      .app_name = "rg-bench",
+      .validation_layers_enabled = false,
+      .frames_in_flight = 2,
+  });
+
+  std::vector<double> bake_ms;
+  bake_ms.reserve(options->iterations);
+  {
+    gfx::RenderGraph rg;
+    rg.init(device.get());
+    const gfx::RGCaptureBindings bindings = gfx::create_capture_bindings(device.get(), *capture);
+    gfx::rhi::Swapchain* swapchain =
+        bindings.swapchain.is_valid() ? device->get_swapchain(bindings.swapchain) : nullptr;
+
+    const std::uint32_t frames = options->warmup + options->iterations;
+    for (std::uint32_t frame = 0; frame < frames; ++frame) {
+      if (swapchain) {
+        device->acquire_next_swapchain_image(swapchain);
+      }
+      rg.replay(*capture, bindings);
+      const auto start = std::chrono::steady_clock::now();
+      rg.bake(capture->fb_size);
+      const auto end = std::chrono::steady_clock::now();
+      if (frame >= options->warmup) {
+        bake_ms.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+      }
+      rg.execute();
+      device->submit_frame();
+    }
+
+    const auto& bake_stats = rg.get_bake_stats();
+    const auto& mem = rg.get_transient_memory_stats();
+    const auto& exec = rg.get_execute_stats();
+    std::cout << std::format("capture: {} ({} passes, {} resources, {} culled)\n",
+                             options->capture_path.string(), capture->passes.size(),
+                             capture->resources.size(), bake_stats.culled_passes);
+    std::cout << std::format("barriers: {} in {} calls per frame\n", exec.barriers,
+                             exec.barrier_calls);
+    std::cout << std::format("transient memory: {} KiB unaliased -> {} KiB aliased\n",
+                             mem.bytes_unaliased() / 1024, mem.bytes_aliased() / 1024);
+    std::cout << std::format("bake cache: {} (topology hit rate {:.3f})\n",
+                             options->bake_cache ? "on" : "off", bake_stats.topology_hit_rate());
+    rg.shutdown();
+  }
+  device->shutdown();
+
+  std::ranges::sort(bake_ms);
+  double total_ms = 0.0;
+  for (const double ms : bake_ms) {
+    total_ms += ms;
+  }
+  std::cout << std::format(
+      "bake ms over {} iterations: min {:.4f}  avg {:.4f}  p50 {:.4f}  p99 {:.4f}  max {:.4f}\n",
+      bake_ms.size(), bake_ms.front(), total_ms / static_cast<double>(bake_ms.size()),
+      percentile(bake_ms, 0.5), percentile(bake_ms, 0.99), bake_ms.back());
+  return 0;
+}
@@ -1,8 +1,7 @@
 #include "Window.hpp"
 
-#include <tracy/Tracy.hpp>
-
 #include "core/Logger.hpp"
+#include "core/Profiler.hpp"
 
 #ifdef __APPLE__
 #include "core/Config.hpp"
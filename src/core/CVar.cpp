@@ -1,6 +1,8 @@
 #include "CVar.hpp"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
 #include <charconv>
 #include <cstdint>
@@ -8,17 +10,19 @@
 #include <fstream>
 #include <iomanip>
 #include <limits>
+#include <mutex>
 #include <span>
 #include <sstream>
 #include <string_view>
-#include <tracy/Tracy.hpp>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include "core/Console.hpp"
 #include "core/Logger.hpp"
+#include "core/Profiler.hpp"
 #include "imgui.h"
 #include "imgui_internal.h"
 #include "imgui_stdlib.h"
@@ -60,8 +64,7 @@ struct CVarArray {
   std::vector<CVarStorage<T>> cvars;
   uint32_t last_cvar{0};
   explicit CVarArray(size_t size) { cvars.reserve(size); }
-  T get_current(uint32_t idx) { return cvars[idx].current; }
-  T* get_current_ptr(uint32_t idx) { return &cvars[idx].current; }
+  const T& get_current(uint32_t idx) const { return cvars[idx].current; }
 
   uint32_t add(const T& default_value, const T& current_value, CVarParameter* param) {
     uint32_t idx = cvars.size();
@@ -85,6 +88,9 @@ struct CVarArray {
 
 class CVarSystemImpl : public CVarSystem {
  public:
+  // Readers always find a snapshot, even before the first cvar is registered.
+  CVarSystemImpl() { publish_snapshot(); }
+
   CVarParameter* get_cvar(util::hash::HashedString hash) final {
     auto it = saved_cvars_.find(hash);
     if (it != saved_cvars_.end()) {
@@ -103,11 +109,12 @@ class CVarSystemImpl : public CVarSystem {
   CVarParameter* create_int_cvar(const char* name, const char* description, int32_t default_value,
                                  int32_t current_value) final;
 
-  template <typename T>
-  T* get_cvar_current(uint32_t hash);
-
-  float* get_float_cvar(util::hash::HashedString hash) final {
-    return get_cvar_current<float>(hash);
+  std::optional<float> get_float_cvar(util::hash::HashedString hash) final {
+    CVarParameter* param = get_cvar(hash);
+    if (!param || param->type != CVarKind::Float) {
+      return std::nullopt;
+    }
+    return snapshot().floats_[param->array_idx];
   }
 
   void set_float_cvar(util::hash::HashedString hash, float value) final {
@@ -117,8 +124,12 @@ class CVarSystemImpl : public CVarSystem {
     }
   }
 
-  int32_t* get_int_cvar(util::hash::HashedString hash) final {
-    return get_cvar_current<int32_t>(hash);
+  std::optional<int32_t> get_int_cvar(util::hash::HashedString hash) final {
+    CVarParameter* param = get_cvar(hash);
+    if (!param || param->type != CVarKind::Int) {
+      return std::nullopt;
+    }
+    return snapshot().ints_[param->array_idx];
   }
   void set_int_cvar(util::hash::HashedString hash, int32_t value) final {
     CVarParameter* param = get_cvar(hash);
@@ -127,7 +138,11 @@ class CVarSystemImpl : public CVarSystem {
     }
   }
   const char* get_string_cvar(util::hash::HashedString hash) final {
-    return get_cvar_current<std::string>(hash)->c_str();
+    CVarParameter* param = get_cvar(hash);
+    if (!param || param->type != CVarKind::String) {
+      return nullptr;
+    }
+    return snapshot().strings_[param->array_idx].c_str();
   }
   void set_string_cvar(util::hash::HashedString hash, const char* value) final {
     CVarParameter* param = get_cvar(hash);
@@ -136,11 +151,19 @@ class CVarSystemImpl : public CVarSystem {
     }
   }
 
+  void apply_pending_changes() final;
+  std::shared_ptr<const CVarSnapshot> acquire_snapshot() final;
+  // Latest published snapshot. See CVarSnapshot::k_retained_frames for how long it stays alive.
+  [[nodiscard]] const CVarSnapshot& snapshot() const {
+    return *snapshot_.load(std::memory_order_acquire);
+  }
+
   void add_change_callback(util::hash::HashedString name, std::function<void()> cb) final;
   void add_change_callback(const AutoCVarInt& cv, std::function<void()> cb) final;
   void add_change_callback(const AutoCVarFloat& cv, std::function<void()> cb) final;
   void add_change_callback(const AutoCVarString& cv, std::function<void()> cb) final;
 
+  // Queue a write for the next apply_pending_changes(). Callable from any thread.
   void assign_int(CVarParameter* p, int32_t v);
   void assign_float(CVarParameter* p, float v);
   void assign_string(CVarParameter* p, std::string v);
@@ -164,14 +187,40 @@ class CVarSystemImpl : public CVarSystem {
                                        std::string* error_msg) final;
 
  private:
+  struct PendingWrite {
+    CVarParameter* param;
+    std::variant<int32_t, float, std::string> value;
+  };
+
   CVarParameter* init_cvar(const char* name, const char* description);
+  void queue_write(CVarParameter* p, std::variant<int32_t, float, std::string> value);
+  // Whether the authoritative value of `p` differs from the published snapshot.
+  [[nodiscard]] bool differs_from_snapshot(const CVarParameter* p) const;
+  void publish_snapshot();
 
   std::vector<CVarParameter*> active_edit_parameters_;
   std::unordered_map<uint32_t, CVarParameter> saved_cvars_;
   std::unordered_map<uint32_t, std::vector<std::function<void()>>> change_callbacks_;
+  // Authoritative values, touched only on the main thread. Readers use the snapshots.
   CVarArray<int32_t> int_cvars_{200};
   CVarArray<float> float_cvars_{200};
   CVarArray<std::string> string_cvars_{200};
+
+  std::mutex pending_mtx_;
+  std::vector<PendingWrite> pending_writes_;
+  // Swapped with pending_writes_ in apply_pending_changes() so neither reallocates every frame.
+  std::vector<PendingWrite> applying_writes_;
+  std::vector<CVarParameter*> touched_params_;
+
+  // Hot-path readers load this pointer; shared ownership lives in retained_snapshots_.
+  std::atomic<const CVarSnapshot*> snapshot_{};
+  // Guards the ring against acquire_snapshot() copies racing a publish. get() never takes it.
+  std::mutex snapshot_mtx_;
+  // The published snapshot and the k_retained_frames before it, oldest overwritten first.
+  std::array<std::shared_ptr<const CVarSnapshot>, CVarSnapshot::k_retained_frames + 1>
+      retained_snapshots_;
+  size_t current_snapshot_{};
+  uint64_t snapshot_generation_{};
 };
 
 template <>
@@ -378,6 +427,7 @@ CVarParameter* CVarSystemImpl::create_float_cvar(const char* name, const char* d
   if (!param) return nullptr;
   param->type = CVarKind::Float;
   get_cvar_array<float>().add(default_value, current_value, param);
+  publish_snapshot();
   return param;
 }
 
@@ -388,6 +438,7 @@ CVarParameter* CVarSystemImpl::create_string_cvar(const char* name, const char*
   if (!param) return nullptr;
   param->type = CVarKind::String;
   get_cvar_array<std::string>().add(default_value, current_value, param);
+  publish_snapshot();
   return param;
 }
 
@@ -397,16 +448,10 @@ CVarParameter* CVarSystemImpl::create_int_cvar(const char* name, const char* des
   if (!param) return nullptr;
   param->type = CVarKind::Int;
   get_cvar_array<int32_t>().add(default_value, current_value, param);
+  publish_snapshot();
   return param;
 }
 
-template <typename T>
-T* CVarSystemImpl::get_cvar_current(uint32_t hash) {
-  CVarParameter* param = get_cvar(hash);
-  if (!param) return nullptr;
-  return get_cvar_array<T>().get_current_ptr(param->array_idx);
-}
-
 void CVarSystemImpl::add_change_callback(util::hash::HashedString name, std::function<void()> cb) {
   if (!get_cvar(name)) {
     return;
@@ -441,11 +486,7 @@ void CVarSystemImpl::assign_int(CVarParameter* p, int32_t v) {
     LWARN("incorrect cvar type");
     return;
   }
-  if (int_cvars_.get_current(p->array_idx) == v) {
-    return;
-  }
-  int_cvars_.set_current(v, p->array_idx);
-  fire_change_callbacks(util::hash::HashedString{p->name});
+  queue_write(p, v);
 }
 
 void CVarSystemImpl::assign_float(CVarParameter* p, float v) {
@@ -453,11 +494,7 @@ void CVarSystemImpl::assign_float(CVarParameter* p, float v) {
     LWARN("incorrect cvar type");
     return;
   }
-  if (float_cvars_.get_current(p->array_idx) == v) {
-    return;
-  }
-  float_cvars_.set_current(v, p->array_idx);
-  fire_change_callbacks(util::hash::HashedString{p->name});
+  queue_write(p, v);
 }
 
 void CVarSystemImpl::assign_string(CVarParameter* p, std::string v) {
@@ -465,11 +502,95 @@ void CVarSystemImpl::assign_string(CVarParameter* p, std::string v) {
     LWARN("incorrect cvar type");
     return;
   }
-  if (string_cvars_.get_current(p->array_idx) == v) {
+  queue_write(p, std::move(v));
+}
+
+void CVarSystemImpl::queue_write(CVarParameter* p,
+                                 std::variant<int32_t, float, std::string> value) {
+  std::scoped_lock lock(pending_mtx_);
+  pending_writes_.push_back(PendingWrite{.param = p, .value = std::move(value)});
+}
+
+void CVarSystemImpl::apply_pending_changes() {
+  ZoneScoped;
+  {
+    std::scoped_lock lock(pending_mtx_);
+    std::swap(pending_writes_, applying_writes_);
+  }
+  if (applying_writes_.empty()) {
     return;
   }
-  string_cvars_.set_current(std::move(v), p->array_idx);
-  fire_change_callbacks(util::hash::HashedString{p->name});
+  touched_params_.clear();
+  for (PendingWrite& write : applying_writes_) {
+    CVarParameter* p = write.param;
+    switch (p->type) {
+      case CVarKind::Int:
+        int_cvars_.set_current(std::get<int32_t>(write.value), p->array_idx);
+        break;
+      case CVarKind::Float:
+        float_cvars_.set_current(std::get<float>(write.value), p->array_idx);
+        break;
+      case CVarKind::String:
+        string_cvars_.set_current(std::move(std::get<std::string>(write.value)), p->array_idx);
+        break;
+    }
+    if (std::ranges::find(touched_params_, p) == touched_params_.end()) {
+      touched_params_.push_back(p);
+    }
+  }
+  applying_writes_.clear();
+  // A cvar set and then reset within one frame has not changed.
+  std::erase_if(touched_params_, [this](const CVarParameter* p) {
+    return !differs_from_snapshot(p);
+  });
+  if (touched_params_.empty()) {
+    return;
+  }
+  publish_snapshot();
+  for (const CVarParameter* p : touched_params_) {
+    fire_change_callbacks(util::hash::HashedString{p->name});
+  }
+}
+
+bool CVarSystemImpl::differs_from_snapshot(const CVarParameter* p) const {
+  const CVarSnapshot& snap = snapshot();
+  switch (p->type) {
+    case CVarKind::Int:
+      return snap.ints_[p->array_idx] != int_cvars_.get_current(p->array_idx);
+    case CVarKind::Float:
+      return snap.floats_[p->array_idx] != float_cvars_.get_current(p->array_idx);
+    case CVarKind::String:
+      return snap.strings_[p->array_idx] != string_cvars_.get_current(p->array_idx);
+  }
+  return false;
+}
+
+void CVarSystemImpl::publish_snapshot() {
+  auto snap = std::make_shared<CVarSnapshot>();
+  snap->generation_ = ++snapshot_generation_;
+  snap->ints_.reserve(int_cvars_.cvars.size());
+  for (const auto& cv : int_cvars_.cvars) {
+    snap->ints_.push_back(cv.current);
+  }
+  snap->floats_.reserve(float_cvars_.cvars.size());
+  for (const auto& cv : float_cvars_.cvars) {
+    snap->floats_.push_back(cv.current);
+  }
+  snap->strings_.reserve(string_cvars_.cvars.size());
+  for (const auto& cv : string_cvars_.cvars) {
+    snap->strings_.push_back(cv.current);
+  }
+  // Readers that loaded an older pointer keep using it; the ring keeps it alive for
+  // k_retained_frames more publishes.
+  std::scoped_lock lock(snapshot_mtx_);
+  snapshot_.store(snap.get(), std::memory_order_release);
+  current_snapshot_ = snapshot_generation_ % retained_snapshots_.size();
+  retained_snapshots_[current_snapshot_] = std::move(snap);
+}
+
+std::shared_ptr<const CVarSnapshot> CVarSystemImpl::acquire_snapshot() {
+  std::scoped_lock lock(snapshot_mtx_);
+  return retained_snapshots_[current_snapshot_];
 }
 
 void CVarSystemImpl::im_gui_label(const char* label, float text_width) {
@@ -579,15 +700,6 @@ void assert_unique_cvar_registered(CVarParameter* param) {
   std::abort();
 }
 
-template <typename T>
-T get_cvar_current_by_index(uint32_t idx) {
-  return CVarSystemImpl::get().get_cvar_array<T>().get_current(idx);
-}
-template <typename T>
-T* get_cvar_current_ptr_by_index(uint32_t idx) {
-  return CVarSystemImpl::get().get_cvar_array<T>().get_current_ptr(idx);
-}
-
 template <typename T, typename U>
 void set_cvar_by_idx(uint32_t idx, U&& data) {
   auto& impl = CVarSystemImpl::get();
@@ -615,9 +727,7 @@ AutoCVarFloat::AutoCVarFloat(const char* name, const char* description, float de
   idx_ = param->array_idx;
 }
 
-float AutoCVarFloat::get() { return get_cvar_current_by_index<float>(idx_); }
-
-float* AutoCVarFloat::get_ptr() { return get_cvar_current_ptr_by_index<float>(idx_); }
+float AutoCVarFloat::get() const { return CVarSystemImpl::get().snapshot().get(*this); }
 
 void AutoCVarFloat::set(float val) { set_cvar_by_idx<float>(idx_, val); }
 
@@ -630,9 +740,7 @@ AutoCVarInt::AutoCVarInt(const char* name, const char* desc, int initial_value,
   idx_ = param->array_idx;
 }
 
-int32_t AutoCVarInt::get() { return get_cvar_current_by_index<int32_t>(idx_); }
-
-int32_t* AutoCVarInt::get_ptr() { return get_cvar_current_ptr_by_index<int32_t>(idx_); }
+int32_t AutoCVarInt::get() const { return CVarSystemImpl::get().snapshot().get(*this); }
 
 void AutoCVarInt::set(int32_t val) { set_cvar_by_idx<int32_t>(idx_, val); }
 
@@ -646,8 +754,8 @@ AutoCVarString::AutoCVarString(const char* name, const char* description, const
   idx_ = param->array_idx;
 }
 
-const char* AutoCVarString::get() {
-  return get_cvar_current_ptr_by_index<std::string>(idx_)->c_str();
+const char* AutoCVarString::get() const {
+  return CVarSystemImpl::get().snapshot().get(*this).c_str();
 }
 
 void AutoCVarString::set(std::string_view val) {
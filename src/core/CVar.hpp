@@ -4,8 +4,11 @@
 
 #include <cstdint>
 #include <functional>
+#include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "Hash.hpp"
 #include "core/Config.hpp"
@@ -46,7 +49,13 @@ enum class CVarApplyResult : uint8_t {
 struct AutoCVarInt;
 struct AutoCVarFloat;
 struct AutoCVarString;
+class CVarSnapshot;
 
+// Values are read from immutable snapshots and written through a queue. set_*_cvar / AutoCVar::set
+// may be called from any thread; the writes take effect together at the next
+// apply_pending_changes(), which the engine calls once per frame on the main thread. Reads on any
+// thread see the latest published snapshot and never lock. Registration, callbacks, the editor
+// and file load/save are main-thread only.
 class CVarSystem {
  public:
   static CVarSystem& get();
@@ -58,13 +67,20 @@ class CVarSystem {
   virtual CVarParameter* create_string_cvar(const char* name, const char* description,
                                             const char* default_value,
                                             const char* current_value) = 0;
-  virtual float* get_float_cvar(util::hash::HashedString hash) = 0;
+  // Value in the current snapshot; empty when there is no such cvar or it has another type.
+  virtual std::optional<float> get_float_cvar(util::hash::HashedString hash) = 0;
   virtual void set_float_cvar(util::hash::HashedString hash, float value) = 0;
-  virtual int32_t* get_int_cvar(util::hash::HashedString hash) = 0;
+  virtual std::optional<int32_t> get_int_cvar(util::hash::HashedString hash) = 0;
   virtual void set_int_cvar(util::hash::HashedString hash, int32_t value) = 0;
-  // Pointer is valid only until the stored string is next assigned (reallocation may invalidate).
+  // Null when there is no such cvar. Same lifetime as AutoCVarString::get().
   virtual const char* get_string_cvar(util::hash::HashedString hash) = 0;
   virtual void set_string_cvar(util::hash::HashedString hash, const char* value) = 0;
+  // Frame boundary: applies the queued writes in order, publishes a new snapshot if any value
+  // changed, then runs the change callbacks of those cvars, once each.
+  virtual void apply_pending_changes() = 0;
+  // Shared ownership of the current snapshot, for work that must see one consistent set of values
+  // for longer than a frame or two (e.g. a render thread recording a whole frame).
+  virtual std::shared_ptr<const CVarSnapshot> acquire_snapshot() = 0;
   virtual void draw_imgui_editor() = 0;
   virtual void load_from_file(const std::string& path) = 0;
   virtual void save_to_file(const std::string& path) = 0;
@@ -72,8 +88,8 @@ class CVarSystem {
   virtual void for_each_cvar(std::function<void(const CVarInfoView&)> visitor) = 0;
   virtual CVarApplyResult set_cvar_from_string(std::string_view name, std::string_view value,
                                                std::string* error_msg) = 0;
-  /// Fired after a successful value change via set_*_cvar / AutoCVar::set (not when mutating
-  /// through get_*_cvar / get_ptr()).
+  /// Run by apply_pending_changes() on the main thread for each cvar whose value differs from the
+  /// previous snapshot. Values set from a callback are applied at the next frame boundary.
   virtual void add_change_callback(util::hash::HashedString name, std::function<void()> cb) = 0;
   virtual void add_change_callback(const AutoCVarInt& cv, std::function<void()> cb) = 0;
   virtual void add_change_callback(const AutoCVarFloat& cv, std::function<void()> cb) = 0;
@@ -86,39 +102,65 @@ struct AutoCVar {
   [[nodiscard]] util::hash::HashedString hashed_name() const {
     return util::hash::HashedString{name_hash_};
   }
+  // Slot in CVarSnapshot's array of this value type.
+  [[nodiscard]] uint32_t index() const { return idx_; }
 
  protected:
   uint32_t idx_{};
   uint32_t name_hash_{};
 };
 
+// get() reads the latest published snapshot by index: no lookup, no lock, safe from any thread.
+// set() queues the write for the next frame boundary, so get() keeps returning the old value until
+// then.
 struct AutoCVarInt : AutoCVar<int32_t> {
   AutoCVarInt(const char* name, const char* desc, int initial_value,
               CVarFlags flags = CVarFlags::None);
-  int32_t get();
-  /// Raw storage; writes do not run change callbacks — prefer set() or CVarSystem::set_int_cvar.
-  int32_t* get_ptr();
+  [[nodiscard]] int32_t get() const;
   void set(int32_t val);
 };
 
 struct AutoCVarFloat : AutoCVar<float> {
   AutoCVarFloat(const char* name, const char* description, float default_value,
                 CVarFlags flags = CVarFlags::None);
-  float get();
-  /// Raw storage; writes do not run change callbacks — prefer set() or CVarSystem::set_float_cvar.
-  float* get_ptr();
+  [[nodiscard]] float get() const;
   void set(float val);
 };
 
 struct AutoCVarString : AutoCVar<std::string> {
   AutoCVarString(const char* name, const char* description, const char* default_value,
                  CVarFlags flags = CVarFlags::None);
-  // Same lifetime caveats as CVarSystem::get_string_cvar.
-  const char* get();
+  // Points into the current snapshot, which is kept alive for CVarSnapshot::k_retained_frames more
+  // publishes. Copy it, or hold a snapshot from acquire_snapshot(), to keep it longer.
+  [[nodiscard]] const char* get() const;
   void set(std::string_view val);
   void set(std::string&& val);
 };
 
+// Immutable copy of every cvar value, indexed by AutoCVar::index().
+class CVarSnapshot {
+ public:
+  // Snapshots replaced more recently than this many publishes are still alive, so references from
+  // AutoCVar::get() stay valid for at least that long.
+  static constexpr uint32_t k_retained_frames = 4;
+
+  // Increases by one with every publish.
+  [[nodiscard]] uint64_t generation() const { return generation_; }
+  [[nodiscard]] int32_t get(const AutoCVarInt& cv) const { return ints_[cv.index()]; }
+  [[nodiscard]] float get(const AutoCVarFloat& cv) const { return floats_[cv.index()]; }
+  [[nodiscard]] const std::string& get(const AutoCVarString& cv) const {
+    return strings_[cv.index()];
+  }
+
+ private:
+  friend class CVarSystemImpl;
+
+  uint64_t generation_{};
+  std::vector<int32_t> ints_;
+  std::vector<float> floats_;
+  std::vector<std::string> strings_;
+};
+
 class Console;
 void register_cvar_console(Console& console);
 
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "core/Config.hpp"
+
+namespace TENG_NAMESPACE {
+
+// Writes to entries of an array, queued on the CPU and flushed as one copy per run of adjacent
+// entries. Among writes to the same entry, the last one queued wins.
+template <typename T>
+class CoalescedWrites {
+ public:
+  void write(uint32_t index, const T& value) { pending_.emplace_back(index, value); }
+
+  [[nodiscard]] bool empty() const { return pending_.empty(); }
+  [[nodiscard]] size_t pending_count() const { return pending_.size(); }
+
+  // Calls `emit(first_index, std::span<const T>)` once per run, in ascending index order, then
+  // clears the queue.
+  template <typename EmitFn>
+  void flush(EmitFn&& emit) {
+    if (pending_.empty()) {
+      return;
+    }
+    // Stable so that, among writes to the same entry, the last one queued sorts last.
+    std::ranges::stable_sort(pending_, {}, [](const auto& write) { return write.first; });
+    uint32_t run_first = pending_.front().first;
+    for (size_t i = 0; i < pending_.size(); i++) {
+      const auto& [index, value] = pending_[i];
+      if (i + 1 < pending_.size() && pending_[i + 1].first == index) {
+        continue;
+      }
+      if (run_first + run_.size() != index) {
+        emit(run_first, std::span<const T>(run_));
+        run_.clear();
+        run_first = index;
+      }
+      run_.push_back(value);
+    }
+    emit(run_first, std::span<const T>(run_));
+    run_.clear();
+    pending_.clear();
+  }
+
+ private:
+  std::vector<std::pair<uint32_t, T>> pending_;
+  // Staging for the run being built; kept to avoid reallocating per flush.
+  std::vector<T> run_;
+};
+
+}  // namespace TENG_NAMESPACE
@@ -13,6 +13,9 @@ namespace TENG_NAMESPACE {
 
 #define ALL_ASSERTS_ENABLED 1
 
+// Defined in core/Logger.cpp: writes out queued log messages before the process aborts.
+void flush_logs();
+
 #ifndef NDEBUG
 #ifndef ALL_ASSERTS_ENABLED
 #define ALL_ASSERTS_ENABLED 1
@@ -22,11 +25,13 @@ namespace TENG_NAMESPACE {
 class AlwaysAssert {
  public:
   static void fail(const char* expr, const char* file, int line) {
+    flush_logs();
     std::println(stderr, "Assertion failed: ({}), file {}, line {}", expr, file, line);
     std::abort();
   }
 
   static void fail(const char* expr, const char* file, int line, const char* msg) {
+    flush_logs();
     std::println(stderr, "Assertion failed: ({}), file {}, line {}: {}", expr, file, line, msg);
     std::abort();
   }
@@ -37,6 +42,7 @@ class AlwaysAssert {
                    int line,
                    std::format_string<Args...> fmt,
                    Args&&... args) {
+    flush_logs();
     std::print(stderr, "Assertion failed: ({}), file {}, line {}: ", expr, file, line);
     std::println(stderr, fmt, std::forward<Args>(args)...);
     std::abort();
@@ -1,22 +1,19 @@
 #include "FileUtil.hpp"
 
-#include <fstream>
 #include <print>
-#include <sstream>
 
 #include "core/Config.hpp"
+#include "core/MappedFile.hpp"
 
 namespace TENG_NAMESPACE {
 
 std::string util::load_file_to_string(const std::filesystem::path& path) {
-  std::ifstream file(path);
-  if (!file.is_open()) {
+  Result<MappedFile> file = MappedFile::open(path);
+  if (!file) {
     std::println("File not found or cannot be opened at path {}", path.string());
     return "";
   }
-  std::ostringstream ss;
-  ss << file.rdbuf();
-  return ss.str();
+  return std::string{file->text()};
 }
 
 }  // namespace TENG_NAMESPACE
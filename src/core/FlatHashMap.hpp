@@ -0,0 +1,490 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "core/Config.hpp"
+#include "core/EAssert.hpp"
+#include "core/Hash.hpp"
+
+namespace TENG_NAMESPACE {
+
+namespace flat_hash_detail {
+
+// Control byte per slot: 0..127 holds the low 7 bits of a full slot's hash, the rest mark empty
+// and deleted (tombstone) slots. Groups of 8 control bytes are matched at once with SWAR on a
+// 64-bit word, so a probe touches one cache line of metadata before it compares any key.
+using Ctrl = int8_t;
+inline constexpr Ctrl k_empty = -128;
+inline constexpr Ctrl k_deleted = -2;
+inline constexpr size_t k_group_width = 8;
+inline constexpr uint64_t k_lsbs = 0x0101010101010101ull;
+inline constexpr uint64_t k_msbs = 0x8080808080808080ull;
+
+inline uint64_t load_group(const Ctrl* ctrl) {
+  static_assert(std::endian::native == std::endian::little);
+  uint64_t group;
+  std::memcpy(&group, ctrl, sizeof(group));
+  return group;
+}
+
+// One bit (the byte's msb) per matching byte. May report false positives in bytes that follow
+// a true match; callers always confirm with a key compare.
+inline uint64_t match_h2(uint64_t group, uint8_t h2) {
+  const uint64_t x = group ^ (k_lsbs * h2);
+  return (x - k_lsbs) & ~x & k_msbs;
+}
+inline uint64_t match_empty(uint64_t group) { return group & ~(group << 6) & k_msbs; }
+inline uint64_t match_empty_or_deleted(uint64_t group) { return group & ~(group << 7) & k_msbs; }
+inline size_t lowest_match(uint64_t mask) {
+  return static_cast<size_t>(std::countr_zero(mask)) / 8;
+}
+
+// Triangular probing over groups; visits every group once when the capacity is a power of two.
+struct ProbeSeq {
+  size_t pos;
+  size_t mask;
+  size_t stride{};
+  void next() {
+    stride += k_group_width;
+    pos = (pos + stride) & mask;
+  }
+};
+
+template <typename K, typename V>
+struct MapPolicy {
+  using key_type = K;
+  using value_type = std::pair<const K, V>;
+  static constexpr bool k_const_iteration = false;
+  static const K& key(const value_type& v) { return v.first; }
+  template <typename KArg, typename... Args>
+  static void construct(value_type* p, KArg&& key, Args&&... args) {
+    ::new (static_cast<void*>(p))
+        value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<KArg>(key)),
+                   std::forward_as_tuple(std::forward<Args>(args)...));
+  }
+};
+
+template <typename K>
+struct SetPolicy {
+  using key_type = K;
+  using value_type = K;
+  static constexpr bool k_const_iteration = true;
+  static const K& key(const value_type& v) { return v; }
+  template <typename KArg>
+  static void construct(value_type* p, KArg&& key) {
+    ::new (static_cast<void*>(p)) value_type(std::forward<KArg>(key));
+  }
+};
+
+// Open-addressing table shared by FlatHashMap and FlatHashSet. Capacity is 0 or a power of two
+// of at least one group, with a 7/8 maximum load. The first group of control bytes is mirrored
+// past the end so a group load starting near the end never wraps.
+template <typename Policy, typename Hash, typename Eq>
+class FlatHashTable {
+ public:
+  using key_type = typename Policy::key_type;
+  using value_type = typename Policy::value_type;
+  using size_type = size_t;
+  using hasher = Hash;
+  using key_equal = Eq;
+
+  template <bool Const>
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename Policy::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<Const, const value_type&, value_type&>;
+    using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+    Iterator() = default;
+    // NOLINTNEXTLINE(google-explicit-constructor): iterator -> const_iterator.
+    template <bool OtherConst>
+      requires(Const && !OtherConst)
+    Iterator(const Iterator<OtherConst>& other)
+        : ctrl_(other.ctrl_), end_(other.end_), slot_(other.slot_) {}
+
+    reference operator*() const { return *slot_; }
+    pointer operator->() const { return slot_; }
+    Iterator& operator++() {
+      ++ctrl_;
+      ++slot_;
+      skip_free_();
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator tmp = *this;
+      ++*this;
+      return tmp;
+    }
+    friend bool operator==(const Iterator& a, const Iterator& b) { return a.ctrl_ == b.ctrl_; }
+
+   private:
+    friend class FlatHashTable;
+    template <bool>
+    friend class Iterator;
+
+    Iterator(const Ctrl* ctrl, const Ctrl* end, value_type* slot)
+        : ctrl_(ctrl), end_(end), slot_(slot) {}
+    void skip_free_() {
+      while (ctrl_ != end_ && *ctrl_ < 0) {
+        ++ctrl_;
+        ++slot_;
+      }
+    }
+
+    const Ctrl* ctrl_{};
+    const Ctrl* end_{};
+    value_type* slot_{};
+  };
+
+  using iterator = Iterator<Policy::k_const_iteration>;
+  using const_iterator = Iterator<true>;
+
+  FlatHashTable() = default;
+  explicit FlatHashTable(size_t reserve_count) { reserve(reserve_count); }
+  FlatHashTable(const FlatHashTable& other) : hash_(other.hash_), eq_(other.eq_) {
+    reserve(other.size_);
+    for (const value_type& v : other) {
+      insert_unique_(v);
+    }
+  }
+  FlatHashTable(FlatHashTable&& other) noexcept
+      : ctrl_(std::exchange(other.ctrl_, nullptr)),
+        slots_(std::exchange(other.slots_, nullptr)),
+        capacity_(std::exchange(other.capacity_, 0)),
+        size_(std::exchange(other.size_, 0)),
+        growth_left_(std::exchange(other.growth_left_, 0)),
+        hash_(std::move(other.hash_)),
+        eq_(std::move(other.eq_)) {}
+  FlatHashTable& operator=(FlatHashTable other) noexcept {
+    swap(other);
+    return *this;
+  }
+  ~FlatHashTable() { destroy_(); }
+
+  void swap(FlatHashTable& other) noexcept {
+    std::swap(ctrl_, other.ctrl_);
+    std::swap(slots_, other.slots_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(size_, other.size_);
+    std::swap(growth_left_, other.growth_left_);
+    std::swap(hash_, other.hash_);
+    std::swap(eq_, other.eq_);
+  }
+
+  iterator begin() {
+    iterator it{ctrl_, ctrl_ + capacity_, slots_};
+    it.skip_free_();
+    return it;
+  }
+  iterator end() { return iterator{ctrl_ + capacity_, ctrl_ + capacity_, nullptr}; }
+  const_iterator begin() const { return const_cast<FlatHashTable*>(this)->begin(); }
+  const_iterator end() const { return const_cast<FlatHashTable*>(this)->end(); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  [[nodiscard]] size_t size() const { return size_; }
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+  [[nodiscard]] size_t capacity() const { return capacity_; }
+
+  iterator find(const key_type& key) {
+    if (capacity_ == 0) {
+      return end();
+    }
+    const uint64_t h = hash_of_(key);
+    ProbeSeq seq{.pos = h1_(h) & (capacity_ - 1), .mask = capacity_ - 1};
+    while (true) {
+      const uint64_t group = load_group(ctrl_ + seq.pos);
+      for (uint64_t m = match_h2(group, h2_(h)); m != 0; m &= m - 1) {
+        const size_t i = (seq.pos + lowest_match(m)) & seq.mask;
+        if (eq_(Policy::key(slots_[i]), key)) [[likely]] {
+          return iterator_at_(i);
+        }
+      }
+      if (match_empty(group) != 0) [[likely]] {
+        return end();
+      }
+      seq.next();
+    }
+  }
+  const_iterator find(const key_type& key) const {
+    return const_cast<FlatHashTable*>(this)->find(key);
+  }
+  [[nodiscard]] bool contains(const key_type& key) const { return find(key) != end(); }
+  [[nodiscard]] size_t count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+  // Returns the iterator after `it`. Other iterators stay valid (only growth rehashes).
+  iterator erase(const_iterator it) {
+    const auto i = static_cast<size_t>(it.ctrl_ - ctrl_);
+    erase_at_(i);
+    iterator next = iterator_at_(i);
+    ++next;
+    return next;
+  }
+  iterator erase(iterator it)
+    requires(!Policy::k_const_iteration)
+  {
+    return erase(const_iterator{it});
+  }
+  size_t erase(const key_type& key) {
+    const iterator it = find(key);
+    if (it == end()) {
+      return 0;
+    }
+    erase_at_(static_cast<size_t>(it.ctrl_ - ctrl_));
+    return 1;
+  }
+
+  // Destroys every element but keeps the allocation, so per-frame tables do not reallocate.
+  void clear() {
+    if (capacity_ == 0) {
+      return;
+    }
+    if constexpr (!std::is_trivially_destructible_v<value_type>) {
+      for (size_t i = 0; i < capacity_; ++i) {
+        if (ctrl_[i] >= 0) {
+          slots_[i].~value_type();
+        }
+      }
+    }
+    std::memset(ctrl_, static_cast<uint8_t>(k_empty), capacity_ + k_group_width);
+    size_ = 0;
+    growth_left_ = max_load_(capacity_);
+  }
+
+  void reserve(size_t count) {
+    if (count > max_load_(capacity_)) {
+      rehash_(capacity_for_(count));
+    }
+  }
+
+ protected:
+  // Finds `key` or constructs a new element from (key, args...). Rehashing invalidates iterators
+  // and references; erasing does not.
+  template <typename KArg, typename... Args>
+  std::pair<iterator, bool> try_emplace_(KArg&& key, Args&&... args) {
+    if (const iterator it = find(key); it != end()) {
+      return {it, false};
+    }
+    const size_t i = prepare_insert_(hash_of_(key));
+    Policy::construct(slots_ + i, std::forward<KArg>(key), std::forward<Args>(args)...);
+    return {iterator_at_(i), true};
+  }
+
+ private:
+  static size_t max_load_(size_t capacity) { return capacity - (capacity / 8); }
+  static size_t capacity_for_(size_t count) {
+    size_t capacity = k_group_width;
+    while (max_load_(capacity) < count) {
+      capacity *= 2;
+    }
+    return capacity;
+  }
+
+  uint64_t hash_of_(const key_type& key) const {
+    if constexpr (util::hash::AvalanchingHash<Hash>) {
+      return static_cast<uint64_t>(hash_(key));
+    } else {
+      return util::hash::hash_u64(static_cast<uint64_t>(hash_(key)));
+    }
+  }
+  static size_t h1_(uint64_t h) { return static_cast<size_t>(h >> 7); }
+  static uint8_t h2_(uint64_t h) { return static_cast<uint8_t>(h & 0x7f); }
+
+  iterator iterator_at_(size_t i) { return iterator{ctrl_ + i, ctrl_ + capacity_, slots_ + i}; }
+
+  void set_ctrl_(size_t i, Ctrl c) {
+    ctrl_[i] = c;
+    if (i < k_group_width) {
+      ctrl_[capacity_ + i] = c;  // Mirrored first group.
+    }
+  }
+
+  size_t find_free_(uint64_t h) const {
+    ProbeSeq seq{.pos = h1_(h) & (capacity_ - 1), .mask = capacity_ - 1};
+    while (true) {
+      if (const uint64_t m = match_empty_or_deleted(load_group(ctrl_ + seq.pos)); m != 0) {
+        return (seq.pos + lowest_match(m)) & seq.mask;
+      }
+      seq.next();
+    }
+  }
+
+  // Returns a free slot for hash `h`, growing first when the table has no room. Reusing a
+  // tombstone does not consume growth.
+  size_t prepare_insert_(uint64_t h) {
+    size_t i = capacity_ == 0 ? 0 : find_free_(h);
+    if (growth_left_ == 0 && (capacity_ == 0 || ctrl_[i] != k_deleted)) {
+      // Mostly tombstones: rebuild at the same size instead of doubling.
+      const bool reclaim = capacity_ != 0 && size_ <= max_load_(capacity_) / 2;
+      rehash_(reclaim ? capacity_ : (capacity_ == 0 ? k_group_width : capacity_ * 2));
+      i = find_free_(h);
+    }
+    growth_left_ -= ctrl_[i] == k_empty ? 1 : 0;
+    set_ctrl_(i, static_cast<Ctrl>(h2_(h)));
+    ++size_;
+    return i;
+  }
+
+  void erase_at_(size_t i) {
+    ASSERT(i < capacity_ && ctrl_[i] >= 0);
+    slots_[i].~value_type();
+    --size_;
+    // A slot can go straight back to empty when no probe sequence can have passed over it
+    // while it was full: that needs an empty within one group on either side.
+    const size_t before = (i - k_group_width) & (capacity_ - 1);
+    const uint64_t empty_after = match_empty(load_group(ctrl_ + i));
+    const uint64_t empty_before = match_empty(load_group(ctrl_ + before));
+    const bool was_never_full =
+        empty_before != 0 && empty_after != 0 &&
+        static_cast<size_t>(std::countr_zero(empty_after) / 8) +
+                static_cast<size_t>(std::countl_zero(empty_before) / 8) <
+            k_group_width;
+    set_ctrl_(i, was_never_full ? k_empty : k_deleted);
+    growth_left_ += was_never_full ? 1 : 0;
+  }
+
+  void insert_unique_(const value_type& v) {
+    const size_t i = prepare_insert_(hash_of_(Policy::key(v)));
+    ::new (static_cast<void*>(slots_ + i)) value_type(v);
+  }
+
+  void rehash_(size_t new_capacity) {
+    ASSERT(std::has_single_bit(new_capacity) && new_capacity >= k_group_width);
+    Ctrl* old_ctrl = ctrl_;
+    value_type* old_slots = slots_;
+    const size_t old_capacity = capacity_;
+
+    ctrl_ = new Ctrl[new_capacity + k_group_width];
+    std::memset(ctrl_, static_cast<uint8_t>(k_empty), new_capacity + k_group_width);
+    slots_ = static_cast<value_type*>(::operator new(new_capacity * sizeof(value_type),
+                                                     std::align_val_t{alignof(value_type)}));
+    capacity_ = new_capacity;
+    growth_left_ = max_load_(new_capacity) - size_;
+
+    for (size_t j = 0; j < old_capacity; ++j) {
+      if (old_ctrl[j] < 0) {
+        continue;
+      }
+      const uint64_t h = hash_of_(Policy::key(old_slots[j]));
+      const size_t i = find_free_(h);
+      set_ctrl_(i, static_cast<Ctrl>(h2_(h)));
+      ::new (static_cast<void*>(slots_ + i)) value_type(std::move(old_slots[j]));
+      old_slots[j].~value_type();
+    }
+    if (old_capacity != 0) {
+      delete[] old_ctrl;
+      ::operator delete(old_slots, std::align_val_t{alignof(value_type)});
+    }
+  }
+
+  void destroy_() {
+    if (capacity_ == 0) {
+      return;
+    }
+    clear();
+    delete[] ctrl_;
+    ::operator delete(slots_, std::align_val_t{alignof(value_type)});
+    ctrl_ = nullptr;
+    slots_ = nullptr;
+    capacity_ = 0;
+    growth_left_ = 0;
+  }
+
+  Ctrl* ctrl_{};
+  value_type* slots_{};
+  size_t capacity_{};
+  size_t size_{};
+  size_t growth_left_{};
+  [[no_unique_address]] Hash hash_{};
+  [[no_unique_address]] Eq eq_{};
+};
+
+}  // namespace flat_hash_detail
+
+// Open-addressing hash map with inline storage (SwissTable-style control bytes, 8-wide SWAR
+// group probing). Much cheaper than std::unordered_map for the small, trivially copyable keys
+// used across the renderer: no node allocation per element and lookups touch contiguous memory.
+// Unlike std::unordered_map, inserting may move elements: references and iterators are
+// invalidated whenever an insertion grows the table (erase invalidates only the erased element).
+// Iteration order is unspecified and changes with capacity.
+template <typename K, typename V, typename Hash = util::hash::FastHash<K>,
+          typename Eq = std::equal_to<K>>
+class FlatHashMap
+    : public flat_hash_detail::FlatHashTable<flat_hash_detail::MapPolicy<K, V>, Hash, Eq> {
+  using Base = flat_hash_detail::FlatHashTable<flat_hash_detail::MapPolicy<K, V>, Hash, Eq>;
+
+ public:
+  using mapped_type = V;
+  using typename Base::iterator;
+  using Base::Base;
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+    return this->try_emplace_(key, std::forward<Args>(args)...);
+  }
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+    return this->try_emplace_(std::move(key), std::forward<Args>(args)...);
+  }
+  // (key, value) form only; does not overwrite an existing value.
+  template <typename KArg, typename VArg>
+  std::pair<iterator, bool> emplace(KArg&& key, VArg&& value) {
+    return this->try_emplace_(std::forward<KArg>(key), std::forward<VArg>(value));
+  }
+  std::pair<iterator, bool> insert(const std::pair<K, V>& kv) {
+    return this->try_emplace_(kv.first, kv.second);
+  }
+  template <typename VArg>
+  std::pair<iterator, bool> insert_or_assign(const K& key, VArg&& value) {
+    auto result = this->try_emplace_(key, std::forward<VArg>(value));
+    if (!result.second) {
+      result.first->second = std::forward<VArg>(value);
+    }
+    return result;
+  }
+
+  V& operator[](const K& key) { return this->try_emplace_(key).first->second; }
+  V& operator[](K&& key) { return this->try_emplace_(std::move(key)).first->second; }
+
+  V& at(const K& key) {
+    auto it = this->find(key);
+    ALWAYS_ASSERT(it != this->end());
+    return it->second;
+  }
+  const V& at(const K& key) const {
+    auto it = this->find(key);
+    ALWAYS_ASSERT(it != this->end());
+    return it->second;
+  }
+};
+
+// Set counterpart of FlatHashMap, with the same invalidation rules.
+template <typename K, typename Hash = util::hash::FastHash<K>, typename Eq = std::equal_to<K>>
+class FlatHashSet
+    : public flat_hash_detail::FlatHashTable<flat_hash_detail::SetPolicy<K>, Hash, Eq> {
+  using Base = flat_hash_detail::FlatHashTable<flat_hash_detail::SetPolicy<K>, Hash, Eq>;
+
+ public:
+  using typename Base::iterator;
+  using Base::Base;
+
+  std::pair<iterator, bool> insert(const K& key) { return this->try_emplace_(key); }
+  std::pair<iterator, bool> insert(K&& key) { return this->try_emplace_(std::move(key)); }
+  template <typename KArg>
+  std::pair<iterator, bool> emplace(KArg&& key) {
+    return this->try_emplace_(std::forward<KArg>(key));
+  }
+};
+
+}  // namespace TENG_NAMESPACE
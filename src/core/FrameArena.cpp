@@ -0,0 +1,79 @@
+#include "core/FrameArena.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "core/EAssert.hpp"
+#include "core/Profiler.hpp"
+#include "core/Util.hpp"
+
+namespace TENG_NAMESPACE {
+
+void LinearArena::reset() {
+  const size_t used = bytes_used();
+  high_water_ = std::max(high_water_, used);
+  if (!spilled_blocks_.empty()) {
+    spilled_blocks_.clear();
+    spilled_bytes_ = 0;
+    spilled_capacity_ = 0;
+    new_block_(std::bit_ceil(used));
+  }
+  offset_ = 0;
+}
+
+void LinearArena::reserve(size_t bytes) {
+  if (bytes > block_size_ && bytes_used() == 0) {
+    new_block_(bytes);
+  }
+}
+
+void* LinearArena::do_allocate(size_t bytes, size_t alignment) {
+  auto base = reinterpret_cast<uintptr_t>(block_.get());
+  size_t offset = align_up(base + offset_, alignment) - base;
+  if (!block_ || offset + bytes > block_size_) {
+    if (block_) {
+      spilled_bytes_ += offset_;
+      spilled_capacity_ += block_size_;
+      spilled_blocks_.emplace_back(std::move(block_));
+    }
+    new_block_(std::max(block_size_ * 2, bytes + alignment));
+    base = reinterpret_cast<uintptr_t>(block_.get());
+    offset = align_up(base, alignment) - base;
+  }
+  offset_ = offset + bytes;
+  return block_.get() + offset;
+}
+
+void LinearArena::new_block_(size_t min_bytes) {
+  block_size_ = align_up(std::max<size_t>(min_bytes, 4096), 64);
+  block_ = std::make_unique_for_overwrite<std::byte[]>(block_size_);
+  offset_ = 0;
+  heap_allocations_++;
+}
+
+FrameArena::FrameArena(uint32_t frame_count, size_t initial_bytes_per_frame)
+    : frame_count_(frame_count) {
+  ALWAYS_ASSERT(frame_count > 0 && frame_count <= k_max_frames);
+  for (uint32_t i = 0; i < frame_count_; i++) {
+    arenas_[i].reserve(initial_bytes_per_frame);
+  }
+}
+
+void FrameArena::begin_frame() {
+  ZoneScoped;
+  last_frame_bytes_ = arenas_[curr_].bytes_used();
+  curr_ = (curr_ + 1) % frame_count_;
+  arenas_[curr_].reset();
+}
+
+FrameArena::Stats FrameArena::get_stats() const {
+  Stats stats{.last_frame_bytes = last_frame_bytes_};
+  for (uint32_t i = 0; i < frame_count_; i++) {
+    stats.high_water_bytes = std::max(stats.high_water_bytes, arenas_[i].high_water());
+    stats.capacity_bytes += arenas_[i].capacity();
+    stats.heap_allocations += arenas_[i].heap_allocations();
+  }
+  return stats;
+}
+
+}  // namespace TENG_NAMESPACE
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#include "core/Config.hpp"
+
+namespace TENG_NAMESPACE {
+
+// Bump allocator exposed as a std::pmr::memory_resource. deallocate() is a no-op; reset() rewinds
+// everything at once. When a frame outgrows the current block, overflow blocks are chained on;
+// the next reset() replaces them with one block big enough for that frame, so a steady workload
+// settles on a single block and stops touching the heap. Not thread-safe.
+class LinearArena final : public std::pmr::memory_resource {
+ public:
+  LinearArena() = default;
+  explicit LinearArena(size_t initial_bytes) { reserve(initial_bytes); }
+  LinearArena(const LinearArena&) = delete;
+  LinearArena& operator=(const LinearArena&) = delete;
+  ~LinearArena() override = default;
+
+  // Invalidates every allocation made since the previous reset.
+  void reset();
+  // Grows the current block to at least `bytes` if nothing has been allocated from it yet.
+  void reserve(size_t bytes);
+
+  // Bytes handed out since the last reset, including alignment padding.
+  [[nodiscard]] size_t bytes_used() const { return spilled_bytes_ + offset_; }
+  [[nodiscard]] size_t capacity() const { return block_size_ + spilled_capacity_; }
+  // Largest bytes_used() of any frame so far, the current one included.
+  [[nodiscard]] size_t high_water() const { return std::max(high_water_, bytes_used()); }
+  // Blocks requested from the upstream heap over the arena's lifetime.
+  [[nodiscard]] uint64_t heap_allocations() const { return heap_allocations_; }
+
+ private:
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void*, size_t, size_t) override {}
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  void new_block_(size_t min_bytes);
+
+  std::unique_ptr<std::byte[]> block_;
+  size_t block_size_{};
+  size_t offset_{};
+  // Full blocks of the current frame, freed (and folded into one block) on reset.
+  std::vector<std::unique_ptr<std::byte[]>> spilled_blocks_;
+  size_t spilled_bytes_{};
+  size_t spilled_capacity_{};
+  size_t high_water_{};
+  uint64_t heap_allocations_{};
+};
+
+// Ring of LinearArenas for CPU temporaries that live for one frame. begin_frame() moves to the
+// next arena and rewinds it, so memory from the previous frame_count - 1 frames stays valid
+// (e.g. a RenderScene extracted last frame while this frame is built).
+class FrameArena {
+ public:
+  static constexpr uint32_t k_max_frames = 3;
+
+  struct Stats {
+    // Bytes the most recently finished frame used.
+    size_t last_frame_bytes{};
+    size_t high_water_bytes{};
+    size_t capacity_bytes{};
+    uint64_t heap_allocations{};
+  };
+
+  explicit FrameArena(uint32_t frame_count = 2, size_t initial_bytes_per_frame = 256 * 1024);
+
+  void begin_frame();
+
+  [[nodiscard]] std::pmr::memory_resource* resource() { return &arenas_[curr_]; }
+  [[nodiscard]] uint32_t curr_slot() const { return curr_; }
+  [[nodiscard]] uint32_t frame_count() const { return frame_count_; }
+  [[nodiscard]] Stats get_stats() const;
+
+ private:
+  std::array<LinearArena, k_max_frames> arenas_;
+  uint32_t frame_count_{};
+  uint32_t curr_{};
+  size_t last_frame_bytes_{};
+};
+
+}  // namespace TENG_NAMESPACE
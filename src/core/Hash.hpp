@@ -1,11 +1,19 @@
 #pragma once
+#include <bit>
 #include <cstdint>
+#include <cstring>
 #include <functional>
+#include <string>
 #include <string_view>
 #include <tuple>
+#include <type_traits>
 
 #include "core/Config.hpp"
 
+#if defined(_MSC_VER) && !defined(__SIZEOF_INT128__)
+#include <intrin.h>
+#endif
+
 namespace TENG_NAMESPACE {
 
 // src: https://github.com/JuanDiegoMontoya/Frogfood/blob/main/src/Fvog/detail/Hash2.h
@@ -83,6 +91,154 @@ struct HashedString {
   // NOLINTEND(google-explicit-constructor)
 };
 
+// Fast 64-bit hashing (wyhash-style multiply-fold) for in-memory tables. Values are not stable
+// across builds or platforms: never persist them or use them as content ids.
+
+inline constexpr uint64_t k_wy_p0 = 0xa0761d6478bd642full;
+inline constexpr uint64_t k_wy_p1 = 0xe7037ed1a0b428dbull;
+inline constexpr uint64_t k_wy_p2 = 0x8ebc6af09c88c6e3ull;
+inline constexpr uint64_t k_wy_p3 = 0x589965cc75374cc3ull;
+
+// 64x64 -> 128-bit multiply. GCC and Clang use the __int128 extension (spelled through
+// __extension__ so -pedantic-errors accepts it), MSVC x64 uses _umul128 outside constant
+// evaluation, and everything else splits into 32-bit halves.
+constexpr void mul128(uint64_t a, uint64_t b, uint64_t& lo, uint64_t& hi) {
+#ifdef __SIZEOF_INT128__
+  __extension__ using u128 = unsigned __int128;
+  const u128 r = static_cast<u128>(a) * b;
+  lo = static_cast<uint64_t>(r);
+  hi = static_cast<uint64_t>(r >> 64);
+#else
+#if defined(_MSC_VER) && defined(_M_X64)
+  if !consteval {
+    lo = _umul128(a, b, &hi);
+    return;
+  }
+#endif
+  const uint64_t a_lo = a & 0xffffffffull;
+  const uint64_t a_hi = a >> 32;
+  const uint64_t b_lo = b & 0xffffffffull;
+  const uint64_t b_hi = b >> 32;
+  const uint64_t ll = a_lo * b_lo;
+  const uint64_t lh = a_lo * b_hi;
+  const uint64_t hl = a_hi * b_lo;
+  const uint64_t mid = (ll >> 32) + (lh & 0xffffffffull) + (hl & 0xffffffffull);
+  lo = (mid << 32) | (ll & 0xffffffffull);
+  hi = a_hi * b_hi + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+// 64x64 -> 128-bit multiply, folded by xor.
+[[nodiscard]] constexpr uint64_t hash_mix(uint64_t a, uint64_t b) {
+  uint64_t lo = 0;
+  uint64_t hi = 0;
+  mul128(a, b, lo, hi);
+  return lo ^ hi;
+}
+
+[[nodiscard]] constexpr uint64_t hash_u64(uint64_t v) { return hash_mix(v ^ k_wy_p0, k_wy_p1); }
+
+// Order-dependent, unlike xor: combining a then b differs from combining b then a.
+[[nodiscard]] constexpr uint64_t hash_combine64(uint64_t seed, uint64_t v) {
+  return hash_mix(seed ^ k_wy_p0, v ^ k_wy_p1);
+}
+
+namespace detail {
+
+inline uint64_t read_u64(const unsigned char* p) {
+  uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+inline uint64_t read_u32(const unsigned char* p) {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+}  // namespace detail
+
+[[nodiscard]] inline uint64_t hash_bytes(const void* data, size_t len, uint64_t seed = 0) {
+  static_assert(std::endian::native == std::endian::little);
+  using detail::read_u32;
+  using detail::read_u64;
+  const auto* p = static_cast<const unsigned char*>(data);
+  seed ^= hash_mix(seed ^ k_wy_p0, k_wy_p1);
+  uint64_t a = 0;
+  uint64_t b = 0;
+  if (len <= 16) {
+    if (len >= 4) {
+      const size_t mid = (len >> 3) << 2;
+      a = (read_u32(p) << 32) | read_u32(p + mid);
+      b = (read_u32(p + len - 4) << 32) | read_u32(p + len - 4 - mid);
+    } else if (len > 0) {
+      a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[len >> 1]) << 8) |
+          p[len - 1];
+    }
+  } else {
+    size_t i = len;
+    if (i > 48) {
+      uint64_t see1 = seed;
+      uint64_t see2 = seed;
+      do {
+        seed = hash_mix(read_u64(p) ^ k_wy_p1, read_u64(p + 8) ^ seed);
+        see1 = hash_mix(read_u64(p + 16) ^ k_wy_p2, read_u64(p + 24) ^ see1);
+        see2 = hash_mix(read_u64(p + 32) ^ k_wy_p3, read_u64(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16) {
+      seed = hash_mix(read_u64(p) ^ k_wy_p1, read_u64(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    a = read_u64(p + i - 16);
+    b = read_u64(p + i - 8);
+  }
+  a ^= k_wy_p1;
+  b ^= seed;
+  mul128(a, b, a, b);
+  return hash_mix(a ^ k_wy_p0 ^ len, b ^ k_wy_p1);
+}
+
+// Hash functors that already spread entropy over all 64 bits declare `is_avalanching`, so
+// FlatHashMap skips its own finalizing mix.
+template <typename Hash>
+concept AvalanchingHash = requires { typename Hash::is_avalanching; };
+
+// Default hasher for flat tables. Integers, enums and pointers are mixed directly, strings hashed
+// with hash_bytes (transparently across std::string / std::string_view / const char*); any
+// other key falls back to std::hash followed by a mix, so identity std::hash specializations
+// (e.g. over uint64_t ids) still spread across buckets.
+template <typename T>
+struct FastHash {
+  using is_avalanching = void;
+  [[nodiscard]] uint64_t operator()(const T& v) const noexcept {
+    if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+      return hash_u64(static_cast<uint64_t>(v));
+    } else if constexpr (std::is_pointer_v<T>) {
+      return hash_u64(reinterpret_cast<uintptr_t>(v));
+    } else {
+      return hash_u64(static_cast<uint64_t>(std::hash<T>{}(v)));
+    }
+  }
+};
+
+struct StringFastHash {
+  using is_avalanching = void;
+  using is_transparent = void;
+  [[nodiscard]] uint64_t operator()(std::string_view s) const noexcept {
+    return hash_bytes(s.data(), s.size());
+  }
+};
+
+template <>
+struct FastHash<std::string> : StringFastHash {};
+template <>
+struct FastHash<std::string_view> : StringFastHash {};
+
 }  // namespace util::hash
 
 }  // namespace TENG_NAMESPACE
@@ -0,0 +1,560 @@
+#include "IoService.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <utility>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define TENG_HAS_IO_URING 1
+#else
+#define TENG_HAS_IO_URING 0
+#endif
+
+#include "core/EAssert.hpp"
+#include "core/JobSystem.hpp"
+#include "core/Logger.hpp"
+#include "core/Profiler.hpp"
+
+namespace TENG_NAMESPACE {
+
+namespace io_detail {
+
+struct RequestState {
+  std::filesystem::path path;
+  JobCounter* counter{};
+  IoBuffer buffer;
+  std::string error;
+  bool taken{};
+  std::atomic<bool> done{false};
+#if TENG_HAS_IO_URING
+  int fd{-1};
+  size_t offset{};  // Bytes read so far.
+  iovec iov{};
+#endif
+};
+
+}  // namespace io_detail
+
+namespace {
+
+using io_detail::RequestState;
+
+void complete(RequestState& req, std::string error = {}) {
+#if TENG_HAS_IO_URING
+  if (req.fd >= 0) {
+    ::close(req.fd);
+    req.fd = -1;
+  }
+#endif
+  if (!error.empty()) {
+    req.buffer = {};
+    req.error = std::move(error);
+  }
+  // The waiter may release the counter as soon as it drains; read it first.
+  JobCounter* counter = req.counter;
+  req.done.store(true, std::memory_order_release);
+  req.done.notify_all();
+  if (counter) {
+    counter->release();
+  }
+}
+
+std::string io_error(const std::filesystem::path& path, std::string_view action) {
+  return "failed to " + std::string(action) + " " + path.string();
+}
+
+void read_blocking(RequestState& req) {
+  std::ifstream in(req.path, std::ios::binary | std::ios::ate);
+  if (!in) {
+    complete(req, io_error(req.path, "open"));
+    return;
+  }
+  const std::streamsize size = in.tellg();
+  if (size < 0) {
+    complete(req, io_error(req.path, "stat"));
+    return;
+  }
+  req.buffer.data = std::make_unique_for_overwrite<std::byte[]>(static_cast<size_t>(size));
+  req.buffer.size = static_cast<size_t>(size);
+  in.seekg(0);
+  if (!in.read(reinterpret_cast<char*>(req.buffer.data.get()), size)) {
+    complete(req, io_error(req.path, "read"));
+    return;
+  }
+  complete(req);
+}
+
+}  // namespace
+
+bool IoRequest::done() const {
+  ASSERT(state_);
+  return state_->done.load(std::memory_order_acquire);
+}
+
+const std::filesystem::path& IoRequest::path() const {
+  ASSERT(state_);
+  return state_->path;
+}
+
+void IoRequest::wait() const {
+  ASSERT(state_);
+  while (!state_->done.load(std::memory_order_acquire)) {
+    state_->done.wait(false, std::memory_order_acquire);
+  }
+}
+
+Result<IoBuffer> IoRequest::take() {
+  wait();
+  if (!state_->error.empty()) {
+    return make_unexpected(state_->error);
+  }
+  if (std::exchange(state_->taken, true)) {
+    return make_unexpected("read of " + state_->path.string() + " was already taken");
+  }
+  return std::move(state_->buffer);
+}
+
+#if TENG_HAS_IO_URING
+
+// Minimal io_uring driver over the raw syscalls: one submission and one completion ring, owned by
+// the I/O thread. An eventfd poll is kept armed so other threads can wake it while it waits for
+// completions.
+struct IoService::Ring {
+  static constexpr uint64_t k_wake_tag = ~0ull;
+
+  int fd{-1};
+  int event_fd{-1};
+  uint32_t entries{};
+  void* sq_ring{};
+  size_t sq_ring_bytes{};
+  void* cq_ring{};
+  size_t cq_ring_bytes{};
+  io_uring_sqe* sqes{};
+  size_t sqes_bytes{};
+  uint32_t* sq_head{};
+  uint32_t* sq_tail{};
+  uint32_t sq_mask{};
+  uint32_t* sq_array{};
+  uint32_t* cq_head{};
+  uint32_t* cq_tail{};
+  uint32_t cq_mask{};
+  io_uring_cqe* cqes{};
+  // Tail as written by us; published to the kernel in enter().
+  uint32_t local_tail{};
+
+  static std::unique_ptr<Ring> create(uint32_t depth) {
+    io_uring_params params{};
+    const auto ring_fd = static_cast<int>(::syscall(__NR_io_uring_setup, depth, &params));
+    if (ring_fd < 0) {
+      return nullptr;
+    }
+    auto ring = std::make_unique<Ring>();
+    ring->fd = ring_fd;
+    ring->entries = params.sq_entries;
+    ring->sq_ring_bytes = params.sq_off.array + (params.sq_entries * sizeof(uint32_t));
+    ring->cq_ring_bytes = params.cq_off.cqes + (params.cq_entries * sizeof(io_uring_cqe));
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      ring->sq_ring_bytes = ring->cq_ring_bytes =
+          std::max(ring->sq_ring_bytes, ring->cq_ring_bytes);
+    }
+    ring->sq_ring = ::mmap(nullptr, ring->sq_ring_bytes, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ring == MAP_FAILED) {
+      ring->sq_ring = nullptr;
+      return nullptr;
+    }
+    if (single_mmap) {
+      ring->cq_ring = ring->sq_ring;
+    } else {
+      ring->cq_ring = ::mmap(nullptr, ring->cq_ring_bytes, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+      if (ring->cq_ring == MAP_FAILED) {
+        ring->cq_ring = nullptr;
+        return nullptr;
+      }
+    }
+    ring->sqes_bytes = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, ring->sqes_bytes, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+      return nullptr;
+    }
+    ring->sqes = static_cast<io_uring_sqe*>(sqes);
+    ring->event_fd = ::eventfd(0, EFD_CLOEXEC);
+    if (ring->event_fd < 0) {
+      return nullptr;
+    }
+
+    auto* sq = static_cast<std::byte*>(ring->sq_ring);
+    auto* cq = static_cast<std::byte*>(ring->cq_ring);
+    ring->sq_head = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+    ring->sq_tail = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+    ring->sq_mask = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+    ring->sq_array = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+    ring->cq_head = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+    ring->cq_tail = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+    ring->cq_mask = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    ring->local_tail = *ring->sq_tail;
+    return ring;
+  }
+
+  Ring() = default;
+  Ring(const Ring&) = delete;
+  Ring& operator=(const Ring&) = delete;
+  ~Ring() {
+    if (sqes) {
+      ::munmap(sqes, sqes_bytes);
+    }
+    if (cq_ring && cq_ring != sq_ring) {
+      ::munmap(cq_ring, cq_ring_bytes);
+    }
+    if (sq_ring) {
+      ::munmap(sq_ring, sq_ring_bytes);
+    }
+    if (event_fd >= 0) {
+      ::close(event_fd);
+    }
+    if (fd >= 0) {
+      ::close(fd);
+    }
+  }
+
+  // Callers keep at most `entries` operations outstanding, so a slot is always free.
+  io_uring_sqe& next_sqe() {
+    const uint32_t idx = local_tail & sq_mask;
+    sq_array[idx] = idx;
+    ++local_tail;
+    io_uring_sqe& sqe = sqes[idx];
+    std::memset(&sqe, 0, sizeof(sqe));
+    return sqe;
+  }
+
+  void prep_read(RequestState& req, uint64_t tag) {
+    // Single reads are capped by the kernel anyway; short reads are resubmitted.
+    constexpr size_t k_max_read = size_t{1} << 30;
+    req.iov.iov_base = req.buffer.data.get() + req.offset;
+    req.iov.iov_len = std::min(req.buffer.size - req.offset, k_max_read);
+    io_uring_sqe& sqe = next_sqe();
+    sqe.opcode = IORING_OP_READV;
+    sqe.fd = req.fd;
+    sqe.addr = reinterpret_cast<uint64_t>(&req.iov);
+    sqe.len = 1;
+    sqe.off = req.offset;
+    sqe.user_data = tag;
+  }
+
+  void prep_wake_poll() {
+    io_uring_sqe& sqe = next_sqe();
+    sqe.opcode = IORING_OP_POLL_ADD;
+    sqe.fd = event_fd;
+    sqe.poll_events = POLLIN;
+    sqe.user_data = k_wake_tag;
+  }
+
+  void wake() const {
+    const uint64_t one = 1;
+    [[maybe_unused]] const ssize_t written = ::write(event_fd, &one, sizeof(one));
+  }
+
+  // Publishes queued SQEs and blocks until at least one completion is available. Returns 0, or
+  // the errno of a failure that retrying cannot fix.
+  [[nodiscard]] int submit_and_wait() {
+    const uint32_t published = std::atomic_ref(*sq_tail).load(std::memory_order_relaxed);
+    std::atomic_ref(*sq_tail).store(local_tail, std::memory_order_release);
+    uint32_t to_submit = local_tail - published;
+    while (true) {
+      const auto ret = ::syscall(__NR_io_uring_enter, fd, to_submit, 1, IORING_ENTER_GETEVENTS,
+                                 nullptr, 0);
+      if (ret >= 0) {
+        to_submit -= std::min(to_submit, static_cast<uint32_t>(ret));
+        if (to_submit == 0) {
+          return 0;
+        }
+        continue;
+      }
+      if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+        return errno;
+      }
+    }
+  }
+
+  template <typename F>
+  void for_each_completion(F&& fn) {
+    uint32_t head = std::atomic_ref(*cq_head).load(std::memory_order_relaxed);
+    const uint32_t tail = std::atomic_ref(*cq_tail).load(std::memory_order_acquire);
+    for (; head != tail; ++head) {
+      const io_uring_cqe cqe = cqes[head & cq_mask];
+      std::atomic_ref(*cq_head).store(head + 1, std::memory_order_release);
+      fn(cqe);
+    }
+  }
+};
+
+#else
+
+struct IoService::Ring {
+  void wake() const {}
+};
+
+#endif
+
+IoService& IoService::get() {
+  static IoService service{CreateInfo{}};
+  return service;
+}
+
+IoService::IoService(const CreateInfo& cinfo)
+    : fallback_threads_(std::max(1u, cinfo.fallback_threads)) {
+  ASSERT(cinfo.queue_depth >= 2);
+#if TENG_HAS_IO_URING
+  if (!cinfo.force_thread_pool) {
+    ring_ = Ring::create(cinfo.queue_depth);
+    if (ring_) {
+      backend_ = Backend::IoUring;
+      threads_.emplace_back([this] { uring_loop_(); });
+      return;
+    }
+    LINFO("io_uring unavailable, using blocking reads on a thread pool");
+  }
+#endif
+  backend_ = Backend::ThreadPool;
+  for (uint32_t i = 0; i < fallback_threads_; ++i) {
+    threads_.emplace_back([this, i] {
+      Profiler::set_thread_name(std::format("io worker {}", i));
+      pool_loop_();
+    });
+  }
+}
+
+IoService::~IoService() {
+  {
+    std::scoped_lock lock(mtx_);
+    stop_ = true;
+    if (ring_) {
+      ring_->wake();
+    }
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+IoRequest IoService::read(const std::filesystem::path& path, JobCounter* counter) {
+  auto state = std::make_shared<RequestState>();
+  state->path = path;
+  state->counter = counter;
+  enqueue_(std::span(&state, 1));
+  return IoRequest{std::move(state)};
+}
+
+std::vector<IoRequest> IoService::read_batch(std::span<const std::filesystem::path> paths,
+                                             JobCounter* counter) {
+  std::vector<StatePtr> states;
+  states.reserve(paths.size());
+  for (const auto& path : paths) {
+    auto& state = states.emplace_back(std::make_shared<RequestState>());
+    state->path = path;
+    state->counter = counter;
+  }
+  enqueue_(states);
+  std::vector<IoRequest> requests;
+  requests.reserve(states.size());
+  for (auto& state : states) {
+    requests.push_back(IoRequest{std::move(state)});
+  }
+  return requests;
+}
+
+void IoService::enqueue_(std::span<const StatePtr> states) {
+  if (states.empty()) {
+    return;
+  }
+  for (const StatePtr& state : states) {
+    if (state->counter) {
+      state->counter->add();
+    }
+  }
+  {
+    std::scoped_lock lock(mtx_);
+    ASSERT(!stop_);
+    pending_.insert(pending_.end(), states.begin(), states.end());
+    if (ring_) {
+      ring_->wake();
+      return;
+    }
+  }
+  if (states.size() == 1) {
+    cv_.notify_one();
+  } else {
+    cv_.notify_all();
+  }
+}
+
+void IoService::pool_loop_() {
+  while (true) {
+    StatePtr req;
+    {
+      std::unique_lock lock(mtx_);
+      cv_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+      if (pending_.empty()) {
+        return;
+      }
+      req = std::move(pending_.front());
+      pending_.pop_front();
+    }
+    ZoneScopedN("io read");
+    read_blocking(*req);
+  }
+}
+
+#if TENG_HAS_IO_URING
+
+void IoService::uring_loop_() {
+  Profiler::set_thread_name("io uring");
+  Ring& ring = *ring_;
+  // In-flight reads by slot; the slot index is the SQE user_data. One ring entry is reserved
+  // for the wakeup poll.
+  std::vector<StatePtr> slots(ring.entries - 1);
+  std::vector<uint64_t> free_slots;
+  for (uint64_t i = slots.size(); i-- > 0;) {
+    free_slots.push_back(i);
+  }
+  std::vector<StatePtr> incoming;
+  bool poll_armed = false;
+  while (true) {
+    if (!poll_armed) {
+      ring.prep_wake_poll();
+      poll_armed = true;
+    }
+    incoming.clear();
+    {
+      std::scoped_lock lock(mtx_);
+      if (stop_ && pending_.empty() && free_slots.size() == slots.size()) {
+        break;
+      }
+      while (!pending_.empty() && incoming.size() < free_slots.size()) {
+        incoming.push_back(std::move(pending_.front()));
+        pending_.pop_front();
+      }
+    }
+    for (StatePtr& req : incoming) {
+      req->fd = ::open(req->path.c_str(), O_RDONLY | O_CLOEXEC);
+      if (req->fd < 0) {
+        complete(*req, io_error(req->path, "open"));
+        continue;
+      }
+      struct stat st{};
+      if (::fstat(req->fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        complete(*req, io_error(req->path, "stat"));
+        continue;
+      }
+      req->buffer.size = static_cast<size_t>(st.st_size);
+      if (req->buffer.size == 0) {
+        complete(*req);
+        continue;
+      }
+      req->buffer.data = std::make_unique_for_overwrite<std::byte[]>(req->buffer.size);
+      const uint64_t slot = free_slots.back();
+      free_slots.pop_back();
+      ring.prep_read(*req, slot);
+      slots[slot] = std::move(req);
+    }
+
+    if (const int err = ring.submit_and_wait(); err != 0) {
+      fall_back_to_thread_pool_(slots, err);
+      pool_loop_();
+      return;
+    }
+
+    ring.for_each_completion([&](const io_uring_cqe& cqe) {
+      if (cqe.user_data == Ring::k_wake_tag) {
+        uint64_t value{};
+        [[maybe_unused]] const ssize_t n = ::read(ring.event_fd, &value, sizeof(value));
+        poll_armed = false;
+        return;
+      }
+      StatePtr& req = slots[cqe.user_data];
+      if (cqe.res == -EINTR || cqe.res == -EAGAIN) {
+        ring.prep_read(*req, cqe.user_data);
+        return;
+      }
+      if (cqe.res < 0) {
+        complete(*req, std::format("failed to read {}: {}", req->path.string(),
+                                   std::strerror(-cqe.res)));
+      } else if (cqe.res == 0) {
+        complete(*req, std::format("failed to read {}: file shrank while reading",
+                                   req->path.string()));
+      } else {
+        req->offset += static_cast<size_t>(cqe.res);
+        if (req->offset < req->buffer.size) {
+          ring.prep_read(*req, cqe.user_data);
+          return;
+        }
+        complete(*req);
+      }
+      req.reset();
+      free_slots.push_back(cqe.user_data);
+    });
+  }
+}
+
+void IoService::fall_back_to_thread_pool_(std::vector<StatePtr>& in_flight, int err) {
+  LERROR("io_uring_enter failed: {}; falling back to blocking reads", std::strerror(err));
+  const auto fail = [this, err](RequestState& req) {
+    if (req.buffer.data) {
+      orphaned_buffers_.push_back(std::move(req.buffer.data));
+    }
+    complete(req, std::format("failed to read {}: io_uring_enter failed: {}", req.path.string(),
+                              std::strerror(err)));
+  };
+  std::unique_ptr<Ring> ring;
+  std::deque<StatePtr> queued;
+  {
+    std::scoped_lock lock(mtx_);
+    ring = std::move(ring_);
+    queued.swap(pending_);
+    backend_ = Backend::ThreadPool;
+    // This thread is one worker; add the rest unless the service is already shutting down.
+    for (uint32_t i = 1; i < fallback_threads_ && !stop_; ++i) {
+      threads_.emplace_back([this, i] {
+        Profiler::set_thread_name(std::format("io worker {}", i));
+        pool_loop_();
+      });
+    }
+  }
+  for (StatePtr& req : in_flight) {
+    if (req) {
+      fail(*req);
+      req.reset();
+    }
+  }
+  // Closing the ring makes the kernel cancel whatever it still holds.
+  ring.reset();
+  for (const StatePtr& req : queued) {
+    fail(*req);
+  }
+  Profiler::set_thread_name("io worker 0");
+}
+
+#else
+
+void IoService::uring_loop_() {}
+
+#endif
+
+}  // namespace TENG_NAMESPACE
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "core/Config.hpp"
+#include "core/Result.hpp"
+
+namespace TENG_NAMESPACE {
+
+class JobCounter;
+
+// Contents of a completed read.
+struct IoBuffer {
+  std::unique_ptr<std::byte[]> data;
+  size_t size{};
+
+  [[nodiscard]] std::span<const std::byte> bytes() const { return {data.get(), size}; }
+  [[nodiscard]] std::string_view text() const {
+    return {reinterpret_cast<const char*>(data.get()), size};
+  }
+};
+
+namespace io_detail {
+struct RequestState;
+}  // namespace io_detail
+
+// Handle to one queued read; copies share the same request.
+class IoRequest {
+ public:
+  IoRequest() = default;
+
+  [[nodiscard]] bool valid() const { return state_ != nullptr; }
+  [[nodiscard]] bool done() const;
+  [[nodiscard]] const std::filesystem::path& path() const;
+  // Blocks the calling thread until the read finishes. From job code, pass a JobCounter at
+  // submission and JobSystem::wait on it instead, which keeps the thread running jobs.
+  void wait() const;
+  // Waits, then moves the result out. Later calls return an error.
+  [[nodiscard]] Result<IoBuffer> take();
+
+ private:
+  friend class IoService;
+  explicit IoRequest(std::shared_ptr<io_detail::RequestState> state) : state_(std::move(state)) {}
+
+  std::shared_ptr<io_detail::RequestState> state_;
+};
+
+// Asynchronous whole-file reads. On Linux, a dedicated thread drives an io_uring instance: reads
+// queued between two wakeups are submitted together and up to `queue_depth` stay in flight, so
+// many small asset reads keep the device queue full without occupying job workers. Elsewhere, or
+// when io_uring is unavailable (old kernels, seccomp'd containers), a small pool of threads does
+// blocking reads instead. If the ring fails for good at runtime, reads in flight and queued fail
+// with the error and the service continues on the thread pool. Thread-safe.
+class IoService {
+ public:
+  enum class Backend : uint8_t { IoUring, ThreadPool };
+
+  struct CreateInfo {
+    uint32_t queue_depth{64};
+    uint32_t fallback_threads{4};
+    bool force_thread_pool{};
+  };
+
+  static IoService& get();
+
+  explicit IoService(const CreateInfo& cinfo);
+  // Finishes every queued read before returning.
+  ~IoService();
+  IoService(const IoService&) = delete;
+  IoService& operator=(const IoService&) = delete;
+
+  [[nodiscard]] Backend backend() const { return backend_.load(std::memory_order_acquire); }
+
+  // Queues a read of the whole file. With a counter, the read counts as pending work on it until
+  // it completes, so JobSystem::wait(*counter) also covers it.
+  IoRequest read(const std::filesystem::path& path, JobCounter* counter = nullptr);
+  // Queues all reads with a single wakeup of the I/O thread. Results are in `paths` order.
+  std::vector<IoRequest> read_batch(std::span<const std::filesystem::path> paths,
+                                    JobCounter* counter = nullptr);
+
+ private:
+  struct Ring;
+  using StatePtr = std::shared_ptr<io_detail::RequestState>;
+
+  void enqueue_(std::span<const StatePtr> states);
+  void uring_loop_();
+  void pool_loop_();
+  // Called by the I/O thread when io_uring_enter fails with `err` for good. Returns with the
+  // service on the thread-pool backend; the caller then serves as one of its workers.
+  void fall_back_to_thread_pool_(std::vector<StatePtr>& in_flight, int err);
+
+  std::atomic<Backend> backend_{Backend::ThreadPool};
+  uint32_t fallback_threads_{};
+  // Guarded by mtx_ so the I/O thread can drop it while other threads enqueue.
+  std::unique_ptr<Ring> ring_;
+  std::vector<std::thread> threads_;
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  std::deque<StatePtr> pending_;
+  // Buffers of reads abandoned with a failed ring: the kernel may still write them, so they are
+  // only freed with the service.
+  std::vector<std::unique_ptr<std::byte[]>> orphaned_buffers_;
+  bool stop_{};
+};
+
+}  // namespace TENG_NAMESPACE
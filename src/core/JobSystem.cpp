@@ -0,0 +1,149 @@
+#include "core/JobSystem.hpp"
+
+#include <format>
+
+#include "core/Profiler.hpp"
+
+namespace TENG_NAMESPACE {
+
+namespace {
+
+thread_local const JobSystem* t_job_system{};
+thread_local int32_t t_worker_i{-1};
+
+}  // namespace
+
+JobSystem& JobSystem::get() {
+  static JobSystem system{std::max(1u, std::thread::hardware_concurrency()) - 1};
+  return system;
+}
+
+JobSystem::JobSystem(uint32_t worker_count)
+    : queues_(std::make_unique<WorkQueue[]>(worker_count + 1)), queue_count_(worker_count + 1) {
+  workers_.reserve(worker_count);
+  for (uint32_t worker_i = 0; worker_i < worker_count; ++worker_i) {
+    workers_.emplace_back([this, worker_i] { worker_loop_(worker_i); });
+  }
+}
+
+JobSystem::~JobSystem() {
+  stop_.store(true, std::memory_order_release);
+  // Leaves queued_ nonzero so no worker goes back to sleep; each drains what is left and exits.
+  queued_.fetch_add(1, std::memory_order_release);
+  queued_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+int32_t JobSystem::current_worker() const { return t_job_system == this ? t_worker_i : -1; }
+
+void JobSystem::submit(const Job& job) {
+  if (job.counter) {
+    job.counter->pending_.fetch_add(1, std::memory_order_relaxed);
+  }
+  const int32_t self = current_worker();
+  WorkQueue& queue = queues_[self >= 0 ? static_cast<uint32_t>(self) : queue_count_ - 1];
+  {
+    std::scoped_lock lock(queue.mtx);
+    queue.jobs.push_back(job);
+  }
+  queued_.fetch_add(1, std::memory_order_release);
+  queued_.notify_one();
+}
+
+void JobSystem::submit_background_(const Job& job) {
+  {
+    std::scoped_lock lock(background_queue_.mtx);
+    background_queue_.jobs.push_back(job);
+  }
+  queued_.fetch_add(1, std::memory_order_release);
+  queued_.notify_one();
+}
+
+void JobSystem::wait(JobCounter& counter) {
+  const int32_t self = current_worker();
+  uint32_t idle_rounds = 0;
+  while (!counter.done()) {
+    Job job;
+    if (try_take_(self, job, false)) {
+      execute_(job);
+      idle_rounds = 0;
+      continue;
+    }
+    // Nothing runnable: the remaining jobs of `counter` are executing on other threads.
+    if (++idle_rounds > 16) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+void JobSystem::worker_loop_(uint32_t worker_i) {
+  t_job_system = this;
+  t_worker_i = static_cast<int32_t>(worker_i);
+  Profiler::set_thread_name(std::format("job worker {}", worker_i));
+  while (true) {
+    Job job;
+    if (try_take_(static_cast<int32_t>(worker_i), job, true)) {
+      execute_(job);
+      continue;
+    }
+    if (stop_.load(std::memory_order_acquire)) {
+      break;
+    }
+    queued_.wait(0, std::memory_order_acquire);
+  }
+}
+
+bool JobSystem::try_take_(int32_t self, Job& out, bool allow_background) {
+  if (queued_.load(std::memory_order_acquire) == 0) {
+    return false;
+  }
+  if (self >= 0) {
+    WorkQueue& own = queues_[self];
+    std::scoped_lock lock(own.mtx);
+    if (!own.jobs.empty()) {
+      out = own.jobs.back();
+      own.jobs.pop_back();
+      queued_.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  // Steal oldest-first, starting after our own queue so thieves spread across victims.
+  const uint32_t start = self >= 0 ? static_cast<uint32_t>(self) + 1 : 0;
+  for (uint32_t i = 0; i < queue_count_; ++i) {
+    const uint32_t victim_i = (start + i) % queue_count_;
+    if (static_cast<int32_t>(victim_i) == self) {
+      continue;
+    }
+    WorkQueue& victim = queues_[victim_i];
+    std::unique_lock lock(victim.mtx, std::try_to_lock);
+    if (!lock.owns_lock() || victim.jobs.empty()) {
+      continue;
+    }
+    out = victim.jobs.front();
+    victim.jobs.pop_front();
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+  if (allow_background) {
+    std::scoped_lock lock(background_queue_.mtx);
+    if (!background_queue_.jobs.empty()) {
+      out = background_queue_.jobs.front();
+      background_queue_.jobs.pop_front();
+      queued_.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+void JobSystem::execute_(const Job& job) {
+  JobCounter* counter = job.counter;
+  job.fn(job);
+  if (counter) {
+    counter->pending_.fetch_sub(1, std::memory_order_release);
+  }
+}
+
+}  // namespace TENG_NAMESPACE
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "core/Config.hpp"
+
+namespace TENG_NAMESPACE {
+
+// Number of outstanding jobs submitted against it. Lives on the submitter's stack; JobSystem::wait
+// returns once every job counted on it has finished. Not reusable while jobs are pending.
+class JobCounter {
+ public:
+  JobCounter() = default;
+  JobCounter(const JobCounter&) = delete;
+  JobCounter& operator=(const JobCounter&) = delete;
+
+  [[nodiscard]] bool done() const { return pending_.load(std::memory_order_acquire) == 0; }
+
+  // For work that runs outside the job queues (e.g. IoService reads): add() before starting it and
+  // release() once it has finished, from any thread. JobSystem::wait then covers it as well.
+  void add(uint32_t count = 1) { pending_.fetch_add(count, std::memory_order_relaxed); }
+  void release() { pending_.fetch_sub(1, std::memory_order_release); }
+
+ private:
+  friend class JobSystem;
+  std::atomic<uint32_t> pending_{0};
+};
+
+// Work-stealing scheduler. Each worker owns a deque: it pushes and pops its own work LIFO at the
+// back, idle workers steal FIFO from the front of others. Threads that are not workers submit into
+// a shared injection queue. wait() never blocks while there is runnable work: the waiting thread
+// executes jobs (its own first, then stolen ones) until its counter drains, so nested
+// parallel_for / fork_join from inside jobs cannot deadlock the pool.
+class JobSystem {
+ public:
+  // Plain data copied by value through the deques: no allocation or refcount per job.
+  // parallel_for / fork_join jobs point `ctx` at a callable on the waiting thread's stack;
+  // run() heap-allocates the closure and the job frees it.
+  struct Job {
+    void (*fn)(const Job&){};
+    void* ctx{};
+    size_t begin{};
+    size_t end{};
+    JobCounter* counter{};
+  };
+
+  // Process-wide scheduler with hardware_concurrency() - 1 workers (the main thread is expected to
+  // help through wait()).
+  static JobSystem& get();
+
+  explicit JobSystem(uint32_t worker_count);
+  ~JobSystem();
+  JobSystem(const JobSystem&) = delete;
+  JobSystem& operator=(const JobSystem&) = delete;
+
+  [[nodiscard]] uint32_t worker_count() const { return static_cast<uint32_t>(workers_.size()); }
+  // Worker index of the calling thread, or -1 if it is not one of this system's workers.
+  [[nodiscard]] int32_t current_worker() const;
+
+  void submit(const Job& job);
+  // Runs `fn()` on the pool. With a counter, wait(*counter) joins it; without, it is detached.
+  template <typename F>
+  void run(F&& fn, JobCounter* counter = nullptr) {
+    using Fn = std::decay_t<F>;
+    auto* heap_fn = new Fn(std::forward<F>(fn));
+    submit(Job{
+        .fn = [](const Job& job) {
+          std::unique_ptr<Fn> owned(static_cast<Fn*>(job.ctx));
+          (*owned)();
+        },
+        .ctx = heap_fn,
+        .counter = counter,
+    });
+  }
+  // Runs `fn()` detached at background priority: only workers pick it up, after any normal job,
+  // and wait() never runs it inline, so long tasks (terrain generation, meshing) cannot stall a
+  // thread that is waiting on frame work. Without workers it runs on the caller immediately.
+  template <typename F>
+  void run_background(F&& fn) {
+    using Fn = std::decay_t<F>;
+    if (workers_.empty()) {
+      fn();
+      return;
+    }
+    auto* heap_fn = new Fn(std::forward<F>(fn));
+    submit_background_(Job{
+        .fn = [](const Job& job) {
+          std::unique_ptr<Fn> owned(static_cast<Fn*>(job.ctx));
+          (*owned)();
+        },
+        .ctx = heap_fn,
+    });
+  }
+  // Executes queued jobs on the calling thread until `counter` drains. Background jobs are left
+  // to the workers.
+  void wait(JobCounter& counter);
+
+  // Calls fn(i) for every i in [begin, end), split into chunks of `grain` indices (0 picks one so
+  // every thread gets a few chunks). Returns once all indices ran; the caller executes chunks too.
+  template <typename F>
+  void parallel_for(size_t begin, size_t end, size_t grain, F&& fn) {
+    if (begin >= end) {
+      return;
+    }
+    const size_t count = end - begin;
+    if (grain == 0) {
+      grain = std::max<size_t>(1, count / ((worker_count() + 1) * 4));
+    }
+    if (count <= grain || workers_.empty()) {
+      for (size_t i = begin; i < end; ++i) {
+        fn(i);
+      }
+      return;
+    }
+    using Fn = std::remove_reference_t<F>;
+    JobCounter counter;
+    for (size_t chunk_begin = begin; chunk_begin < end; chunk_begin += grain) {
+      submit(Job{
+          .fn = [](const Job& job) {
+            Fn& body = *static_cast<Fn*>(job.ctx);
+            for (size_t i = job.begin; i < job.end; ++i) {
+              body(i);
+            }
+          },
+          .ctx = const_cast<void*>(static_cast<const void*>(std::addressof(fn))),
+          .begin = chunk_begin,
+          .end = std::min(chunk_begin + grain, end),
+          .counter = &counter,
+      });
+    }
+    wait(counter);
+  }
+
+  // Runs every callable in parallel: all but the first are submitted, the first runs inline, then
+  // the caller helps until the rest finish.
+  template <typename First, typename... Rest>
+  void fork_join(First&& first, Rest&&... rest) {
+    JobCounter counter;
+    (submit_ref_(rest, counter), ...);
+    first();
+    wait(counter);
+  }
+
+ private:
+  struct alignas(64) WorkQueue {
+    std::mutex mtx;
+    std::deque<Job> jobs;
+  };
+
+  template <typename F>
+  void submit_ref_(F& fn, JobCounter& counter) {
+    submit(Job{
+        .fn = [](const Job& job) { (*static_cast<F*>(job.ctx))(); },
+        .ctx = const_cast<void*>(static_cast<const void*>(std::addressof(fn))),
+        .counter = &counter,
+    });
+  }
+
+  void submit_background_(const Job& job);
+  void worker_loop_(uint32_t worker_i);
+  // Pops from the calling thread's own queue (back), else steals from another queue (front),
+  // else, with `allow_background`, takes the oldest background job.
+  bool try_take_(int32_t self, Job& out, bool allow_background);
+  static void execute_(const Job& job);
+
+  std::vector<std::thread> workers_;
+  // One per worker, plus the injection queue used by non-worker threads at index worker_count().
+  std::unique_ptr<WorkQueue[]> queues_;
+  uint32_t queue_count_{};
+  WorkQueue background_queue_;
+  // Jobs sitting in any queue; idle workers sleep on it (atomic wait) while it is zero.
+  std::atomic<uint32_t> queued_{0};
+  std::atomic<bool> stop_{};
+};
+
+}  // namespace TENG_NAMESPACE
@@ -0,0 +1,718 @@
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace TENG_NAMESPACE {
+
+namespace log_detail {
+
+// Single-producer single-consumer byte ring owned by one logging thread. Positions only grow;
+// offsets are taken modulo the ring size.
+struct ThreadRing {
+  alignas(64) std::atomic<uint64_t> head{0};  // Published by the owning thread.
+  uint64_t cached_tail{0};
+  uint64_t pending_head{0};  // Head after the record currently being written.
+  std::atomic<uint64_t> messages{0};
+  alignas(64) std::atomic<uint64_t> tail{0};  // Published by the writer thread.
+  std::atomic<bool> retired{false};
+  uint16_t thread_index{};
+  std::unique_ptr<std::byte[]> data;
+};
+
+}  // namespace log_detail
+
+namespace {
+
+using log_detail::ArgTag;
+using log_detail::RecordHeader;
+using log_detail::ThreadRing;
+
+constexpr size_t k_ring_bytes = 256 * 1024;
+// Larger messages bypass the ring and are written synchronously after a flush.
+constexpr size_t k_max_record_bytes = k_ring_bytes / 4;
+// Written in place of a record header when a record does not fit before the end of the ring.
+constexpr uint32_t k_wrap_marker = ~0u;
+constexpr auto k_idle_poll = std::chrono::milliseconds(5);
+constexpr std::array<char, 8> k_binary_magic{'T', 'E', 'N', 'G', 'L', 'O', 'G', '1'};
+// Format string used for messages that were formatted on the calling thread.
+constexpr std::string_view k_message_fmt = "{}";
+
+uint64_t now_ns() {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now().time_since_epoch())
+                                   .count());
+}
+
+std::string_view level_prefix(LogLevel level) {
+  switch (level) {
+    case LogLevel::Debug:
+      return "[debug]   ";
+    case LogLevel::Info:
+      return "";
+    case LogLevel::Warn:
+      return "[warn]     ";
+    case LogLevel::Error:
+      return "[error]    ";
+    case LogLevel::Critical:
+      return "[critical] ";
+  }
+  return "";
+}
+
+thread_local ThreadRing* t_ring = nullptr;
+thread_local bool t_ring_dead = false;
+
+// Hands the thread's ring back to the writer, which frees it once drained.
+struct RingRetirer {
+  bool armed{};
+  ~RingRetirer() {
+    if (t_ring) {
+      t_ring->retired.store(true, std::memory_order_release);
+    }
+    t_ring = nullptr;
+    t_ring_dead = true;
+  }
+};
+thread_local RingRetirer t_retirer;
+
+// A decoded argument; std::formatter<LogArg> forwards to the formatter of the original type.
+struct LogArg {
+  ArgTag tag{};
+  union {
+    int64_t i;
+    uint64_t u;
+    float f32;
+    double f64;
+    bool b;
+    char c;
+    const void* p;
+  };
+  std::string_view s;
+};
+
+template <typename T>
+bool read_value(const std::byte*& p, const std::byte* end, T& out) {
+  if (static_cast<size_t>(end - p) < sizeof(T)) {
+    return false;
+  }
+  std::memcpy(&out, p, sizeof(T));
+  p += sizeof(T);
+  return true;
+}
+
+bool decode_args(const std::byte* p, size_t size, uint32_t count, LogArg* out) {
+  const std::byte* const end = p + size;
+  for (uint32_t i = 0; i < count; ++i) {
+    uint8_t tag{};
+    if (!read_value(p, end, tag)) {
+      return false;
+    }
+    LogArg& arg = out[i];
+    arg.tag = static_cast<ArgTag>(tag);
+    bool ok = false;
+    switch (arg.tag) {
+      case ArgTag::I64:
+        ok = read_value(p, end, arg.i);
+        break;
+      case ArgTag::U64:
+        ok = read_value(p, end, arg.u);
+        break;
+      case ArgTag::F32:
+        ok = read_value(p, end, arg.f32);
+        break;
+      case ArgTag::F64:
+        ok = read_value(p, end, arg.f64);
+        break;
+      case ArgTag::Bool:
+        ok = read_value(p, end, arg.b);
+        break;
+      case ArgTag::Char:
+        ok = read_value(p, end, arg.c);
+        break;
+      case ArgTag::Ptr: {
+        uint64_t bits{};
+        ok = read_value(p, end, bits);
+        arg.p = reinterpret_cast<const void*>(static_cast<uintptr_t>(bits));
+        break;
+      }
+      case ArgTag::String: {
+        uint32_t len{};
+        ok = read_value(p, end, len) && static_cast<size_t>(end - p) >= len;
+        if (ok) {
+          arg.s = std::string_view(reinterpret_cast<const char*>(p), len);
+          p += len;
+        }
+        break;
+      }
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+  return p == end;
+}
+
+}  // namespace
+
+}  // namespace TENG_NAMESPACE
+
+template <>
+struct std::formatter<TENG_NAMESPACE::LogArg> {
+  // The spec is kept and handed to the real formatter once the argument's type is known.
+  constexpr auto parse(std::format_parse_context& ctx) {
+    auto it = ctx.begin();
+    int depth = 0;
+    while (it != ctx.end() && (depth > 0 || *it != '}')) {
+      depth += *it == '{' ? 1 : (*it == '}' ? -1 : 0);
+      ++it;
+    }
+    spec_ = std::string_view(ctx.begin(), it);
+    return it;
+  }
+
+  template <typename FormatContext>
+  auto format(const TENG_NAMESPACE::LogArg& arg, FormatContext& ctx) const {
+    using TENG_NAMESPACE::log_detail::ArgTag;
+    switch (arg.tag) {
+      case ArgTag::I64:
+        return format_as_(arg.i, ctx);
+      case ArgTag::U64:
+        return format_as_(arg.u, ctx);
+      case ArgTag::F32:
+        return format_as_(arg.f32, ctx);
+      case ArgTag::F64:
+        return format_as_(arg.f64, ctx);
+      case ArgTag::Bool:
+        return format_as_(arg.b, ctx);
+      case ArgTag::Char:
+        return format_as_(arg.c, ctx);
+      case ArgTag::Ptr:
+        return format_as_(arg.p, ctx);
+      case ArgTag::String:
+        break;
+    }
+    return format_as_(arg.s, ctx);
+  }
+
+ private:
+  template <typename T, typename FormatContext>
+  auto format_as_(const T& value, FormatContext& ctx) const {
+    std::formatter<T, char> formatter;
+    // Dynamic width/precision ({:{}}) has no arguments to refer to here and throws; the writer
+    // reports that instead of the message.
+    std::format_parse_context parse_ctx(spec_);
+    parse_ctx.advance_to(formatter.parse(parse_ctx));
+    return formatter.format(value, ctx);
+  }
+
+  std::string_view spec_;
+};
+
+namespace TENG_NAMESPACE {
+
+namespace {
+
+using FormatFn = void (*)(std::string&, std::string_view, const LogArg*);
+
+template <size_t... I>
+void vformat_args(std::string& out, std::string_view fmt, const LogArg* args,
+                  std::index_sequence<I...>) {
+  std::vformat_to(std::back_inserter(out), fmt, std::make_format_args(args[I]...));
+}
+
+template <size_t... N>
+constexpr std::array<FormatFn, sizeof...(N)> make_format_table(std::index_sequence<N...>) {
+  return {[](std::string& out, std::string_view fmt, const LogArg* args) {
+    vformat_args(out, fmt, args, std::make_index_sequence<N>{});
+  }...};
+}
+
+constexpr std::array<FormatFn, log_detail::k_max_args + 1> k_format_table =
+    make_format_table(std::make_index_sequence<log_detail::k_max_args + 1>{});
+
+void format_message(std::string& out, std::string_view fmt, const LogArg* args, uint32_t count) {
+  const size_t start = out.size();
+  try {
+    k_format_table[count](out, fmt, args);
+  } catch (const std::format_error& e) {
+    out.resize(start);
+    out += std::format("{} [log format error: {}]", fmt, e.what());
+  }
+}
+
+template <typename T>
+void append_value(std::string& out, const T& value) {
+  out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void append_text_line(std::string& out, LogLevel level, std::string_view fmt, const LogArg* args,
+                      uint32_t count) {
+  out += level_prefix(level);
+  format_message(out, fmt, args, count);
+  out += '\n';
+}
+
+}  // namespace
+
+struct Logger::Impl {
+  struct Pending {
+    const RecordHeader* header;
+    uint16_t thread_index;
+  };
+
+  ThreadRing* thread_ring();
+  void writer_loop();
+  // Writes every published record; only one thread drains at a time. Returns the record count.
+  size_t drain();
+  void wake();
+  // Appends one record to the text and binary buffers. Requires sink_mtx.
+  void write_record(LogLevel level, uint16_t thread_index, uint64_t timestamp_ns,
+                    std::string_view fmt, const std::byte* args, uint32_t args_size,
+                    uint32_t arg_count);
+  // Writes out the text and binary buffers. Requires sink_mtx.
+  void flush_sinks();
+
+  std::mutex rings_mtx;
+  std::vector<std::unique_ptr<ThreadRing>> rings;
+  uint16_t next_thread_index{};
+  uint64_t retired_messages{};
+
+  std::thread writer;
+  std::atomic<bool> running{false};
+  std::atomic<bool> stop{false};
+  std::mutex wake_mtx;
+  std::condition_variable wake_cv;
+  bool wake_requested{false};
+  std::atomic<uint64_t> flush_requested{0};
+  std::atomic<uint64_t> flush_completed{0};
+
+  std::mutex sink_mtx;
+  bool console{true};
+  std::FILE* binary_file{};
+  uint64_t binary_start_ns{};
+  std::unordered_map<const char*, uint32_t> fmt_ids;
+  std::string text_buf;
+  std::string binary_buf;
+
+  // Writer-thread scratch.
+  std::vector<ThreadRing*> ring_snapshot;
+  std::vector<uint64_t> ring_heads;
+  std::vector<Pending> pending;
+
+  std::atomic<uint64_t> ring_full_stalls{0};
+  std::atomic<uint64_t> sync_writes{0};
+};
+
+ThreadRing* Logger::Impl::thread_ring() {
+  if (t_ring || t_ring_dead) {
+    return t_ring;
+  }
+  t_retirer.armed = true;
+  auto ring = std::make_unique<ThreadRing>();
+  ring->data = std::make_unique_for_overwrite<std::byte[]>(k_ring_bytes);
+  std::scoped_lock lock(rings_mtx);
+  ring->thread_index = next_thread_index++;
+  t_ring = ring.get();
+  rings.push_back(std::move(ring));
+  return t_ring;
+}
+
+void Logger::Impl::wake() {
+  {
+    std::scoped_lock lock(wake_mtx);
+    wake_requested = true;
+  }
+  wake_cv.notify_one();
+}
+
+void Logger::Impl::writer_loop() {
+  while (true) {
+    const uint64_t flush_target = flush_requested.load(std::memory_order_acquire);
+    const size_t written = drain();
+    if (flush_target > flush_completed.load(std::memory_order_relaxed)) {
+      flush_completed.store(flush_target, std::memory_order_release);
+      flush_completed.notify_all();
+    }
+    if (stop.load(std::memory_order_acquire)) {
+      break;
+    }
+    if (written == 0) {
+      std::unique_lock lock(wake_mtx);
+      wake_cv.wait_for(lock, k_idle_poll, [this] { return wake_requested; });
+      wake_requested = false;
+    }
+  }
+}
+
+size_t Logger::Impl::drain() {
+  {
+    std::scoped_lock lock(rings_mtx);
+    // A retired ring's owner is gone, so once it is empty nothing can be published into it again.
+    std::erase_if(rings, [this](const std::unique_ptr<ThreadRing>& ring) {
+      if (!ring->retired.load(std::memory_order_acquire) ||
+          ring->head.load(std::memory_order_acquire) !=
+              ring->tail.load(std::memory_order_relaxed)) {
+        return false;
+      }
+      retired_messages += ring->messages.load(std::memory_order_relaxed);
+      return true;
+    });
+    ring_snapshot.clear();
+    for (const auto& ring : rings) {
+      ring_snapshot.push_back(ring.get());
+    }
+  }
+
+  pending.clear();
+  ring_heads.resize(ring_snapshot.size());
+  for (size_t i = 0; i < ring_snapshot.size(); ++i) {
+    ThreadRing& ring = *ring_snapshot[i];
+    const uint64_t head = ring.head.load(std::memory_order_acquire);
+    uint64_t pos = ring.tail.load(std::memory_order_relaxed);
+    while (pos < head) {
+      const size_t offset = pos & (k_ring_bytes - 1);
+      uint32_t size{};
+      std::memcpy(&size, ring.data.get() + offset, sizeof(size));
+      if (size == k_wrap_marker) {
+        pos += k_ring_bytes - offset;
+        continue;
+      }
+      pending.push_back(Pending{
+          .header = reinterpret_cast<const RecordHeader*>(ring.data.get() + offset),
+          .thread_index = ring.thread_index,
+      });
+      pos += size;
+    }
+    ring_heads[i] = head;
+  }
+  if (pending.empty()) {
+    return 0;
+  }
+
+  std::ranges::stable_sort(pending, {}, [](const Pending& p) { return p.header->timestamp_ns; });
+  {
+    std::scoped_lock lock(sink_mtx);
+    for (const Pending& p : pending) {
+      const RecordHeader& h = *p.header;
+      write_record(h.level, p.thread_index, h.timestamp_ns, std::string_view(h.fmt, h.fmt_size),
+                   reinterpret_cast<const std::byte*>(p.header + 1), h.args_size, h.arg_count);
+    }
+    flush_sinks();
+  }
+  // Only now may producers reuse the space: the records (and their strings) have been written.
+  for (size_t i = 0; i < ring_snapshot.size(); ++i) {
+    ring_snapshot[i]->tail.store(ring_heads[i], std::memory_order_release);
+  }
+  return pending.size();
+}
+
+void Logger::Impl::write_record(LogLevel level, uint16_t thread_index, uint64_t timestamp_ns,
+                                std::string_view fmt, const std::byte* args, uint32_t args_size,
+                                uint32_t arg_count) {
+  if (console) {
+    std::array<LogArg, log_detail::k_max_args> decoded{};
+    if (decode_args(args, args_size, arg_count, decoded.data())) {
+      append_text_line(text_buf, level, fmt, decoded.data(), arg_count);
+    }
+  }
+  if (binary_file) {
+    auto [it, inserted] = fmt_ids.try_emplace(fmt.data(), static_cast<uint32_t>(fmt_ids.size()));
+    if (inserted) {
+      binary_buf += 'F';
+      append_value(binary_buf, it->second);
+      append_value(binary_buf, static_cast<uint32_t>(fmt.size()));
+      binary_buf += fmt;
+    }
+    binary_buf += 'R';
+    append_value(binary_buf, it->second);
+    append_value(binary_buf, level);
+    append_value(binary_buf, static_cast<uint8_t>(arg_count));
+    append_value(binary_buf, thread_index);
+    append_value(binary_buf, timestamp_ns);
+    append_value(binary_buf, args_size);
+    binary_buf.append(reinterpret_cast<const char*>(args), args_size);
+  }
+}
+
+void Logger::Impl::flush_sinks() {
+  if (!text_buf.empty()) {
+    std::fwrite(text_buf.data(), 1, text_buf.size(), stdout);
+    std::fflush(stdout);
+    text_buf.clear();
+  }
+  if (binary_file && !binary_buf.empty()) {
+    std::fwrite(binary_buf.data(), 1, binary_buf.size(), binary_file);
+    std::fflush(binary_file);
+  }
+  binary_buf.clear();
+}
+
+namespace {
+
+std::atomic<Logger*> g_logger{nullptr};
+
+}  // namespace
+
+Logger& Logger::get() {
+  // Never destroyed: messages logged from static destructors after the atexit shutdown are
+  // written synchronously instead of touching a dead logger.
+  static Logger* logger = [] {
+    auto* created = new Logger();
+    g_logger.store(created, std::memory_order_release);
+    std::atexit([] { Logger::get().shutdown(); });
+    return created;
+  }();
+  return *logger;
+}
+
+Logger::Logger() : impl_(new Impl) {
+  impl_->running.store(true, std::memory_order_release);
+  impl_->writer = std::thread([this] { impl_->writer_loop(); });
+}
+
+Logger::~Logger() {
+  shutdown();
+  delete impl_;
+}
+
+void Logger::set_console_enabled(bool enabled) {
+  std::scoped_lock lock(impl_->sink_mtx);
+  impl_->console = enabled;
+}
+
+Result<void> Logger::open_binary_file(const std::filesystem::path& path) {
+  flush();
+  std::FILE* file = std::fopen(path.string().c_str(), "wb");
+  if (!file) {
+    return make_unexpected("failed to open binary log " + path.string());
+  }
+  const uint64_t start_ns = now_ns();
+  const auto wall_ns = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+  std::fwrite(k_binary_magic.data(), 1, k_binary_magic.size(), file);
+  std::fwrite(&start_ns, sizeof(start_ns), 1, file);
+  std::fwrite(&wall_ns, sizeof(wall_ns), 1, file);
+
+  std::scoped_lock lock(impl_->sink_mtx);
+  if (impl_->binary_file) {
+    std::fclose(impl_->binary_file);
+  }
+  impl_->binary_file = file;
+  impl_->binary_start_ns = start_ns;
+  impl_->fmt_ids.clear();
+  return {};
+}
+
+void Logger::close_binary_file() {
+  flush();
+  std::scoped_lock lock(impl_->sink_mtx);
+  if (impl_->binary_file) {
+    std::fclose(impl_->binary_file);
+    impl_->binary_file = nullptr;
+  }
+}
+
+void Logger::flush() {
+  if (!impl_->running.load(std::memory_order_acquire)) {
+    std::scoped_lock lock(impl_->sink_mtx);
+    std::fflush(stdout);
+    return;
+  }
+  const uint64_t target = impl_->flush_requested.fetch_add(1, std::memory_order_acq_rel) + 1;
+  impl_->wake();
+  uint64_t completed = impl_->flush_completed.load(std::memory_order_acquire);
+  while (completed < target) {
+    impl_->flush_completed.wait(completed, std::memory_order_acquire);
+    completed = impl_->flush_completed.load(std::memory_order_acquire);
+  }
+}
+
+void Logger::shutdown() {
+  if (!impl_->running.exchange(false, std::memory_order_acq_rel)) {
+    return;
+  }
+  impl_->stop.store(true, std::memory_order_release);
+  impl_->wake();
+  impl_->writer.join();
+  // Records committed by threads that saw `running` just before it flipped.
+  impl_->drain();
+  impl_->flush_completed.store(~0ull, std::memory_order_release);
+  impl_->flush_completed.notify_all();
+  std::scoped_lock lock(impl_->sink_mtx);
+  if (impl_->binary_file) {
+    std::fclose(impl_->binary_file);
+    impl_->binary_file = nullptr;
+  }
+}
+
+Logger::Stats Logger::get_stats() const {
+  Stats stats{
+      .eager_formats = eager_formats_.load(std::memory_order_relaxed),
+      .ring_full_stalls = impl_->ring_full_stalls.load(std::memory_order_relaxed),
+      .sync_writes = impl_->sync_writes.load(std::memory_order_relaxed),
+  };
+  std::scoped_lock lock(impl_->rings_mtx);
+  stats.messages = impl_->retired_messages;
+  for (const auto& ring : impl_->rings) {
+    stats.messages += ring->messages.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+std::byte* Logger::begin_record_(size_t bytes) {
+  const size_t size = (bytes + 7) & ~size_t{7};
+  if (size > k_max_record_bytes || !impl_->running.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  ThreadRing* ring = impl_->thread_ring();
+  if (!ring) {
+    return nullptr;
+  }
+  const uint64_t head = ring->head.load(std::memory_order_relaxed);
+  const size_t offset = head & (k_ring_bytes - 1);
+  const size_t contiguous = k_ring_bytes - offset;
+  const size_t needed = size <= contiguous ? size : contiguous + size;
+  while (k_ring_bytes - (head - ring->cached_tail) < needed) {
+    ring->cached_tail = ring->tail.load(std::memory_order_acquire);
+    if (k_ring_bytes - (head - ring->cached_tail) >= needed) {
+      break;
+    }
+    impl_->ring_full_stalls.fetch_add(1, std::memory_order_relaxed);
+    if (!impl_->running.load(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    impl_->wake();
+    std::this_thread::yield();
+  }
+
+  std::byte* const base = ring->data.get();
+  uint64_t record_pos = head;
+  if (size > contiguous) {
+    std::memcpy(base + offset, &k_wrap_marker, sizeof(k_wrap_marker));
+    record_pos += contiguous;
+  }
+  std::byte* const out = base + (record_pos & (k_ring_bytes - 1));
+  auto* header = reinterpret_cast<RecordHeader*>(out);
+  header->size = static_cast<uint32_t>(size);
+  header->timestamp_ns = now_ns();
+  ring->pending_head = record_pos + size;
+  return out;
+}
+
+void Logger::commit_record_(LogLevel level) {
+  ThreadRing* ring = t_ring;
+  ring->head.store(ring->pending_head, std::memory_order_release);
+  ring->messages.store(ring->messages.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+  if (level >= LogLevel::Critical) {
+    flush();
+  } else if (ring->pending_head - ring->cached_tail > k_ring_bytes / 2) {
+    impl_->wake();
+  }
+}
+
+void Logger::log_message_(LogLevel level, std::string_view message) {
+  const size_t args_size = log_detail::encoded_size<std::string_view>(message);
+  if (std::byte* out = begin_record_(sizeof(RecordHeader) + args_size)) {
+    auto* header = reinterpret_cast<RecordHeader*>(out);
+    header->level = level;
+    header->arg_count = 1;
+    header->fmt = k_message_fmt.data();
+    header->fmt_size = static_cast<uint32_t>(k_message_fmt.size());
+    header->args_size = static_cast<uint32_t>(args_size);
+    log_detail::encode_arg<std::string_view>(out + sizeof(RecordHeader), message);
+    commit_record_(level);
+    return;
+  }
+  // Too large for the ring, or the writer is gone: keep ordering by flushing first.
+  flush();
+  impl_->sync_writes.fetch_add(1, std::memory_order_relaxed);
+  std::vector<std::byte> args(args_size);
+  log_detail::encode_arg<std::string_view>(args.data(), message);
+  std::scoped_lock lock(impl_->sink_mtx);
+  impl_->write_record(level, 0, now_ns(), k_message_fmt, args.data(),
+                      static_cast<uint32_t>(args_size), 1);
+  impl_->flush_sinks();
+}
+
+void flush_logs() {
+  if (Logger* logger = g_logger.load(std::memory_order_acquire)) {
+    logger->flush();
+  }
+}
+
+Result<std::string> read_binary_log(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return make_unexpected("failed to open binary log " + path.string());
+  }
+  const std::string bytes{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  const auto* p = reinterpret_cast<const std::byte*>(bytes.data());
+  const std::byte* const end = p + bytes.size();
+  const auto truncated = [&path] {
+    return make_unexpected("truncated or corrupt binary log " + path.string());
+  };
+
+  std::array<char, 8> magic{};
+  uint64_t start_ns{};
+  uint64_t wall_ns{};
+  if (!read_value(p, end, magic) || magic != k_binary_magic || !read_value(p, end, start_ns) ||
+      !read_value(p, end, wall_ns)) {
+    return make_unexpected(path.string() + " is not a binary log");
+  }
+
+  std::vector<std::string_view> fmts;
+  std::string out;
+  std::array<LogArg, log_detail::k_max_args> args{};
+  while (p < end) {
+    char kind{};
+    read_value(p, end, kind);
+    if (kind == 'F') {
+      uint32_t id{};
+      uint32_t len{};
+      if (!read_value(p, end, id) || !read_value(p, end, len) ||
+          static_cast<size_t>(end - p) < len || id != fmts.size()) {
+        return truncated();
+      }
+      fmts.emplace_back(reinterpret_cast<const char*>(p), len);
+      p += len;
+    } else if (kind == 'R') {
+      uint32_t fmt_id{};
+      LogLevel level{};
+      uint8_t arg_count{};
+      uint16_t thread_index{};
+      uint64_t timestamp_ns{};
+      uint32_t args_size{};
+      if (!read_value(p, end, fmt_id) || !read_value(p, end, level) ||
+          !read_value(p, end, arg_count) || !read_value(p, end, thread_index) ||
+          !read_value(p, end, timestamp_ns) || !read_value(p, end, args_size) ||
+          static_cast<size_t>(end - p) < args_size || fmt_id >= fmts.size() ||
+          arg_count > log_detail::k_max_args || !decode_args(p, args_size, arg_count, args.data())) {
+        return truncated();
+      }
+      p += args_size;
+      const double seconds = static_cast<double>(static_cast<int64_t>(timestamp_ns - start_ns)) *
+                             1e-9;
+      out += std::format("{:>12.6f} t{:<3} ", seconds, thread_index);
+      append_text_line(out, level, fmts[fmt_id], args.data(), arg_count);
+    } else {
+      return truncated();
+    }
+  }
+  return out;
+}
+
+}  // namespace TENG_NAMESPACE
@@ -1,16 +1,206 @@
 #pragma once
 
-#include <print>  // IWYU pragma: keep
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 #include "core/Config.hpp"
+#include "core/Result.hpp"
+
+// Messages below this level compile out entirely: 0 debug, 1 info, 2 warn, 3 error, 4 critical.
+#ifndef TENG_LOG_LEVEL
+#define TENG_LOG_LEVEL 0
+#endif
 
 namespace TENG_NAMESPACE {
 
-#define LINFO(...) std::println("" __VA_ARGS__)
-// #define LINFO(...) std::println("[info] " __VA_ARGS__)
-#define LWARN(...) std::println("[warn]     " __VA_ARGS__)
-#define LERROR(...) std::println("[error]    " __VA_ARGS__)
-#define LCRITICAL(...) std::println("[critical] " __VA_ARGS__)
-#define LDEBUG(...) std::println("[debug]   " __VA_ARGS__)
+enum class LogLevel : uint8_t { Debug, Info, Warn, Error, Critical };
+
+namespace log_detail {
+
+// Encoding of a captured argument: one tag byte, then the value (strings: u32 length + bytes).
+// The same bytes go into the per-thread rings and into binary log files.
+enum class ArgTag : uint8_t { I64, U64, F32, F64, Bool, Char, Ptr, String };
+
+inline constexpr size_t k_max_args = 16;
+
+template <typename T>
+constexpr bool is_string_arg_v =
+    std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> ||
+    std::is_same_v<T, const char*> || std::is_same_v<T, char*>;
+
+template <typename T>
+constexpr bool is_capturable_v =
+    std::is_same_v<T, bool> || std::is_same_v<T, char> || std::is_same_v<T, float> ||
+    std::is_same_v<T, double> || std::is_integral_v<T> || std::is_same_v<T, const void*> ||
+    std::is_same_v<T, void*> || std::is_same_v<T, std::nullptr_t> || is_string_arg_v<T>;
+
+template <typename T>
+size_t encoded_size(const T& value) {
+  if constexpr (is_string_arg_v<T>) {
+    return 1 + sizeof(uint32_t) + std::string_view(value).size();
+  } else if constexpr (std::is_same_v<T, float>) {
+    return 1 + sizeof(float);
+  } else if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, char>) {
+    return 2;
+  } else {
+    return 1 + sizeof(uint64_t);
+  }
+}
+
+inline std::byte* encode_raw(std::byte* out, ArgTag tag, const void* data, size_t size) {
+  *out++ = static_cast<std::byte>(tag);
+  std::memcpy(out, data, size);
+  return out + size;
+}
+
+template <typename T>
+std::byte* encode_arg(std::byte* out, const T& value) {
+  if constexpr (is_string_arg_v<T>) {
+    const std::string_view str(value);
+    const auto len = static_cast<uint32_t>(str.size());
+    out = encode_raw(out, ArgTag::String, &len, sizeof(len));
+    std::memcpy(out, str.data(), str.size());
+    return out + str.size();
+  } else if constexpr (std::is_same_v<T, bool>) {
+    return encode_raw(out, ArgTag::Bool, &value, 1);
+  } else if constexpr (std::is_same_v<T, char>) {
+    return encode_raw(out, ArgTag::Char, &value, 1);
+  } else if constexpr (std::is_same_v<T, float>) {
+    return encode_raw(out, ArgTag::F32, &value, sizeof(float));
+  } else if constexpr (std::is_same_v<T, double>) {
+    return encode_raw(out, ArgTag::F64, &value, sizeof(double));
+  } else if constexpr (std::is_pointer_v<T> || std::is_same_v<T, std::nullptr_t>) {
+    const auto bits = reinterpret_cast<uintptr_t>(static_cast<const void*>(value));
+    const uint64_t wide = bits;
+    return encode_raw(out, ArgTag::Ptr, &wide, sizeof(wide));
+  } else if constexpr (std::is_signed_v<T>) {
+    const int64_t wide = value;
+    return encode_raw(out, ArgTag::I64, &wide, sizeof(wide));
+  } else {
+    const uint64_t wide = value;
+    return encode_raw(out, ArgTag::U64, &wide, sizeof(wide));
+  }
+}
+
+// Fixed part of every record in a thread's ring; the encoded arguments follow it.
+struct RecordHeader {
+  uint32_t size;  // Whole record including arguments, padded to 8 bytes.
+  LogLevel level;
+  uint8_t arg_count;
+  uint16_t reserved;
+  uint32_t fmt_size;
+  uint32_t args_size;
+  const char* fmt;  // Points at the call site's string literal.
+  uint64_t timestamp_ns;
+};
+
+}  // namespace log_detail
+
+// Asynchronous logger behind the L* macros. The calling thread only copies the format string
+// pointer and its arguments into a lock-free ring it owns; a background thread formats and
+// writes them, merging threads by timestamp. Arguments of types that cannot be captured by value
+// (anything without a tag above, e.g. glm vectors with custom formatters) make the call site
+// format on the calling thread instead, but the write is still deferred. Critical messages flush
+// before returning, and asserts flush before aborting.
+class Logger {
+ public:
+  struct Stats {
+    uint64_t messages{};
+    uint64_t eager_formats{};  // Messages formatted on the calling thread.
+    uint64_t ring_full_stalls{};
+    uint64_t sync_writes{};  // Messages written directly (too large, or after shutdown).
+  };
+
+  static Logger& get();
+
+  Logger(const Logger&) = delete;
+  Logger& operator=(const Logger&) = delete;
+
+  // Runtime threshold on top of TENG_LOG_LEVEL.
+  void set_level(LogLevel level) { level_.store(level, std::memory_order_relaxed); }
+  [[nodiscard]] LogLevel level() const { return level_.load(std::memory_order_relaxed); }
+  void set_console_enabled(bool enabled);
+  // Writes every record, unformatted, to `path` (decode with read_binary_log or log-dump).
+  Result<void> open_binary_file(const std::filesystem::path& path);
+  void close_binary_file();
+
+  // Returns once everything logged before the call has been written.
+  void flush();
+  // Drains and stops the writer thread; later messages are written synchronously.
+  void shutdown();
+  [[nodiscard]] Stats get_stats() const;
+
+  template <typename... Args>
+  void log(LogLevel level, std::format_string<Args...> fmt, Args&&... args) {
+    if (level < level_.load(std::memory_order_relaxed)) {
+      return;
+    }
+    if constexpr ((log_detail::is_capturable_v<std::decay_t<Args>> && ...) &&
+                  sizeof...(Args) <= log_detail::k_max_args) {
+      const size_t args_size =
+          (size_t{0} + ... + log_detail::encoded_size<std::decay_t<Args>>(args));
+      if (std::byte* out = begin_record_(sizeof(log_detail::RecordHeader) + args_size)) {
+        auto* header = reinterpret_cast<log_detail::RecordHeader*>(out);
+        header->level = level;
+        header->arg_count = static_cast<uint8_t>(sizeof...(Args));
+        header->fmt = fmt.get().data();
+        header->fmt_size = static_cast<uint32_t>(fmt.get().size());
+        header->args_size = static_cast<uint32_t>(args_size);
+        std::byte* arg_out = out + sizeof(log_detail::RecordHeader);
+        ((arg_out = log_detail::encode_arg<std::decay_t<Args>>(arg_out, args)), ...);
+        commit_record_(level);
+        return;
+      }
+    } else {
+      eager_formats_.fetch_add(1, std::memory_order_relaxed);
+    }
+    log_message_(level, std::format(fmt, std::forward<Args>(args)...));
+  }
+
+ private:
+  struct Impl;
+
+  Logger();
+  ~Logger();
+
+  // Reserves a contiguous record in the calling thread's ring and fills in its header size and
+  // timestamp. Null when the message has to be written synchronously.
+  std::byte* begin_record_(size_t bytes);
+  void commit_record_(LogLevel level);
+  // Enqueues an already formatted message.
+  void log_message_(LogLevel level, std::string_view message);
+
+  Impl* impl_;
+  std::atomic<LogLevel> level_{LogLevel::Debug};
+  std::atomic<uint64_t> eager_formats_{0};
+};
+
+// Flushes the logger if it has been started; safe to call from crash paths.
+void flush_logs();
+
+// Decodes a binary log file into text, one line per record prefixed with seconds since the file
+// was opened and the logging thread's index.
+Result<std::string> read_binary_log(const std::filesystem::path& path);
+
+#define TENG_LOG_(lvl, ...)                                                   \
+  do {                                                                        \
+    if constexpr (static_cast<int>(lvl) >= TENG_LOG_LEVEL) {                  \
+      ::TENG_NAMESPACE::Logger::get().log(lvl, "" __VA_ARGS__);               \
+    }                                                                         \
+  } while (0)
+
+#define LDEBUG(...) TENG_LOG_(::TENG_NAMESPACE::LogLevel::Debug, __VA_ARGS__)
+#define LINFO(...) TENG_LOG_(::TENG_NAMESPACE::LogLevel::Info, __VA_ARGS__)
+#define LWARN(...) TENG_LOG_(::TENG_NAMESPACE::LogLevel::Warn, __VA_ARGS__)
+#define LERROR(...) TENG_LOG_(::TENG_NAMESPACE::LogLevel::Error, __VA_ARGS__)
+#define LCRITICAL(...) TENG_LOG_(::TENG_NAMESPACE::LogLevel::Critical, __VA_ARGS__)
 
 }  // namespace TENG_NAMESPACE
@@ -0,0 +1,154 @@
+#include "MappedFile.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <utility>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TENG_HAS_MMAP 1
+#else
+#define TENG_HAS_MMAP 0
+#endif
+
+#include "core/Logger.hpp"
+
+namespace TENG_NAMESPACE {
+
+namespace {
+
+std::string io_error(const std::filesystem::path& path, std::string_view action) {
+  return "failed to " + std::string(action) + " " + path.string();
+}
+
+#if TENG_HAS_MMAP
+int to_madvise(FileAccessHint hint) {
+  switch (hint) {
+    case FileAccessHint::Sequential:
+      return MADV_SEQUENTIAL;
+    case FileAccessHint::Random:
+      return MADV_RANDOM;
+    case FileAccessHint::WillNeed:
+      return MADV_WILLNEED;
+    case FileAccessHint::Normal:
+    default:
+      return MADV_NORMAL;
+  }
+}
+#endif
+
+}  // namespace
+
+Result<MappedFile> MappedFile::open(const std::filesystem::path& path, FileAccessHint hint) {
+#if TENG_HAS_MMAP
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return make_unexpected(io_error(path, "open"));
+  }
+  struct stat st{};
+  if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    ::close(fd);
+    return make_unexpected(io_error(path, "stat"));
+  }
+  MappedFile file;
+  if (st.st_size == 0) {
+    ::close(fd);
+    return file;
+  }
+  const auto size = static_cast<size_t>(st.st_size);
+  void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps its own reference to the file.
+  ::close(fd);
+  if (addr == MAP_FAILED) {
+    LWARN("mmap of {} failed, reading it into memory instead", path.string());
+    return open_buffered(path);
+  }
+  file.data_ = static_cast<const std::byte*>(addr);
+  file.size_ = size;
+  file.mapped_ = true;
+  file.advise(hint);
+  return file;
+#else
+  (void)hint;
+  return open_buffered(path);
+#endif
+}
+
+Result<MappedFile> MappedFile::open_buffered(const std::filesystem::path& path) {
+  std::ifstream in(path, std::ios::binary | std::ios::ate);
+  if (!in) {
+    return make_unexpected(io_error(path, "open"));
+  }
+  const std::streamsize size = in.tellg();
+  if (size < 0) {
+    return make_unexpected(io_error(path, "stat"));
+  }
+  MappedFile file;
+  if (size == 0) {
+    return file;
+  }
+  file.buffer_ = std::make_unique_for_overwrite<std::byte[]>(static_cast<size_t>(size));
+  in.seekg(0);
+  if (!in.read(reinterpret_cast<char*>(file.buffer_.get()), size)) {
+    return make_unexpected(io_error(path, "read"));
+  }
+  file.data_ = file.buffer_.get();
+  file.size_ = static_cast<size_t>(size);
+  return file;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      mapped_(std::exchange(other.mapped_, false)),
+      buffer_(std::move(other.buffer_)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    reset_();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    mapped_ = std::exchange(other.mapped_, false);
+    buffer_ = std::move(other.buffer_);
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() { reset_(); }
+
+void MappedFile::advise(FileAccessHint hint, size_t offset, size_t length) const {
+#if TENG_HAS_MMAP
+  if (!mapped_ || offset >= size_) {
+    return;
+  }
+  // madvise wants a page-aligned start; widen the range down to the page boundary.
+  static const auto page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  const size_t begin = offset & ~(page - 1);
+  const size_t end = offset + std::min(length, size_ - offset);
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast): madvise takes a non-const address.
+  ::madvise(const_cast<std::byte*>(data_) + begin, end - begin, to_madvise(hint));
+#else
+  (void)hint;
+  (void)offset;
+  (void)length;
+#endif
+}
+
+void MappedFile::reset_() {
+#if TENG_HAS_MMAP
+  if (mapped_) {
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast): munmap takes a non-const address.
+    ::munmap(const_cast<std::byte*>(data_), size_);
+  }
+#endif
+  data_ = nullptr;
+  size_ = 0;
+  mapped_ = false;
+  buffer_.reset();
+}
+
+}  // namespace TENG_NAMESPACE
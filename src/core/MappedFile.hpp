@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+
+#include "core/Config.hpp"
+#include "core/Result.hpp"
+
+namespace TENG_NAMESPACE {
+
+// Expected access pattern, forwarded to madvise() for mapped files.
+enum class FileAccessHint : uint8_t {
+  Normal,
+  Sequential,  // Read front to back once (parsers, hashing).
+  Random,      // Sparse reads; disables readahead.
+  WillNeed,    // Whole file is needed soon; start paging it in now.
+};
+
+// Read-only view of a whole file. On POSIX the file is mmap'd, so readers get its bytes straight
+// from the page cache without an intermediate copy. Where mapping is unavailable or fails, the
+// contents are read into an owned heap buffer instead; the interface is identical either way.
+// Move-only. The bytes stay valid until the MappedFile is destroyed or reassigned; truncating the
+// file on disk while it is mapped faults on the next access to the lost pages.
+class MappedFile {
+ public:
+  static Result<MappedFile> open(const std::filesystem::path& path,
+                                 FileAccessHint hint = FileAccessHint::Sequential);
+  // Always takes the read-into-memory fallback path.
+  static Result<MappedFile> open_buffered(const std::filesystem::path& path);
+
+  MappedFile() = default;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  [[nodiscard]] const std::byte* data() const { return data_; }
+  [[nodiscard]] size_t size() const { return size_; }
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+  [[nodiscard]] std::span<const std::byte> bytes() const { return {data_, size_}; }
+  [[nodiscard]] std::string_view text() const {
+    return {reinterpret_cast<const char*>(data_), size_};
+  }
+  // False when the contents live in a heap buffer (fallback path or empty file).
+  [[nodiscard]] bool is_mapped() const { return mapped_; }
+
+  // Updates the access hint for [offset, offset + length). No-op for buffered files.
+  void advise(FileAccessHint hint, size_t offset = 0, size_t length = SIZE_MAX) const;
+
+ private:
+  void reset_();
+
+  const std::byte* data_{};
+  size_t size_{};
+  bool mapped_{};
+  std::unique_ptr<std::byte[]> buffer_;
+};
+
+}  // namespace TENG_NAMESPACE
@@ -0,0 +1,286 @@
+#include "Metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <nlohmann/json.hpp>
+
+#include "core/EAssert.hpp"
+
+namespace TENG_NAMESPACE {
+
+namespace {
+
+constexpr double k_inf = std::numeric_limits<double>::infinity();
+
+int exponent_of(double value) {
+  int exponent{};
+  std::frexp(value, &exponent);
+  return exponent;
+}
+
+template <typename Map, typename... Args>
+auto& find_or_create(Map& map, std::string_view name, Args&&... args) {
+  auto it = map.find(name);
+  if (it == map.end()) {
+    using T = typename Map::mapped_type::element_type;
+    it = map.emplace(std::string(name), std::make_unique<T>(std::forward<Args>(args)...)).first;
+  }
+  return *it->second;
+}
+
+struct HistogramSummary {
+  uint64_t count{};
+  double sum{};
+  double mean{};
+  double min{};
+  double max{};
+  double p50{};
+  double p95{};
+  double p99{};
+};
+
+HistogramSummary summarize(const Histogram& histogram) {
+  const Histogram::Snapshot snap = histogram.snapshot();
+  return HistogramSummary{
+      .count = snap.count,
+      .sum = snap.sum,
+      .mean = snap.mean(),
+      .min = snap.min,
+      .max = snap.max,
+      .p50 = snap.quantile(0.50),
+      .p95 = snap.quantile(0.95),
+      .p99 = snap.quantile(0.99),
+  };
+}
+
+Result<void> write_text_file(const std::filesystem::path& path, const std::string& text) {
+  if (path.has_parent_path()) {
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+  }
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    return make_unexpected("failed to open " + path.string() + " for writing");
+  }
+  file << text;
+  if (!file) {
+    return make_unexpected("failed to write " + path.string());
+  }
+  return {};
+}
+
+}  // namespace
+
+Histogram::Histogram(HistogramDesc desc) : desc_(std::move(desc)) {
+  if (desc_.bounds.empty()) {
+    ALWAYS_ASSERT(desc_.lowest > 0.0 && desc_.highest > desc_.lowest && desc_.sub_buckets > 0);
+    min_exponent_ = exponent_of(desc_.lowest);
+    const int max_exponent = exponent_of(desc_.highest);
+    const auto exponents = static_cast<size_t>(max_exponent - min_exponent_ + 1);
+    bucket_count_ = 2 + (exponents * desc_.sub_buckets);
+  } else {
+    ALWAYS_ASSERT(std::ranges::is_sorted(desc_.bounds));
+    bucket_count_ = desc_.bounds.size() + 1;
+  }
+  buckets_ = std::make_unique<std::atomic<uint64_t>[]>(bucket_count_);
+  reset();
+}
+
+size_t Histogram::bucket_index_(double value) const {
+  if (!desc_.bounds.empty()) {
+    return static_cast<size_t>(std::ranges::upper_bound(desc_.bounds, value) -
+                               desc_.bounds.begin());
+  }
+  if (value < desc_.lowest) {
+    return 0;
+  }
+  int exponent{};
+  const double mantissa = std::frexp(value, &exponent);
+  const auto sub = static_cast<size_t>((mantissa * 2.0 - 1.0) * desc_.sub_buckets);
+  const size_t index =
+      1 + (static_cast<size_t>(exponent - min_exponent_) * desc_.sub_buckets) + sub;
+  return std::min(index, bucket_count_ - 1);
+}
+
+std::pair<double, double> Histogram::bucket_range(size_t bucket) const {
+  ASSERT(bucket < bucket_count_);
+  if (!desc_.bounds.empty()) {
+    return {bucket == 0 ? -k_inf : desc_.bounds[bucket - 1],
+            bucket == desc_.bounds.size() ? k_inf : desc_.bounds[bucket]};
+  }
+  if (bucket == 0) {
+    return {-k_inf, desc_.lowest};
+  }
+  const size_t j = bucket - 1;
+  const int exponent = min_exponent_ + static_cast<int>(j / desc_.sub_buckets);
+  if (bucket == bucket_count_ - 1) {
+    return {std::ldexp(1.0, exponent - 1), k_inf};
+  }
+  const double sub = static_cast<double>(j % desc_.sub_buckets);
+  const double scale = 2.0 * desc_.sub_buckets;
+  return {std::ldexp((desc_.sub_buckets + sub) / scale, exponent),
+          std::ldexp((desc_.sub_buckets + sub + 1) / scale, exponent)};
+}
+
+void Histogram::record(double value) {
+  if (std::isnan(value)) {
+    return;
+  }
+  buckets_[bucket_index_(value)].fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(value, std::memory_order_relaxed);
+  double curr = min_.load(std::memory_order_relaxed);
+  while (value < curr && !min_.compare_exchange_weak(curr, value, std::memory_order_relaxed)) {
+  }
+  curr = max_.load(std::memory_order_relaxed);
+  while (value > curr && !max_.compare_exchange_weak(curr, value, std::memory_order_relaxed)) {
+  }
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+  Snapshot snap;
+  snap.histogram_ = this;
+  snap.buckets.resize(bucket_count_);
+  for (size_t i = 0; i < bucket_count_; ++i) {
+    snap.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    snap.count += snap.buckets[i];
+  }
+  if (snap.count > 0) {
+    snap.sum = sum_.load(std::memory_order_relaxed);
+    snap.min = min_.load(std::memory_order_relaxed);
+    snap.max = max_.load(std::memory_order_relaxed);
+  }
+  return snap;
+}
+
+void Histogram::reset() {
+  for (size_t i = 0; i < bucket_count_; ++i) {
+    buckets_[i].store(0, std::memory_order_relaxed);
+  }
+  sum_.store(0.0, std::memory_order_relaxed);
+  min_.store(k_inf, std::memory_order_relaxed);
+  max_.store(-k_inf, std::memory_order_relaxed);
+}
+
+double Histogram::Snapshot::quantile(double q) const {
+  if (count == 0) {
+    return 0.0;
+  }
+  const auto rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(count))));
+  uint64_t below = 0;
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    if (below + buckets[i] < rank) {
+      below += buckets[i];
+      continue;
+    }
+    // Clamp open-ended and sparsely used buckets to what was actually recorded.
+    auto [lower, upper] = histogram_->bucket_range(i);
+    lower = std::max(lower, min);
+    upper = std::min(upper, max);
+    const double t = static_cast<double>(rank - below) / static_cast<double>(buckets[i]);
+    return std::clamp(lower + ((upper - lower) * t), min, max);
+  }
+  return max;
+}
+
+MetricsRegistry& MetricsRegistry::get() {
+  static MetricsRegistry registry;
+  return registry;
+}
+
+Counter& MetricsRegistry::counter(std::string_view name) {
+  std::scoped_lock lock(mtx_);
+  return find_or_create(counters_, name);
+}
+
+Gauge& MetricsRegistry::gauge(std::string_view name) {
+  std::scoped_lock lock(mtx_);
+  return find_or_create(gauges_, name);
+}
+
+Histogram& MetricsRegistry::histogram(std::string_view name, const HistogramDesc& desc) {
+  std::scoped_lock lock(mtx_);
+  return find_or_create(histograms_, name, desc);
+}
+
+void MetricsRegistry::for_each_counter(
+    const std::function<void(const std::string&, const Counter&)>& fn) const {
+  std::scoped_lock lock(mtx_);
+  for (const auto& [name, counter] : counters_) {
+    fn(name, *counter);
+  }
+}
+
+void MetricsRegistry::for_each_gauge(
+    const std::function<void(const std::string&, const Gauge&)>& fn) const {
+  std::scoped_lock lock(mtx_);
+  for (const auto& [name, gauge] : gauges_) {
+    fn(name, *gauge);
+  }
+}
+
+void MetricsRegistry::for_each_histogram(
+    const std::function<void(const std::string&, const Histogram&)>& fn) const {
+  std::scoped_lock lock(mtx_);
+  for (const auto& [name, histogram] : histograms_) {
+    fn(name, *histogram);
+  }
+}
+
+void MetricsRegistry::reset() {
+  std::scoped_lock lock(mtx_);
+  for (auto& [name, counter] : counters_) {
+    counter->reset();
+  }
+  for (auto& [name, gauge] : gauges_) {
+    gauge->reset();
+  }
+  for (auto& [name, histogram] : histograms_) {
+    histogram->reset();
+  }
+}
+
+std::string MetricsRegistry::to_json() const {
+  nlohmann::ordered_json counters = nlohmann::ordered_json::object();
+  nlohmann::ordered_json gauges = nlohmann::ordered_json::object();
+  nlohmann::ordered_json histograms = nlohmann::ordered_json::object();
+  for_each_counter([&](const std::string& name, const Counter& c) { counters[name] = c.value(); });
+  for_each_gauge([&](const std::string& name, const Gauge& g) { gauges[name] = g.value(); });
+  for_each_histogram([&](const std::string& name, const Histogram& h) {
+    const HistogramSummary s = summarize(h);
+    histograms[name] = {{"count", s.count}, {"sum", s.sum}, {"mean", s.mean}, {"min", s.min},
+                        {"max", s.max},     {"p50", s.p50}, {"p95", s.p95},   {"p99", s.p99}};
+  });
+  const nlohmann::ordered_json root = {
+      {"counters", counters}, {"gauges", gauges}, {"histograms", histograms}};
+  return root.dump(2);
+}
+
+std::string MetricsRegistry::to_csv() const {
+  std::string out = "name,type,count,value,mean,min,max,p50,p95,p99\n";
+  for_each_counter([&](const std::string& name, const Counter& c) {
+    out += std::format("{},counter,,{},,,,,,\n", name, c.value());
+  });
+  for_each_gauge([&](const std::string& name, const Gauge& g) {
+    out += std::format("{},gauge,,{},,,,,,\n", name, g.value());
+  });
+  for_each_histogram([&](const std::string& name, const Histogram& h) {
+    const HistogramSummary s = summarize(h);
+    out += std::format("{},histogram,{},{},{},{},{},{},{},{}\n", name, s.count, s.sum, s.mean,
+                       s.min, s.max, s.p50, s.p95, s.p99);
+  });
+  return out;
+}
+
+Result<void> MetricsRegistry::write_json(const std::filesystem::path& path) const {
+  return write_text_file(path, to_json());
+}
+
+Result<void> MetricsRegistry::write_csv(const std::filesystem::path& path) const {
+  return write_text_file(path, to_csv());
+}
+
+}  // namespace TENG_NAMESPACE
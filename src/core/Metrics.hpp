@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/Config.hpp"
+#include "core/Result.hpp"
+
+namespace TENG_NAMESPACE {
+
+// Monotonic event count. add() is a relaxed atomic increment, safe from any thread.
+class Counter {
+ public:
+  void add(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+  [[nodiscard]] uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+  void reset() { value_.store(0, std::memory_order_relaxed); }
+
+ private:
+  std::atomic<uint64_t> value_{0};
+};
+
+// Last written value (e.g. a pool size or memory budget).
+class Gauge {
+ public:
+  void set(double value) { value_.store(value, std::memory_order_relaxed); }
+  void add(double delta) { value_.fetch_add(delta, std::memory_order_relaxed); }
+  [[nodiscard]] double value() const { return value_.load(std::memory_order_relaxed); }
+  void reset() { set(0.0); }
+
+ private:
+  std::atomic<double> value_{0.0};
+};
+
+struct HistogramDesc {
+  // Log-linear (HDR-style) buckets covering [lowest, highest]: each power of two is split into
+  // `sub_buckets` linear buckets, so quantiles are within 1 / sub_buckets relative error.
+  double lowest{1e-3};
+  double highest{1e6};
+  uint32_t sub_buckets{32};
+  // When non-empty, fixed bucket upper bounds (ascending) replace the log-linear layout.
+  std::vector<double> bounds;
+};
+
+// Distribution of recorded values. record() costs a bucket computation and a few relaxed atomic
+// RMWs, so it is fine on hot paths and from any thread. Quantiles are taken on a snapshot and
+// interpolated within the bucket they fall into.
+class Histogram {
+ public:
+  struct Snapshot {
+    uint64_t count{};
+    double sum{};
+    double min{};
+    double max{};
+    std::vector<uint64_t> buckets;
+
+    [[nodiscard]] double mean() const { return count ? sum / static_cast<double>(count) : 0.0; }
+    // q in [0, 1]; 0 when empty.
+    [[nodiscard]] double quantile(double q) const;
+
+   private:
+    friend class Histogram;
+    const Histogram* histogram_{};
+  };
+
+  explicit Histogram(HistogramDesc desc = {});
+  Histogram(const Histogram&) = delete;
+  Histogram& operator=(const Histogram&) = delete;
+
+  void record(double value);
+  [[nodiscard]] Snapshot snapshot() const;
+  void reset();
+
+  [[nodiscard]] const HistogramDesc& desc() const { return desc_; }
+  [[nodiscard]] size_t bucket_count() const { return bucket_count_; }
+  // [lower, upper) value range of a bucket. The first and last buckets catch values outside the
+  // covered range; their open ends are reported as -inf / +inf.
+  [[nodiscard]] std::pair<double, double> bucket_range(size_t bucket) const;
+
+ private:
+  [[nodiscard]] size_t bucket_index_(double value) const;
+
+  HistogramDesc desc_;
+  int min_exponent_{};
+  size_t bucket_count_{};
+  std::unique_ptr<std::atomic<uint64_t>[]> buckets_;
+  std::atomic<double> sum_{0.0};
+  std::atomic<double> min_;
+  std::atomic<double> max_;
+};
+
+// Records the scope's duration in milliseconds.
+class ScopedHistogramTimer {
+ public:
+  explicit ScopedHistogramTimer(Histogram& histogram)
+      : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+  ~ScopedHistogramTimer() {
+    histogram_.record(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                                                start_)
+                          .count());
+  }
+  ScopedHistogramTimer(const ScopedHistogramTimer&) = delete;
+  ScopedHistogramTimer& operator=(const ScopedHistogramTimer&) = delete;
+
+ private:
+  Histogram& histogram_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+// Named metrics shared by every subsystem. Lookups take a lock, so call sites resolve a metric
+// once and keep the reference (metrics live as long as the registry). Names are dotted paths,
+// e.g. "engine.frame_ms"; time histograms are in milliseconds by convention (suffix _ms).
+class MetricsRegistry {
+ public:
+  static MetricsRegistry& get();
+
+  Counter& counter(std::string_view name);
+  Gauge& gauge(std::string_view name);
+  // `desc` only applies when the histogram is created.
+  Histogram& histogram(std::string_view name, const HistogramDesc& desc = {});
+
+  // Visits metrics in name order.
+  void for_each_counter(const std::function<void(const std::string&, const Counter&)>& fn) const;
+  void for_each_gauge(const std::function<void(const std::string&, const Gauge&)>& fn) const;
+  void for_each_histogram(
+      const std::function<void(const std::string&, const Histogram&)>& fn) const;
+
+  // Zeroes every metric; registrations and references stay valid.
+  void reset();
+
+  // Histograms are summarized as count/mean/min/max/p50/p95/p99.
+  [[nodiscard]] std::string to_json() const;
+  [[nodiscard]] std::string to_csv() const;
+  Result<void> write_json(const std::filesystem::path& path) const;
+  Result<void> write_csv(const std::filesystem::path& path) const;
+
+ private:
+  mutable std::mutex mtx_;
+  std::map<std::string, std::unique_ptr<Counter>, std::less<>> counters_;
+  std::map<std::string, std::unique_ptr<Gauge>, std::less<>> gauges_;
+  std::map<std::string, std::unique_ptr<Histogram>, std::less<>> histograms_;
+};
+
+}  // namespace TENG_NAMESPACE
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <shared_mutex>
 #include <utility>
@@ -286,6 +289,214 @@ struct BlockPool {
   }
 };
 
+// BlockPool with wait-free get(). Blocks are never moved or freed while the pool lives, so an
+// entry's address is stable; get() is two acquire loads and a generation compare, no lock.
+// alloc/destroy go through a lock-free free list (Treiber stack with an ABA tag); only growing by
+// a block takes a mutex. As with BlockPool, using a handle concurrently with its destroy() is a
+// caller bug; stale handles from earlier generations are rejected.
+// for_each and clear must not race with alloc/destroy.
+template <typename HandleT, typename ObjectT>
+struct AtomicBlockPool {
+  static_assert(std::is_default_constructible_v<ObjectT>, "ObjectT must be default constructible");
+
+  static constexpr uint32_t k_max_blocks = 1024;
+
+  AtomicBlockPool(size_t element_count_per_block, size_t initial_blocks, bool do_destroy)
+      : element_count_per_block_(static_cast<uint16_t>(element_count_per_block)),
+        do_destroy_(do_destroy) {
+    ASSERT(element_count_per_block > 0 && element_count_per_block <= UINT16_MAX);
+    std::unique_lock lock(grow_mtx_);
+    for (size_t i = 0; i < initial_blocks; i++) {
+      add_block();
+    }
+  }
+
+  AtomicBlockPool& operator=(AtomicBlockPool&& other) = delete;
+  AtomicBlockPool& operator=(const AtomicBlockPool& other) = delete;
+  AtomicBlockPool(const AtomicBlockPool& other) = delete;
+  AtomicBlockPool(AtomicBlockPool&& other) = delete;
+
+  ~AtomicBlockPool() { free_blocks(); }
+
+  struct Entry {
+    ObjectT object{};
+    std::atomic<uint32_t> gen_{1};
+    // Free list link: combined handle index + 1 of the next free entry, 0 terminates.
+    std::atomic<uint32_t> next_free_{};
+    std::atomic<bool> live_{false};
+  };
+
+  template <typename... Args>
+  HandleT alloc(Args&&... args) {
+    uint32_t idx = pop_free();
+    while (idx == k_null) {
+      grow();
+      idx = pop_free();
+    }
+    Entry& entry = get_entry(idx);
+    std::destroy_at(std::addressof(entry.object));
+    ::new (std::addressof(entry.object)) ObjectT{std::forward<Args>(args)...};
+    entry.live_.store(true, std::memory_order_relaxed);
+    num_created_.fetch_add(1, std::memory_order_relaxed);
+    size_.fetch_add(1, std::memory_order_relaxed);
+    return HandleT{idx - 1, entry.gen_.load(std::memory_order_relaxed)};
+  }
+
+  void destroy(HandleT handle) {
+    Entry* entry = find_entry(handle.get_idx());
+    if (!entry) {
+      return;
+    }
+    // The CAS makes a racing double destroy of the same handle free the entry once.
+    uint32_t gen = handle.get_gen();
+    if (gen == 0 ||
+        !entry->gen_.compare_exchange_strong(gen, gen + 1, std::memory_order_acq_rel)) {
+      return;
+    }
+    if (do_destroy_) {
+      entry->object = {};
+    }
+    entry->live_.store(false, std::memory_order_relaxed);
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    num_destroyed_.fetch_add(1, std::memory_order_relaxed);
+    push_free(handle.get_idx() + 1);
+  }
+
+  ObjectT* get(HandleT handle) {
+    Entry* entry = find_entry(handle.get_idx());
+    if (!entry || !handle.get_gen() ||
+        entry->gen_.load(std::memory_order_acquire) != handle.get_gen()) {
+      return nullptr;
+    }
+    return &entry->object;
+  }
+  const ObjectT* get(HandleT handle) const {
+    return const_cast<AtomicBlockPool*>(this)->get(handle);
+  }
+
+  void for_each(auto&& f) {
+    const uint32_t block_count = num_blocks();
+    for (uint32_t block = 0; block < block_count; block++) {
+      Entry* entries = blocks_[block].load(std::memory_order_acquire);
+      for (uint32_t i = 0; i < element_count_per_block_; i++) {
+        if (entries[i].live_.load(std::memory_order_relaxed)) {
+          f(entries[i].object);
+        }
+      }
+    }
+  }
+
+  void clear() {
+    std::unique_lock lock(grow_mtx_);
+    free_blocks();
+    free_head_.store(0, std::memory_order_relaxed);
+    size_.store(0, std::memory_order_relaxed);
+    num_created_.store(0, std::memory_order_relaxed);
+    num_destroyed_.store(0, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] size_t size() const { return size_.load(std::memory_order_relaxed); }
+  [[nodiscard]] bool empty() const { return size() == 0; }
+  [[nodiscard]] size_t get_num_created() const {
+    return num_created_.load(std::memory_order_relaxed);
+  }
+  [[nodiscard]] size_t get_num_destroyed() const {
+    return num_destroyed_.load(std::memory_order_relaxed);
+  }
+  [[nodiscard]] uint32_t num_blocks() const {
+    return num_blocks_.load(std::memory_order_acquire);
+  }
+
+ private:
+  static constexpr uint32_t k_null = 0;
+
+  Entry* find_entry(uint32_t handle_idx) {
+    const uint32_t block = handle_idx >> 16;
+    const uint32_t idx = handle_idx & 0xFFFFu;
+    if (block >= num_blocks() || idx >= element_count_per_block_) {
+      return nullptr;
+    }
+    return &blocks_[block].load(std::memory_order_relaxed)[idx];
+  }
+  Entry& get_entry(uint32_t idx_plus_one) {
+    Entry* entry = find_entry(idx_plus_one - 1);
+    ASSERT(entry);
+    return *entry;
+  }
+
+  // free_head_ packs an ABA tag (high 32 bits) with the head's index + 1 (low 32 bits). Entries
+  // are never freed, so reading a popped entry's next_free_ is always safe; the tag makes the CAS
+  // fail if the head was popped and pushed back in between.
+  uint32_t pop_free() {
+    uint64_t head = free_head_.load(std::memory_order_acquire);
+    while (true) {
+      const auto idx = static_cast<uint32_t>(head);
+      if (idx == k_null) {
+        return k_null;
+      }
+      const uint32_t next = get_entry(idx).next_free_.load(std::memory_order_relaxed);
+      const uint64_t new_head = ((head >> 32) + 1) << 32 | next;
+      if (free_head_.compare_exchange_weak(head, new_head, std::memory_order_acquire,
+                                           std::memory_order_acquire)) {
+        return idx;
+      }
+    }
+  }
+
+  // Pushes the chain first..last (already linked through next_free_).
+  void push_free_chain(uint32_t first, uint32_t last) {
+    uint64_t head = free_head_.load(std::memory_order_relaxed);
+    while (true) {
+      get_entry(last).next_free_.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+      const uint64_t new_head = ((head >> 32) + 1) << 32 | first;
+      if (free_head_.compare_exchange_weak(head, new_head, std::memory_order_release,
+                                           std::memory_order_relaxed)) {
+        return;
+      }
+    }
+  }
+  void push_free(uint32_t idx_plus_one) { push_free_chain(idx_plus_one, idx_plus_one); }
+
+  void grow() {
+    std::unique_lock lock(grow_mtx_);
+    // Another thread may have grown (or entries were destroyed) while we waited.
+    if (static_cast<uint32_t>(free_head_.load(std::memory_order_acquire)) != k_null) {
+      return;
+    }
+    add_block();
+  }
+
+  void add_block() {
+    const uint32_t block = num_blocks_.load(std::memory_order_relaxed);
+    ALWAYS_ASSERT(block < k_max_blocks);
+    auto* entries = new Entry[element_count_per_block_];
+    const uint32_t base = (block << 16) + 1;
+    for (uint32_t i = 0; i + 1 < element_count_per_block_; i++) {
+      entries[i].next_free_.store(base + i + 1, std::memory_order_relaxed);
+    }
+    blocks_[block].store(entries, std::memory_order_relaxed);
+    num_blocks_.store(block + 1, std::memory_order_release);
+    push_free_chain(base, base + element_count_per_block_ - 1);
+  }
+
+  void free_blocks() {
+    const uint32_t block_count = num_blocks_.exchange(0, std::memory_order_acq_rel);
+    for (uint32_t block = 0; block < block_count; block++) {
+      delete[] blocks_[block].exchange(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  std::array<std::atomic<Entry*>, k_max_blocks> blocks_{};
+  std::atomic<uint32_t> num_blocks_{};
+  std::atomic<uint64_t> free_head_{};
+  std::atomic<size_t> size_{};
+  std::atomic<size_t> num_created_{};
+  std::atomic<size_t> num_destroyed_{};
+  std::mutex grow_mtx_;
+  uint16_t element_count_per_block_{};
+  bool do_destroy_{};
+};
+
 template <typename ObjectT, uint32_t ElementsPerBlock = 64>
 struct BlockPool2 {
   struct Block {
@@ -0,0 +1,290 @@
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace TENG_NAMESPACE {
+
+namespace profiler_detail {
+
+// Single-producer (owning thread) / single-consumer (frame_mark caller) ring of closed zones.
+// When full, new zones are dropped and counted rather than overwriting unread ones.
+struct ThreadBuffer {
+  static constexpr uint64_t k_capacity = 1u << 15;
+
+  // Allocated by the owner on its first zone; only read for slots published through `head`.
+  std::unique_ptr<ProfileEvent[]> events;
+  std::atomic<uint64_t> head{0};
+  std::atomic<uint64_t> tail{0};
+  std::atomic<uint64_t> dropped{0};
+  std::atomic<bool> retired{false};
+  uint32_t tid{};
+  std::string name;  // Guarded by the registry mutex.
+};
+
+}  // namespace profiler_detail
+
+namespace {
+
+using profiler_detail::ThreadBuffer;
+
+struct Registry {
+  std::mutex mtx;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+  uint32_t next_tid{1};
+};
+
+// Leaked so threads that outlive static destruction can still retire their buffers.
+Registry& registry() {
+  static auto* reg = new Registry;
+  return *reg;
+}
+
+thread_local ThreadBuffer* t_buffer = nullptr;
+thread_local bool t_buffer_dead = false;
+
+// Marks the thread's buffer for removal once it has been drained.
+struct BufferRetirer {
+  bool armed{};
+  ~BufferRetirer() {
+    if (t_buffer) {
+      t_buffer->retired.store(true, std::memory_order_release);
+    }
+    t_buffer = nullptr;
+    t_buffer_dead = true;
+  }
+};
+thread_local BufferRetirer t_retirer;
+
+ThreadBuffer* thread_buffer() {
+  if (t_buffer || t_buffer_dead) {
+    return t_buffer;
+  }
+  t_retirer.armed = true;
+  auto buffer = std::make_unique<ThreadBuffer>();
+  Registry& reg = registry();
+  std::scoped_lock lock(reg.mtx);
+  buffer->tid = reg.next_tid++;
+  buffer->name = std::format("thread {}", buffer->tid);
+  t_buffer = buffer.get();
+  reg.buffers.push_back(std::move(buffer));
+  return t_buffer;
+}
+
+void append_json_string(std::string& out, std::string_view s) {
+  out += '"';
+  for (const char c : s) {
+    switch (c) {
+      case '"':
+        out += "\\\"";
+        break;
+      case '\\':
+        out += "\\\\";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          out += std::format("\\u{:04x}", static_cast<unsigned>(c));
+        } else {
+          out += c;
+        }
+    }
+  }
+  out += '"';
+}
+
+}  // namespace
+
+size_t ProfileCapture::event_count() const {
+  size_t count = 0;
+  for (const Thread& thread : threads) {
+    count += thread.events.size();
+  }
+  return count;
+}
+
+std::string ProfileCapture::to_chrome_trace_json() const {
+  const auto to_us = [this](uint64_t ns) {
+    return static_cast<double>(ns - std::min(ns, begin_ns)) / 1000.0;
+  };
+  std::string out;
+  out.reserve(256 + (event_count() * 96));
+  out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  const auto begin_event = [&] {
+    out += first ? "\n" : ",\n";
+    first = false;
+  };
+  for (const Thread& thread : threads) {
+    begin_event();
+    out += std::format(R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":)",
+                       thread.tid);
+    append_json_string(out, thread.name);
+    out += "}}";
+  }
+  for (size_t i = 0; i < frame_begin_ns.size(); ++i) {
+    begin_event();
+    out += std::format(R"({{"name":"frame {}","ph":"i","s":"g","pid":1,"tid":0,"ts":{:.3f}}})", i,
+                       to_us(frame_begin_ns[i]));
+  }
+  for (const Thread& thread : threads) {
+    for (const ProfileEvent& event : thread.events) {
+      begin_event();
+      out += "{\"name\":";
+      append_json_string(out, event.name);
+      out += std::format(R"(,"ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}})", thread.tid,
+                         to_us(event.begin_ns),
+                         static_cast<double>(event.end_ns - event.begin_ns) / 1000.0);
+    }
+  }
+  out += "\n]}\n";
+  return out;
+}
+
+Result<void> ProfileCapture::write_chrome_trace(const std::filesystem::path& path) const {
+  if (path.has_parent_path()) {
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+  }
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    return make_unexpected("failed to open " + path.string() + " for writing");
+  }
+  file << to_chrome_trace_json();
+  if (!file) {
+    return make_unexpected("failed to write " + path.string());
+  }
+  return {};
+}
+
+Profiler& Profiler::get() {
+  static Profiler profiler;
+  return profiler;
+}
+
+void Profiler::record(const char* name, uint64_t begin_ns, uint64_t end_ns) {
+  ThreadBuffer* buffer = thread_buffer();
+  if (!buffer) {
+    return;
+  }
+  if (!buffer->events) {
+    buffer->events = std::make_unique_for_overwrite<ProfileEvent[]>(ThreadBuffer::k_capacity);
+  }
+  const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+  if (head - buffer->tail.load(std::memory_order_acquire) >= ThreadBuffer::k_capacity) {
+    buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  buffer->events[head & (ThreadBuffer::k_capacity - 1)] =
+      ProfileEvent{.name = name, .begin_ns = begin_ns, .end_ns = end_ns};
+  buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::set_thread_name(std::string_view name) {
+  ThreadBuffer* buffer = thread_buffer();
+  if (!buffer) {
+    return;
+  }
+  std::scoped_lock lock(registry().mtx);
+  buffer->name = name;
+}
+
+bool Profiler::request_capture(uint32_t frames) {
+  if (frames == 0 || capturing() || requested_frames_ > 0) {
+    return false;
+  }
+  requested_frames_ = frames;
+  return true;
+}
+
+std::optional<ProfileCapture> Profiler::frame_mark() {
+  if (!capturing()) {
+    if (requested_frames_ > 0) {
+      remaining_frames_ = std::exchange(requested_frames_, 0);
+      begin_capture();
+      capture_.frame_begin_ns.push_back(capture_.begin_ns);
+    }
+    return std::nullopt;
+  }
+  if (remaining_frames_ > 0 && --remaining_frames_ == 0) {
+    return end_capture();
+  }
+  std::scoped_lock lock(registry().mtx);
+  drain_();
+  capture_.frame_begin_ns.push_back(now_ns());
+  return std::nullopt;
+}
+
+void Profiler::begin_capture() {
+  Registry& reg = registry();
+  std::scoped_lock lock(reg.mtx);
+  // Zones left over from an earlier capture closed after it ended; discard them.
+  for (const auto& buffer : reg.buffers) {
+    buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_release);
+    buffer->dropped.store(0, std::memory_order_relaxed);
+  }
+  std::erase_if(reg.buffers, [](const std::unique_ptr<ThreadBuffer>& buffer) {
+    return buffer->retired.load(std::memory_order_acquire);
+  });
+  capture_ = ProfileCapture{};
+  capture_.begin_ns = now_ns();
+  s_capturing.store(true, std::memory_order_relaxed);
+}
+
+ProfileCapture Profiler::end_capture() {
+  s_capturing.store(false, std::memory_order_relaxed);
+  remaining_frames_ = 0;
+  {
+    std::scoped_lock lock(registry().mtx);
+    drain_();
+  }
+  capture_.end_ns = now_ns();
+  for (ProfileCapture::Thread& thread : capture_.threads) {
+    // Zones are recorded as they close (inner first); viewers want parents before children.
+    std::ranges::sort(thread.events, [](const ProfileEvent& a, const ProfileEvent& b) {
+      return a.begin_ns != b.begin_ns ? a.begin_ns < b.begin_ns : a.end_ns > b.end_ns;
+    });
+  }
+  std::ranges::sort(capture_.threads, {}, &ProfileCapture::Thread::tid);
+  return std::exchange(capture_, ProfileCapture{});
+}
+
+void Profiler::drain_() {
+  Registry& reg = registry();
+  for (auto& buffer : reg.buffers) {
+    // Read `retired` first: once set, the owner will not publish anything after `head`.
+    const bool retired = buffer->retired.load(std::memory_order_acquire);
+    const uint64_t head = buffer->head.load(std::memory_order_acquire);
+    uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+    capture_.dropped_events += buffer->dropped.exchange(0, std::memory_order_relaxed);
+    if (tail == head) {
+      if (retired) {
+        buffer.reset();
+      }
+      continue;
+    }
+    auto it = std::ranges::find(capture_.threads, buffer->tid, &ProfileCapture::Thread::tid);
+    if (it == capture_.threads.end()) {
+      capture_.threads.push_back(
+          ProfileCapture::Thread{.tid = buffer->tid, .name = buffer->name, .events = {}});
+      it = std::prev(capture_.threads.end());
+    }
+    for (; tail != head; ++tail) {
+      const ProfileEvent& event = buffer->events[tail & (ThreadBuffer::k_capacity - 1)];
+      // Zones opened before this capture began belong to an earlier one.
+      if (event.begin_ns >= capture_.begin_ns) {
+        it->events.push_back(event);
+      }
+    }
+    buffer->tail.store(head, std::memory_order_release);
+    if (retired) {
+      buffer.reset();
+    }
+  }
+  std::erase(reg.buffers, nullptr);
+}
+
+}  // namespace TENG_NAMESPACE
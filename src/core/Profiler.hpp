@@ -0,0 +1,127 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tracy/Tracy.hpp>
+#include <vector>
+
+#include "core/Config.hpp"
+#include "core/Result.hpp"
+
+namespace TENG_NAMESPACE {
+
+// One closed zone. `name` points at a string literal or __func__, never owned.
+struct ProfileEvent {
+  const char* name{};
+  uint64_t begin_ns{};
+  uint64_t end_ns{};
+};
+
+// Result of a frame capture: every zone that closed on any thread while it was recording.
+struct ProfileCapture {
+  struct Thread {
+    uint32_t tid{};
+    std::string name;
+    std::vector<ProfileEvent> events;  // Sorted by begin time, outer zones first.
+  };
+
+  uint64_t begin_ns{};
+  uint64_t end_ns{};
+  std::vector<uint64_t> frame_begin_ns;
+  std::vector<Thread> threads;
+  // Zones lost because a thread's ring filled up between two frame marks.
+  uint64_t dropped_events{};
+
+  [[nodiscard]] size_t event_count() const;
+  // Chrome trace event format (chrome://tracing, ui.perfetto.dev): one complete ("X") event per
+  // zone, thread names as metadata and a global instant event per frame.
+  [[nodiscard]] std::string to_chrome_trace_json() const;
+  Result<void> write_chrome_trace(const std::filesystem::path& path) const;
+};
+
+// In-process CPU profiler behind ZoneScoped / ZoneScopedN. Zones are recorded only while a capture
+// is active: each thread appends closed zones to its own fixed-size SPSC ring, and the thread
+// calling frame_mark() drains the rings once per frame. Outside a capture a zone costs one relaxed
+// load. Tracy still receives every zone when it is enabled.
+class Profiler {
+ public:
+  static Profiler& get();
+
+  [[nodiscard]] static bool capturing() { return s_capturing.load(std::memory_order_relaxed); }
+  [[nodiscard]] static uint64_t now_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+  }
+
+  // Called by ProfileScope when a zone that opened during a capture closes.
+  static void record(const char* name, uint64_t begin_ns, uint64_t end_ns);
+  // Label for the calling thread in captures.
+  static void set_thread_name(std::string_view name);
+
+  // Records the next `frames` frames, starting at the next frame_mark(). Returns false while a
+  // capture is already pending or active. Capture control (this, frame_mark, begin/end_capture)
+  // belongs to a single thread, normally the main loop.
+  bool request_capture(uint32_t frames);
+  // Frame boundary, called by the main loop once per frame. Returns the capture once its last
+  // requested frame has ended.
+  std::optional<ProfileCapture> frame_mark();
+
+  // Manual control for tools and tests; frame_mark() is the usual driver.
+  void begin_capture();
+  ProfileCapture end_capture();
+  [[nodiscard]] bool capture_active() const { return capturing(); }
+
+ private:
+  Profiler() = default;
+  void drain_();
+
+  inline static std::atomic<bool> s_capturing{false};
+
+  uint32_t requested_frames_{};
+  uint32_t remaining_frames_{};
+  ProfileCapture capture_;
+};
+
+// RAII zone. Reads the clock only when a capture is active at construction.
+class ProfileScope {
+ public:
+  explicit ProfileScope(const char* name) {
+    if (Profiler::capturing()) {
+      name_ = name;
+      begin_ns_ = Profiler::now_ns();
+    }
+  }
+  ~ProfileScope() {
+    if (name_ != nullptr) {
+      Profiler::record(name_, begin_ns_, Profiler::now_ns());
+    }
+  }
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+
+ private:
+  const char* name_{};
+  uint64_t begin_ns_{};
+};
+
+}  // namespace TENG_NAMESPACE
+
+#define TENG_PROFILE_CONCAT_IMPL(a, b) a##b
+#define TENG_PROFILE_CONCAT(a, b) TENG_PROFILE_CONCAT_IMPL(a, b)
+
+// Same zone macros as Tracy, also feeding the built-in profiler. Include this header instead of
+// <tracy/Tracy.hpp>.
+#undef ZoneScoped
+#undef ZoneScopedN
+#define ZoneScoped                       \
+  ZoneNamed(___tracy_scoped_zone, true); \
+  const ::TENG_NAMESPACE::ProfileScope TENG_PROFILE_CONCAT(teng_profile_scope_, __LINE__)(__func__)
+#define ZoneScopedN(name)                      \
+  ZoneNamedN(___tracy_scoped_zone, name, true); \
+  const ::TENG_NAMESPACE::ProfileScope TENG_PROFILE_CONCAT(teng_profile_scope_, __LINE__)(name)
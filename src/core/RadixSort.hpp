@@ -0,0 +1,67 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+
+#include "core/Config.hpp"
+#include "core/EAssert.hpp"
+
+namespace TENG_NAMESPACE {
+
+// Order-preserving unsigned key for a signed value, for building radix sort keys.
+[[nodiscard]] constexpr uint32_t radix_key(int32_t value) {
+  return static_cast<uint32_t>(value) ^ 0x8000'0000u;
+}
+
+// Stable LSD radix sort of `items` by the unsigned 64-bit key `key_of(item)`, 8 bits per pass.
+// All eight byte histograms are built in one read of the input, and passes over bytes that are
+// the same in every key are skipped, so e.g. small GUIDs or 32-bit keys cost only the passes they
+// need. `scratch` must hold at least items.size() elements; its contents are clobbered. Sort by
+// several keys by sorting by the least significant one first.
+template <typename T, typename KeyFn>
+void radix_sort(std::span<T> items, std::span<T> scratch, KeyFn&& key_of) {
+  const size_t count = items.size();
+  if (count < 2) {
+    return;
+  }
+  ASSERT(scratch.size() >= count);
+  ASSERT(count <= std::numeric_limits<uint32_t>::max());
+
+  constexpr size_t k_passes = sizeof(uint64_t);
+  std::array<std::array<uint32_t, 256>, k_passes> histograms{};
+  for (const T& item : items) {
+    const uint64_t key = key_of(item);
+    for (size_t pass = 0; pass < k_passes; ++pass) {
+      ++histograms[pass][(key >> (pass * 8)) & 0xff];
+    }
+  }
+
+  T* src = items.data();
+  T* dst = scratch.data();
+  for (size_t pass = 0; pass < k_passes; ++pass) {
+    const size_t shift = pass * 8;
+    std::array<uint32_t, 256>& offsets = histograms[pass];
+    if (offsets[(key_of(src[0]) >> shift) & 0xff] == count) {
+      continue;
+    }
+    uint32_t sum = 0;
+    for (uint32_t& bucket : offsets) {
+      sum += std::exchange(bucket, sum);
+    }
+    for (size_t i = 0; i < count; ++i) {
+      const size_t bucket = (key_of(src[i]) >> shift) & 0xff;
+      dst[offsets[bucket]++] = std::move(src[i]);
+    }
+    std::swap(src, dst);
+  }
+  if (src != items.data()) {
+    std::move(src, src + count, items.data());
+  }
+}
+
+}  // namespace TENG_NAMESPACE
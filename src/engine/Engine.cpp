@@ -2,11 +2,13 @@
 
 #include <GLFW/glfw3.h>
 
+#include <chrono>
 #include <cstdlib>
 #include <filesystem>
+#include <format>
 #include <memory>
+#include <optional>
 #include <ranges>
-#include <tracy/Tracy.hpp>
 #include <utility>
 
 #include "Window.hpp"
@@ -14,7 +16,10 @@
 #include "core/Diagnostic.hpp"
 #include "core/EAssert.hpp"
 #include "core/Logger.hpp"
+#include "core/Metrics.hpp"
+#include "core/Profiler.hpp"
 #include "core/TomlUtil.hpp"
+#include "engine/EngineCVars.hpp"
 #include "engine/assets/AssetService.hpp"
 #include "engine/render/RenderService.hpp"
 #include "engine/scene/BuiltinComponentSerialization.hpp"
@@ -22,6 +27,7 @@
 #include "engine/scene/SceneComponentContext.hpp"
 #include "engine/scene/SceneSerialization.hpp"
 #include "engine/scene/SceneSerializationContext.hpp"
+#include "gfx/renderer/RendererCVars.hpp"
 #include "gfx/rhi/Device.hpp"
 #include "gfx/rhi/Swapchain.hpp"
 #include "imgui.h"
@@ -30,6 +36,26 @@ namespace teng::engine {
 
 namespace {
 
+struct EngineMetrics {
+  Histogram& frame_ms;
+  Histogram& scene_tick_ms;
+  Histogram& layers_update_ms;
+  Histogram& render_ms;
+  Counter& frames;
+};
+
+EngineMetrics& engine_metrics() {
+  MetricsRegistry& registry = MetricsRegistry::get();
+  static EngineMetrics metrics{
+      .frame_ms = registry.histogram("engine.frame_ms"),
+      .scene_tick_ms = registry.histogram("engine.scene_tick_ms"),
+      .layers_update_ms = registry.histogram("engine.layers_update_ms"),
+      .render_ms = registry.histogram("engine.render_ms"),
+      .frames = registry.counter("engine.frames"),
+  };
+  return metrics;
+}
+
 std::filesystem::path find_resource_dir() {
   std::filesystem::path curr_path = std::filesystem::current_path();
   while (curr_path.has_parent_path()) {
@@ -41,6 +67,13 @@ std::filesystem::path find_resource_dir() {
   return {};
 }
 
+glm::uvec2 headless_extent(const EngineConfig& config) {
+  return {config.initial_window_width > 0 ? static_cast<uint32_t>(config.initial_window_width)
+                                          : 1280u,
+          config.initial_window_height > 0 ? static_cast<uint32_t>(config.initial_window_height)
+                                           : 720u};
+}
+
 }  // namespace
 
 LayerStack::~LayerStack() { clear(); }
@@ -119,6 +152,7 @@ void Engine::init() {
     return;
   }
 
+  Profiler::set_thread_name("main");
   init_resource_paths();
   std::filesystem::current_path(resource_dir_.parent_path());
   local_resource_dir_ = resource_dir_ / "local";
@@ -126,6 +160,7 @@ void Engine::init() {
     std::filesystem::create_directories(local_resource_dir_);
   }
   CVarSystem::get().load_from_file((local_resource_dir_ / "cvars.txt").string());
+  CVarSystem::get().apply_pending_changes();
 
   scene::ComponentRegistryBuilder component_registry_builder;
   register_core_components(component_registry_builder);
@@ -155,39 +190,46 @@ void Engine::init() {
 
   scenes_ = std::make_unique<SceneManager>(*frozen_scene_component_ctx_);
 
-  window_ = create_platform_window();
-  Window::InitInfo win_init_info{
-      .key_callback_fn =
-          [this](int key, int action, int mods) {
-            pending_key_events_.push_back(KeyEvent{.key = key, .action = action, .mods = mods});
-          },
-      .cursor_pos_callback_fn =
-          [this](double x, double y) {
-            pending_cursor_events_.push_back(CursorEvent{.x = x, .y = y});
-          },
-      .win_dims_x = config_.initial_window_width,
-      .win_dims_y = config_.initial_window_height,
-      .floating_window = config_.floating_window,
-  };
-  window_->init(win_init_info);
-  window_->set_window_position(config_.initial_window_position);
+  const gfx::rhi::GfxAPI gfx_api = resolve_gfx_api();
+  // The null device never presents, so it runs without a window (or a display to open one on).
+  if (gfx_api != gfx::rhi::GfxAPI::Null) {
+    window_ = create_platform_window();
+    Window::InitInfo win_init_info{
+        .key_callback_fn =
+            [this](int key, int action, int mods) {
+              pending_key_events_.push_back(KeyEvent{.key = key, .action = action, .mods = mods});
+            },
+        .cursor_pos_callback_fn =
+            [this](double x, double y) {
+              pending_cursor_events_.push_back(CursorEvent{.x = x, .y = y});
+            },
+        .win_dims_x = config_.initial_window_width,
+        .win_dims_y = config_.initial_window_height,
+        .floating_window = config_.floating_window,
+    };
+    window_->init(win_init_info);
+    window_->set_window_position(config_.initial_window_position);
+  }
 
-  device_ = gfx::rhi::create_device(resolve_gfx_api());
+  device_ = gfx::rhi::create_device(gfx_api);
   device_->init({
       .shader_lib_dir = resource_dir_ / "shader_out",
       .app_name = config_.app_name,
       .frames_in_flight = 3,
+      .async_compute = gfx::renderer_cv::developer_render_graph_async_compute.get() != 0,
   });
 
-  const auto win_dims = window_->get_window_size();
+  // Headless, the null device backs the swapchain with offscreen images and no surface.
+  const glm::uvec2 output_dims = window_ ? window_->get_window_size() : headless_extent(config_);
   swapchain_ = device_->create_swapchain_h(gfx::rhi::SwapchainDesc{
       .window = window_.get(),
-      .width = win_dims.x,
-      .height = win_dims.y,
+      .width = output_dims.x,
+      .height = output_dims.y,
       .vsync = config_.vsync,
   });
 
   time_ = {};
+  start_time_ = std::chrono::steady_clock::now();
   context_.window_ = window_.get();
   context_.device_ = device_.get();
   context_.swapchain_ = device_->get_swapchain(swapchain_);
@@ -213,6 +255,7 @@ void Engine::init() {
       .time = &time_,
       .resource_dir = resource_dir_,
       .imgui_ui_active = imgui_enabled_,
+      .render_thread = config_.render_thread,
   });
   context_.renderer_ = renderer_.get();
   layers_.set_context(&context_);
@@ -244,6 +287,8 @@ gfx::rhi::GfxAPI Engine::resolve_gfx_api() const {
 #else
       return gfx::rhi::GfxAPI::Metal;
 #endif
+    case EngineGfxApi::Null:
+      return gfx::rhi::GfxAPI::Null;
     case EngineGfxApi::PlatformDefault:
     default:
 #if defined(__APPLE__) && defined(METAL_BACKEND)
@@ -324,19 +369,32 @@ Result<SceneLoadResult> Engine::load_project_startup_scene() {
 }
 
 bool Engine::tick() {
+  // Frame boundary for cvars: writes queued during the last frame (console, editor, init code)
+  // become visible to every thread at once.
+  CVarSystem::get().apply_pending_changes();
+  // Frame boundary for the built-in profiler; kept ahead of the zone so tick() lands inside the
+  // captured frame.
+  update_profiler_capture();
   ZoneScoped;
-  if (shutting_down_ || !initialized_ || window_->should_close()) {
+  if (shutting_down_ || !initialized_ || (window_ && window_->should_close())) {
     return false;
   }
 
-  window_->poll_events();
+  if (window_) {
+    window_->poll_events();
+  }
   dispatch_pending_events();
   refresh_input_snapshot_ui_state();
 
-  const double curr_time = glfwGetTime();
+  EngineMetrics& metrics = engine_metrics();
+  const double curr_time =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time_).count();
   time_.total_seconds = curr_time;
   time_.delta_seconds = have_prev_time_ ? static_cast<float>(curr_time - prev_time_seconds_) : 0.f;
   time_.frame_index = completed_frames_;
+  if (have_prev_time_) {
+    metrics.frame_ms.record((curr_time - prev_time_seconds_) * 1000.0);
+  }
   prev_time_seconds_ = curr_time;
   have_prev_time_ = true;
   input_snapshot_.delta_seconds = time_.delta_seconds;
@@ -344,27 +402,97 @@ bool Engine::tick() {
   if (Scene* active_scene = scenes_->active_scene()) {
     active_scene->set_input_snapshot(input_snapshot_);
   }
-  if (!scenes_->tick_active_scene(time_.delta_seconds)) {
-    return false;
+  {
+    ScopedHistogramTimer scene_timer(metrics.scene_tick_ms);
+    if (!scenes_->tick_active_scene(time_.delta_seconds)) {
+      return false;
+    }
   }
   clear_transient_input();
 
   renderer_->begin_frame();
 
-  layers_.update(time_);
-  layers_.imgui();
-  if (scenes_->active_scene()) {
-    renderer_->enqueue_active_scene();
+  {
+    ScopedHistogramTimer layers_timer(metrics.layers_update_ms);
+    layers_.update(time_);
+    layers_.imgui();
+  }
+  {
+    ScopedHistogramTimer render_timer(metrics.render_ms);
+    if (scenes_->active_scene()) {
+      renderer_->enqueue_active_scene();
+    }
+    layers_.render();
+    renderer_->end_frame();
   }
-  layers_.render();
-  renderer_->end_frame();
   layers_.end_frame();
 
   ++completed_frames_;
+  metrics.frames.add();
+  update_metrics_dump(curr_time);
   if (config_.quit_after_frames.has_value() && completed_frames_ >= *config_.quit_after_frames) {
     return false;
   }
-  return !window_->should_close();
+  return !window_ || !window_->should_close();
+}
+
+void Engine::update_metrics_dump(double now_seconds) {
+  const float interval = engine_cv::metrics_dump_interval.get();
+  if (interval <= 0.f || now_seconds - last_metrics_dump_seconds_ < interval) {
+    return;
+  }
+  last_metrics_dump_seconds_ = now_seconds;
+  dump_metrics();
+}
+
+void Engine::dump_metrics() {
+  ZoneScoped;
+  const char* dir_c = engine_cv::metrics_dump_dir.get();
+  const std::filesystem::path dir =
+      dir_c != nullptr && *dir_c != '\0' ? std::filesystem::path(dir_c)
+                                          : local_resource_dir_ / "metrics";
+  const MetricsRegistry& metrics = MetricsRegistry::get();
+  if (Result<void> written = metrics.write_json(dir / "metrics.json"); !written) {
+    LWARN("Failed to dump metrics: {}", written.error());
+  }
+  if (Result<void> written = metrics.write_csv(dir / "metrics.csv"); !written) {
+    LWARN("Failed to dump metrics: {}", written.error());
+  }
+}
+
+void Engine::update_profiler_capture() {
+  Profiler& profiler = Profiler::get();
+  if (const int32_t frames = engine_cv::profiler_capture_frames.get(); frames > 0) {
+    engine_cv::profiler_capture_frames.set(0);
+    if (profiler.request_capture(static_cast<uint32_t>(frames))) {
+      LINFO("Capturing {} frames with the CPU profiler", frames);
+    } else {
+      LWARN("CPU profiler capture already in progress");
+    }
+  }
+  if (std::optional<ProfileCapture> capture = profiler.frame_mark()) {
+    write_profile_capture(*capture);
+  }
+}
+
+void Engine::write_profile_capture(const ProfileCapture& capture) {
+  ZoneScoped;
+  const char* dir_c = engine_cv::profiler_trace_dir.get();
+  const std::filesystem::path dir =
+      dir_c != nullptr && *dir_c != '\0' ? std::filesystem::path(dir_c)
+                                          : local_resource_dir_ / "traces";
+  const std::filesystem::path path =
+      dir / std::format("trace_frame{}.json", completed_frames_ - capture.frame_begin_ns.size());
+  if (Result<void> written = capture.write_chrome_trace(path); !written) {
+    LWARN("Failed to write profiler trace: {}", written.error());
+    return;
+  }
+  if (capture.dropped_events > 0) {
+    LWARN("Profiler dropped {} zones; per-thread rings filled within a frame",
+          capture.dropped_events);
+  }
+  LINFO("Wrote {} profiler zones over {} frames to {}", capture.event_count(),
+        capture.frame_begin_ns.size(), path.string());
 }
 
 void Engine::run() {
@@ -379,13 +507,24 @@ void Engine::shutdown() {
     return;
   }
   shutting_down_ = true;
+  // Let a pipelined frame finish submitting before anything it uses is torn down.
+  renderer_->wait_for_render_thread();
+  if (Profiler::capturing()) {
+    write_profile_capture(Profiler::get().end_capture());
+  }
+  if (engine_cv::metrics_dump_interval.get() > 0.f) {
+    dump_metrics();
+  }
+  CVarSystem::get().apply_pending_changes();
   CVarSystem::get().save_to_file((local_resource_dir_ / "cvars.txt").string());
   layers_.clear();
   renderer_->shutdown();
   renderer_.reset();
   assets_.reset();
   swapchain_ = {};
-  window_->shutdown();
+  if (window_) {
+    window_->shutdown();
+  }
   device_->shutdown();
   context_ = {};
   window_.reset();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <filesystem>
 #include <glm/vec2.hpp>
@@ -19,6 +20,7 @@
 namespace teng {
 
 class Window;
+struct ProfileCapture;
 
 namespace gfx::rhi {
 class Swapchain;
@@ -35,18 +37,25 @@ enum class EngineGfxApi {
   PlatformDefault,
   Vulkan,
   Metal,
+  // Headless: no GPU work is submitted, only the CPU side of each frame runs.
+  Null,
 };
 
 struct EngineConfig {
   std::filesystem::path resource_dir;
   std::string app_name{"metalrender"};
   EngineGfxApi preferred_gfx_api{EngineGfxApi::PlatformDefault};
+  // Headless runs (EngineGfxApi::Null) create no window; these size the offscreen swapchain
+  // instead, falling back to 1280x720 when unset.
   int initial_window_width{-1};
   int initial_window_height{-1};
   glm::ivec2 initial_window_position{500, 0};
   bool floating_window{false};
   bool vsync{true};
   bool enable_imgui{true};
+  // Bake and submit each frame on a render thread while the next one simulates (see
+  // RenderService::CreateInfo::render_thread). Adds up to one frame of input latency.
+  bool render_thread{false};
   std::optional<uint32_t> quit_after_frames;
 };
 
@@ -59,6 +68,8 @@ struct EngineTime {
 class EngineContext {
  public:
   [[nodiscard]] Window& window() const { return *window_; }
+  // False when headless (null device): there is no window to query or hook input into.
+  [[nodiscard]] bool has_window() const { return window_ != nullptr; }
   [[nodiscard]] gfx::rhi::Device& device() const { return *device_; }
   [[nodiscard]] gfx::rhi::Swapchain& swapchain() const { return *swapchain_; }
   [[nodiscard]] const std::filesystem::path& resource_dir() const { return *resource_dir_; }
@@ -152,6 +163,7 @@ class Engine {
   [[nodiscard]] RenderService& renderer() { return *renderer_; }
   [[nodiscard]] const RenderService& renderer() const { return *renderer_; }
   [[nodiscard]] const EngineConfig& config() const { return config_; }
+  [[nodiscard]] bool headless() const { return window_ == nullptr; }
 
  private:
   struct KeyEvent {
@@ -170,6 +182,11 @@ class Engine {
   void dispatch_pending_events();
   void refresh_input_snapshot_ui_state();
   void clear_transient_input();
+  // Writes metrics.json / metrics.csv when engine.metrics.dump_interval has elapsed.
+  void update_metrics_dump(double now_seconds);
+  void dump_metrics();
+  void update_profiler_capture();
+  void write_profile_capture(const ProfileCapture& capture);
 
   EngineConfig config_;
   std::filesystem::path resource_dir_;
@@ -193,7 +210,9 @@ class Engine {
   bool initialized_{false};
   bool shutting_down_{false};
   bool have_prev_time_{false};
+  std::chrono::steady_clock::time_point start_time_{};
   double prev_time_seconds_{};
+  double last_metrics_dump_seconds_{};
   uint32_t completed_frames_{};
   std::vector<KeyEvent> pending_key_events_;
   std::vector<CursorEvent> pending_cursor_events_;
@@ -0,0 +1,26 @@
+#include "engine/EngineCVars.hpp"
+
+namespace TENG_NAMESPACE {
+namespace engine {
+namespace engine_cv {
+
+AutoCVarFloat metrics_dump_interval{
+    "engine.metrics.dump_interval",
+    "Seconds between metrics.json / metrics.csv dumps of the metrics registry (0 = off). Also "
+    "dumped once at shutdown when enabled.",
+    0.f, CVarFlags::Advanced};
+AutoCVarString metrics_dump_dir{
+    "engine.metrics.dump_dir",
+    "Directory for metrics dumps; empty uses <local resource dir>/metrics.", ""};
+AutoCVarInt profiler_capture_frames{
+    "engine.profiler.capture_frames",
+    "Set to N to record the next N frames with the built-in CPU profiler and write a Chrome trace "
+    "(chrome://tracing, ui.perfetto.dev). Resets to 0 once the capture starts.",
+    0};
+AutoCVarString profiler_trace_dir{
+    "engine.profiler.trace_dir",
+    "Directory for profiler traces; empty uses <local resource dir>/traces.", ""};
+
+}  // namespace engine_cv
+}  // namespace engine
+}  // namespace TENG_NAMESPACE
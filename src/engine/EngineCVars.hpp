@@ -0,0 +1,16 @@
+#pragma once
+
+#include "core/CVar.hpp"
+
+namespace TENG_NAMESPACE {
+namespace engine {
+namespace engine_cv {
+
+extern AutoCVarFloat metrics_dump_interval;
+extern AutoCVarString metrics_dump_dir;
+extern AutoCVarInt profiler_capture_frames;
+extern AutoCVarString profiler_trace_dir;
+
+}  // namespace engine_cv
+}  // namespace engine
+}  // namespace TENG_NAMESPACE
@@ -6,6 +6,8 @@
 
 #include "UI.hpp"
 #include "Window.hpp"
+#include "core/Metrics.hpp"
+#include "engine/MetricsImGui.hpp"
 #include "engine/render/RenderService.hpp"
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
@@ -39,6 +41,7 @@ void ImGuiOverlayLayer::on_update(EngineContext& ctx, const EngineTime&) {
 void ImGuiOverlayLayer::on_imgui(EngineContext& ctx) {
   if (frame_started_) {
     ctx.renderer().on_imgui();
+    draw_metrics_imgui(MetricsRegistry::get());
   }
   if (frame_started_) {
     ImGui::Render();
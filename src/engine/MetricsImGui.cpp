@@ -0,0 +1,107 @@
+#include "engine/MetricsImGui.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "core/Metrics.hpp"
+#include "imgui.h"
+#include "implot.h"
+
+namespace TENG_NAMESPACE {
+
+namespace engine {
+
+namespace {
+
+void draw_histogram_plot(const std::string& name, const Histogram& histogram) {
+  const Histogram::Snapshot snap = histogram.snapshot();
+  std::vector<double> xs;
+  std::vector<double> counts;
+  for (size_t i = 0; i < snap.buckets.size(); ++i) {
+    if (snap.buckets[i] == 0) {
+      continue;
+    }
+    const auto [lower, upper] = histogram.bucket_range(i);
+    xs.push_back(std::max(lower, snap.min));
+    counts.push_back(static_cast<double>(snap.buckets[i]));
+  }
+  if (xs.empty()) {
+    return;
+  }
+  if (ImPlot::BeginPlot("##metrics_histogram", ImVec2(-1, 220))) {
+    ImPlot::SetupAxes(name.c_str(), "samples", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+    ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Log10);
+    ImPlot::PlotStairs("count", xs.data(), counts.data(), static_cast<int>(xs.size()));
+    const double quantiles[] = {snap.quantile(0.50), snap.quantile(0.95), snap.quantile(0.99)};
+    ImPlot::PlotInfLines("p50/p95/p99", quantiles, 3);
+    ImPlot::EndPlot();
+  }
+}
+
+}  // namespace
+
+void draw_metrics_imgui(MetricsRegistry& metrics) {
+  if (!ImGui::CollapsingHeader("Metrics")) {
+    return;
+  }
+  static std::string selected;
+  if (ImGui::Button("Reset metrics")) {
+    metrics.reset();
+  }
+
+  if (ImGui::BeginTable("metrics_histograms", 7,
+                        ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders |
+                            ImGuiTableFlags_SizingStretchProp)) {
+    ImGui::TableSetupColumn("Histogram");
+    ImGui::TableSetupColumn("Count");
+    ImGui::TableSetupColumn("Mean");
+    ImGui::TableSetupColumn("P50");
+    ImGui::TableSetupColumn("P95");
+    ImGui::TableSetupColumn("P99");
+    ImGui::TableSetupColumn("Max");
+    ImGui::TableHeadersRow();
+    metrics.for_each_histogram([](const std::string& name, const Histogram& histogram) {
+      const Histogram::Snapshot snap = histogram.snapshot();
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      if (ImGui::Selectable(name.c_str(), selected == name, ImGuiSelectableFlags_SpanAllColumns)) {
+        selected = name;
+      }
+      ImGui::TableNextColumn();
+      ImGui::Text("%llu", static_cast<unsigned long long>(snap.count));
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", snap.mean());
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", snap.quantile(0.50));
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", snap.quantile(0.95));
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", snap.quantile(0.99));
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", snap.max);
+    });
+    ImGui::EndTable();
+  }
+  if (!selected.empty()) {
+    metrics.for_each_histogram([](const std::string& name, const Histogram& histogram) {
+      if (name == selected) {
+        draw_histogram_plot(name, histogram);
+      }
+    });
+  }
+
+  if (ImGui::TreeNode("Counters and gauges")) {
+    metrics.for_each_counter([](const std::string& name, const Counter& counter) {
+      ImGui::Text("%s: %llu", name.c_str(), static_cast<unsigned long long>(counter.value()));
+    });
+    metrics.for_each_gauge([](const std::string& name, const Gauge& gauge) {
+      ImGui::Text("%s: %.3f", name.c_str(), gauge.value());
+    });
+    ImGui::TreePop();
+  }
+}
+
+}  // namespace engine
+
+}  // namespace TENG_NAMESPACE
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "core/Config.hpp"
+
+namespace TENG_NAMESPACE {
+
+class MetricsRegistry;
+
+namespace engine {
+
+// "Metrics" header: histogram quantile table, the selected histogram's distribution, counters and
+// gauges.
+void draw_metrics_imgui(MetricsRegistry& metrics);
+
+}  // namespace engine
+
+}  // namespace TENG_NAMESPACE
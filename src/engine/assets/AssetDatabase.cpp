@@ -3,12 +3,14 @@
 #include <algorithm>
 #include <fstream>
 #include <iomanip>
+#include <span>
 #include <sstream>
 #include <string_view>
 #include <system_error>
 #include <toml++/toml.hpp>
 
 #include "core/EAssert.hpp"
+#include "core/MappedFile.hpp"
 #include "core/Result.hpp"
 #include "core/TomlUtil.hpp"
 
@@ -55,16 +57,11 @@ constexpr uint64_t k_fnv_prime = 1099511628211ull;
   return std::nullopt;
 }
 
-[[nodiscard]] uint64_t fnv1a_bytes(std::istream& stream) {
+[[nodiscard]] uint64_t fnv1a_bytes(std::span<const std::byte> bytes) {
   uint64_t hash = k_fnv_offset_basis;
-  char buffer[4096];
-  while (stream) {
-    stream.read(buffer, sizeof(buffer));
-    const std::streamsize read = stream.gcount();
-    for (std::streamsize i = 0; i < read; ++i) {
-      hash ^= static_cast<unsigned char>(buffer[i]);
-      hash *= k_fnv_prime;
-    }
+  for (const std::byte b : bytes) {
+    hash ^= static_cast<unsigned char>(b);
+    hash *= k_fnv_prime;
   }
   return hash == 0 ? 1 : hash;
 }
@@ -667,11 +664,11 @@ void AssetDatabase::write_aggregate_index_best_effort() const {
 }
 
 std::string AssetDatabase::hash_source_file(const std::filesystem::path& source_path) const {
-  std::ifstream in(source_path, std::ios::binary);
-  if (!in) {
+  const Result<MappedFile> file = MappedFile::open(source_path);
+  if (!file) {
     return {};
   }
-  return hash_to_string(fnv1a_bytes(in));
+  return hash_to_string(fnv1a_bytes(file->bytes()));
 }
 
 void AssetDatabase::add_dependency_diagnostics(AssetScanReport& report) const {
@@ -1,7 +1,9 @@
 #include "engine/assets/AssetService.hpp"
 
+#include <algorithm>
 #include <glm/mat4x4.hpp>
 #include <utility>
+#include <vector>
 
 namespace teng::engine::assets {
 
@@ -26,8 +28,7 @@ ModelAssetLoadResult AssetService::load_model(AssetId id) {
   auto asset = std::make_unique<ModelAsset>();
   asset->id = id;
   asset->source_path = record->source_path;
-  if (!gfx::load_model(absolute_source_path(record->source_path), glm::mat4{1}, asset->model,
-                       asset->load_result)) {
+  if (!load_model_source(id, record->source_path, asset->model, asset->load_result)) {
     return {.status = AssetLoadStatus::ImportFailed};
   }
 
@@ -46,14 +47,49 @@ ModelAssetImportResult AssetService::import_model_for_upload(AssetId id) {
   auto asset = std::make_unique<ModelAssetImport>();
   asset->id = id;
   asset->source_path = record->source_path;
-  if (!gfx::load_model(absolute_source_path(record->source_path), glm::mat4{1}, asset->model,
-                       asset->load_result)) {
+  if (!load_model_source(id, record->source_path, asset->model, asset->load_result)) {
     return {.status = AssetLoadStatus::ImportFailed};
   }
 
   return {.status = AssetLoadStatus::Ok, .asset = std::move(asset)};
 }
 
+void AssetService::prefetch_models(std::span<const AssetId> ids) {
+  std::vector<AssetId> read_ids;
+  std::vector<std::filesystem::path> read_paths;
+  for (const AssetId id : ids) {
+    if (model_assets_.contains(id) || source_reads_.contains(id) ||
+        std::ranges::find(read_ids, id) != read_ids.end()) {
+      continue;
+    }
+    const AssetRecord* record{};
+    if (validate_model_asset(id, record) != AssetLoadStatus::Ok) {
+      continue;
+    }
+    read_ids.push_back(id);
+    read_paths.push_back(absolute_source_path(record->source_path));
+  }
+  std::vector<IoRequest> reads = IoService::get().read_batch(read_paths);
+  for (size_t i = 0; i < reads.size(); ++i) {
+    source_reads_.emplace(read_ids[i], std::move(reads[i]));
+  }
+}
+
+bool AssetService::load_model_source(AssetId id, const std::filesystem::path& source_path,
+                                     ModelInstance& out_model,
+                                     gfx::ModelLoadResult& out_load_result) {
+  const std::filesystem::path path = absolute_source_path(source_path);
+  IoBuffer source;
+  if (const auto it = source_reads_.find(id); it != source_reads_.end()) {
+    // A failed prefetch leaves `source` empty and load_model reads the file itself.
+    if (Result<IoBuffer> read = it->second.take()) {
+      source = std::move(*read);
+    }
+    source_reads_.erase(it);
+  }
+  return gfx::load_model(path, glm::mat4{1}, out_model, out_load_result, source.bytes());
+}
+
 AssetLoadStatus AssetService::validate_model_asset(AssetId id, const AssetRecord*& out_record) const {
   const AssetRecord* record = database_.find(id);
   if (!record || record->status == AssetRecordStatus::Tombstoned) {
@@ -3,8 +3,10 @@
 #include <cstdint>
 #include <filesystem>
 #include <memory>
+#include <span>
 #include <unordered_map>
 
+#include "core/IoService.hpp"
 #include "engine/assets/AssetDatabase.hpp"
 #include "gfx/ModelInstance.hpp"
 #include "gfx/ModelLoader.hpp"
@@ -57,15 +59,23 @@ class AssetService {
   [[nodiscard]] AssetScanReport scan() { return database_.scan(); }
   [[nodiscard]] ModelAssetLoadResult load_model(AssetId id);
   [[nodiscard]] ModelAssetImportResult import_model_for_upload(AssetId id);
+  // Starts reading the source files of these model assets on the IoService, so that a following
+  // load_model / import_model_for_upload parses bytes that are already in memory. Unknown,
+  // already-loaded and already-prefetched ids are skipped.
+  void prefetch_models(std::span<const AssetId> ids);
 
  private:
   [[nodiscard]] AssetLoadStatus validate_model_asset(AssetId id, const AssetRecord*& out_record) const;
   [[nodiscard]] std::filesystem::path absolute_source_path(
       const std::filesystem::path& source_path) const;
+  [[nodiscard]] bool load_model_source(AssetId id, const std::filesystem::path& source_path,
+                                       ModelInstance& out_model,
+                                       gfx::ModelLoadResult& out_load_result);
 
   AssetServiceConfig config_;
   AssetDatabase database_;
   std::unordered_map<AssetId, std::unique_ptr<ModelAsset>> model_assets_;
+  std::unordered_map<AssetId, IoRequest> source_reads_;
 };
 
 [[nodiscard]] const char* to_string(AssetLoadStatus status);
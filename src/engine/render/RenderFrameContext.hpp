@@ -3,7 +3,9 @@
 #include <cstdint>
 #include <filesystem>
 #include <glm/ext/vector_uint2.hpp>
+#include <memory_resource>
 
+#include "core/CVar.hpp"
 #include "gfx/RenderGraph.hpp"
 
 namespace teng::gfx {
@@ -30,6 +32,7 @@ class SceneManager;
 struct RenderFrameContext {
   gfx::rhi::Device* device{};
   gfx::rhi::Swapchain* swapchain{};
+  // Null when the engine runs headless.
   Window* window{};
   gfx::RenderGraph* render_graph{};
   gfx::ShaderManager* shader_mgr{};
@@ -39,6 +42,10 @@ struct RenderFrameContext {
   SceneManager* scenes{};
   const std::filesystem::path* resource_dir{};
   const EngineTime* time{};
+  // Frame arena for CPU temporaries; allocations stay valid through the next frame.
+  std::pmr::memory_resource* frame_memory{};
+  // Cvar values for the whole frame, held by RenderService until the next begin_frame.
+  const CVarSnapshot* cvars{};
   glm::uvec2 output_extent{};
   gfx::RGResourceId curr_swapchain_rg_id{};
   uint64_t frame_index{};
@@ -6,6 +6,7 @@
 #include <glm/ext/vector_float3.hpp>
 #include <glm/ext/vector_float4.hpp>
 #include <glm/ext/vector_uint2.hpp>
+#include <memory_resource>
 #include <vector>
 
 #include "engine/scene/SceneIds.hpp"
@@ -54,12 +55,23 @@ struct RenderSprite {
   int sorting_order{};
 };
 
+// Lists are pmr so a frame's scene can live in the render frame arena; moving a RenderScene keeps
+// its memory resource, copying or assigning into one allocated elsewhere does not.
 struct RenderScene {
   RenderSceneFrame frame;
-  std::vector<RenderCamera> cameras;
-  std::vector<RenderDirectionalLight> directional_lights;
-  std::vector<RenderMesh> meshes;
-  std::vector<RenderSprite> sprites;
+  std::pmr::vector<RenderCamera> cameras;
+  std::pmr::vector<RenderDirectionalLight> directional_lights;
+  std::pmr::vector<RenderMesh> meshes;
+  std::pmr::vector<RenderSprite> sprites;
+};
+
+// Mesh changes since the previous incremental extraction of a scene. `changed` meshes may carry
+// the same model and transform as before (change tracking is per flecs table); consumers compare
+// against their own copy. `removed` entities are no longer renderable meshes.
+struct RenderSceneMeshDelta {
+  std::pmr::vector<RenderMesh> added;
+  std::pmr::vector<RenderMesh> changed;
+  std::pmr::vector<EntityGuid> removed;
 };
 
 }  // namespace teng::engine
@@ -1,114 +1,487 @@
 #include "engine/render/RenderSceneExtractor.hpp"
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
 
+#include "core/EAssert.hpp"
+#include "core/FlatHashMap.hpp"
+#include "core/JobSystem.hpp"
+#include "core/Profiler.hpp"
+#include "core/RadixSort.hpp"
 #include "engine/scene/Scene.hpp"
 #include "engine/scene/SceneComponents.hpp"
 
 namespace teng::engine {
 
+namespace extract_detail {
+
+using MeshQuery = flecs::query<const EntityGuidComponent, const LocalToWorld, const MeshRenderable>;
+
+// Incremental mesh tracking state, stored as a world singleton so it lives exactly as long as the
+// scene. Observers record meshes set or removed through the entity API; transforms written by
+// systems emit no OnSet, so those are found per table through the change-detecting query. Kept
+// out of the anonymous namespace so flecs derives a plain component name from it.
+struct RenderMeshTracking {
+  MeshQuery changed_tables;
+  std::vector<flecs::entity_t> set_entities;
+  std::vector<EntityGuid> removed;
+  // Meshes reported to the consumer and not removed since.
+  FlatHashSet<EntityGuid> live;
+  // Scratch: entities already reported by the current drain.
+  FlatHashSet<EntityGuid> visited;
+};
+
+// Rows [0, count) of one flecs table, or a slice of a large one.
+template <typename Component>
+struct ExtractChunk {
+  const EntityGuidComponent* guids{};
+  const LocalToWorld* local_to_worlds{};
+  const Component* components{};
+  size_t count{};
+};
+
+template <typename T>
+struct SortEntry {
+  uint64_t key{};
+  const T* item{};
+};
+
+// Query and scratch for one output list of a full extraction, reused across frames.
+template <typename T, typename Component>
+struct ExtractList {
+  flecs::query<const EntityGuidComponent, const LocalToWorld, const Component> query;
+  std::vector<ExtractChunk<Component>> chunks;
+  // Indexed by JobSystem worker + 1; slot 0 belongs to a calling thread that is not a worker.
+  std::vector<std::vector<T>> worker_items;
+  std::vector<uint32_t> worker_skipped;
+  std::vector<SortEntry<T>> entries;
+  std::vector<SortEntry<T>> sort_scratch;
+};
+
+// World singleton, like RenderMeshTracking.
+struct RenderExtractState {
+  ExtractList<RenderCamera, Camera> cameras;
+  ExtractList<RenderDirectionalLight, DirectionalLight> directional_lights;
+  ExtractList<RenderMesh, MeshRenderable> meshes;
+  ExtractList<RenderSprite, SpriteRenderable> sprites;
+};
+
+}  // namespace extract_detail
+
 namespace {
 
-[[nodiscard]] constexpr bool guid_less(EntityGuid a, EntityGuid b) { return a.value < b.value; }
+using extract_detail::ExtractChunk;
+using extract_detail::ExtractList;
+using extract_detail::MeshQuery;
+using extract_detail::RenderExtractState;
+using extract_detail::RenderMeshTracking;
+using extract_detail::SortEntry;
 
-}  // namespace
+// Large tables are cut into chunks of this many rows so one archetype still spreads over workers.
+constexpr size_t k_extract_chunk_rows = 4096;
+// Below this many rows in total, extraction stays on the calling thread: job overhead dominates.
+constexpr size_t k_parallel_extract_min_rows = 8192;
 
-RenderScene extract_render_scene(Scene& scene, const RenderSceneExtractOptions& options) {
-  RenderScene output;
-  output.frame = options.frame;
+template <typename Component>
+[[nodiscard]] flecs::query<const EntityGuidComponent, const LocalToWorld, const Component>
+build_extract_query(flecs::world& world, const char* name) {
+  return world.query_builder<const EntityGuidComponent, const LocalToWorld, const Component>(name)
+      .cached()
+      .build();
+}
 
-  flecs::world& world = scene.world();
-  RenderSceneExtractStats local_stats;
-  RenderSceneExtractStats& stats = options.stats ? *options.stats : local_stats;
+// Sets `installed` when this call created the tracking.
+RenderMeshTracking* find_or_install_mesh_tracking(flecs::world& world, bool& installed) {
+  installed = false;
+  if (RenderMeshTracking* tracking = world.try_get_mut<RenderMeshTracking>()) {
+    return tracking;
+  }
+  installed = true;
+  world.component<RenderMeshTracking>();
+  world.set<RenderMeshTracking>({
+      .changed_tables =
+          world
+              .query_builder<const EntityGuidComponent, const LocalToWorld, const MeshRenderable>(
+                  "RenderMeshChanges")
+              .cached()
+              .detect_changes()
+              .build(),
+  });
+  world.observer<const EntityGuidComponent, const LocalToWorld, const MeshRenderable>(
+           "RenderMeshSet")
+      .event(flecs::OnSet)
+      .each([](flecs::entity entity, const EntityGuidComponent&, const LocalToWorld&,
+               const MeshRenderable&) {
+        if (auto* tracking = entity.world().try_get_mut<RenderMeshTracking>()) {
+          tracking->set_entities.push_back(entity.id());
+        }
+      });
+  world.observer<const EntityGuidComponent, const LocalToWorld, const MeshRenderable>(
+           "RenderMeshRemoved")
+      .event(flecs::OnRemove)
+      .each([](flecs::entity entity, const EntityGuidComponent& guid, const LocalToWorld&,
+               const MeshRenderable&) {
+        if (auto* tracking = entity.world().try_get_mut<RenderMeshTracking>()) {
+          tracking->removed.push_back(guid.guid);
+        }
+      });
+  return world.try_get_mut<RenderMeshTracking>();
+}
 
-  world.each([&output](const EntityGuidComponent& guid, const LocalToWorld& local_to_world,
-                       const Camera& camera) {
-    if (!guid.guid.is_valid()) {
-      return;
+void report_mesh(RenderMeshTracking& tracking, RenderSceneMeshDelta& delta,
+                 RenderSceneExtractStats& stats, EntityGuid guid, const glm::mat4& local_to_world,
+                 const MeshRenderable& mesh) {
+  if (!guid.is_valid()) {
+    return;
+  }
+  if (!mesh.model.is_valid()) {
+    ++stats.skipped_meshes_missing_asset;
+    if (tracking.live.erase(guid) != 0) {
+      delta.removed.push_back(guid);
     }
-    output.cameras.push_back(RenderCamera{
-        .entity = guid.guid,
-        .local_to_world = local_to_world.value,
-        .fov_y = camera.fov_y,
-        .z_near = camera.z_near,
-        .z_far = camera.z_far,
-        .primary = camera.primary,
-    });
-  });
+    return;
+  }
+  const RenderMesh render_mesh{
+      .entity = guid,
+      .model = mesh.model,
+      .local_to_world = local_to_world,
+  };
+  if (tracking.live.insert(guid).second) {
+    delta.added.push_back(render_mesh);
+  } else {
+    delta.changed.push_back(render_mesh);
+  }
+}
 
-  world.each([&output](const EntityGuidComponent& guid, const LocalToWorld& local_to_world,
-                       const DirectionalLight& light) {
-    if (!guid.guid.is_valid()) {
-      return;
+void drain_mesh_changes(flecs::world& world, RenderMeshTracking& tracking,
+                        RenderSceneMeshDelta& delta, RenderSceneExtractStats& stats, bool reset) {
+  ZoneScoped;
+  if (reset) {
+    tracking.live.clear();
+    tracking.set_entities.clear();
+    tracking.removed.clear();
+  }
+
+  // Removals first: an entity removed and set again within one frame is reported as re-added.
+  for (const EntityGuid guid : tracking.removed) {
+    if (tracking.live.erase(guid) != 0) {
+      delta.removed.push_back(guid);
     }
-    output.directional_lights.push_back(RenderDirectionalLight{
-        .entity = guid.guid,
-        .local_to_world = local_to_world.value,
-        .direction = light.direction,
-        .color = light.color,
-        .intensity = light.intensity,
-    });
-  });
+  }
+  tracking.removed.clear();
 
-  world.each([&output, &stats](const EntityGuidComponent& guid, const LocalToWorld& local_to_world,
-                               const MeshRenderable& mesh) {
-    if (!guid.guid.is_valid()) {
-      return;
+  std::ranges::sort(tracking.set_entities);
+  const auto duplicates = std::ranges::unique(tracking.set_entities);
+  tracking.set_entities.erase(duplicates.begin(), duplicates.end());
+  for (const flecs::entity_t id : tracking.set_entities) {
+    const flecs::entity entity{world.c_ptr(), id};
+    if (!entity.is_alive()) {
+      continue;
     }
-    if (!mesh.model.is_valid()) {
-      ++stats.skipped_meshes_missing_asset;
-      return;
+    const auto* guid = entity.try_get<EntityGuidComponent>();
+    const auto* local_to_world = entity.try_get<LocalToWorld>();
+    const auto* mesh = entity.try_get<MeshRenderable>();
+    if (!guid || !local_to_world || !mesh) {
+      continue;
     }
-    output.meshes.push_back(RenderMesh{
-        .entity = guid.guid,
-        .model = mesh.model,
-        .local_to_world = local_to_world.value,
-    });
-  });
+    tracking.visited.insert(guid->guid);
+    report_mesh(tracking, delta, stats, guid->guid, local_to_world->value, *mesh);
+  }
+  tracking.set_entities.clear();
 
-  world.each([&output, &stats](const EntityGuidComponent& guid, const LocalToWorld& local_to_world,
-                               const SpriteRenderable& sprite) {
-    if (!guid.guid.is_valid()) {
-      return;
+  // Tables whose matrices or meshes were written since the last drain; after a reset, all of them.
+  tracking.changed_tables.run([&](flecs::iter& it) {
+    while (it.next()) {
+      if (!it.changed() && !reset) {
+        continue;
+      }
+      const auto guids = it.field<const EntityGuidComponent>(0);
+      const auto local_to_worlds = it.field<const LocalToWorld>(1);
+      const auto meshes = it.field<const MeshRenderable>(2);
+      for (const auto i : it) {
+        if (!tracking.visited.empty() && tracking.visited.contains(guids[i].guid)) {
+          continue;
+        }
+        report_mesh(tracking, delta, stats, guids[i].guid, local_to_worlds[i].value, meshes[i]);
+      }
     }
-    if (!sprite.texture.is_valid()) {
-      ++stats.skipped_sprites_missing_asset;
-      return;
-    }
-    output.sprites.push_back(RenderSprite{
-        .entity = guid.guid,
-        .texture = sprite.texture,
-        .local_to_world = local_to_world.value,
-        .tint = sprite.tint,
-        .sorting_layer = sprite.sorting_layer,
-        .sorting_order = sprite.sorting_order,
-    });
   });
+  tracking.visited.clear();
+}
 
-  std::ranges::sort(output.cameras, [](const RenderCamera& a, const RenderCamera& b) {
-    if (a.primary != b.primary) {
-      return a.primary > b.primary;
-    }
-    return guid_less(a.entity, b.entity);
+void extract_row(EntityGuid guid, const glm::mat4& local_to_world, const Camera& camera,
+                 std::vector<RenderCamera>& out, uint32_t&) {
+  out.push_back(RenderCamera{
+      .entity = guid,
+      .local_to_world = local_to_world,
+      .fov_y = camera.fov_y,
+      .z_near = camera.z_near,
+      .z_far = camera.z_far,
+      .primary = camera.primary,
   });
-  std::ranges::sort(output.directional_lights,
-                    [](const RenderDirectionalLight& a, const RenderDirectionalLight& b) {
-                      return guid_less(a.entity, b.entity);
-                    });
-  std::ranges::sort(output.meshes, [](const RenderMesh& a, const RenderMesh& b) {
-    return guid_less(a.entity, b.entity);
+}
+
+void extract_row(EntityGuid guid, const glm::mat4& local_to_world, const DirectionalLight& light,
+                 std::vector<RenderDirectionalLight>& out, uint32_t&) {
+  out.push_back(RenderDirectionalLight{
+      .entity = guid,
+      .local_to_world = local_to_world,
+      .direction = light.direction,
+      .color = light.color,
+      .intensity = light.intensity,
   });
-  std::ranges::sort(output.sprites, [](const RenderSprite& a, const RenderSprite& b) {
-    if (a.sorting_layer != b.sorting_layer) {
-      return a.sorting_layer < b.sorting_layer;
-    }
-    if (a.sorting_order != b.sorting_order) {
-      return a.sorting_order < b.sorting_order;
+}
+
+void extract_row(EntityGuid guid, const glm::mat4& local_to_world, const MeshRenderable& mesh,
+                 std::vector<RenderMesh>& out, uint32_t& skipped_missing_asset) {
+  if (!mesh.model.is_valid()) {
+    ++skipped_missing_asset;
+    return;
+  }
+  out.push_back(RenderMesh{
+      .entity = guid,
+      .model = mesh.model,
+      .local_to_world = local_to_world,
+  });
+}
+
+void extract_row(EntityGuid guid, const glm::mat4& local_to_world, const SpriteRenderable& sprite,
+                 std::vector<RenderSprite>& out, uint32_t& skipped_missing_asset) {
+  if (!sprite.texture.is_valid()) {
+    ++skipped_missing_asset;
+    return;
+  }
+  out.push_back(RenderSprite{
+      .entity = guid,
+      .texture = sprite.texture,
+      .local_to_world = local_to_world,
+      .tint = sprite.tint,
+      .sorting_layer = sprite.sorting_layer,
+      .sorting_order = sprite.sorting_order,
+  });
+}
+
+RenderExtractState& find_or_install_extract_state(flecs::world& world) {
+  if (RenderExtractState* state = world.try_get_mut<RenderExtractState>()) {
+    return *state;
+  }
+  world.component<RenderExtractState>();
+  RenderExtractState state;
+  state.cameras.query = build_extract_query<Camera>(world, "RenderExtractCameras");
+  state.directional_lights.query =
+      build_extract_query<DirectionalLight>(world, "RenderExtractDirectionalLights");
+  state.meshes.query = build_extract_query<MeshRenderable>(world, "RenderExtractMeshes");
+  state.sprites.query = build_extract_query<SpriteRenderable>(world, "RenderExtractSprites");
+  world.set<RenderExtractState>(std::move(state));
+  return *world.try_get_mut<RenderExtractState>();
+}
+
+template <typename T, typename Component>
+void reset_list(ExtractList<T, Component>& list, size_t worker_slots) {
+  list.chunks.clear();
+  list.worker_items.resize(worker_slots);
+  list.worker_skipped.assign(worker_slots, 0);
+  for (std::vector<T>& items : list.worker_items) {
+    items.clear();
+  }
+}
+
+// Records the list's matching tables as chunks of raw column pointers, so workers read component
+// data without calling into flecs. Returns the number of rows.
+template <typename T, typename Component>
+size_t gather_chunks(ExtractList<T, Component>& list) {
+  size_t rows = 0;
+  list.query.run([&list, &rows](flecs::iter& it) {
+    while (it.next()) {
+      const auto guids = it.field<const EntityGuidComponent>(0);
+      const auto local_to_worlds = it.field<const LocalToWorld>(1);
+      const auto components = it.field<const Component>(2);
+      const size_t count = it.count();
+      for (size_t begin = 0; begin < count; begin += k_extract_chunk_rows) {
+        list.chunks.push_back(ExtractChunk<Component>{
+            .guids = &guids[begin],
+            .local_to_worlds = &local_to_worlds[begin],
+            .components = &components[begin],
+            .count = std::min(k_extract_chunk_rows, count - begin),
+        });
+      }
+      rows += count;
     }
-    return guid_less(a.entity, b.entity);
   });
+  return rows;
+}
+
+template <typename T, typename Component>
+void extract_chunk(ExtractList<T, Component>& list, size_t chunk_i, size_t slot) {
+  const ExtractChunk<Component>& chunk = list.chunks[chunk_i];
+  std::vector<T>& items = list.worker_items[slot];
+  uint32_t& skipped = list.worker_skipped[slot];
+  for (size_t i = 0; i < chunk.count; ++i) {
+    const EntityGuid guid = chunk.guids[i].guid;
+    if (guid.is_valid()) {
+      extract_row(guid, chunk.local_to_worlds[i].value, chunk.components[i], items, skipped);
+    }
+  }
+}
+
+// Sorts pointers into the worker buffers by GUID, then stably by `order_key` if given, so each
+// element is copied once, straight into its final slot. Returns the rows skipped for missing
+// assets.
+template <typename T, typename Component>
+uint32_t sort_worker_items(ExtractList<T, Component>& list, uint64_t (*order_key)(const T&)) {
+  ZoneScoped;
+  uint32_t skipped = 0;
+  list.entries.clear();
+  for (size_t slot = 0; slot < list.worker_items.size(); ++slot) {
+    for (const T& item : list.worker_items[slot]) {
+      list.entries.push_back(SortEntry<T>{.key = item.entity.value, .item = &item});
+    }
+    skipped += list.worker_skipped[slot];
+  }
+  list.sort_scratch.resize(list.entries.size());
+  const auto by_key = [](const SortEntry<T>& entry) { return entry.key; };
+  radix_sort(std::span(list.entries), std::span(list.sort_scratch), by_key);
+  if (order_key) {
+    for (SortEntry<T>& entry : list.entries) {
+      entry.key = order_key(*entry.item);
+    }
+    radix_sort(std::span(list.entries), std::span(list.sort_scratch), by_key);
+  }
+  return skipped;
+}
+
+template <typename T, typename Component>
+void copy_sorted(const ExtractList<T, Component>& list, std::pmr::vector<T>& out) {
+  out.reserve(list.entries.size());
+  for (const SortEntry<T>& entry : list.entries) {
+    out.push_back(*entry.item);
+  }
+}
+
+// Primary cameras first.
+uint64_t camera_order_key(const RenderCamera& camera) { return camera.primary ? 0 : 1; }
+
+uint64_t sprite_order_key(const RenderSprite& sprite) {
+  return (uint64_t{radix_key(sprite.sorting_layer)} << 32) | radix_key(sprite.sorting_order);
+}
+
+RenderScene extract_render_scene_impl(Scene& scene, const RenderSceneExtractOptions& options,
+                                      RenderSceneExtractStats& stats, bool with_meshes) {
+  ZoneScoped;
+  std::pmr::memory_resource* memory =
+      options.memory ? options.memory : std::pmr::get_default_resource();
+  RenderScene output{
+      .frame = options.frame,
+      .cameras = std::pmr::vector<RenderCamera>(memory),
+      .directional_lights = std::pmr::vector<RenderDirectionalLight>(memory),
+      .meshes = std::pmr::vector<RenderMesh>(memory),
+      .sprites = std::pmr::vector<RenderSprite>(memory),
+  };
+
+  RenderExtractState& state = find_or_install_extract_state(scene.world());
+  JobSystem& jobs = JobSystem::get();
+  // Slot 0 is the calling thread, 1..worker_count the workers, and the last one any other thread
+  // that picks up a chunk while waiting on its own jobs (the render thread does).
+  const size_t worker_slots = jobs.worker_count() + 2;
+  reset_list(state.cameras, worker_slots);
+  reset_list(state.directional_lights, worker_slots);
+  reset_list(state.meshes, worker_slots);
+  reset_list(state.sprites, worker_slots);
+  size_t rows = gather_chunks(state.cameras) + gather_chunks(state.directional_lights) +
+                gather_chunks(state.sprites);
+  if (with_meshes) {
+    rows += gather_chunks(state.meshes);
+  }
+
+  const size_t cameras_end = state.cameras.chunks.size();
+  const size_t lights_end = cameras_end + state.directional_lights.chunks.size();
+  const size_t meshes_end = lights_end + state.meshes.chunks.size();
+  const size_t chunk_count = meshes_end + state.sprites.chunks.size();
+  const bool parallel = options.parallel && rows >= k_parallel_extract_min_rows;
+  {
+    ZoneScopedN("extract chunks");
+    const std::thread::id caller = std::this_thread::get_id();
+    std::mutex foreign_mtx;
+    const auto extract = [&](size_t chunk_i, size_t slot) {
+      if (chunk_i < cameras_end) {
+        extract_chunk(state.cameras, chunk_i, slot);
+      } else if (chunk_i < lights_end) {
+        extract_chunk(state.directional_lights, chunk_i - cameras_end, slot);
+      } else if (chunk_i < meshes_end) {
+        extract_chunk(state.meshes, chunk_i - lights_end, slot);
+      } else {
+        extract_chunk(state.sprites, chunk_i - meshes_end, slot);
+      }
+    };
+    jobs.parallel_for(0, chunk_count, parallel ? 1 : chunk_count, [&](size_t chunk_i) {
+      // Each thread appends to its own buffers.
+      if (const int32_t worker = jobs.current_worker(); worker >= 0) {
+        extract(chunk_i, static_cast<size_t>(worker) + 1);
+      } else if (std::this_thread::get_id() == caller) {
+        extract(chunk_i, 0);
+      } else {
+        std::scoped_lock lock(foreign_mtx);
+        extract(chunk_i, worker_slots - 1);
+      }
+    });
+  }
 
+  uint32_t skipped_meshes = 0;
+  uint32_t skipped_sprites = 0;
+  const auto sort_meshes = [&] { skipped_meshes = sort_worker_items(state.meshes, nullptr); };
+  const auto sort_sprites = [&] {
+    skipped_sprites = sort_worker_items(state.sprites, sprite_order_key);
+  };
+  const auto sort_small = [&] {
+    (void)sort_worker_items(state.cameras, camera_order_key);
+    (void)sort_worker_items(state.directional_lights, nullptr);
+  };
+  if (parallel) {
+    jobs.fork_join(sort_meshes, sort_sprites, sort_small);
+  } else {
+    sort_meshes();
+    sort_sprites();
+    sort_small();
+  }
+  stats.skipped_meshes_missing_asset += skipped_meshes;
+  stats.skipped_sprites_missing_asset += skipped_sprites;
+
+  copy_sorted(state.cameras, output.cameras);
+  copy_sorted(state.directional_lights, output.directional_lights);
+  copy_sorted(state.meshes, output.meshes);
+  copy_sorted(state.sprites, output.sprites);
   return output;
 }
 
+}  // namespace
+
+RenderScene extract_render_scene(Scene& scene, const RenderSceneExtractOptions& options) {
+  RenderSceneExtractStats local_stats;
+  return extract_render_scene_impl(scene, options, options.stats ? *options.stats : local_stats,
+                                   true);
+}
+
+RenderScene extract_render_scene_delta(Scene& scene, RenderSceneMeshDelta& mesh_delta,
+                                       const RenderSceneExtractOptions& options, bool reset) {
+  ZoneScoped;
+  mesh_delta.added.clear();
+  mesh_delta.changed.clear();
+  mesh_delta.removed.clear();
+  RenderSceneExtractStats local_stats;
+  RenderSceneExtractStats& stats = options.stats ? *options.stats : local_stats;
+
+  flecs::world& world = scene.world();
+  bool installed{};
+  RenderMeshTracking* tracking = find_or_install_mesh_tracking(world, installed);
+  ASSERT(tracking);
+  drain_mesh_changes(world, *tracking, mesh_delta, stats, reset || installed);
+  return extract_render_scene_impl(scene, options, stats, false);
+}
+
 }  // namespace teng::engine
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory_resource>
+
 #include "engine/render/RenderScene.hpp"
 
 namespace teng::engine {
@@ -14,9 +16,23 @@ struct RenderSceneExtractStats {
 struct RenderSceneExtractOptions {
   RenderSceneFrame frame;
   RenderSceneExtractStats* stats{};
+  // Backing memory for the output lists; null uses the default (heap) resource.
+  std::pmr::memory_resource* memory{};
+  // Spread large extractions over JobSystem workers. The output is identical either way.
+  bool parallel{true};
 };
 
 [[nodiscard]] RenderScene extract_render_scene(Scene& scene,
                                                const RenderSceneExtractOptions& options = {});
 
+// Incremental extraction for scenes extracted every frame. Cameras, lights and sprites are listed
+// in full as above, but `meshes` is left empty: mesh changes since the previous call for the same
+// scene are reported in `mesh_delta` instead (its lists are cleared first and keep their own
+// memory resource). Tracking is installed in the scene's world on first use; that call, and any
+// with `reset`, reports every mesh as added. Cost scales with the number of set or removed meshes
+// plus the size of the flecs tables whose transforms changed, not with scene size.
+[[nodiscard]] RenderScene extract_render_scene_delta(Scene& scene, RenderSceneMeshDelta& mesh_delta,
+                                                     const RenderSceneExtractOptions& options = {},
+                                                     bool reset = false);
+
 }  // namespace teng::engine
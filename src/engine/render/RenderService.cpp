@@ -3,14 +3,17 @@
 #include <filesystem>
 #include <glm/ext/vector_int2.hpp>
 #include <memory>
-#include <tracy/Tracy.hpp>
-#include <unordered_map>
-#include <unordered_set>
+#include <memory_resource>
+#include <span>
 #include <utility>
+#include <vector>
 
 #include "Window.hpp"
 #include "core/EAssert.hpp"
+#include "core/FlatHashMap.hpp"
 #include "core/Logger.hpp"  // IWYU pragma: keep
+#include "core/Metrics.hpp"
+#include "core/Profiler.hpp"
 #include "engine/Engine.hpp"
 #include "engine/assets/AssetService.hpp"
 #include "engine/render/IRenderer.hpp"
@@ -23,16 +26,19 @@
 #include "gfx/GPUFrameAllocator2.hpp"
 #include "gfx/ImGuiRenderer.hpp"
 #include "gfx/ModelGPUManager.hpp"
+#include "gfx/ModelInstance.hpp"
 #include "gfx/RenderGraph.hpp"
 #include "gfx/ShaderManager.hpp"
 #include "gfx/renderer/BufferResize.hpp"
 #include "gfx/renderer/InstanceMgr.hpp"
 #include "gfx/renderer/MeshletRenderer.hpp"
 #include "gfx/renderer/ModelGPUUploader.hpp"
+#include "gfx/renderer/RendererCVars.hpp"
 #include "gfx/rhi/CmdEncoder.hpp"
 #include "gfx/rhi/Device.hpp"
 #include "gfx/rhi/GFXTypes.hpp"
 #include "gfx/rhi/Swapchain.hpp"
+#include "imgui.h"
 
 namespace teng::engine {
 
@@ -49,6 +55,20 @@ namespace {
   return true;
 }
 
+struct RenderThreadMetrics {
+  Histogram& submit_ms;
+  Histogram& wait_ms;
+};
+
+RenderThreadMetrics& render_thread_metrics() {
+  MetricsRegistry& registry = MetricsRegistry::get();
+  static RenderThreadMetrics metrics{
+      .submit_ms = registry.histogram("engine.render_thread_submit_ms"),
+      .wait_ms = registry.histogram("engine.render_thread_wait_ms"),
+  };
+  return metrics;
+}
+
 }  // namespace
 
 class RenderModelResidencyService {
@@ -58,39 +78,45 @@ class RenderModelResidencyService {
 
   ~RenderModelResidencyService() { clear_instances(); }
 
-  void reconcile(const RenderScene& scene) {
-    std::vector<std::pair<ModelGPUHandle, uint32_t>> reserve_requests;
-    reserve_requests.reserve(scene.meshes.size());
-    for (const RenderMesh& mesh : scene.meshes) {
-      if (!mesh.model.is_valid() || entity_instances_.contains(mesh.entity)) {
-        continue;
-      }
-      ModelResidency* model = ensure_model_resident(mesh.model);
-      if (model) {
-        reserve_requests.emplace_back(model->gpu_handle, 1);
-      }
-    }
-    if (!reserve_requests.empty()) {
-      model_gpu_mgr_.reserve_space_for(reserve_requests);
-    }
+  // Full diff against the meshes `scene` lists. Scratch vectors come from `frame_memory`.
+  void reconcile(const RenderScene& scene, std::pmr::memory_resource* frame_memory) {
+    prepare_meshes(scene.meshes, frame_memory);
 
-    std::unordered_set<EntityGuid> seen;
-    seen.reserve(scene.meshes.size());
+    seen_.clear();
+    seen_.reserve(scene.meshes.size());
     for (const RenderMesh& mesh : scene.meshes) {
-      seen.insert(mesh.entity);
+      seen_.insert(mesh.entity);
       reconcile_mesh(mesh);
     }
 
-    std::vector<EntityGuid> removed;
+    std::pmr::vector<EntityGuid> removed{frame_memory};
     for (const auto& [entity, instance] : entity_instances_) {
       (void)instance;
-      if (!seen.contains(entity)) {
+      if (!seen_.contains(entity)) {
         removed.push_back(entity);
       }
     }
     for (const EntityGuid entity : removed) {
       free_entity_instance(entity);
     }
+    model_gpu_mgr_.flush_instance_updates();
+  }
+
+  // Applies only what changed since the previous delta; the caller keeps the delta stream
+  // consistent with the current instances (clear_instances() before a reset extraction).
+  void apply_delta(const RenderSceneMeshDelta& delta, std::pmr::memory_resource* frame_memory) {
+    for (const EntityGuid entity : delta.removed) {
+      free_entity_instance(entity);
+    }
+    prepare_meshes(delta.added, frame_memory);
+    prepare_meshes(delta.changed, frame_memory);
+    for (const RenderMesh& mesh : delta.added) {
+      reconcile_mesh(mesh);
+    }
+    for (const RenderMesh& mesh : delta.changed) {
+      reconcile_mesh(mesh);
+    }
+    model_gpu_mgr_.flush_instance_updates();
   }
 
   void clear_instances() {
@@ -106,15 +132,45 @@ class RenderModelResidencyService {
   }
 
  private:
+  // Makes the models of meshes without an instance resident and reserves instance space for them.
+  void prepare_meshes(std::span<const RenderMesh> meshes, std::pmr::memory_resource* frame_memory) {
+    // Read the sources of every newly referenced model in one batch before importing them one by
+    // one, so later imports find their files already in memory.
+    std::pmr::vector<AssetId> missing_models{frame_memory};
+    for (const RenderMesh& mesh : meshes) {
+      if (mesh.model.is_valid() && !models_.contains(mesh.model)) {
+        missing_models.push_back(mesh.model);
+      }
+    }
+    if (!missing_models.empty()) {
+      assets_.prefetch_models(missing_models);
+    }
+
+    std::pmr::vector<std::pair<ModelGPUHandle, uint32_t>> reserve_requests{frame_memory};
+    reserve_requests.reserve(meshes.size());
+    for (const RenderMesh& mesh : meshes) {
+      if (!mesh.model.is_valid() || entity_instances_.contains(mesh.entity)) {
+        continue;
+      }
+      ModelResidency* model = ensure_model_resident(mesh.model);
+      if (model) {
+        reserve_requests.emplace_back(model->gpu_handle, 1);
+      }
+    }
+    if (!reserve_requests.empty()) {
+      model_gpu_mgr_.reserve_space_for(reserve_requests);
+    }
+  }
+
   struct ModelResidency {
-    ModelInstance model;
+    std::shared_ptr<const ModelHierarchy> hierarchy;
     ModelGPUHandle gpu_handle;
   };
 
   struct EntityInstance {
     AssetId model;
     glm::mat4 local_to_world{1.f};
-    ModelInstance instance;
+    ModelInstanceState instance;
   };
 
   void reconcile_mesh(const RenderMesh& mesh) {
@@ -124,8 +180,10 @@ class RenderModelResidencyService {
     }
 
     const auto it = entity_instances_.find(mesh.entity);
-    if (it != entity_instances_.end() && it->second.model == mesh.model &&
-        same_matrix(it->second.local_to_world, mesh.local_to_world)) {
+    if (it != entity_instances_.end() && it->second.model == mesh.model) {
+      if (!same_matrix(it->second.local_to_world, mesh.local_to_world)) {
+        move_entity_instance(it->second, mesh.local_to_world);
+      }
       return;
     }
     if (it != entity_instances_.end()) {
@@ -137,11 +195,9 @@ class RenderModelResidencyService {
       return;
     }
 
-    ModelInstance instance = model->model;
-    instance.set_transform(0, mesh.local_to_world);
-    instance.update_transforms();
+    ModelInstanceState instance{.hierarchy = model->hierarchy};
+    instance.set_root_transform(mesh.local_to_world);
     instance.instance_gpu_handle = model_gpu_mgr_.add_model_instance(instance, model->gpu_handle);
-    instance.model_gpu_handle = model->gpu_handle;
     entity_instances_.emplace(mesh.entity, EntityInstance{
                                                .model = mesh.model,
                                                .local_to_world = mesh.local_to_world,
@@ -149,6 +205,13 @@ class RenderModelResidencyService {
                                            });
   }
 
+  // Same model, new transform: rewrite its instance data in place instead of reallocating it.
+  void move_entity_instance(EntityInstance& entity, const glm::mat4& local_to_world) {
+    entity.local_to_world = local_to_world;
+    entity.instance.set_root_transform(local_to_world);
+    model_gpu_mgr_.update_instance_transforms(entity.instance.instance_gpu_handle, entity.instance);
+  }
+
   ModelResidency* ensure_model_resident(AssetId asset_id) {
     const auto it = models_.find(asset_id);
     if (it != models_.end()) {
@@ -164,10 +227,12 @@ class RenderModelResidencyService {
 
     ModelGPUHandle gpu_handle;
     model_gpu_mgr_.upload_model(imported.asset->load_result, imported.asset->model, gpu_handle);
-    auto [inserted, did_insert] = models_.emplace(asset_id, ModelResidency{
-                                                               .model = std::move(imported.asset->model),
-                                                               .gpu_handle = gpu_handle,
-                                                           });
+    // Only the hierarchy outlives the upload; instances share it instead of copying the model.
+    auto [inserted, did_insert] =
+        models_.emplace(asset_id, ModelResidency{
+                                      .hierarchy = ModelHierarchy::create(imported.asset->model),
+                                      .gpu_handle = gpu_handle,
+                                  });
     ASSERT(did_insert);
     return &inserted->second;
   }
@@ -183,8 +248,10 @@ class RenderModelResidencyService {
 
   assets::AssetService& assets_;
   gfx::ModelGPUMgr& model_gpu_mgr_;
-  std::unordered_map<AssetId, ModelResidency> models_;
-  std::unordered_map<EntityGuid, EntityInstance> entity_instances_;
+  FlatHashMap<AssetId, ModelResidency> models_;
+  FlatHashMap<EntityGuid, EntityInstance> entity_instances_;
+  // Scratch for reconcile(); kept across frames so its table is not reallocated every frame.
+  FlatHashSet<EntityGuid> seen_;
 };
 
 RenderService::RenderService(const CreateInfo& cinfo) { init(cinfo); }
@@ -195,7 +262,6 @@ void RenderService::init(const CreateInfo& cinfo) {
   ASSERT(!initialized_);
   ASSERT(cinfo.device != nullptr);
   ASSERT(cinfo.swapchain != nullptr);
-  ASSERT(cinfo.window != nullptr);
   ASSERT(cinfo.scenes != nullptr);
   ASSERT(cinfo.assets != nullptr);
   ASSERT(cinfo.time != nullptr);
@@ -216,6 +282,7 @@ void RenderService::init(const CreateInfo& cinfo) {
   imgui_renderer_ = std::make_unique<gfx::ImGuiRenderer>(*shader_mgr_, device_);
   ALWAYS_ASSERT(gfx::RenderGraph::run_barrier_coalesce_self_tests());
   render_graph_.init(device_);
+  render_graph_.set_frame_memory(frame_arena_.resource());
   model_gpu_mgr_ = std::make_unique<gfx::ModelGPUMgr>(*device_, *buffer_copy_mgr_);
   model_residency_ = std::make_unique<RenderModelResidencyService>(*assets_, *model_gpu_mgr_);
 
@@ -256,14 +323,30 @@ void RenderService::init(const CreateInfo& cinfo) {
   initialized_ = true;
   // TODO: this is scene/game dependent. A 2d game uses different renderer maybe? or maybe not?
   set_renderer(std::make_unique<gfx::MeshletRenderer>());
+  if (cinfo.render_thread) {
+    render_thread_stop_ = false;
+    render_thread_frame_pending_ = false;
+    render_thread_ = std::thread([this] { render_thread_loop(); });
+  }
 }
 
 void RenderService::shutdown() {
   if (!initialized_) {
     return;
   }
+  if (render_thread_.joinable()) {
+    // The loop submits a pending frame before it honors the stop request.
+    {
+      std::lock_guard lock(render_thread_mtx_);
+      render_thread_stop_ = true;
+    }
+    render_thread_cv_.notify_all();
+    render_thread_.join();
+  }
   renderer_.reset();
   model_residency_.reset();
+  last_extracted_scene_.reset();
+  delta_scene_id_.reset();
   samplers_.clear();
   model_gpu_mgr_.reset();
   render_graph_.shutdown();
@@ -284,6 +367,7 @@ void RenderService::shutdown() {
 }
 
 void RenderService::shutdown_imgui_renderer() {
+  wait_for_render_thread();
   if (imgui_renderer_) {
     imgui_renderer_->shutdown();
     imgui_renderer_.reset();
@@ -291,6 +375,7 @@ void RenderService::shutdown_imgui_renderer() {
 }
 
 void RenderService::set_renderer(std::unique_ptr<IRenderer> renderer) {
+  wait_for_render_thread();
   renderer_ = std::move(renderer);
   if (renderer_ && initialized_) {
     renderer_->on_resize(frame_);
@@ -301,7 +386,19 @@ void RenderService::begin_frame() {
   ZoneScoped;
   ASSERT(initialized_);
   ASSERT(!frame_open_);
-
+  // Pipelining handshake: the previous frame must be submitted before this one acquires a
+  // swapchain image (which may recreate the swapchain on resize), samples the window size or
+  // rewinds the arena slot holding an older scene. The scene extracted below then stays
+  // untouched until the render thread has submitted it.
+  wait_for_render_thread();
+
+  // Drop the extracted scene before its arena slot is rewound (no scene was extracted since).
+  if (last_extracted_scene_ &&
+      last_extracted_scene_slot_ == (frame_arena_.curr_slot() + 1) % frame_arena_.frame_count()) {
+    last_extracted_scene_.reset();
+  }
+  frame_arena_.begin_frame();
+  render_graph_.set_frame_memory(frame_arena_.resource());
   update_frame_context();
   shader_mgr_->replace_dirty_pipelines();
   device_->acquire_next_swapchain_image(swapchain_);
@@ -320,21 +417,34 @@ void RenderService::enqueue_active_scene() {
   ASSERT(renderer_ != nullptr);
 
   Scene* active_scene = scenes_->active_scene();
-  last_extracted_scene_ =
+  const RenderSceneFrame scene_frame{
+      .frame_index = frame_.frame_index,
+      .delta_seconds = time_->delta_seconds,
+      .output_extent = frame_.output_extent,
+  };
+  // Meshes are extracted as deltas against the instances already resident. A different scene (or
+  // a full reconcile through render_scene()) restarts the delta stream from empty instances.
+  const SceneId active_scene_id = active_scene ? active_scene->id() : SceneId{};
+  const bool reset_meshes = delta_scene_id_ != active_scene_id;
+  if (reset_meshes) {
+    model_residency_->clear_instances();
+    delta_scene_id_ = active_scene_id;
+  }
+  RenderSceneMeshDelta mesh_delta{
+      .added = std::pmr::vector<RenderMesh>(frame_arena_.resource()),
+      .changed = std::pmr::vector<RenderMesh>(frame_arena_.resource()),
+      .removed = std::pmr::vector<EntityGuid>(frame_arena_.resource()),
+  };
+  // emplace move-constructs, so the lists keep the frame arena as their resource.
+  last_extracted_scene_.emplace(
       active_scene
-          ? extract_render_scene(*active_scene, {.frame =
-                                                     RenderSceneFrame{
-                                                         .frame_index = frame_.frame_index,
-                                                         .delta_seconds = time_->delta_seconds,
-                                                         .output_extent = frame_.output_extent,
-                                                     }})
-          : RenderScene{.frame = RenderSceneFrame{
-                            .frame_index = frame_.frame_index,
-                            .delta_seconds = time_->delta_seconds,
-                            .output_extent = frame_.output_extent,
-                        }};
-  model_residency_->reconcile(last_extracted_scene_);
-  renderer_->render(frame_, last_extracted_scene_);
+          ? extract_render_scene_delta(*active_scene, mesh_delta,
+                                       {.frame = scene_frame, .memory = frame_arena_.resource()},
+                                       reset_meshes)
+          : RenderScene{.frame = scene_frame});
+  last_extracted_scene_slot_ = frame_arena_.curr_slot();
+  model_residency_->apply_delta(mesh_delta, frame_arena_.resource());
+  renderer_->render(frame_, *last_extracted_scene_);
 }
 
 void RenderService::enqueue_imgui_overlay_pass() {
@@ -363,7 +473,51 @@ void RenderService::end_frame() {
   ZoneScoped;
   ASSERT(initialized_);
   ASSERT(frame_open_);
+  frame_open_ = false;
+  if (!render_thread_.joinable()) {
+    submit_frame();
+    return;
+  }
+  {
+    std::lock_guard lock(render_thread_mtx_);
+    ASSERT(!render_thread_frame_pending_);
+    render_thread_frame_pending_ = true;
+  }
+  render_thread_cv_.notify_all();
+}
 
+void RenderService::wait_for_render_thread() {
+  if (!render_thread_.joinable()) {
+    return;
+  }
+  ZoneScoped;
+  ScopedHistogramTimer wait_timer(render_thread_metrics().wait_ms);
+  std::unique_lock lock(render_thread_mtx_);
+  render_thread_cv_.wait(lock, [this] { return !render_thread_frame_pending_; });
+}
+
+void RenderService::render_thread_loop() {
+  Profiler::set_thread_name("render");
+  std::unique_lock lock(render_thread_mtx_);
+  while (true) {
+    render_thread_cv_.wait(
+        lock, [this] { return render_thread_frame_pending_ || render_thread_stop_; });
+    if (!render_thread_frame_pending_) {
+      return;
+    }
+    lock.unlock();
+    {
+      ScopedHistogramTimer submit_timer(render_thread_metrics().submit_ms);
+      submit_frame();
+    }
+    lock.lock();
+    render_thread_frame_pending_ = false;
+    render_thread_cv_.notify_all();
+  }
+}
+
+void RenderService::submit_frame() {
+  ZoneScoped;
   static int i = 0;
   const bool verbose = i++ == -1;
   render_graph_.bake(frame_.output_extent, verbose);
@@ -374,9 +528,16 @@ void RenderService::end_frame() {
 
   flush_pending_texture_uploads(enc);
 
-  render_graph_.execute(enc);
-
-  enc->end_encoding();
+  const int32_t record_chunks =
+      frame_.cvars->get(gfx::renderer_cv::developer_render_graph_record_chunks);
+  if (record_chunks > 1) {
+    // Graph encoders are submitted after this one, so uploads still land first.
+    enc->end_encoding();
+    render_graph_.execute_parallel(static_cast<uint32_t>(record_chunks));
+  } else {
+    render_graph_.execute(enc);
+    enc->end_encoding();
+  }
 
   device_->submit_frame();
 
@@ -385,7 +546,6 @@ void RenderService::end_frame() {
   if (frame_gpu_upload_allocator_) {
     frame_gpu_upload_allocator_->set_frame_idx_and_reset_bufs(frame_.curr_frame_in_flight_idx);
   }
-  frame_open_ = false;
 }
 
 void RenderService::render_scene(const RenderScene& scene) {
@@ -394,22 +554,43 @@ void RenderService::render_scene(const RenderScene& scene) {
   ASSERT(renderer_ != nullptr);
 
   begin_frame();
-  model_residency_->reconcile(scene);
+  model_residency_->reconcile(scene, frame_arena_.resource());
+  delta_scene_id_.reset();
   renderer_->render(frame_, scene);
   end_frame();
+  // The caller owns `scene`; do not return while the render thread may still read it.
+  wait_for_render_thread();
 }
 
 void RenderService::set_imgui_ui_active(bool active) { frame_.imgui_ui_active = active; }
 
+const RenderScene& RenderService::last_extracted_scene() const {
+  static const RenderScene empty;
+  return last_extracted_scene_ ? *last_extracted_scene_ : empty;
+}
+
 void RenderService::on_imgui() {
   if (renderer_) {
     renderer_->on_imgui(frame_);
   }
+  render_graph_.on_imgui_gpu_timings();
+  if (ImGui::CollapsingHeader("Frame arena")) {
+    const FrameArena::Stats stats = frame_arena_.get_stats();
+    ImGui::Text("Last frame: %.1f KiB  High water: %.1f KiB", stats.last_frame_bytes / 1024.0,
+                stats.high_water_bytes / 1024.0);
+    ImGui::Text("Capacity: %.1f KiB over %u frames, %llu block allocations",
+                stats.capacity_bytes / 1024.0, frame_arena_.frame_count(),
+                static_cast<unsigned long long>(stats.heap_allocations));
+  }
 }
 
-void RenderService::request_render_graph_debug_dump() { render_graph_.request_debug_dump_once(); }
+void RenderService::request_render_graph_debug_dump() {
+  wait_for_render_thread();
+  render_graph_.request_debug_dump_once();
+}
 
 void RenderService::recreate_resources_on_swapchain_resize() {
+  wait_for_render_thread();
   if (renderer_) {
     update_frame_context();
     renderer_->on_resize(frame_);
@@ -417,8 +598,8 @@ void RenderService::recreate_resources_on_swapchain_resize() {
 }
 
 void RenderService::update_frame_context() {
-  const glm::ivec2 window_size = window_->get_window_size();
-  frame_.output_extent = window_size;
+  frame_.output_extent = window_ ? window_->get_window_size()
+                                 : glm::uvec2{swapchain_->desc_.width, swapchain_->desc_.height};
   frame_.frame_index = time_ ? time_->frame_index : 0;
   frame_.time = time_;
   frame_.device = device_;
@@ -431,6 +612,9 @@ void RenderService::update_frame_context() {
   frame_.model_gpu_mgr = model_gpu_mgr_.get();
   frame_.scenes = scenes_;
   frame_.resource_dir = &resource_dir_;
+  frame_.frame_memory = frame_arena_.resource();
+  frame_cvars_ = CVarSystem::get().acquire_snapshot();
+  frame_.cvars = frame_cvars_.get();
 }
 
 void RenderService::flush_pending_buffer_copies(gfx::rhi::CmdEncoder* enc) {
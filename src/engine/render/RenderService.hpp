@@ -1,9 +1,15 @@
 #pragma once
 
+#include <condition_variable>
 #include <filesystem>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <vector>
 
+#include "core/CVar.hpp"
+#include "core/FrameArena.hpp"
 #include "engine/render/RenderFrameContext.hpp"
 #include "engine/render/RenderScene.hpp"
 #include "gfx/BackedGPUAllocator.hpp"
@@ -44,12 +50,17 @@ class RenderService {
   struct CreateInfo {
     gfx::rhi::Device* device{};
     gfx::rhi::Swapchain* swapchain{};
+    // Null when headless: the output extent then comes from the swapchain.
     Window* window{};
     SceneManager* scenes{};
     assets::AssetService* assets{};
     const EngineTime* time{};
     std::filesystem::path resource_dir;
     bool imgui_ui_active{};
+    // Pipelined mode: end_frame() hands the recorded frame to a dedicated render thread, which
+    // bakes, encodes and submits it while the caller simulates the next frame. begin_frame()
+    // waits for that submission, so at most one frame is in flight on the CPU.
+    bool render_thread{};
   };
 
   RenderService() = default;
@@ -71,14 +82,24 @@ class RenderService {
   void on_imgui();
   void request_render_graph_debug_dump();
   void recreate_resources_on_swapchain_resize();
+  // Blocks until the render thread has submitted the last frame; a no-op without one. Between
+  // end_frame() and the next begin_frame() the render thread owns the device, render graph, GPU
+  // managers and ImGui draw data: anything touching them from other threads waits here first.
+  void wait_for_render_thread();
 
+  [[nodiscard]] bool render_thread_enabled() const { return render_thread_.joinable(); }
   [[nodiscard]] RenderFrameContext& frame_context() { return frame_; }
   [[nodiscard]] const RenderFrameContext& frame_context() const { return frame_; }
-  [[nodiscard]] const RenderScene& last_extracted_scene() const { return last_extracted_scene_; }
+  [[nodiscard]] const RenderScene& last_extracted_scene() const;
+  [[nodiscard]] FrameArena::Stats frame_arena_stats() const { return frame_arena_.get_stats(); }
   [[nodiscard]] gfx::RenderGraph& render_graph() { return render_graph_; }
 
  private:
   void update_frame_context();
+  // Bakes, encodes and submits the recorded frame: end_frame() on the calling thread, or the
+  // render thread in pipelined mode.
+  void submit_frame();
+  void render_thread_loop();
   void flush_pending_buffer_copies(gfx::rhi::CmdEncoder* enc);
   void flush_pending_texture_uploads(gfx::rhi::CmdEncoder* enc);
 
@@ -96,10 +117,23 @@ class RenderService {
   std::unique_ptr<gfx::ModelGPUMgr> model_gpu_mgr_;
   std::unique_ptr<RenderModelResidencyService> model_residency_;
   std::unique_ptr<IRenderer> renderer_;
+  // CPU per-frame temporaries: the extracted RenderScene, residency scratch and render graph pass
+  // lists. Double-buffered so last frame's scene outlives the rewind at begin_frame. Declared
+  // before its users so it is destroyed after them.
+  FrameArena frame_arena_;
   gfx::RenderGraph render_graph_;
   RenderFrameContext frame_;
-  RenderScene last_extracted_scene_;
+  std::shared_ptr<const CVarSnapshot> frame_cvars_;
+  std::optional<RenderScene> last_extracted_scene_;
+  uint32_t last_extracted_scene_slot_{};
+  // Scene whose mesh deltas the residency instances reflect; unset after a full reconcile.
+  std::optional<SceneId> delta_scene_id_;
   std::vector<gfx::rhi::SamplerHandleHolder> samplers_;
+  std::thread render_thread_;
+  std::mutex render_thread_mtx_;
+  std::condition_variable render_thread_cv_;
+  bool render_thread_frame_pending_{};
+  bool render_thread_stop_{};
   bool frame_open_{};
   bool initialized_{};
 };
@@ -124,10 +124,26 @@ void Scene::register_systems() {
         transform.rotation = glm::quat_cast(local_to_world.value);
       });
 
+  // Only tables whose transforms changed are rewritten. Skipped tables leave LocalToWorld
+  // unmarked, so change-detecting queries downstream (render extraction) see static entities as
+  // unchanged. LocalToWorld is write-only here so the system's own writes do not count as input.
   world_.system<const Transform, LocalToWorld>("UpdateLocalToWorld")
       .kind(flecs::OnUpdate)
-      .each([](const Transform& transform, LocalToWorld& local_to_world) {
-        local_to_world.value = transform_to_matrix(transform);
+      .term_at(1)
+      .out()
+      .detect_changes()
+      .run([](flecs::iter& it) {
+        while (it.next()) {
+          if (!it.changed()) {
+            it.skip();
+            continue;
+          }
+          const auto transforms = it.field<const Transform>(0);
+          const auto local_to_worlds = it.field<LocalToWorld>(1);
+          for (const auto i : it) {
+            local_to_worlds[i].value = transform_to_matrix(transforms[i]);
+          }
+        }
       });
 }
 
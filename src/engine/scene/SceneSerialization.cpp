@@ -9,7 +9,6 @@
 #include <format>
 #include <fstream>
 #include <glm/ext/matrix_float4x4.hpp>
-#include <iterator>
 #include <nlohmann/json.hpp>
 #include <set>
 #include <span>
@@ -23,6 +22,7 @@
 
 #include "core/Diagnostic.hpp"
 #include "core/EAssert.hpp"
+#include "core/MappedFile.hpp"
 #include "core/Result.hpp"
 #include "engine/scene/ComponentRegistry.hpp"
 #include "engine/scene/SceneComponents.hpp"
@@ -46,14 +46,6 @@ struct EntityRecord {
   return "failed to " + std::string(action) + " " + path.string();
 }
 
-[[nodiscard]] Result<std::string> read_text_file(const std::filesystem::path& path) {
-  std::ifstream in(path, std::ios::binary);
-  if (!in) {
-    return make_unexpected(io_error(path, "open"));
-  }
-  return std::string{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
-}
-
 [[nodiscard]] Result<void> write_text_file(const std::filesystem::path& path,
                                            std::string_view text) {
   std::ofstream out(path, std::ios::binary | std::ios::trunc);
@@ -65,10 +57,11 @@ struct EntityRecord {
 }
 
 [[nodiscard]] Result<json> parse_json_file(const std::filesystem::path& path) {
-  Result<std::string> text = read_text_file(path);
-  REQUIRED_OR_RETURN(text);
+  const Result<MappedFile> file = MappedFile::open(path);
+  REQUIRED_OR_RETURN(file);
   try {
-    return json::parse(*text);
+    const std::string_view text = file->text();
+    return json::parse(text.begin(), text.end());
   } catch (const json::parse_error& error) {
     return make_unexpected("failed to parse JSON scene " + path.string() + " at byte " +
                            std::to_string(error.byte) + ": " + error.what());
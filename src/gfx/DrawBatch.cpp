@@ -44,7 +44,8 @@ GeometryBatch::GeometryBatch(GeometryBatchType type, rhi::Device& device,
                {
                    .usage = rhi::BufferUsage::Storage,
                    .size = cinfo.initial_mesh_capacity * sizeof(MeshData),
-                   // .flags = rhi::BufferDescFlags::DisableCPUAccessOnUMA,
+                   // read by culling on the async compute queue
+                   .flags = rhi::BufferDescFlags::SharedAcrossQueues,
                    .name = "mesh buf",
                },
                sizeof(MeshData)),
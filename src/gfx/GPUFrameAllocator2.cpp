@@ -136,7 +136,9 @@ GPUFrameAllocator3::StagingBuffer GPUFrameAllocator3::create_staging_buffer(uint
   return {device_->create_buf_h({
               .usage = uniform_allocator_ ? rhi::BufferUsage::Uniform : rhi::BufferUsage::Storage,
               .size = size,
-              .flags = rhi::BufferDescFlags::CPUAccessible,
+              // constant buffers are bound by passes on any queue
+              .flags = rhi::BufferDescFlags::CPUAccessible |
+                       rhi::BufferDescFlags::SharedAcrossQueues,
               .name = "gpu_frame_allocator3_staging_buf",
           }),
           0, size};
@@ -0,0 +1,188 @@
+#include "GPUPassTimer.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <string>
+
+#include "core/EAssert.hpp"
+#include "core/Profiler.hpp"
+#include "gfx/rhi/QueryPool.hpp"
+#include "imgui.h"
+#include "implot.h"
+
+namespace TENG_NAMESPACE {
+
+namespace gfx {
+
+void GPUPassTimer::init(rhi::Device* device) {
+  device_ = device;
+  ring_size_ = static_cast<uint32_t>(device_->frames_in_flight()) + 1;
+  ALWAYS_ASSERT(ring_size_ <= slots_.size());
+}
+
+void GPUPassTimer::shutdown() {
+  for (auto& slot : slots_) {
+    slot = {};
+  }
+  histories_.clear();
+  active_ = false;
+}
+
+bool GPUPassTimer::begin_frame(uint32_t pass_count, bool enabled) {
+  ZoneScoped;
+  slot_i_ = (slot_i_ + 1) % ring_size_;
+  Slot& slot = slots_[slot_i_];
+  resolve_slot_(slot);
+  active_ = enabled && pass_count > 0 && device_->get_info().timestamp_frequency > 0;
+  if (!active_) {
+    return false;
+  }
+  const uint32_t query_count = pass_count * 2;
+  if (slot.capacity < query_count) {
+    slot.capacity = std::bit_ceil(std::max(query_count, 64u));
+    slot.pool = device_->create_query_pool_h(
+        rhi::QueryPoolDesc{.count = slot.capacity, .name = "rg_pass_timestamps"});
+    if (!slot.pool.is_valid()) {
+      slot.capacity = 0;
+      active_ = false;
+    }
+  }
+  return active_;
+}
+
+void GPUPassTimer::end_frame(std::span<const uint32_t> pass_keys) {
+  if (!active_) {
+    return;
+  }
+  slots_[slot_i_].keys.assign(pass_keys.begin(), pass_keys.end());
+  active_ = false;
+}
+
+void GPUPassTimer::resolve_slot_(Slot& slot) {
+  if (slot.keys.empty()) {
+    return;
+  }
+  const auto query_count = static_cast<uint32_t>(slot.keys.size() * 2);
+  resolve_scratch_.assign(query_count, 0);
+  device_->resolve_query_data(slot.pool.handle, 0, query_count, resolve_scratch_);
+  const double ms_per_tick = 1000.0 / static_cast<double>(device_->get_info().timestamp_frequency);
+  for (uint32_t exec_i = 0; exec_i < slot.keys.size(); ++exec_i) {
+    const uint64_t begin = resolve_scratch_[begin_query(exec_i)];
+    const uint64_t end = resolve_scratch_[end_query(exec_i)];
+    if (begin == 0 || end < begin) {
+      dropped_samples_++;
+      continue;
+    }
+    const uint32_t key = slot.keys[exec_i];
+    if (key >= histories_.size()) {
+      histories_.resize(key + 1);
+    }
+    History& h = histories_[key];
+    h.samples_ms[h.next] = static_cast<float>(static_cast<double>(end - begin) * ms_per_tick);
+    h.next = (h.next + 1) % k_history_len;
+    h.count = std::min(h.count + 1, k_history_len);
+  }
+  slot.keys.clear();
+}
+
+GPUPassTimer::Stats GPUPassTimer::get_stats(uint32_t key) const {
+  if (key >= histories_.size() || histories_[key].count == 0) {
+    return {};
+  }
+  const History& h = histories_[key];
+  std::array<float, k_history_len> sorted;
+  std::copy_n(h.samples_ms.begin(), h.count, sorted.begin());
+  std::sort(sorted.begin(), sorted.begin() + h.count);
+  float sum = 0.f;
+  for (uint32_t i = 0; i < h.count; ++i) {
+    sum += sorted[i];
+  }
+  const auto p99_i = static_cast<uint32_t>(std::ceil(0.99 * h.count)) - 1;
+  return Stats{
+      .last_ms = h.samples_ms[(h.next + k_history_len - 1) % k_history_len],
+      .min_ms = sorted[0],
+      .avg_ms = sum / static_cast<float>(h.count),
+      .p99_ms = sorted[p99_i],
+      .sample_count = h.count,
+  };
+}
+
+void GPUPassTimer::on_imgui(const std::function<std::string_view(uint32_t)>& key_name) const {
+  if (!ImGui::CollapsingHeader("Render graph GPU pass timings")) {
+    return;
+  }
+  struct Row {
+    std::string name;
+    Stats stats;
+  };
+  std::vector<Row> rows;
+  for (uint32_t key = 0; key < key_count(); ++key) {
+    const Stats stats = get_stats(key);
+    if (stats.sample_count > 0) {
+      rows.push_back(Row{.name = std::string(key_name(key)), .stats = stats});
+    }
+  }
+  if (rows.empty()) {
+    ImGui::TextUnformatted("No samples (enable renderer.developer.render_graph_gpu_timing).");
+    return;
+  }
+  std::ranges::sort(rows, [](const Row& a, const Row& b) { return a.stats.avg_ms > b.stats.avg_ms; });
+
+  float total_avg_ms = 0.f;
+  for (const Row& row : rows) {
+    total_avg_ms += row.stats.avg_ms;
+  }
+  ImGui::Text("Sum of pass averages: %.3f ms (%llu dropped samples)", total_avg_ms,
+              static_cast<unsigned long long>(dropped_samples_));
+
+  if (ImGui::BeginTable("rg_gpu_pass_timings", 5,
+                        ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders |
+                            ImGuiTableFlags_SizingStretchProp)) {
+    ImGui::TableSetupColumn("Pass");
+    ImGui::TableSetupColumn("Last ms");
+    ImGui::TableSetupColumn("Min ms");
+    ImGui::TableSetupColumn("Avg ms");
+    ImGui::TableSetupColumn("P99 ms");
+    ImGui::TableHeadersRow();
+    for (const Row& row : rows) {
+      ImGui::TableNextRow();
+      ImGui::TableNextColumn();
+      ImGui::TextUnformatted(row.name.c_str());
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", row.stats.last_ms);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", row.stats.min_ms);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", row.stats.avg_ms);
+      ImGui::TableNextColumn();
+      ImGui::Text("%.3f", row.stats.p99_ms);
+    }
+    ImGui::EndTable();
+  }
+
+  std::vector<double> avg_ms(rows.size());
+  std::vector<double> p99_ms(rows.size());
+  std::vector<double> ticks(rows.size());
+  std::vector<const char*> labels(rows.size());
+  for (size_t i = 0; i < rows.size(); ++i) {
+    avg_ms[i] = rows[i].stats.avg_ms;
+    p99_ms[i] = rows[i].stats.p99_ms;
+    ticks[i] = static_cast<double>(i);
+    labels[i] = rows[i].name.c_str();
+  }
+  const float plot_height = (static_cast<float>(rows.size()) * 18.f) + 60.f;
+  if (ImPlot::BeginPlot("##rg_gpu_pass_bars", ImVec2(-1, plot_height))) {
+    ImPlot::SetupAxes("ms", nullptr, ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+    ImPlot::SetupAxisTicks(ImAxis_Y1, ticks.data(), static_cast<int>(ticks.size()), labels.data());
+    ImPlot::PlotBars("p99", p99_ms.data(), static_cast<int>(p99_ms.size()), 0.7, 0.0,
+                     ImPlotBarsFlags_Horizontal);
+    ImPlot::PlotBars("avg", avg_ms.data(), static_cast<int>(avg_ms.size()), 0.4, 0.0,
+                     ImPlotBarsFlags_Horizontal);
+    ImPlot::EndPlot();
+  }
+}
+
+}  // namespace gfx
+
+}  // namespace TENG_NAMESPACE
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "core/Config.hpp"
+#include "gfx/rhi/Config.hpp"
+#include "gfx/rhi/Device.hpp"
+#include "gfx/rhi/GFXTypes.hpp"
+
+namespace TENG_NAMESPACE {
+
+namespace gfx {
+
+// Per-pass GPU timestamps for RenderGraph. Every timed frame writes a begin/end query pair per
+// pass into one query pool of a ring. A pool is read back only when the ring wraps around to it,
+// frames_in_flight + 1 frames later, so its frame has already retired and resolving never stalls.
+// Samples are keyed by the caller (RenderGraph uses pass name ids).
+class GPUPassTimer {
+ public:
+  static constexpr uint32_t k_history_len = 128;
+
+  struct Stats {
+    float last_ms{};
+    float min_ms{};
+    float avg_ms{};
+    float p99_ms{};
+    uint32_t sample_count{};
+  };
+
+  void init(rhi::Device* device);
+  void shutdown();
+
+  // Resolves the ring slot this frame reuses and sizes it for `pass_count` passes. Passes are
+  // timed this frame iff this returns true.
+  bool begin_frame(uint32_t pass_count, bool enabled);
+  // Tags the frame's query pairs (indexed by pass exec index) with their keys for resolution.
+  void end_frame(std::span<const uint32_t> pass_keys);
+
+  [[nodiscard]] bool active() const { return active_; }
+  [[nodiscard]] rhi::QueryPoolHandle query_pool() const { return slots_[slot_i_].pool.handle; }
+  [[nodiscard]] static uint32_t begin_query(uint32_t exec_i) { return exec_i * 2; }
+  [[nodiscard]] static uint32_t end_query(uint32_t exec_i) { return (exec_i * 2) + 1; }
+
+  // Rolling stats over the last k_history_len resolved samples. sample_count is 0 if none.
+  [[nodiscard]] Stats get_stats(uint32_t key) const;
+  [[nodiscard]] uint32_t key_count() const { return static_cast<uint32_t>(histories_.size()); }
+  // Query pairs discarded because a timestamp was missing or end < begin.
+  [[nodiscard]] uint64_t dropped_sample_count() const { return dropped_samples_; }
+
+  // Table + bar chart of every key with samples; `key_name` labels a key.
+  void on_imgui(const std::function<std::string_view(uint32_t)>& key_name) const;
+
+ private:
+  struct Slot {
+    rhi::QueryPoolHandleHolder pool;
+    uint32_t capacity{};
+    // Key per exec index of the frame written into `pool`; empty when nothing is pending.
+    std::vector<uint32_t> keys;
+  };
+  struct History {
+    std::array<float, k_history_len> samples_ms{};
+    uint32_t next{};
+    uint32_t count{};
+  };
+
+  void resolve_slot_(Slot& slot);
+
+  rhi::Device* device_{};
+  std::array<Slot, k_max_frames_in_flight + 1> slots_;
+  uint32_t ring_size_{};
+  uint32_t slot_i_{};
+  bool active_{};
+  std::vector<History> histories_;
+  std::vector<uint64_t> resolve_scratch_;
+  uint64_t dropped_samples_{};
+};
+
+}  // namespace gfx
+
+}  // namespace TENG_NAMESPACE
@@ -1,7 +1,6 @@
 #include "ModelGPUManager.hpp"
 
-#include <tracy/Tracy.hpp>
-
+#include "core/Profiler.hpp"
 #include "gfx/renderer/RendererCVars.hpp"
 #include "hlsl/material.h"
 #include "hlsl/shader_constants.h"
@@ -60,7 +59,7 @@ void ModelGPUMgr::reserve_space_for(std::span<std::pair<ModelGPUHandle, uint32_t
   static_instance_mgr_.reserve_space(total_instance_datas);
 }
 
-ModelInstanceGPUHandle ModelGPUMgr::add_model_instance(ModelInstance& model,
+ModelInstanceGPUHandle ModelGPUMgr::add_model_instance(const ModelInstanceState& instance,
                                                        ModelGPUHandle model_gpu_handle) {
   ZoneScoped;
   auto* model_resources = model_gpu_resource_pool_.get(model_gpu_handle);
@@ -87,12 +86,12 @@ ModelInstanceGPUHandle ModelGPUMgr::add_model_instance(ModelInstance& model,
   }
   for (size_t i = 0; i < instance_datas.size(); i++) {
     auto node_i = instance_id_to_node[i];
-    const auto& transform = model.global_transforms[node_i];
+    const TRS transform = instance.global_transform(node_i);
     instance_datas[i].translation = transform.translation;
     instance_datas[i].rotation = transform.rotation;
     instance_datas[i].scale = transform.scale;
     instance_datas[i].meshlet_vis_base += instance_data_gpu_alloc.meshlet_vis_alloc.offset;
-    const size_t mesh_id = model.mesh_ids[node_i];
+    const size_t mesh_id = instance.hierarchy->mesh_ids[node_i];
     auto& mesh = model_resources->meshes[mesh_id];
     const IndexedIndirectDrawCmd cmd{
         .index_count = mesh.index_count,
@@ -139,6 +138,32 @@ ModelInstanceGPUHandle ModelGPUMgr::add_model_instance(ModelInstance& model,
   });
 }
 
+void ModelGPUMgr::update_instance_transforms(ModelInstanceGPUHandle handle,
+                                             const ModelInstanceState& instance) {
+  const auto* gpu_resources = model_instance_gpu_resource_pool_.get(handle);
+  ASSERT(gpu_resources);
+  if (!gpu_resources) {
+    return;
+  }
+  const auto* model_resources = model_gpu_resource_pool_.get(gpu_resources->model_resources_handle);
+  ASSERT(model_resources);
+  const InstanceMgr::Alloc& alloc = gpu_resources->instance_data_gpu_alloc;
+
+  // Every node hangs off the root, so every entry moves.
+  const auto& instance_id_to_node = model_resources->instance_id_to_node;
+  for (size_t i = 0; i < instance_id_to_node.size(); i++) {
+    // Same entry add_model_instance built, with the new transform.
+    InstanceData data = model_resources->base_instance_datas[i];
+    const TRS transform = instance.global_transform(instance_id_to_node[i]);
+    data.translation = transform.translation;
+    data.rotation = transform.rotation;
+    data.scale = transform.scale;
+    data.meshlet_vis_base += alloc.meshlet_vis_alloc.offset;
+    static_instance_mgr_.write_instance_data(
+        static_cast<uint32_t>(alloc.instance_data_alloc.offset + i), data);
+  }
+}
+
 void ModelGPUMgr::free_instance(ModelInstanceGPUHandle handle) {
   auto* gpu_resources = model_instance_gpu_resource_pool_.get(handle);
   ASSERT(gpu_resources);
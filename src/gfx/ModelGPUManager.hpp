@@ -39,7 +39,14 @@ class ModelGPUMgr {
   void upload_model(ModelLoadResult& result, ModelInstance& model, ModelGPUHandle& out_handle);
   void set_curr_frame_idx(uint32_t curr_frame_idx) { curr_frame_idx_ = curr_frame_idx; }
   void reserve_space_for(std::span<std::pair<ModelGPUHandle, uint32_t>> models);
-  ModelInstanceGPUHandle add_model_instance(ModelInstance& model, ModelGPUHandle model_gpu_handle);
+  ModelInstanceGPUHandle add_model_instance(const ModelInstanceState& instance,
+                                            ModelGPUHandle model_gpu_handle);
+  // Rewrites the transforms of an existing instance in place after its root moved, keeping its
+  // instance data and meshlet visibility allocations. The writes reach the GPU at the next
+  // flush_instance_updates().
+  void update_instance_transforms(ModelInstanceGPUHandle handle,
+                                  const ModelInstanceState& instance);
+  void flush_instance_updates() { static_instance_mgr_.flush_instance_writes(); }
   void free_instance(ModelInstanceGPUHandle handle);
   void free_model(ModelGPUHandle handle);
   struct Stats {
@@ -82,9 +89,9 @@ class ModelGPUMgr {
   BackedGPUAllocator materials_buf_;
   std::vector<GPUTexUpload> pending_texture_uploads_;
   uint32_t curr_frame_idx_{UINT32_MAX};
-  BlockPool<ModelGPUHandle, ModelGPUResources> model_gpu_resource_pool_{20, 1, true};
-  BlockPool<ModelInstanceGPUHandle, ModelInstanceGPUResources> model_instance_gpu_resource_pool_{
-      1024, 5, true};
+  AtomicBlockPool<ModelGPUHandle, ModelGPUResources> model_gpu_resource_pool_{20, 1, true};
+  AtomicBlockPool<ModelInstanceGPUHandle, ModelInstanceGPUResources>
+      model_instance_gpu_resource_pool_{1024, 5, true};
 };
 
 }  // namespace gfx
@@ -19,6 +19,14 @@ TRS to_trs(const glm::mat4& transform) {
 
 }  // namespace
 
+TRS compose_transforms(const TRS& parent, const TRS& child) {
+  return {
+      .translation = parent.translation + parent.rotation * (parent.scale * child.translation),
+      .rotation = parent.rotation * child.rotation,
+      .scale = parent.scale * child.scale,
+  };
+}
+
 void ModelInstance::set_transform(int32_t node, const glm::mat4& transform) {
   local_transforms[node] = to_trs(transform);
   mark_changed(node);
@@ -52,13 +60,8 @@ bool ModelInstance::update_transforms() {
     auto& level_changed_nodes = changed_this_frame[level];
     dirty |= !level_changed_nodes.empty();
     for (const auto node : level_changed_nodes) {
-      const auto parent_rot = global_transforms[nodes[node].parent].rotation;
-      const auto parent_scale = global_transforms[nodes[node].parent].scale;
-      const auto parent_translation = global_transforms[nodes[node].parent].translation;
-      global_transforms[node].rotation = parent_rot * local_transforms[node].rotation;
-      global_transforms[node].scale = parent_scale * local_transforms[node].scale;
-      global_transforms[node].translation =
-          parent_translation + parent_rot * (parent_scale * local_transforms[node].translation);
+      global_transforms[node] =
+          compose_transforms(global_transforms[nodes[node].parent], local_transforms[node]);
     }
     level_changed_nodes.clear();
   }
@@ -66,4 +69,26 @@ bool ModelInstance::update_transforms() {
   return dirty;
 }
 
+std::shared_ptr<const ModelHierarchy> ModelHierarchy::create(const ModelInstance& model) {
+  ASSERT(!model.nodes.empty());
+  ASSERT(model.nodes[0].parent == Hierarchy::k_invalid_node_id);
+  auto hierarchy = std::make_shared<ModelHierarchy>();
+  hierarchy->nodes = model.nodes;
+  hierarchy->mesh_ids = model.mesh_ids;
+  hierarchy->tot_mesh_nodes = model.tot_mesh_nodes;
+  // Nodes are appended after their parent, so one pass in index order sees every parent first.
+  auto& relative = hierarchy->root_relative_transforms;
+  relative.resize(model.nodes.size());
+  for (size_t node = 1; node < model.nodes.size(); node++) {
+    const int32_t parent = model.nodes[node].parent;
+    ASSERT(parent >= 0 && static_cast<size_t>(parent) < node);
+    relative[node] = compose_transforms(relative[parent], model.local_transforms[node]);
+  }
+  return hierarchy;
+}
+
+void ModelInstanceState::set_root_transform(const glm::mat4& transform) {
+  root = to_trs(transform);
+}
+
 }  // namespace TENG_NAMESPACE
@@ -2,6 +2,7 @@
 
 #include <glm/gtc/quaternion.hpp>
 #include <glm/mat4x4.hpp>
+#include <memory>
 #include <vector>
 
 #include "core/Config.hpp"
@@ -26,6 +27,11 @@ struct TRS {
 
 static_assert(sizeof(TRS) == sizeof(float) * 8);
 
+// `child` expressed in its parent's space, moved into the space `parent` is expressed in.
+[[nodiscard]] TRS compose_transforms(const TRS& parent, const TRS& child);
+
+// A loaded model with its own, fully posable copy of every node, as the loader builds it.
+// Placements that only move the root use ModelHierarchy + ModelInstanceState instead.
 struct ModelInstance {
   constexpr static uint32_t invalid_id = UINT32_MAX;
   std::vector<Hierarchy> nodes;
@@ -34,9 +40,6 @@ struct ModelInstance {
   std::vector<uint32_t> mesh_ids;
   std::vector<std::vector<int32_t>> changed_this_frame;
   uint32_t tot_mesh_nodes{};
-  glm::mat4 root_transform{1};
-  ModelInstanceGPUHandle instance_gpu_handle;
-  ModelGPUHandle model_gpu_handle;
   constexpr static size_t k_max_hierarchy_depth{24};
   void set_transform(int32_t node, const glm::mat4& transform);
   void mark_changed(int32_t node);
@@ -44,4 +47,29 @@ struct ModelInstance {
   bool update_transforms();
 };
 
+// The parts of a loaded model that placing it never changes: node topology, mesh bindings and the
+// rest pose below the root node. Built once per model and shared by all of its instances.
+struct ModelHierarchy {
+  std::vector<Hierarchy> nodes;
+  std::vector<uint32_t> mesh_ids;
+  // Global transform of each node with the root node (node 0) at identity.
+  std::vector<TRS> root_relative_transforms;
+  uint32_t tot_mesh_nodes{};
+
+  [[nodiscard]] static std::shared_ptr<const ModelHierarchy> create(const ModelInstance& model);
+};
+
+// One placement of a model whose nodes keep their rest pose: only the root transform is stored,
+// node transforms are derived from the shared hierarchy when needed.
+struct ModelInstanceState {
+  std::shared_ptr<const ModelHierarchy> hierarchy;
+  TRS root;
+  ModelInstanceGPUHandle instance_gpu_handle;
+
+  void set_root_transform(const glm::mat4& transform);
+  [[nodiscard]] TRS global_transform(uint32_t node) const {
+    return compose_transforms(root, hierarchy->root_relative_transforms[node]);
+  }
+};
+
 }  // namespace TENG_NAMESPACE
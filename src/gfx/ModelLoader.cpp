@@ -2,14 +2,18 @@
 
 #include <ktx.h>
 
+#include <array>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
-#include <future>
-#include <tracy/Tracy.hpp>
+#include <optional>
+#include <utility>
 
 #include "core/EAssert.hpp"
+#include "core/IoService.hpp"
+#include "core/JobSystem.hpp"
 #include "core/Logger.hpp"
-#include "core/ThreadPool.hpp"
+#include "core/MappedFile.hpp"
 #include "core/Util.hpp"
 #include "gfx/rhi/GFXTypes.hpp"
 #include "hlsl/shader_constants.h"
@@ -29,6 +33,7 @@
 
 #include "core/Config.hpp"
 #include "core/MathUtil.hpp"
+#include "core/Profiler.hpp"
 #include "meshoptimizer.h"
 
 namespace TENG_NAMESPACE {
@@ -44,10 +49,17 @@ void load_stb_image(const void *data, size_t data_size, const std::filesystem::p
   if (!std::filesystem::exists(path)) {
     LINFO("path doesn't exist: {}", path.string());
   }
+  MappedFile file;
+  if (!data) {
+    if (Result<MappedFile> mapped = MappedFile::open(path)) {
+      file = std::move(*mapped);
+      data = file.data();
+      data_size = file.size();
+    }
+  }
   if (data) {
-    img_data = stbi_load_from_memory((const stbi_uc *)data, data_size, &w, &h, &comp, 4);
-  } else {
-    img_data = stbi_load(path.string().c_str(), &w, &h, &comp, 4);
+    img_data = stbi_load_from_memory((const stbi_uc *)data, static_cast<int>(data_size), &w, &h,
+                                     &comp, 4);
   }
   const uint32_t mip_levels = math::get_mip_levels(w, h);
   const rhi::TextureDesc desc{
@@ -121,26 +133,39 @@ void write_meshlet_data(std::ostream &o_file, const MeshletLoadResult &meshlet_d
                sizeof(uint8_t) * meshlet_triangles_count);
 }
 
-void read_meshlet_data(std::istream &i_file, MeshletLoadResult &meshlet_data) {
-  ZoneScoped;
+// Bounds-checked cursor over a mapped meshlet cache. A short read leaves `ok` false so a truncated
+// cache is rebuilt instead of trusted.
+struct MeshletCacheReader {
+  std::span<const std::byte> bytes;
+  size_t offset{};
+  bool ok{true};
+
+  bool read(void *dst, size_t size) {
+    if (!ok || bytes.size() - offset < size) {
+      ok = false;
+      return false;
+    }
+    std::memcpy(dst, bytes.data() + offset, size);
+    offset += size;
+    return true;
+  }
+  template <typename T>
+  bool read_array(std::vector<T> &out) {
+    uint32_t count{};
+    if (!read(&count, sizeof(uint32_t)) || (bytes.size() - offset) / sizeof(T) < count) {
+      ok = false;
+      return false;
+    }
+    out.resize(count);
+    return read(out.data(), sizeof(T) * count);
+  }
+};
 
-  uint32_t meshlet_count{};
-  i_file.read(reinterpret_cast<char *>(&meshlet_count), sizeof(uint32_t));
-  meshlet_data.meshlets.resize(meshlet_count);
-  i_file.read(reinterpret_cast<char *>(meshlet_data.meshlets.data()),
-              sizeof(Meshlet) * meshlet_count);
-
-  uint32_t meshlet_vertices_count{};
-  i_file.read(reinterpret_cast<char *>(&meshlet_vertices_count), sizeof(uint32_t));
-  meshlet_data.meshlet_vertices.resize(meshlet_vertices_count);
-  i_file.read(reinterpret_cast<char *>(meshlet_data.meshlet_vertices.data()),
-              sizeof(uint32_t) * meshlet_vertices_count);
-
-  uint32_t meshlet_triangles_count{};
-  i_file.read(reinterpret_cast<char *>(&meshlet_triangles_count), sizeof(uint32_t));
-  meshlet_data.meshlet_triangles.resize(meshlet_triangles_count);
-  i_file.read(reinterpret_cast<char *>(meshlet_data.meshlet_triangles.data()),
-              sizeof(uint8_t) * meshlet_triangles_count);
+bool read_meshlet_data(MeshletCacheReader &reader, MeshletLoadResult &meshlet_data) {
+  ZoneScoped;
+  return reader.read_array(meshlet_data.meshlets) &&
+         reader.read_array(meshlet_data.meshlet_vertices) &&
+         reader.read_array(meshlet_data.meshlet_triangles);
 }
 
 void write_meshlets(std::ostream &o_file, std::span<const MeshletLoadResult> meshlet_data) {
@@ -152,14 +177,66 @@ void write_meshlets(std::ostream &o_file, std::span<const MeshletLoadResult> mes
   }
 }
 
-void read_meshlets(std::istream &i_file, std::vector<MeshletLoadResult> &meshlet_data) {
+bool read_meshlets(std::span<const std::byte> bytes,
+                   std::vector<MeshletLoadResult> &meshlet_data) {
   ZoneScoped;
+  MeshletCacheReader reader{.bytes = bytes};
   uint32_t meshlet_data_count{};
-  i_file.read(reinterpret_cast<char *>(&meshlet_data_count), sizeof(uint32_t));
+  if (!reader.read(&meshlet_data_count, sizeof(uint32_t))) {
+    return false;
+  }
   meshlet_data.resize(meshlet_data_count);
   for (auto &m : meshlet_data) {
-    read_meshlet_data(i_file, m);
+    if (!read_meshlet_data(reader, m)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// cgltf file callbacks that map the .gltf/.glb and external buffers instead of copying them into
+// malloc'd memory. GLB binary chunks and .bin buffers then point straight into the mappings,
+// which live until cgltf_free releases them.
+struct GltfMappedFiles {
+  std::vector<MappedFile> files;
+};
+
+cgltf_result gltf_map_file(const cgltf_memory_options *, const cgltf_file_options *file_options,
+                           const char *path, cgltf_size *size, void **data) {
+  // Accessors are read in whatever order the meshes reference them, so page everything in up front.
+  Result<MappedFile> file = MappedFile::open(path, FileAccessHint::WillNeed);
+  if (!file) {
+    return cgltf_result_file_not_found;
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast): cgltf treats file data as read-only.
+  *data = const_cast<std::byte *>(file->data());
+  *size = file->size();
+  static_cast<GltfMappedFiles *>(file_options->user_data)->files.push_back(std::move(*file));
+  return cgltf_result_success;
+}
+
+void gltf_unmap_file(const cgltf_memory_options *, const cgltf_file_options *file_options,
+                     void *data) {
+  if (!data) {
+    return;
+  }
+  auto *mapped = static_cast<GltfMappedFiles *>(file_options->user_data);
+  std::erase_if(mapped->files, [data](const MappedFile &file) { return file.data() == data; });
+}
+
+// Index into gltf->images of the image a texture view samples, preferring the KTX2 (basisu)
+// variant. -1 when the view has no image.
+int64_t material_image_index(const cgltf_data &gltf, const cgltf_texture_view &tex_view) {
+  if (!tex_view.texture) {
+    return -1;
+  }
+  if (tex_view.texture->has_basisu && tex_view.texture->basisu_image) {
+    return tex_view.texture->basisu_image - gltf.images;
   }
+  if (tex_view.texture->image) {
+    return tex_view.texture->image - gltf.images;
+  }
+  return -1;
 }
 
 int32_t add_node_to_hierarchy(std::vector<Hierarchy> &hierarchies, int32_t parent, int32_t level) {
@@ -268,14 +345,34 @@ MeshletLoadResult load_meshlet_data(std::span<DefaultVertex> vertices,
 }  // namespace
 
 bool load_model(const std::filesystem::path &path, const glm::mat4 &root_transform,
-                ModelInstance &out_model, ModelLoadResult &out_load_result) {
+                ModelInstance &out_model, ModelLoadResult &out_load_result,
+                std::span<const std::byte> source_bytes) {
   PrintTimerMilli t{"model load"};
   ZoneScoped;
   out_load_result = {};
   out_model = {};
-  const cgltf_options gltf_load_opts{};
+  // The meshlet cache is only needed after the meshes are processed. Map it now: WillNeed starts
+  // readahead in the background, and it is then parsed straight from the page cache.
+  const std::filesystem::path meshlet_cache_path =
+      std::filesystem::path(path).replace_extension(".meshletcache");
+  std::optional<MappedFile> meshlet_cache;
+  if (std::filesystem::exists(meshlet_cache_path)) {
+    Result<MappedFile> mapped = MappedFile::open(meshlet_cache_path, FileAccessHint::WillNeed);
+    if (mapped) {
+      meshlet_cache = std::move(*mapped);
+    }
+  }
+  // Declared before `gltf` so the mappings outlive cgltf_free.
+  GltfMappedFiles gltf_files;
+  cgltf_options gltf_load_opts{};
+  gltf_load_opts.file.read = &gltf_map_file;
+  gltf_load_opts.file.release = &gltf_unmap_file;
+  gltf_load_opts.file.user_data = &gltf_files;
   cgltf_data *raw_gltf{};
-  cgltf_result gltf_res = cgltf_parse_file(&gltf_load_opts, path.c_str(), &raw_gltf);
+  cgltf_result gltf_res =
+      source_bytes.empty()
+          ? cgltf_parse_file(&gltf_load_opts, path.c_str(), &raw_gltf)
+          : cgltf_parse(&gltf_load_opts, source_bytes.data(), source_bytes.size(), &raw_gltf);
   std::unique_ptr<cgltf_data, void (*)(cgltf_data *)> gltf(raw_gltf, cgltf_free);
   std::filesystem::path directory_path = path.parent_path();
 
@@ -297,15 +394,63 @@ bool load_model(const std::filesystem::path &path, const glm::mat4 &root_transfo
   auto &texture_uploads = out_load_result.texture_uploads;
   texture_uploads.resize(gltf->images_count);
 
-  auto load_img = [&](uint32_t gltf_img_i, rhi::TextureFormat format) -> uint32_t {
+  // Texture slots a material samples, with the format each one is decoded in.
+  const auto material_texture_slots = [](const cgltf_material &gltf_mat) {
+    return std::array{
+        std::pair{&gltf_mat.pbr_metallic_roughness.base_color_texture,
+                  rhi::TextureFormat::R8G8B8A8Srgb},
+        std::pair{&gltf_mat.normal_texture, rhi::TextureFormat::R8G8B8A8Srgb},
+    };
+  };
+  // Each image is decoded once, in the format of the first material slot that uses it.
+  constexpr rhi::TextureFormat k_unused_image = rhi::TextureFormat::Undefined;
+  std::vector<rhi::TextureFormat> image_formats(gltf->images_count, k_unused_image);
+  for (size_t material_i = 0; material_i < gltf->materials_count; material_i++) {
+    for (const auto &[tex_view, format] : material_texture_slots(gltf->materials[material_i])) {
+      const int64_t image_i = material_image_index(*gltf, *tex_view);
+      if (image_i >= 0 && image_formats[image_i] == k_unused_image) {
+        image_formats[image_i] = format;
+      }
+    }
+  }
+
+  // Queue every external image as one batch so the reads overlap each other instead of each
+  // decode job blocking on its own file. Decoding starts once all of them have landed.
+  std::vector<IoBuffer> image_files(gltf->images_count);
+  {
+    ZoneScopedN("Read images");
+    std::vector<std::filesystem::path> read_paths;
+    std::vector<size_t> read_images;
+    for (size_t image_i = 0; image_i < gltf->images_count; image_i++) {
+      const cgltf_image &img = gltf->images[image_i];
+      if (image_formats[image_i] != k_unused_image && !img.buffer_view && img.uri) {
+        read_paths.push_back(directory_path / img.uri);
+        read_images.push_back(image_i);
+      }
+    }
+    JobCounter image_reads_counter;
+    std::vector<IoRequest> reads = IoService::get().read_batch(read_paths, &image_reads_counter);
+    JobSystem::get().wait(image_reads_counter);
+    // A failed read leaves the buffer empty; decoding then loads from the path, which reports
+    // the error.
+    for (size_t i = 0; i < reads.size(); i++) {
+      if (Result<IoBuffer> read = reads[i].take()) {
+        image_files[read_images[i]] = std::move(*read);
+      }
+    }
+  }
+
+  auto load_img = [&](uint32_t gltf_img_i, rhi::TextureFormat format) {
     const cgltf_image &img = gltf->images[gltf_img_i];
 
     if (!img.buffer_view) {
       const std::filesystem::path full_img_path = directory_path / img.uri;
+      const void *data = image_files[gltf_img_i].data.get();
+      const size_t data_size = image_files[gltf_img_i].size;
       if (full_img_path.extension() == ".ktx2") {
-        load_ktx(nullptr, 0, full_img_path, texture_uploads[gltf_img_i]);
+        load_ktx(data, data_size, full_img_path, texture_uploads[gltf_img_i]);
       } else {
-        load_stb_image(nullptr, 0, full_img_path, format, texture_uploads[gltf_img_i]);
+        load_stb_image(data, data_size, full_img_path, format, texture_uploads[gltf_img_i]);
       }
     } else {
       std::string_view mime_type = img.mime_type ? img.mime_type : "";
@@ -317,65 +462,57 @@ bool load_model(const std::filesystem::path &path, const glm::mat4 &root_transfo
                        img.buffer_view->size, "", format, texture_uploads[gltf_img_i]);
       }
     }
-    return gltf_img_i;
+    // Decoded; the file bytes are no longer needed.
+    image_files[gltf_img_i] = {};
   };
 
   {
-    ZoneScopedN("Load materials and images");
+    ZoneScopedN("Load images");
+    JobSystem::get().parallel_for(0, gltf->images_count, 1, [&](size_t image_i) {
+      if (image_formats[image_i] != k_unused_image) {
+        load_img(static_cast<uint32_t>(image_i), image_formats[image_i]);
+      }
+    });
+  }
+
+  {
+    ZoneScopedN("Load materials");
     auto &materials = out_load_result.materials;
     materials.resize(gltf->materials_count);
-    std::vector<std::future<void>> img_load_futures;
-    img_load_futures.reserve(gltf->materials_count);
-    for (size_t material_i = 0; material_i < gltf->materials_count; material_i++) {
-      img_load_futures.emplace_back(ThreadPool::get().submit_task([&, material_i]() {
-        const cgltf_material *gltf_mat = &gltf->materials[material_i];
-        if (!gltf_mat) {
-          ALWAYS_ASSERT(0);
+    JobSystem::get().parallel_for(0, gltf->materials_count, 1, [&](size_t material_i) {
+      const cgltf_material *gltf_mat = &gltf->materials[material_i];
+      if (!gltf_mat) {
+        ALWAYS_ASSERT(0);
+      }
+      Material material{};
+      material.albedo_factors.r = gltf_mat->pbr_metallic_roughness.base_color_factor[0];
+      material.albedo_factors.g = gltf_mat->pbr_metallic_roughness.base_color_factor[1];
+      material.albedo_factors.b = gltf_mat->pbr_metallic_roughness.base_color_factor[2];
+      material.albedo_factors.a = gltf_mat->pbr_metallic_roughness.base_color_factor[3];
+      material.albedo_factors.a = 1.0;
+      material.flags = 0;
+      if (gltf_mat->alpha_mode == cgltf_alpha_mode_mask) {
+        // TODO: use the define
+        material.flags |= 0x1;
+      }
+
+      // Images were all decoded above; materials only reference them.
+      auto set_material_img = [&gltf](const cgltf_texture_view *tex_view,
+                                      uint32_t &result_tex_id) {
+        if (!tex_view || !tex_view->texture) {
+          return;
         }
-        Material material{};
-        material.albedo_factors.r = gltf_mat->pbr_metallic_roughness.base_color_factor[0];
-        material.albedo_factors.g = gltf_mat->pbr_metallic_roughness.base_color_factor[1];
-        material.albedo_factors.b = gltf_mat->pbr_metallic_roughness.base_color_factor[2];
-        material.albedo_factors.a = gltf_mat->pbr_metallic_roughness.base_color_factor[3];
-        material.albedo_factors.a = 1.0;
-        material.flags = 0;
-        if (gltf_mat->alpha_mode == cgltf_alpha_mode_mask) {
-          // TODO: use the define
-          material.flags |= 0x1;
+        const int64_t gltf_image_i = material_image_index(*gltf, *tex_view);
+        if (gltf_image_i < 0) {
+          LINFO("No texture image found");
+          return;
         }
-
-        auto set_and_load_material_img = [&gltf, &load_img, &texture_uploads](
-                                             const cgltf_texture_view *tex_view,
-                                             uint32_t &result_tex_id, rhi::TextureFormat format) {
-          if (!tex_view || !tex_view->texture) {
-            return;
-          }
-          size_t gltf_image_i{};
-          if (tex_view->texture->has_basisu && tex_view->texture->basisu_image) {
-            gltf_image_i = tex_view->texture->basisu_image - gltf->images;
-          } else if (tex_view->texture->image) {
-            gltf_image_i = tex_view->texture->image - gltf->images;
-          } else {
-            LINFO("No texture image found");
-            return;
-          }
-          if (texture_uploads[gltf_image_i].data) {
-            result_tex_id = gltf_image_i;
-          } else {
-            result_tex_id = load_img(gltf_image_i, format);
-          }
-        };
-        set_and_load_material_img(&gltf_mat->pbr_metallic_roughness.base_color_texture,
-                                  material.albedo_tex, rhi::TextureFormat::R8G8B8A8Srgb);
-        set_and_load_material_img(&gltf_mat->normal_texture, material.normal_tex,
-                                  rhi::TextureFormat::R8G8B8A8Srgb);
-        materials[material_i] = material;
-      }));
-    }
-
-    for (auto &fut : img_load_futures) {
-      fut.get();
-    }
+        result_tex_id = static_cast<uint32_t>(gltf_image_i);
+      };
+      set_material_img(&gltf_mat->pbr_metallic_roughness.base_color_texture, material.albedo_tex);
+      set_material_img(&gltf_mat->normal_texture, material.normal_tex);
+      materials[material_i] = material;
+    });
   }
 
   std::vector<DefaultVertex> &all_vertices = out_load_result.vertices;
@@ -448,105 +585,93 @@ bool load_model(const std::filesystem::path &path, const glm::mat4 &root_transfo
     all_indices.resize(total_indices);
     all_vertices.resize(total_vertices);
 
-    std::vector<std::future<void>> mesh_load_futures;
-    auto total_meshes = overall_mesh_i;
-    mesh_load_futures.reserve(total_meshes);
-    overall_mesh_i = 0;
-
+    // Flattened (gltf mesh, primitive) per output mesh, in overall_mesh_i order.
+    std::vector<std::pair<uint32_t, uint32_t>> prim_refs;
+    prim_refs.reserve(overall_mesh_i);
     for (uint32_t mesh_i = 0; mesh_i < gltf->meshes_count; mesh_i++) {
-      for (uint32_t prim_i = 0; prim_i < gltf->meshes[mesh_i].primitives_count;
-           prim_i++, overall_mesh_i++) {
-        const uint32_t overall_prim_i = overall_mesh_i;
-        mesh_load_futures.emplace_back(ThreadPool::get().submit_task(
-            [mesh_i, prim_i, overall_prim_i, &gltf, &all_indices, &meshes, &all_vertices]() {
-              ZoneScopedN("Process Mesh");
-              const auto &primitive = gltf->meshes[mesh_i].primitives[prim_i];
-              auto &result_mesh = meshes[overall_prim_i];
-              size_t base_index = result_mesh.index_offset / sizeof(rhi::DefaultIndexT);
-              for (size_t i = 0; i < primitive.indices->count; i++) {
-                all_indices[base_index + i] = cgltf_accessor_read_index(primitive.indices, i);
-              }
+      for (uint32_t prim_i = 0; prim_i < gltf->meshes[mesh_i].primitives_count; prim_i++) {
+        prim_refs.emplace_back(mesh_i, prim_i);
+      }
+    }
 
-              auto base_vertex =
-                  static_cast<size_t>(result_mesh.vertex_offset_bytes / sizeof(DefaultVertex));
-              glm::vec3 tot_center{};
-              for (size_t attr_i = 0; attr_i < primitive.attributes_count; attr_i++) {
-                const auto &attr = primitive.attributes[attr_i];
-                if (attr.index != 0) continue;
-                const cgltf_accessor *accessor = attr.data;
-                if (attr.type == cgltf_attribute_type_position) {
-                  for (size_t i = 0; i < accessor->count; i++) {
-                    float pos[3] = {0, 0, 0};
-                    cgltf_accessor_read_float(accessor, i, pos, 3);
-                    all_vertices[base_vertex + i].pos = glm::vec4{pos[0], pos[1], pos[2], 0};
-                    tot_center += glm::vec3{pos[0], pos[1], pos[2]};
-                  }
-                } else if (attr.type == cgltf_attribute_type_texcoord) {
-                  for (size_t i = 0; i < accessor->count; i++) {
-                    float uv[2] = {0, 0};
-                    cgltf_accessor_read_float(accessor, i, uv, 2);
-                    all_vertices[base_vertex + i].uv = glm::vec2{uv[0], uv[1]};
-                  }
-                } else if (attr.type == cgltf_attribute_type_normal) {
-                  float normal[3] = {0, 0, 0};
-                  for (size_t i = 0; i < accessor->count; i++) {
-                    cgltf_accessor_read_float(accessor, i, normal, 3);
-                    all_vertices[base_vertex + i].normal =
-                        glm::vec3{normal[0], normal[1], normal[2]};
-                  }
-                }
-              }
+    JobSystem::get().parallel_for(
+        0, prim_refs.size(), 0,
+        [&prim_refs, &gltf, &all_indices, &meshes, &all_vertices](size_t overall_prim_i) {
+          ZoneScopedN("Process Mesh");
+          const auto [mesh_i, prim_i] = prim_refs[overall_prim_i];
+          const auto &primitive = gltf->meshes[mesh_i].primitives[prim_i];
+          auto &result_mesh = meshes[overall_prim_i];
+          size_t base_index = result_mesh.index_offset / sizeof(rhi::DefaultIndexT);
+          for (size_t i = 0; i < primitive.indices->count; i++) {
+            all_indices[base_index + i] = cgltf_accessor_read_index(primitive.indices, i);
+          }
 
-              auto vertex_count = result_mesh.vertex_count;
-              glm::vec3 center = tot_center / glm::vec3{static_cast<float>(vertex_count)};
-              float radius{};
-              for (size_t i = base_vertex; i < base_vertex + vertex_count; i++) {
-                radius = glm::max(radius, glm::distance(glm::vec3{all_vertices[i].pos}, center));
+          auto base_vertex =
+              static_cast<size_t>(result_mesh.vertex_offset_bytes / sizeof(DefaultVertex));
+          glm::vec3 tot_center{};
+          for (size_t attr_i = 0; attr_i < primitive.attributes_count; attr_i++) {
+            const auto &attr = primitive.attributes[attr_i];
+            if (attr.index != 0) continue;
+            const cgltf_accessor *accessor = attr.data;
+            if (attr.type == cgltf_attribute_type_position) {
+              for (size_t i = 0; i < accessor->count; i++) {
+                float pos[3] = {0, 0, 0};
+                cgltf_accessor_read_float(accessor, i, pos, 3);
+                all_vertices[base_vertex + i].pos = glm::vec4{pos[0], pos[1], pos[2], 0};
+                tot_center += glm::vec3{pos[0], pos[1], pos[2]};
               }
-              result_mesh.center = center;
-              result_mesh.radius = radius;
-            }));
-      }
-    }
+            } else if (attr.type == cgltf_attribute_type_texcoord) {
+              for (size_t i = 0; i < accessor->count; i++) {
+                float uv[2] = {0, 0};
+                cgltf_accessor_read_float(accessor, i, uv, 2);
+                all_vertices[base_vertex + i].uv = glm::vec2{uv[0], uv[1]};
+              }
+            } else if (attr.type == cgltf_attribute_type_normal) {
+              float normal[3] = {0, 0, 0};
+              for (size_t i = 0; i < accessor->count; i++) {
+                cgltf_accessor_read_float(accessor, i, normal, 3);
+                all_vertices[base_vertex + i].normal =
+                    glm::vec3{normal[0], normal[1], normal[2]};
+              }
+            }
+          }
 
-    for (auto &fut : mesh_load_futures) {
-      fut.get();
-    }
+          auto vertex_count = result_mesh.vertex_count;
+          glm::vec3 center = tot_center / glm::vec3{static_cast<float>(vertex_count)};
+          float radius{};
+          for (size_t i = base_vertex; i < base_vertex + vertex_count; i++) {
+            radius = glm::max(radius, glm::distance(glm::vec3{all_vertices[i].pos}, center));
+          }
+          result_mesh.center = center;
+          result_mesh.radius = radius;
+        });
 
     {
       auto &meshlet_datas = out_load_result.meshlet_process_result.meshlet_datas;
       meshlet_datas.reserve(model_vertex_count / k_max_vertices_per_meshlet);
-      std::filesystem::path meshlet_cache_path =
-          std::filesystem::path(path).replace_extension(".meshletcache");
-      if (std::filesystem::exists(meshlet_cache_path)) {
-        std::ifstream meshlet_cache_file(meshlet_cache_path, std::ios::binary);
-        read_meshlets(meshlet_cache_file, meshlet_datas);
-      } else {
-        meshlet_datas.resize(meshes.size());
-        std::vector<std::future<void>> meshlet_load_futures;
-        meshlet_load_futures.reserve(meshes.size());
-        size_t mesh_i = 0;
-        for (const Mesh &mesh : meshes) {
-          const uint32_t base_vertex = mesh.vertex_offset_bytes / sizeof(DefaultVertex);
-          meshlet_load_futures.emplace_back(ThreadPool::get().submit_task(
-              [&all_vertices, &all_indices, &meshlet_datas, mesh_i, base_vertex, &meshes]() {
-                ZoneScopedN("Process Meshlet");
-                auto &mesh = meshes[mesh_i];
-                meshlet_datas[mesh_i] = load_meshlet_data(
-                    std::span(&all_vertices[base_vertex], mesh.vertex_count),
-                    std::span(&all_indices[mesh.index_offset / sizeof(rhi::DefaultIndexT)],
-                              mesh.index_count),
-                    base_vertex);
-              }));
-          mesh_i++;
-        }
-
-        for (auto &fut : meshlet_load_futures) {
-          fut.get();
+      bool loaded_from_cache = false;
+      if (meshlet_cache) {
+        loaded_from_cache = read_meshlets(meshlet_cache->bytes(), meshlet_datas);
+        if (!loaded_from_cache) {
+          LWARN("Meshlet cache {} is truncated, rebuilding it", meshlet_cache_path.string());
         }
+        // Unmap before a rebuild truncates and rewrites the file.
+        meshlet_cache.reset();
       }
-
-      if (!std::filesystem::exists(meshlet_cache_path)) {
+      if (!loaded_from_cache) {
+        meshlet_datas.resize(meshes.size());
+        JobSystem::get().parallel_for(
+            0, meshes.size(), 1,
+            [&all_vertices, &all_indices, &meshlet_datas, &meshes](size_t mesh_i) {
+              ZoneScopedN("Process Meshlet");
+              const Mesh &mesh = meshes[mesh_i];
+              const uint32_t base_vertex = mesh.vertex_offset_bytes / sizeof(DefaultVertex);
+              meshlet_datas[mesh_i] = load_meshlet_data(
+                  std::span(&all_vertices[base_vertex], mesh.vertex_count),
+                  std::span(&all_indices[mesh.index_offset / sizeof(rhi::DefaultIndexT)],
+                            mesh.index_count),
+                  base_vertex);
+            });
         std::ofstream meshlet_cache_file(meshlet_cache_path, std::ios::binary);
         write_meshlets(meshlet_cache_file, std::span<const MeshletLoadResult>(
                                                meshlet_datas.data(), meshlet_datas.size()));
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <filesystem>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/mat4x4.hpp>
+#include <span>
 
 #include "ModelInstance.hpp"
 #include "RendererTypes.hpp"
@@ -87,8 +89,11 @@ struct ModelLoadResult {
   MeshletProcessResult meshlet_process_result;
 };
 
+// `source_bytes`, when given, is the already-read contents of `path` and is parsed instead of
+// reading the file again. It must stay alive until load_model returns.
 bool load_model(const std::filesystem::path &path, const glm::mat4 &root_transform,
-                ModelInstance &out_model, ModelLoadResult &out_load_result);
+                ModelInstance &out_model, ModelLoadResult &out_load_result,
+                std::span<const std::byte> source_bytes = {});
 
 }  // namespace gfx
 
@@ -2,18 +2,20 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
+#include <chrono>
 #include <format>
 #include <string>
-#include <tracy/Tracy.hpp>
 #include <type_traits>
-#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "core/EAssert.hpp"
 #include "core/Logger.hpp"
+#include "core/Profiler.hpp"
 #include "gfx/RenderGraph.Format.hpp"
+#include "gfx/renderer/RendererCVars.hpp"
 #include "gfx/rhi/Buffer.hpp"
 #include "gfx/rhi/Device.hpp"
 #include "gfx/rhi/GFXTypes.hpp"
@@ -40,9 +42,11 @@ struct RgSubresourceStateKey {
   }
 };
 struct RgSubresourceStateKeyHash {
+  using is_avalanching = void;
   size_t operator()(RgSubresourceStateKey k) const {
-    auto h = std::make_tuple(static_cast<uint32_t>(k.type), k.idx, k.mip, k.slice);
-    return util::hash::tuple_hash<decltype(h)>{}(h);
+    const uint64_t sub = static_cast<uint32_t>(k.mip) |
+                         (static_cast<uint64_t>(static_cast<uint32_t>(k.slice)) << 32);
+    return util::hash::hash_combine64(k.idx | (static_cast<uint64_t>(k.type) << 32), sub);
   }
 };
 
@@ -155,19 +159,50 @@ rhi::TextureUsage texture_desc_usage_for_bake(rhi::AccessFlags accumulated,
   return u;
 }
 
+// Estimated size of a transient attachment (full mip chain, all layers). Used for reporting and
+// the pool budget, never for allocation.
+size_t transient_texture_bytes(const AttachmentInfo& att_info, glm::uvec2 dims) {
+  size_t texel_bytes = 0;
+  switch (att_info.format) {
+    case rhi::TextureFormat::R8G8B8A8Srgb:
+    case rhi::TextureFormat::R8G8B8A8Unorm:
+    case rhi::TextureFormat::B8G8R8A8Unorm:
+    case rhi::TextureFormat::B8G8R8A8Srgb:
+    case rhi::TextureFormat::R32float:
+    case rhi::TextureFormat::D32float:
+      texel_bytes = 4;
+      break;
+    case rhi::TextureFormat::R16G16B16A16Sfloat:
+      texel_bytes = 8;
+      break;
+    case rhi::TextureFormat::R32G32B32A32Sfloat:
+      texel_bytes = 16;
+      break;
+    default:
+      // block-compressed formats are never render targets
+      texel_bytes = 1;
+      break;
+  }
+  size_t bytes = 0;
+  for (uint32_t mip = 0; mip < att_info.mip_levels; ++mip) {
+    const size_t w = std::max(dims.x >> mip, 1u);
+    const size_t h = std::max(dims.y >> mip, 1u);
+    bytes += w * h * texel_bytes;
+  }
+  return bytes * att_info.array_layers;
+}
+
 rhi::BufferUsage buffer_usage_from_accumulated_access(rhi::AccessFlags acc) {
   using B = rhi::BufferUsage;
   auto u = B::None;
-  if (has_flag(acc, rhi::AccessFlags::ShaderStorageRead) ||
-      has_flag(acc, rhi::AccessFlags::ShaderStorageWrite)) {
+  // Buffers are bound bindlessly as storage buffers, so generic shader access implies Storage.
+  if (has_flag(acc, rhi::AccessFlags::ShaderStorageRead | rhi::AccessFlags::ShaderStorageWrite |
+                        rhi::AccessFlags::ShaderRead | rhi::AccessFlags::ShaderWrite)) {
     u |= B::Storage;
   }
   if (has_flag(acc, rhi::AccessFlags::IndirectCommandRead)) {
     u |= B::Indirect;
   }
-  if (has_flag(acc, rhi::AccessFlags::ShaderRead)) {
-    u |= B::Uniform;
-  }
   if (has_flag(acc, rhi::AccessFlags::IndexRead)) {
     u |= B::Index;
   }
@@ -177,6 +212,11 @@ rhi::BufferUsage buffer_usage_from_accumulated_access(rhi::AccessFlags acc) {
   if (has_flag(acc, rhi::AccessFlags::UniformRead)) {
     u |= B::Uniform;
   }
+  // Copy-only buffers: devices add transfer usage implicitly but require one non-transfer usage.
+  if (u == B::None &&
+      has_flag(acc, rhi::AccessFlags::TransferRead | rhi::AccessFlags::TransferWrite)) {
+    u = B::Storage;
+  }
   return u;
 }
 
@@ -324,44 +364,84 @@ void coalesce_pass_texture_barriers(std::vector<RenderGraph::BarrierInfo>& barri
 
 void RenderGraph::bake(glm::uvec2 fb_size, bool verbose) {
   ZoneScoped;
+  const auto bake_start = std::chrono::steady_clock::now();
   if (verbose) {
     LINFO("//////////// Baking Render Graph ////////////");
   }
   bake_reset_and_gc_pools_(fb_size);
-  bake_find_sink_passes_(verbose);
-  bake_compute_pass_order_(verbose);
-  std::vector<rhi::AccessFlags> tex_physical_access(tex_att_infos_.size(), rhi::AccessFlags::None);
-  std::vector<rhi::AccessFlags> buf_physical_access(buffer_infos_.size(), rhi::AccessFlags::None);
-  bake_accumulate_physical_access_(tex_physical_access, buf_physical_access);
-  bake_allocate_transient_resources_(fb_size, tex_physical_access, buf_physical_access);
+  // Verbose bakes always take the full path so the per-step logging is emitted.
+  const bool cache_enabled = renderer_cv::developer_render_graph_bake_cache.get() != 0 && !verbose;
+  // Keys are compared word for word rather than by hash: a collision would replay a stale plan.
+  bake_encode_structure_(bake_key_scratch_);
+  const bool topology_hit =
+      cache_enabled && bake_cache_.valid && bake_cache_.structure_key == bake_key_scratch_;
+  if (!topology_hit) {
+    bake_find_sink_passes_(verbose);
+    bake_compute_pass_order_(verbose);
+    bake_collect_culled_passes_(verbose);
+    bake_cache_.tex_physical_access.assign(tex_att_infos_.size(), rhi::AccessFlags::None);
+    bake_cache_.buf_physical_access.assign(buffer_infos_.size(), rhi::AccessFlags::None);
+    bake_accumulate_physical_access_(bake_cache_.tex_physical_access,
+                                     bake_cache_.buf_physical_access);
+    bake_compute_transient_lifetimes_();
+    bake_cache_.valid = true;
+    bake_cache_.barriers_valid = false;
+    bake_cache_.structure_key.swap(bake_key_scratch_);
+  }
+  bake_assign_queues_(verbose);
+  bake_allocate_transient_resources_(fb_size, bake_cache_.tex_physical_access,
+                                     bake_cache_.buf_physical_access);
   bake_allocate_temporal_resources_(fb_size);
-  bake_schedule_barriers_(verbose);
-  bake_validate_();
+  bake_schedule_queues_(verbose);
+  bake_encode_barrier_inputs_(bake_key_scratch_);
+  const bool barrier_hit = topology_hit && bake_cache_.barriers_valid &&
+                           bake_cache_.barrier_input_key == bake_key_scratch_;
+  if (barrier_hit) {
+    bake_restore_cached_barriers_();
+  } else {
+    bake_schedule_barriers_(verbose);
+    bake_validate_();
+    bake_cache_.barriers_valid = true;
+    bake_cache_.barrier_input_key.swap(bake_key_scratch_);
+  }
+
+  bake_stats_.last_bake_ms =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - bake_start)
+          .count();
+  bake_stats_.total_bake_ms += bake_stats_.last_bake_ms;
+  ++bake_stats_.bake_count;
+  bake_stats_.topology_hits += topology_hit ? 1 : 0;
+  bake_stats_.barrier_hits += barrier_hit ? 1 : 0;
+  bake_stats_.culled_passes = static_cast<uint32_t>(culled_pass_names_.size());
+
   bake_write_debug_dump_if_requested_(fb_size);
   if (verbose) {
-    LINFO("//////////// Done Baking Render Graph ////////////");
+    const auto& mem = transient_mem_stats_;
+    LINFO("Transient memory: {} KiB unaliased -> {} KiB aliased (peak live {} KiB), {} tex / {} buf "
+          "aliased",
+          mem.bytes_unaliased() / 1024, mem.bytes_aliased() / 1024, mem.peak_live_bytes / 1024,
+          mem.tex_aliased_count, mem.buf_aliased_count);
+    LINFO("//////////// Done Baking Render Graph ({:.3f} ms) ////////////",
+          bake_stats_.last_bake_ms);
   }
 }
 
 void RenderGraph::bake_reset_and_gc_pools_(glm::uvec2 fb_size) {
   ZoneScopedN("RG bake: reset_and_gc_pools");
+  ++pool_bake_index_;
   {
-    sink_passes_.clear();
-    pass_dependencies_.clear();
-    pass_dep_dfs_state_.clear();
-    pass_dep_dfs_path_.clear();
-    intermed_pass_stack_.clear();
-    pass_stack_.clear();
-
     static std::vector<TexPoolKey> stale_tex_keys;
     stale_tex_keys.clear();
 
-    for (auto& [key, handles] : free_atts_) {
-      ASSERT(!handles.empty());
-      auto* tex = device_->get_tex(handles[0]);
+    for (auto& [key, entries] : free_atts_) {
+      ASSERT(!entries.empty());
+      auto* tex = device_->get_tex(entries[0].handle);
       if (key.info.size_class == SizeClass::Swapchain && glm::uvec2{tex->desc().dims} != fb_size) {
-        for (const auto& handle : handles) {
-          device_->destroy(handle);
+        for (const auto& entry : entries) {
+          device_->destroy(entry.handle);
+          pool_stats_.pooled_bytes -= entry.bytes;
+          pool_stats_.evicted_bytes += entry.bytes;
+          ++pool_stats_.evictions;
         }
         stale_tex_keys.emplace_back(key);
       }
@@ -370,29 +450,201 @@ void RenderGraph::bake_reset_and_gc_pools_(glm::uvec2 fb_size) {
       free_atts_.erase(stale_key);
     }
   }
+  bake_evict_pools_lru_();
+}
+
+void RenderGraph::bake_evict_pools_lru_() {
+  const size_t budget_bytes =
+      static_cast<size_t>(std::max(renderer_cv::developer_render_graph_pool_budget_mb.get(), 0))
+      << 20;
+  if (pool_stats_.pooled_bytes <= budget_bytes) {
+    return;
+  }
+  // Entries the previous bake used are this frame's likely working set; evicting them would
+  // only recreate them a few lines later, so they are never candidates.
+  struct Candidate {
+    uint64_t last_used_bake;
+    PooledTexture* tex;
+    PooledBuffer* buf;
+  };
+  std::vector<Candidate> candidates;
+  const uint64_t prev_bake = pool_bake_index_ - 1;
+  for (auto& [key, entries] : free_atts_) {
+    for (auto& entry : entries) {
+      if (entry.last_used_bake < prev_bake) {
+        candidates.push_back({.last_used_bake = entry.last_used_bake, .tex = &entry, .buf = {}});
+      }
+    }
+  }
+  for (auto& [key, entries] : free_bufs_) {
+    for (auto& entry : entries) {
+      if (entry.last_used_bake < prev_bake) {
+        candidates.push_back({.last_used_bake = entry.last_used_bake, .tex = {}, .buf = &entry});
+      }
+    }
+  }
+  std::ranges::sort(candidates, {}, &Candidate::last_used_bake);
+
+  auto evict = [this](auto& entry) {
+    device_->destroy(entry.handle);
+    entry.handle = {};
+    pool_stats_.pooled_bytes -= entry.bytes;
+    pool_stats_.evicted_bytes += entry.bytes;
+    ++pool_stats_.evictions;
+  };
+  for (const Candidate& c : candidates) {
+    if (pool_stats_.pooled_bytes <= budget_bytes) {
+      break;
+    }
+    if (c.tex) {
+      evict(*c.tex);
+    } else {
+      evict(*c.buf);
+    }
+  }
+  auto compact = [](auto& pool) {
+    for (auto it = pool.begin(); it != pool.end();) {
+      std::erase_if(it->second, [](const auto& entry) { return !entry.handle.is_valid(); });
+      it = it->second.empty() ? pool.erase(it) : std::next(it);
+    }
+  };
+  compact(free_atts_);
+  compact(free_bufs_);
+}
+
+void RenderGraph::bake_encode_structure_(std::vector<uint64_t>& out) const {
+  ZoneScopedN("RG bake: encode_structure");
+  // Everything the sink search, pass ordering, access accumulation and lifetime steps read.
+  // Physical handles and fb_size are deliberately excluded: they are patched every bake.
+  out.clear();
+  out.push_back(passes_.size());
+  for (const auto& pass : passes_) {
+    out.push_back(pass.get_name_id());
+    out.push_back(static_cast<uint64_t>(pass.type()) |
+                  (static_cast<uint64_t>(pass.swapchain_write_ != nullptr) << 32));
+    for (const auto* uses : {&pass.get_external_writes(), &pass.get_internal_writes(),
+                             &pass.get_external_reads(), &pass.get_internal_reads()}) {
+      out.push_back(uses->size());
+      for (const auto& use : *uses) {
+        out.push_back(use.id.idx | (static_cast<uint64_t>(use.id.version) << 32));
+        out.push_back(static_cast<uint64_t>(use.type) |
+                      (static_cast<uint64_t>(use.is_swapchain_write) << 32));
+        out.push_back(static_cast<uint64_t>(use.stage));
+        out.push_back(static_cast<uint64_t>(use.acc));
+        out.push_back(use.subresource.base_mip |
+                      (static_cast<uint64_t>(use.subresource.mip_count) << 32));
+        out.push_back(use.subresource.base_slice |
+                      (static_cast<uint64_t>(use.subresource.slice_count) << 32));
+      }
+    }
+  }
+  out.push_back(resources_.size());
+  for (const auto& rec : resources_) {
+    out.push_back(static_cast<uint64_t>(rec.type) |
+                  (static_cast<uint64_t>(rec.temporal_history_view) << 32));
+    out.push_back(rec.physical_idx | (static_cast<uint64_t>(rec.temporal_idx) << 32));
+  }
+  out.push_back(tex_att_infos_.size());
+  for (const auto& info : tex_att_infos_) {
+    out.push_back(info.dims.x | (static_cast<uint64_t>(info.dims.y) << 32));
+    out.push_back(info.mip_levels | (static_cast<uint64_t>(info.array_layers) << 32));
+    out.push_back(static_cast<uint64_t>(info.format) |
+                  (static_cast<uint64_t>(info.size_class) << 32) |
+                  (static_cast<uint64_t>(info.is_swapchain_tex) << 40) |
+                  (static_cast<uint64_t>(info.temporal) << 41) |
+                  (static_cast<uint64_t>(info.temporal_slot_mode) << 48));
+  }
+  out.push_back(buffer_infos_.size());
+  for (const auto& info : buffer_infos_) {
+    out.push_back(info.size);
+    out.push_back(static_cast<uint64_t>(info.defer_reuse) |
+                  (static_cast<uint64_t>(info.temporal) << 1) |
+                  (static_cast<uint64_t>(info.temporal_slot_mode) << 8));
+  }
+  out.push_back(temporal_buffers_.size());
+  for (const auto& record : temporal_buffers_) {
+    out.push_back(static_cast<uint64_t>(record.slot_mode));
+  }
+  out.push_back(temporal_textures_.size());
+  for (const auto& record : temporal_textures_) {
+    out.push_back(static_cast<uint64_t>(record.slot_mode));
+  }
+}
+
+void RenderGraph::bake_encode_barrier_inputs_(std::vector<uint64_t>& out) {
+  ZoneScopedN("RG bake: encode_barrier_inputs");
+  out.clear();
+  auto push_state = [&out](const RGState& st) {
+    out.push_back(static_cast<uint64_t>(st.access));
+    out.push_back(static_cast<uint64_t>(st.stage));
+    out.push_back(static_cast<uint64_t>(st.layout));
+  };
+  // unordered containers: emit entries sorted by key so equal contents encode identically
+  auto& keys = bake_encode_keys_scratch_;
+  keys.clear();
+  for (const auto& [key, state] : external_initial_states_) {
+    keys.push_back(key);
+  }
+  std::ranges::sort(keys);
+  out.push_back(keys.size());
+  for (const uint64_t key : keys) {
+    out.push_back(key);
+    push_state(external_initial_states_.find(key)->second);
+  }
+  keys.clear();
+  for (const auto& [key, per_mip] : external_tex_mip_initial_states_) {
+    keys.push_back(key);
+  }
+  std::ranges::sort(keys);
+  out.push_back(keys.size());
+  for (const uint64_t key : keys) {
+    const auto& per_mip = external_tex_mip_initial_states_.find(key)->second;
+    out.push_back(key);
+    out.push_back(per_mip.size());
+    for (const auto& state : per_mip) {
+      push_state(state);
+    }
+  }
+  // barrier subresource expansion reads external texture extents from the device
+  out.push_back(external_textures_.size());
+  for (const auto& handle : external_textures_) {
+    const rhi::Texture* tex = handle.is_valid() ? device_->get_tex(handle) : nullptr;
+    out.push_back(tex ? tex->desc().mip_levels |
+                            (static_cast<uint64_t>(tex->desc().array_length) << 32)
+                      : 0);
+  }
+  out.push_back(tex_att_alias_of_.size());
+  out.insert(out.end(), tex_att_alias_of_.begin(), tex_att_alias_of_.end());
+  out.push_back(buffer_alias_of_.size());
+  out.insert(out.end(), buffer_alias_of_.begin(), buffer_alias_of_.end());
+}
+
+void RenderGraph::bake_restore_cached_barriers_() {
+  ZoneScopedN("RG bake: restore_cached_barriers");
+  pass_barrier_infos_ = bake_cache_.pass_barrier_infos;
+  for (const auto& [resource_idx, state] : bake_cache_.temporal_buf_final_states) {
+    const auto& rec = resources_[resource_idx];
+    auto& temporal = temporal_buffers_[rec.temporal_idx];
+    temporal.slot_states[temporal_barrier_target_slot_(temporal, rec)] = state;
+  }
+  for (const auto& [resource_idx, state] : bake_cache_.temporal_tex_final_states) {
+    const auto& rec = resources_[resource_idx];
+    auto& temporal = temporal_textures_[rec.temporal_idx];
+    temporal.slot_states[temporal_barrier_target_slot_(temporal, rec)] = state;
+  }
 }
 
 void RenderGraph::bake_find_sink_passes_(bool verbose) {
   ZoneScopedN("RG bake: find_sink_passes");
-  // find sink nodes, ie nodes that don't write to anything
+  // Sinks are passes with effects visible outside the graph: swapchain writes and writes to
+  // external or temporal resources (temporal resources are imported as external, and are read by
+  // the next frame even when nothing reads them this frame). Everything the sinks don't
+  // transitively depend on is culled by bake_compute_pass_order_.
   sink_passes_.clear();
   ALWAYS_ASSERT(passes_.size() > 0);
-  // find resource that don't get read (swapchain img)
-  // find pass that writes to that resource
   for (size_t pass_i = 0; pass_i < passes_.size(); pass_i++) {
     auto& pass = passes_[pass_i];
-    bool sink = false;
-    if (pass.swapchain_write_) {
-      sink = true;
-    } else {
-      for (const auto& write : pass.get_external_writes()) {
-        if (!external_read_ids_.contains(write.id)) {
-          sink = true;
-          break;
-        }
-      }
-    }
-    if (sink) {
+    if (pass.swapchain_write_ || !pass.get_external_writes().empty()) {
       sink_passes_.push_back(pass_i);
     }
   }
@@ -406,9 +658,35 @@ void RenderGraph::bake_find_sink_passes_(bool verbose) {
   }
 }
 
+void RenderGraph::bake_collect_culled_passes_(bool verbose) {
+  ZoneScopedN("RG bake: collect_culled_passes");
+  std::vector<bool> scheduled(passes_.size());
+  for (uint32_t pass_i : pass_stack_) {
+    scheduled[pass_i] = true;
+  }
+  std::vector<std::string> culled;
+  for (size_t pass_i = 0; pass_i < passes_.size(); pass_i++) {
+    if (!scheduled[pass_i]) {
+      culled.emplace_back(passes_[pass_i].get_name());
+    }
+  }
+  // Report only when the culled set changes so steady-state frames stay quiet.
+  if (culled != culled_pass_names_ || (verbose && !culled.empty())) {
+    if (!culled.empty()) {
+      std::string names;
+      for (const auto& name : culled) {
+        names += names.empty() ? name : ", " + name;
+      }
+      LINFO("RenderGraph: culled {} pass(es) that reach no sink: {}", culled.size(), names);
+    }
+    culled_pass_names_ = std::move(culled);
+  }
+}
+
 void RenderGraph::bake_compute_pass_order_(bool verbose) {
   ZoneScopedN("RG bake: compute_pass_order");
   {  // pass ordering
+    intermed_pass_stack_.clear();
     for (auto& p : pass_dependencies_) {
       p.clear();
     }
@@ -436,7 +714,7 @@ void RenderGraph::bake_compute_pass_order_(bool verbose) {
       for (auto pass_i : pass_stack_) {
         auto& pass = passes_[pass_i];
         LINFO("[PASS]: {}", pass.get_name());
-        const std::vector<RenderGraph::Pass::NameAndAccess>* arrays[4] = {
+        const RenderGraph::Pass::NameAndAccessList* arrays[4] = {
             &pass.get_internal_reads(), &pass.get_internal_writes(), &pass.get_external_reads(),
             &pass.get_external_writes()};
         for (auto& arr : arrays) {
@@ -596,15 +874,293 @@ void RenderGraph::bake_accumulate_physical_access_(
   }
 }
 
+void RenderGraph::bake_compute_transient_lifetimes_() {
+  ZoneScopedN("RG bake: compute_transient_lifetimes");
+  tex_att_lifetimes_.assign(tex_att_infos_.size(), TransientLifetime{});
+  buffer_lifetimes_.assign(buffer_infos_.size(), TransientLifetime{});
+  for (uint32_t exec_i = 0; exec_i < pass_stack_.size(); ++exec_i) {
+    const auto& pass = passes_[pass_stack_[exec_i]];
+    for (const auto& name_accesses : {&pass.get_internal_writes(), &pass.get_internal_reads()}) {
+      for (const auto& use : *name_accesses) {
+        const RGResourcePhysHandle phys = get_physical_handle(use.id);
+        auto& lifetimes =
+            phys.type == RGResourceType::Texture ? tex_att_lifetimes_ : buffer_lifetimes_;
+        ALWAYS_ASSERT(phys.idx < lifetimes.size());
+        auto& lt = lifetimes[phys.idx];
+        lt.first = std::min(lt.first, exec_i);
+        lt.last = std::max(lt.last, exec_i);
+      }
+    }
+  }
+}
+
+void RenderGraph::bake_assign_queues_(bool verbose) {
+  ZoneScopedN("RG bake: assign_queues");
+  const auto pass_count = static_cast<uint32_t>(pass_stack_.size());
+  exec_queues_.assign(pass_count, rhi::QueueType::Graphics);
+  tex_att_shared_.assign(tex_att_infos_.size(), false);
+  buffer_shared_.assign(buffer_infos_.size(), false);
+  temporal_tex_shared_.assign(temporal_textures_.size(), false);
+  temporal_buf_shared_.assign(temporal_buffers_.size(), false);
+  if (renderer_cv::developer_render_graph_async_compute.get() == 0 ||
+      !has_flag(device_->get_graphics_capabilities(), rhi::GraphicsCapability::AsyncCompute)) {
+    return;
+  }
+
+  // The graph creates transients and temporals itself; imported resources keep the sharing mode
+  // they were created with.
+  auto shareable = [this](const Pass::NameAndAccess& use) {
+    if (resources_[use.id.idx].temporal_idx != k_invalid_temporal_idx) {
+      return true;
+    }
+    const RGResourcePhysHandle phys = get_physical_handle(use.id);
+    if (phys.type == RGResourceType::ExternalTexture) {
+      const rhi::Texture* tex = device_->get_tex(external_textures_[phys.idx]);
+      return tex && has_flag(tex->desc().flags, rhi::TextureDescFlags::SharedAcrossQueues);
+    }
+    if (phys.type == RGResourceType::ExternalBuffer) {
+      const rhi::Buffer* buf = device_->get_buf(external_buffers_[phys.idx]);
+      return buf && has_flag(buf->desc().flags, rhi::BufferDescFlags::SharedAcrossQueues);
+    }
+    return true;
+  };
+  for (uint32_t exec_i = 0; exec_i < pass_count; ++exec_i) {
+    const auto& pass = passes_[pass_stack_[exec_i]];
+    if (pass.queue() == rhi::QueueType::Graphics) {
+      continue;
+    }
+    bool all_shareable = true;
+    for (const auto* uses : {&pass.get_external_writes(), &pass.get_internal_writes(),
+                             &pass.get_external_reads(), &pass.get_internal_reads()}) {
+      all_shareable = all_shareable && std::ranges::all_of(*uses, shareable);
+    }
+    if (all_shareable) {
+      exec_queues_[exec_i] = pass.queue();
+    } else if (verbose) {
+      LINFO("pass {} stays on graphics: it touches an imported resource that is not shared "
+            "across queues",
+            pass.get_name());
+    }
+  }
+
+  // Bit per queue touching each transient / temporal this bake.
+  std::vector<uint8_t> tex_queues(tex_att_infos_.size());
+  std::vector<uint8_t> buf_queues(buffer_infos_.size());
+  std::vector<uint8_t> temporal_tex_queues(temporal_textures_.size());
+  std::vector<uint8_t> temporal_buf_queues(temporal_buffers_.size());
+  for (uint32_t exec_i = 0; exec_i < pass_count; ++exec_i) {
+    const auto& pass = passes_[pass_stack_[exec_i]];
+    const auto queue_bit = static_cast<uint8_t>(1u << static_cast<uint32_t>(exec_queues_[exec_i]));
+    for (const auto* uses : {&pass.get_external_writes(), &pass.get_internal_writes(),
+                             &pass.get_external_reads(), &pass.get_internal_reads()}) {
+      for (const auto& use : *uses) {
+        const auto& rec = resources_[use.id.idx];
+        if (rec.temporal_idx != k_invalid_temporal_idx) {
+          auto& queues = rec.type == RGResourceType::ExternalTexture ? temporal_tex_queues
+                                                                     : temporal_buf_queues;
+          queues[rec.temporal_idx] |= queue_bit;
+          continue;
+        }
+        const RGResourcePhysHandle phys = get_physical_handle(use.id);
+        if (phys.type == RGResourceType::Texture) {
+          tex_queues[phys.idx] |= queue_bit;
+        } else if (phys.type == RGResourceType::Buffer) {
+          buf_queues[phys.idx] |= queue_bit;
+        }
+      }
+    }
+  }
+  auto mark_shared = [](const std::vector<uint8_t>& queues, std::vector<bool>& shared) {
+    for (size_t i = 0; i < queues.size(); ++i) {
+      shared[i] = !std::has_single_bit(queues[i]) && queues[i] != 0;
+    }
+  };
+  mark_shared(tex_queues, tex_att_shared_);
+  mark_shared(buf_queues, buffer_shared_);
+  mark_shared(temporal_tex_queues, temporal_tex_shared_);
+  mark_shared(temporal_buf_queues, temporal_buf_shared_);
+}
+
+void RenderGraph::bake_schedule_queues_(bool verbose) {
+  ZoneScopedN("RG bake: schedule_queues");
+  const auto pass_count = static_cast<uint32_t>(pass_stack_.size());
+  queue_segments_.clear();
+  if (std::ranges::none_of(exec_queues_,
+                           [](rhi::QueueType q) { return q != rhi::QueueType::Graphics; })) {
+    return;
+  }
+
+  constexpr size_t k_queue_count = static_cast<size_t>(rhi::QueueType::Count);
+  constexpr uint32_t k_none = UINT32_MAX;
+  // Transients sharing a handle through aliasing are one resource as far as queues are concerned.
+  auto resource_key = [this](RGResourceId id) {
+    const RGResourcePhysHandle phys = get_physical_handle(id);
+    uint32_t idx = phys.idx;
+    if (phys.type == RGResourceType::Texture) {
+      while (tex_att_alias_of_[idx] != k_no_alias) {
+        idx = tex_att_alias_of_[idx];
+      }
+    } else if (phys.type == RGResourceType::Buffer) {
+      while (buffer_alias_of_[idx] != k_no_alias) {
+        idx = buffer_alias_of_[idx];
+      }
+    }
+    return (static_cast<uint64_t>(phys.type) << 32) | idx;
+  };
+  // Last exec index touching each resource, per queue.
+  FlatHashMap<uint64_t, std::array<uint32_t, k_queue_count>> last_use;
+  std::vector<uint32_t> exec_segment(pass_count, k_none);
+  std::array<uint32_t, k_queue_count> open_segment;
+  open_segment.fill(k_none);
+  // synced_end[q][o]: passes on `o` before this exec index are known complete on queue `q`.
+  std::array<std::array<uint32_t, k_queue_count>, k_queue_count> synced_end{};
+  std::array<bool, k_queue_count> queue_used{};
+
+  // Prologue: the encoder recorded before the graph (uploads); compute work waits on it.
+  queue_segments_.push_back(QueueSegment{.queue = rhi::QueueType::Graphics, .waits = {}});
+
+  for (uint32_t exec_i = 0; exec_i < pass_count; ++exec_i) {
+    const auto& pass = passes_[pass_stack_[exec_i]];
+    const auto q = static_cast<size_t>(exec_queues_[exec_i]);
+    std::array<uint32_t, k_queue_count> need;
+    need.fill(k_none);
+    for (const auto* uses : {&pass.get_external_writes(), &pass.get_internal_writes(),
+                             &pass.get_external_reads(), &pass.get_internal_reads()}) {
+      for (const auto& use : *uses) {
+        auto [it, inserted] = last_use.try_emplace(resource_key(use.id));
+        if (inserted) {
+          it->second.fill(k_none);
+        }
+        for (size_t o = 0; o < k_queue_count; ++o) {
+          const uint32_t last = it->second[o];
+          if (o != q && last != k_none && last >= synced_end[q][o] &&
+              (need[o] == k_none || last > need[o])) {
+            need[o] = last;
+          }
+        }
+        it->second[q] = exec_i;
+      }
+    }
+
+    std::vector<uint32_t> waits;
+    for (size_t o = 0; o < k_queue_count; ++o) {
+      if (need[o] == k_none) {
+        continue;
+      }
+      // Signal right after the producing segment; later work on `o` goes to a new segment.
+      const uint32_t wait_seg = exec_segment[need[o]];
+      waits.push_back(wait_seg);
+      synced_end[q][o] = queue_segments_[wait_seg].exec_end;
+      if (open_segment[o] == wait_seg) {
+        open_segment[o] = k_none;
+      }
+    }
+    if (!queue_used[q] && q != static_cast<size_t>(rhi::QueueType::Graphics)) {
+      waits.push_back(0);
+    }
+    queue_used[q] = true;
+    // Waits apply from the start of an encoder, so a pass that needs one starts a new segment.
+    if (open_segment[q] == k_none || !waits.empty()) {
+      open_segment[q] = static_cast<uint32_t>(queue_segments_.size());
+      queue_segments_.push_back(QueueSegment{.queue = exec_queues_[exec_i],
+                                             .exec_begin = exec_i,
+                                             .waits = std::move(waits)});
+    }
+    queue_segments_[open_segment[q]].exec_end = exec_i + 1;
+    exec_segment[exec_i] = open_segment[q];
+  }
+
+  // Join everything back into graphics so the next frame starts from a single timeline.
+  QueueSegment join{.queue = rhi::QueueType::Graphics,
+                    .exec_begin = pass_count,
+                    .exec_end = pass_count,
+                    .waits = {}};
+  const auto gfx = static_cast<size_t>(rhi::QueueType::Graphics);
+  for (size_t o = 0; o < k_queue_count; ++o) {
+    if (o == gfx || !queue_used[o]) {
+      continue;
+    }
+    uint32_t last_seg = k_none;
+    for (uint32_t exec_i = pass_count; exec_i-- > 0;) {
+      if (static_cast<size_t>(exec_queues_[exec_i]) == o) {
+        last_seg = exec_segment[exec_i];
+        break;
+      }
+    }
+    if (queue_segments_[last_seg].exec_end > synced_end[gfx][o]) {
+      join.waits.push_back(last_seg);
+    }
+  }
+  if (!join.waits.empty()) {
+    queue_segments_.push_back(std::move(join));
+  }
+
+  if (verbose) {
+    for (size_t seg_i = 0; seg_i < queue_segments_.size(); ++seg_i) {
+      const auto& seg = queue_segments_[seg_i];
+      std::string waits;
+      for (uint32_t w : seg.waits) {
+        waits += std::format("{} ", w);
+      }
+      LINFO("queue segment {}: {} exec [{}, {}) waits [ {}]", seg_i, rhi::to_string(seg.queue),
+            seg.exec_begin, seg.exec_end, waits);
+    }
+  }
+}
+
 void RenderGraph::bake_allocate_transient_resources_(
     glm::uvec2 fb_size, const std::vector<rhi::AccessFlags>& tex_physical_access,
     const std::vector<rhi::AccessFlags>& buf_physical_access) {
   ZoneScopedN("RG bake: allocate_transient");
+  transient_mem_stats_ = {};
+  // bytes live per exec position, for the peak-live report
+  std::vector<size_t> live_bytes(pass_stack_.size(), 0);
+  auto add_live = [&](const TransientLifetime& lt, size_t bytes) {
+    if (!lt.used()) {
+      return;
+    }
+    for (uint32_t exec_i = lt.first; exec_i <= lt.last; ++exec_i) {
+      live_bytes[exec_i] += bytes;
+    }
+  };
+
+  // A physical resource handed out this bake; later transients with the same pool key whose
+  // first use comes after `free_from` can alias it.
+  struct AliasSlot {
+    uint32_t free_from{};
+    uint32_t tail_idx{};
+  };
+  auto order_by_first_use = [](const std::vector<TransientLifetime>& lifetimes) {
+    std::vector<uint32_t> order(lifetimes.size());
+    for (uint32_t i = 0; i < order.size(); ++i) {
+      order[i] = i;
+    }
+    std::ranges::stable_sort(order, [&](uint32_t a, uint32_t b) {
+      return lifetimes[a].first < lifetimes[b].first;
+    });
+    return order;
+  };
+  // Returns the slot to alias, or nullptr. Unused transients may share any slot since they
+  // receive no barriers and never touch the resource.
+  auto find_alias_slot = [](std::vector<AliasSlot>& slots,
+                            const TransientLifetime& lt) -> AliasSlot* {
+    for (auto& slot : slots) {
+      if (!lt.used() || slot.free_from <= lt.first) {
+        return &slot;
+      }
+    }
+    return nullptr;
+  };
+
   {
     // create attachment images
-    tex_att_handles_.clear();
-    for (size_t i = 0; i < tex_att_infos_.size(); ++i) {
+    tex_att_handles_.assign(tex_att_infos_.size(), rhi::TextureHandle{});
+    tex_att_alias_of_.assign(tex_att_infos_.size(), k_no_alias);
+    tex_att_bytes_.assign(tex_att_infos_.size(), 0);
+    FlatHashMap<TexPoolKey, std::vector<AliasSlot>, TexPoolKeyHash> alias_slots;
+    for (const uint32_t i : order_by_first_use(tex_att_lifetimes_)) {
       const auto& att_info = tex_att_infos_[i];
+      const auto& lt = tex_att_lifetimes_[i];
       if (att_info.is_swapchain_tex) {
         ASSERT(0);
         continue;
@@ -615,82 +1171,128 @@ void RenderGraph::bake_allocate_transient_resources_(
         }
         return att_info.dims;
       };
+      const size_t tex_bytes = transient_texture_bytes(att_info, get_att_dims());
+      tex_att_bytes_[i] = tex_bytes;
 
       const rhi::TextureUsage derived_usage =
           texture_desc_usage_for_bake(tex_physical_access[i], att_info);
 
+      const bool shared = tex_att_shared_[i];
+      const TexPoolKey pool_key{att_info, derived_usage, shared};
+      auto& slots = alias_slots[pool_key];
+      if (lt.used()) {
+        transient_mem_stats_.tex_bytes_unaliased += tex_bytes;
+        add_live(lt, tex_bytes);
+      }
+      if (AliasSlot* slot = find_alias_slot(slots, lt)) {
+        tex_att_handles_[i] = tex_att_handles_[slot->tail_idx];
+        tex_att_alias_of_[i] = slot->tail_idx;
+        if (lt.used()) {
+          slot->free_from = lt.last + 1;
+          slot->tail_idx = i;
+          ++transient_mem_stats_.tex_aliased_count;
+        }
+        continue;
+      }
+
       rhi::TextureHandle actual_att_handle{};
-      const TexPoolKey pool_key{att_info, derived_usage};
       auto free_att_it = free_atts_.find(pool_key);
       if (free_att_it != free_atts_.end()) {
-        auto& texture_handles = free_att_it->second;
-        if (!texture_handles.empty()) {
-          actual_att_handle = texture_handles.back();
-          texture_handles.pop_back();
+        auto& entries = free_att_it->second;
+        actual_att_handle = entries.back().handle;
+        pool_stats_.pooled_bytes -= entries.back().bytes;
+        entries.pop_back();
+        if (entries.empty()) {
+          free_atts_.erase(free_att_it);
         }
+        ++pool_stats_.hits;
       }
 
       if (!actual_att_handle.is_valid()) {
+        ++pool_stats_.misses;
         auto dims = get_att_dims();
-        auto att_tx_handle =
-            device_->create_tex(rhi::TextureDesc{.format = att_info.format,
-                                                 .usage = derived_usage,
-                                                 .dims = glm::uvec3{dims.x, dims.y, 1},
-                                                 .mip_levels = att_info.mip_levels,
-                                                 .array_length = att_info.array_layers,
-                                                 .name = "render_graph_tex_att"});
+        auto att_tx_handle = device_->create_tex(rhi::TextureDesc{
+            .format = att_info.format,
+            .usage = derived_usage,
+            .dims = glm::uvec3{dims.x, dims.y, 1},
+            .mip_levels = att_info.mip_levels,
+            .array_length = att_info.array_layers,
+            .flags = shared ? rhi::TextureDescFlags::SharedAcrossQueues
+                            : rhi::TextureDescFlags::None,
+            .name = "render_graph_tex_att"});
         actual_att_handle = att_tx_handle;
       }
 
-      tex_att_handles_.emplace_back(actual_att_handle);
+      tex_att_handles_[i] = actual_att_handle;
+      transient_mem_stats_.tex_bytes_aliased += tex_bytes;
+      slots.push_back(AliasSlot{.free_from = lt.used() ? lt.last + 1 : 0, .tail_idx = i});
     }
     ASSERT(tex_att_handles_.size() == tex_att_infos_.size());
   }
   {  // create buffers
-    buffer_handles_.clear();
-    defer_pool_handles_by_slot_.clear();
-    for (size_t i = 0; i < buffer_infos_.size(); ++i) {
+    buffer_handles_.assign(buffer_infos_.size(), rhi::BufferHandle{});
+    defer_pool_handles_by_slot_.assign(buffer_infos_.size(), rhi::BufferHandle{});
+    buffer_alias_of_.assign(buffer_infos_.size(), k_no_alias);
+    FlatHashMap<BufPoolKey, std::vector<AliasSlot>, BufPoolKeyHash> alias_slots;
+    for (const uint32_t i : order_by_first_use(buffer_lifetimes_)) {
       const auto& binfo = buffer_infos_[i];
+      const auto& lt = buffer_lifetimes_[i];
       const rhi::BufferUsage derived_usage =
           buffer_usage_from_accumulated_access(buf_physical_access[i]);
 
+      const bool shared = buffer_shared_[i];
+      const BufPoolKey pool_key{binfo, derived_usage, shared};
+      if (lt.used()) {
+        transient_mem_stats_.buf_bytes_unaliased += binfo.size;
+        add_live(lt, binfo.size);
+      }
+      // defer_reuse buffers outlive the frame's pass timeline, so they never alias.
+      auto* slots = binfo.defer_reuse ? nullptr : &alias_slots[pool_key];
+      if (AliasSlot* slot = slots ? find_alias_slot(*slots, lt) : nullptr) {
+        buffer_handles_[i] = buffer_handles_[slot->tail_idx];
+        buffer_alias_of_[i] = slot->tail_idx;
+        if (lt.used()) {
+          slot->free_from = lt.last + 1;
+          slot->tail_idx = i;
+          ++transient_mem_stats_.buf_aliased_count;
+        }
+        continue;
+      }
+
       rhi::BufferHandle actual_buf_handle{};
-      const BufPoolKey pool_key{binfo, derived_usage};
       auto free_buf_it = free_bufs_.find(pool_key);
       if (free_buf_it != free_bufs_.end()) {
-        auto& buffer_handles = free_buf_it->second;
-        if (!buffer_handles.empty()) {
-          actual_buf_handle = buffer_handles.back();
-          buffer_handles.pop_back();
-          if (buffer_handles.empty()) {
-            free_bufs_.erase(free_buf_it);
-          }
+        auto& entries = free_buf_it->second;
+        actual_buf_handle = entries.back().handle;
+        pool_stats_.pooled_bytes -= entries.back().bytes;
+        entries.pop_back();
+        if (entries.empty()) {
+          free_bufs_.erase(free_buf_it);
         }
+        ++pool_stats_.hits;
       }
       if (!actual_buf_handle.is_valid()) {
+        ++pool_stats_.misses;
         auto buf_handle = device_->create_buf(rhi::BufferDesc{
             .usage = derived_usage,
             .size = binfo.size,
+            .flags = shared ? rhi::BufferDescFlags::SharedAcrossQueues : rhi::BufferDescFlags::None,
             .name = "render_graph_buffer",
         });
         actual_buf_handle = buf_handle;
       }
-      buffer_handles_.emplace_back(actual_buf_handle);
+      buffer_handles_[i] = actual_buf_handle;
+      transient_mem_stats_.buf_bytes_aliased += binfo.size;
       if (binfo.defer_reuse) {
-        defer_pool_handles_by_slot_.emplace_back(actual_buf_handle);
+        defer_pool_handles_by_slot_[i] = actual_buf_handle;
       } else {
-        defer_pool_handles_by_slot_.emplace_back();
+        slots->push_back(AliasSlot{.free_from = lt.used() ? lt.last + 1 : 0, .tail_idx = i});
       }
     }
   }
-  // enqueue delete unused free buffers
-  for (auto& [key, handles] : free_bufs_) {
-    (void)key;
-    for (const auto& handle : handles) {
-      device_->destroy(handle);
-    }
+  for (const size_t bytes : live_bytes) {
+    transient_mem_stats_.peak_live_bytes = std::max(transient_mem_stats_.peak_live_bytes, bytes);
   }
-  free_bufs_.clear();
 }
 
 void RenderGraph::bake_allocate_temporal_resources_(glm::uvec2 fb_size) {
@@ -750,6 +1352,9 @@ void RenderGraph::bake_allocate_temporal_resources_(glm::uvec2 fb_size) {
     const uint32_t slot_count = temporal_slot_count(temporal_buf.slot_mode);
     rhi::BufferUsage derived_usage = buffer_usage_from_accumulated_access(temporal_buf_access[i]);
     ALWAYS_ASSERT(derived_usage != rhi::BufferUsage::None);
+    const rhi::BufferDescFlags flags = temporal_buf_shared_[i]
+                                           ? rhi::BufferDescFlags::SharedAcrossQueues
+                                           : rhi::BufferDescFlags::None;
     const bool needs_recreate =
         temporal_buf.usage != derived_usage ||
         temporal_any_slot_invalidated_(slot_count, [&](uint32_t slot) {
@@ -759,7 +1364,8 @@ void RenderGraph::bake_allocate_temporal_resources_(glm::uvec2 fb_size) {
             return true;
           }
           auto* buf = device_->get_buf(handle);
-          return !buf || buf->size() < temporal_buf.info.size || buf->desc().usage != derived_usage;
+          return !buf || buf->size() < temporal_buf.info.size ||
+                 buf->desc().usage != derived_usage || buf->desc().flags != flags;
         });
 
     if (needs_recreate) {
@@ -769,6 +1375,7 @@ void RenderGraph::bake_allocate_temporal_resources_(glm::uvec2 fb_size) {
         temporal_buf.handles[slot] = device_->create_buf(rhi::BufferDesc{
             .usage = derived_usage,
             .size = temporal_buf.info.size,
+            .flags = flags,
             .name = "render_graph_temporal_buffer",
         });
       }
@@ -785,6 +1392,9 @@ void RenderGraph::bake_allocate_temporal_resources_(glm::uvec2 fb_size) {
     const rhi::TextureUsage derived_usage =
         texture_usage_from_accumulated_access(temporal_tex_access[i]);
     ALWAYS_ASSERT(derived_usage != rhi::TextureUsage::None);
+    const rhi::TextureDescFlags flags = temporal_tex_shared_[i]
+                                            ? rhi::TextureDescFlags::SharedAcrossQueues
+                                            : rhi::TextureDescFlags::None;
     const bool needs_recreate = temporal.usage != derived_usage ||
                                 temporal_any_slot_invalidated_(slot_count, [&](uint32_t slot) {
                                   const auto& handle = temporal.handles[slot];
@@ -792,7 +1402,8 @@ void RenderGraph::bake_allocate_temporal_resources_(glm::uvec2 fb_size) {
                                   auto* tex = device_->get_tex(handle);
                                   ASSERT(tex);
                                   const auto& desc = tex->desc();
-                                  return desc.usage != derived_usage || desc.dims != dims ||
+                                  return desc.usage != derived_usage || desc.flags != flags ||
+                                         desc.dims != dims ||
                                          desc.format != temporal.info.format ||
                                          desc.mip_levels != temporal.info.mip_levels ||
                                          desc.array_length != temporal.info.array_layers;
@@ -808,6 +1419,7 @@ void RenderGraph::bake_allocate_temporal_resources_(glm::uvec2 fb_size) {
             .dims = dims,
             .mip_levels = temporal.info.mip_levels,
             .array_length = temporal.info.array_layers,
+            .flags = flags,
             .name = "render_graph_temporal_texture",
         });
         temporal.slot_states[slot].per_mip.assign(temporal.info.mip_levels, {});
@@ -837,7 +1449,7 @@ void RenderGraph::bake_allocate_temporal_resources_(glm::uvec2 fb_size) {
 
 void RenderGraph::bake_schedule_barriers_(bool verbose) {
   ZoneScopedN("RG bake: schedule_barriers");
-  std::unordered_map<RgSubresourceStateKey, SubresourceState, RgSubresourceStateKeyHash>
+  FlatHashMap<RgSubresourceStateKey, SubresourceState, RgSubresourceStateKeyHash>
       subresource_states;
 
   auto get_resource_state = [&](RGResourcePhysHandle handle, int32_t mip,
@@ -878,6 +1490,28 @@ void RenderGraph::bake_schedule_barriers_(bool verbose) {
       init.last_write_stage = external.stage == rhi::PipelineStage::None
                                   ? rhi::PipelineStage::TopOfPipe
                                   : external.stage;
+    } else if (handle.type == RGResourceType::Texture || handle.type == RGResourceType::Buffer) {
+      // Aliased transient: contents are discarded (Undefined layout), but the first access must
+      // still wait on the last accesses of the previous occupant of the same physical resource.
+      const auto& alias_of =
+          handle.type == RGResourceType::Texture ? tex_att_alias_of_ : buffer_alias_of_;
+      for (uint32_t prev = alias_of[handle.idx]; prev != k_no_alias; prev = alias_of[prev]) {
+        const auto prev_it = subresource_states.find(
+            RgSubresourceStateKey{.type = handle.type, .idx = prev, .mip = mip, .slice = slice});
+        if (prev_it == subresource_states.end()) {
+          continue;
+        }
+        const SubresourceState& prev_state = prev_it->second;
+        const rhi::PipelineStage prev_stages =
+            flag_or(prev_state.has_write ? prev_state.last_write_stage : rhi::PipelineStage::None,
+                    read_stage_mask(prev_state));
+        if (prev_stages != rhi::PipelineStage::None) {
+          init.has_write = true;
+          init.last_write_stage = prev_stages;
+          init.to_flush_access = prev_state.to_flush_access;
+        }
+        break;
+      }
     }
     auto [it, inserted] = subresource_states.emplace(key, init);
     return it->second;
@@ -909,7 +1543,7 @@ void RenderGraph::bake_schedule_barriers_(bool verbose) {
       int32_t mip{-1};
       int32_t slice{-1};
     };
-    std::unordered_map<RgSubresourceStateKey, PassUse, RgSubresourceStateKeyHash> pass_uses;
+    FlatHashMap<RgSubresourceStateKey, PassUse, RgSubresourceStateKeyHash> pass_uses;
 
     auto merge_new_pass_use = [&](const RgSubresourceStateKey& key, const PassUse& incoming) {
       auto it = pass_uses.find(key);
@@ -1187,8 +1821,11 @@ void RenderGraph::bake_schedule_barriers_(bool verbose) {
     return out;
   };
 
+  bake_cache_.temporal_buf_final_states.clear();
+  bake_cache_.temporal_tex_final_states.clear();
   const auto finalize_temporal_barrier_state = [&]<typename RecordT>(RecordT& temporal,
-                                                                     const ResourceRecord& r) {
+                                                                     const ResourceRecord& r,
+                                                                     uint32_t resource_idx) {
     if (!temporal_slot_used_this_frame_(temporal, r)) {
       return;
     }
@@ -1198,6 +1835,7 @@ void RenderGraph::bake_schedule_barriers_(bool verbose) {
           .type = RGResourceType::ExternalBuffer, .idx = r.physical_idx, .mip = -1, .slice = -1};
       if (auto it = subresource_states.find(key); it != subresource_states.end()) {
         temporal.slot_states[slot] = final_rg_state(it->second);
+        bake_cache_.temporal_buf_final_states.emplace_back(resource_idx, temporal.slot_states[slot]);
       }
     } else {
       auto& slot_state = temporal.slot_states[slot];
@@ -1214,19 +1852,22 @@ void RenderGraph::bake_schedule_barriers_(bool verbose) {
           }
         }
       }
+      bake_cache_.temporal_tex_final_states.emplace_back(resource_idx, slot_state);
     }
   };
 
-  for (const auto& rec : resources_) {
+  for (uint32_t resource_idx = 0; resource_idx < resources_.size(); ++resource_idx) {
+    const auto& rec = resources_[resource_idx];
     if (rec.temporal_idx == k_invalid_temporal_idx) {
       continue;
     }
     if (rec.type == RGResourceType::ExternalBuffer) {
-      finalize_temporal_barrier_state(temporal_buffers_[rec.temporal_idx], rec);
+      finalize_temporal_barrier_state(temporal_buffers_[rec.temporal_idx], rec, resource_idx);
     } else if (rec.type == RGResourceType::ExternalTexture) {
-      finalize_temporal_barrier_state(temporal_textures_[rec.temporal_idx], rec);
+      finalize_temporal_barrier_state(temporal_textures_[rec.temporal_idx], rec, resource_idx);
     }
   }
+  bake_cache_.pass_barrier_infos = pass_barrier_infos_;
 
   if (verbose) {
     LINFO("Barrier summary: {} barrier record(s) in {} pass(es) (execution order).",
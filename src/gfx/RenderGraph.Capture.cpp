@@ -0,0 +1,472 @@
+#include "RenderGraph.Capture.hpp"
+
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "core/EAssert.hpp"
+#include "gfx/rhi/Buffer.hpp"
+#include "gfx/rhi/Swapchain.hpp"
+#include "gfx/rhi/Texture.hpp"
+
+namespace TENG_NAMESPACE {
+namespace gfx {
+
+namespace {
+
+using json = nlohmann::json;
+
+constexpr const char* k_capture_schema = "teng.render_graph_capture/v1";
+
+// Enums are stored as their underlying integers: captures are tool input, not meant to be edited.
+template <typename E>
+auto to_int(E e) {
+  return static_cast<std::underlying_type_t<E>>(e);
+}
+
+template <typename E>
+E from_int(const json& j) {
+  return static_cast<E>(j.get<std::underlying_type_t<E>>());
+}
+
+json state_to_json(const RGState& s) {
+  return json{{"access", to_int(s.access)}, {"stage", to_int(s.stage)}, {"layout", to_int(s.layout)}};
+}
+
+RGState state_from_json(const json& j) {
+  return RGState{.access = from_int<rhi::AccessFlags>(j.at("access")),
+                 .stage = from_int<rhi::PipelineStage>(j.at("stage")),
+                 .layout = from_int<rhi::ResourceLayout>(j.at("layout"))};
+}
+
+json uses_to_json(const std::vector<RGCapture::Use>& uses) {
+  json out = json::array();
+  for (const auto& u : uses) {
+    out.push_back(json{{"resource", u.resource},
+                       {"version", u.version},
+                       {"stage", to_int(u.stage)},
+                       {"access", to_int(u.access)},
+                       {"swapchain_write", u.is_swapchain_write},
+                       {"subresource",
+                        {u.subresource.base_mip, u.subresource.mip_count,
+                         u.subresource.base_slice, u.subresource.slice_count}}});
+  }
+  return out;
+}
+
+std::vector<RGCapture::Use> uses_from_json(const json& j) {
+  std::vector<RGCapture::Use> out;
+  out.reserve(j.size());
+  for (const auto& u : j) {
+    const auto& sr = u.at("subresource");
+    out.push_back(RGCapture::Use{
+        .resource = u.at("resource").get<uint32_t>(),
+        .version = u.at("version").get<uint32_t>(),
+        .stage = from_int<rhi::PipelineStage>(u.at("stage")),
+        .access = from_int<rhi::AccessFlags>(u.at("access")),
+        .is_swapchain_write = u.at("swapchain_write").get<bool>(),
+        .subresource = RgSubresourceRange::mip_layers(sr.at(0).get<uint32_t>(),
+                                                      sr.at(1).get<uint32_t>(),
+                                                      sr.at(2).get<uint32_t>(),
+                                                      sr.at(3).get<uint32_t>()),
+    });
+  }
+  return out;
+}
+
+std::vector<RGCapture::Use> capture_uses(const RenderGraph::Pass::NameAndAccessList& uses) {
+  std::vector<RGCapture::Use> out;
+  out.reserve(uses.size());
+  for (const auto& u : uses) {
+    out.push_back(RGCapture::Use{.resource = u.id.idx,
+                                 .version = u.id.version,
+                                 .stage = u.stage,
+                                 .access = u.acc,
+                                 .is_swapchain_write = u.is_swapchain_write,
+                                 .subresource = u.subresource});
+  }
+  return out;
+}
+
+}  // namespace
+
+RGCapture RenderGraph::capture(glm::uvec2 fb_size) const {
+  RGCapture cap{.fb_size = fb_size, .resources = {}, .passes = {}};
+  cap.resources.reserve(resources_.size());
+  for (const auto& rec : resources_) {
+    RGCapture::Resource res{};
+    res.name = rec.debug_name == kInvalidNameId ? std::string{} : debug_name(rec.debug_name);
+    res.latest_version = rec.latest_version;
+    const bool temporal = rec.temporal_idx != k_invalid_temporal_idx;
+    if (temporal && rec.temporal_history_view) {
+      res.kind = RGCapture::ResourceKind::History;
+      for (uint32_t i = 0; i < resources_.size(); ++i) {
+        const auto& base = resources_[i];
+        if (base.type == rec.type && base.temporal_idx == rec.temporal_idx &&
+            !base.temporal_history_view) {
+          res.history_of = i;
+          break;
+        }
+      }
+    } else if (temporal && rec.type == RGResourceType::ExternalTexture) {
+      res.kind = RGCapture::ResourceKind::Texture;
+      res.tex_info = temporal_textures_[rec.temporal_idx].info;
+    } else if (temporal) {
+      res.kind = RGCapture::ResourceKind::Buffer;
+      res.buf_info = temporal_buffers_[rec.temporal_idx].info;
+    } else if (rec.type == RGResourceType::Texture) {
+      res.kind = RGCapture::ResourceKind::Texture;
+      res.tex_info = tex_att_infos_[rec.physical_idx];
+    } else if (rec.type == RGResourceType::Buffer) {
+      res.kind = RGCapture::ResourceKind::Buffer;
+      res.buf_info = buffer_infos_[rec.physical_idx];
+    } else {
+      const uint64_t phys64 =
+          RGResourcePhysHandle{.idx = rec.physical_idx, .type = rec.type}.to64();
+      if (auto it = external_tex_mip_initial_states_.find(phys64);
+          it != external_tex_mip_initial_states_.end()) {
+        res.initial_states = it->second;
+      } else if (auto it2 = external_initial_states_.find(phys64);
+                 it2 != external_initial_states_.end()) {
+        res.initial_states = {it2->second};
+      }
+      if (rec.type == RGResourceType::ExternalTexture) {
+        res.kind = RGCapture::ResourceKind::ExternalTexture;
+        res.ext_tex_desc = device_->get_tex(external_textures_[rec.physical_idx])->desc();
+        res.ext_tex_desc.name = nullptr;
+      } else {
+        res.kind = RGCapture::ResourceKind::ExternalBuffer;
+        res.ext_buf_desc = device_->get_buf(external_buffers_[rec.physical_idx])->desc();
+        res.ext_buf_desc.name = nullptr;
+      }
+    }
+    cap.resources.push_back(std::move(res));
+  }
+  cap.passes.reserve(passes_.size());
+  for (const auto& pass : passes_) {
+    cap.passes.push_back(RGCapture::Pass{
+        .name = pass.get_name(),
+        .type = pass.type(),
+        .queue = pass.queue(),
+        .swapchain_write = pass.swapchain_write_ != nullptr,
+        .external_reads = capture_uses(pass.get_external_reads()),
+        .external_writes = capture_uses(pass.get_external_writes()),
+        .internal_reads = capture_uses(pass.get_internal_reads()),
+        .internal_writes = capture_uses(pass.get_internal_writes()),
+    });
+    for (const auto& w : pass.get_external_writes()) {
+      if (w.is_swapchain_write) {
+        cap.resources[w.id.idx].swapchain = true;
+      }
+    }
+  }
+  return cap;
+}
+
+void RenderGraph::replay(const RGCapture& capture, const RGCaptureBindings& bindings) {
+  ALWAYS_ASSERT(passes_.empty() && resources_.empty());
+  for (uint32_t i = 0; i < capture.resources.size(); ++i) {
+    const auto& res = capture.resources[i];
+    RGResourceId id;
+    switch (res.kind) {
+      case RGCapture::ResourceKind::Texture:
+        id = create_texture(res.tex_info, res.name);
+        break;
+      case RGCapture::ResourceKind::Buffer:
+        id = create_buffer(res.buf_info, res.name);
+        break;
+      case RGCapture::ResourceKind::History: {
+        // Same as history(), minus the has_history() check: a replayed graph must keep its shape
+        // on the first frame, before any history exists.
+        const auto& base = resources_[res.history_of];
+        const TemporalSlotMode slot_mode = base.type == RGResourceType::ExternalTexture
+                                               ? temporal_textures_[base.temporal_idx].slot_mode
+                                               : temporal_buffers_[base.temporal_idx].slot_mode;
+        id = allocate_temporal_history_id_(base.type, base.temporal_idx,
+                                           temporal_has_distinct_history_slot(slot_mode),
+                                           base.physical_idx, res.name);
+        break;
+      }
+      case RGCapture::ResourceKind::ExternalTexture: {
+        const rhi::TextureHandle handle = res.swapchain
+                                              ? bindings.swapchain.handle.is_valid()
+                                                    ? device_->get_swapchain(bindings.swapchain)
+                                                          ->get_current_texture()
+                                                    : rhi::TextureHandle{}
+                                              : bindings.textures[i].handle;
+        if (res.initial_states.size() > 1) {
+          id = import_external_texture(handle, std::span(res.initial_states), res.name);
+        } else {
+          id = import_external_texture(
+              handle, res.initial_states.empty() ? RGState{} : res.initial_states[0], res.name);
+        }
+        break;
+      }
+      case RGCapture::ResourceKind::ExternalBuffer:
+        id = import_external_buffer(
+            bindings.buffers[i].handle,
+            res.initial_states.empty() ? RGState{} : res.initial_states[0], res.name);
+        break;
+    }
+    ALWAYS_ASSERT(id.idx == i);
+  }
+
+  rhi::Swapchain* swapchain =
+      bindings.swapchain.handle.is_valid() ? device_->get_swapchain(bindings.swapchain) : nullptr;
+  for (const auto& cp : capture.passes) {
+    Pass& pass = add_pass(cp.name, cp.type);
+    pass.set_queue(cp.queue);
+    pass.set_ex([](rhi::CmdEncoder*) {});
+    if (cp.swapchain_write) {
+      ALWAYS_ASSERT(swapchain);
+      pass.swapchain_write_ = swapchain;
+    }
+    const auto replay_uses = [&](const std::vector<RGCapture::Use>& uses,
+                                 Pass::NameAndAccessList& out, bool is_write) {
+      for (const auto& u : uses) {
+        ALWAYS_ASSERT(u.resource < resources_.size());
+        const RGResourceId id{
+            .idx = u.resource, .type = resources_[u.resource].type, .version = u.version};
+        if (is_write) {
+          register_write(id, pass);
+        }
+        mark_temporal_use_(id, is_write);
+        out.push_back(Pass::NameAndAccess{.id = id,
+                                          .stage = u.stage,
+                                          .acc = u.access,
+                                          .type = id.type,
+                                          .is_swapchain_write = u.is_swapchain_write,
+                                          .subresource = u.subresource});
+      }
+    };
+    replay_uses(cp.external_reads, pass.external_reads_, false);
+    replay_uses(cp.external_writes, pass.external_writes_, true);
+    replay_uses(cp.internal_reads, pass.internal_reads_, false);
+    replay_uses(cp.internal_writes, pass.internal_writes_, true);
+  }
+  for (uint32_t i = 0; i < capture.resources.size(); ++i) {
+    resources_[i].latest_version =
+        std::max(resources_[i].latest_version, capture.resources[i].latest_version);
+  }
+}
+
+RGCaptureBindings create_capture_bindings(rhi::Device* device, const RGCapture& capture) {
+  RGCaptureBindings bindings;
+  bindings.textures.resize(capture.resources.size());
+  bindings.buffers.resize(capture.resources.size());
+  for (size_t i = 0; i < capture.resources.size(); ++i) {
+    const auto& res = capture.resources[i];
+    if (res.kind == RGCapture::ResourceKind::ExternalTexture && res.swapchain &&
+        !bindings.swapchain.is_valid()) {
+      bindings.swapchain = device->create_swapchain_h(rhi::SwapchainDesc{
+          .window = nullptr, .width = capture.fb_size.x, .height = capture.fb_size.y,
+          .vsync = false});
+    } else if (res.kind == RGCapture::ResourceKind::ExternalTexture && !res.swapchain) {
+      rhi::TextureDesc desc = res.ext_tex_desc;
+      desc.name = "rg_capture_external_tex";
+      bindings.textures[i] = device->create_tex_h(desc);
+    } else if (res.kind == RGCapture::ResourceKind::ExternalBuffer) {
+      rhi::BufferDesc desc = res.ext_buf_desc;
+      desc.name = "rg_capture_external_buf";
+      bindings.buffers[i] = device->create_buf_h(desc);
+    }
+  }
+  return bindings;
+}
+
+Result<void> write_rg_capture(const std::filesystem::path& path, const RGCapture& capture) {
+  json root;
+  root["schema"] = k_capture_schema;
+  root["fb_size"] = {capture.fb_size.x, capture.fb_size.y};
+  json resources = json::array();
+  for (const auto& res : capture.resources) {
+    json r{{"kind", to_int(res.kind)},
+           {"name", res.name},
+           {"latest_version", res.latest_version}};
+    switch (res.kind) {
+      case RGCapture::ResourceKind::Texture: {
+        const auto& info = res.tex_info;
+        r["info"] = json{{"format", to_int(info.format)},
+                         {"dims", {info.dims.x, info.dims.y}},
+                         {"mip_levels", info.mip_levels},
+                         {"array_layers", info.array_layers},
+                         {"size_class", to_int(info.size_class)},
+                         {"is_swapchain_tex", info.is_swapchain_tex},
+                         {"temporal", info.temporal},
+                         {"temporal_slot_mode", to_int(info.temporal_slot_mode)}};
+        break;
+      }
+      case RGCapture::ResourceKind::Buffer: {
+        const auto& info = res.buf_info;
+        r["info"] = json{{"size", info.size},
+                         {"defer_reuse", info.defer_reuse},
+                         {"temporal", info.temporal},
+                         {"temporal_slot_mode", to_int(info.temporal_slot_mode)}};
+        break;
+      }
+      case RGCapture::ResourceKind::History:
+        r["history_of"] = res.history_of;
+        break;
+      case RGCapture::ResourceKind::ExternalTexture: {
+        const auto& desc = res.ext_tex_desc;
+        r["desc"] = json{{"format", to_int(desc.format)},
+                         {"usage", to_int(desc.usage)},
+                         {"dims", {desc.dims.x, desc.dims.y, desc.dims.z}},
+                         {"mip_levels", desc.mip_levels},
+                         {"array_length", desc.array_length},
+                         {"flags", to_int(desc.flags)}};
+        r["swapchain"] = res.swapchain;
+        break;
+      }
+      case RGCapture::ResourceKind::ExternalBuffer: {
+        const auto& desc = res.ext_buf_desc;
+        r["desc"] = json{
+            {"usage", to_int(desc.usage)}, {"size", desc.size}, {"flags", to_int(desc.flags)}};
+        break;
+      }
+    }
+    if (!res.initial_states.empty()) {
+      json states = json::array();
+      for (const auto& s : res.initial_states) {
+        states.push_back(state_to_json(s));
+      }
+      r["initial_states"] = std::move(states);
+    }
+    resources.push_back(std::move(r));
+  }
+  root["resources"] = std::move(resources);
+  json passes = json::array();
+  for (const auto& pass : capture.passes) {
+    passes.push_back(json{{"name", pass.name},
+                          {"type", to_int(pass.type)},
+                          {"queue", to_int(pass.queue)},
+                          {"swapchain_write", pass.swapchain_write},
+                          {"external_reads", uses_to_json(pass.external_reads)},
+                          {"external_writes", uses_to_json(pass.external_writes)},
+                          {"internal_reads", uses_to_json(pass.internal_reads)},
+                          {"internal_writes", uses_to_json(pass.internal_writes)}});
+  }
+  root["passes"] = std::move(passes);
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    return make_unexpected("could not open render graph capture " + path.string() + " for write");
+  }
+  out << root.dump(1) << "\n";
+  return {};
+}
+
+Result<RGCapture> read_rg_capture(const std::filesystem::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return make_unexpected("could not open render graph capture " + path.string());
+  }
+  std::stringstream text;
+  text << in.rdbuf();
+  try {
+    const json root = json::parse(text.str());
+    if (root.value("schema", std::string{}) != k_capture_schema) {
+      return make_unexpected(path.string() + " is not a " + k_capture_schema + " file");
+    }
+    RGCapture capture;
+    capture.fb_size = {root.at("fb_size").at(0).get<uint32_t>(),
+                       root.at("fb_size").at(1).get<uint32_t>()};
+    for (const auto& r : root.at("resources")) {
+      RGCapture::Resource res{};
+      res.kind = from_int<RGCapture::ResourceKind>(r.at("kind"));
+      res.name = r.at("name").get<std::string>();
+      res.latest_version = r.at("latest_version").get<uint32_t>();
+      switch (res.kind) {
+        case RGCapture::ResourceKind::Texture: {
+          const auto& info = r.at("info");
+          res.tex_info = AttachmentInfo{
+              .format = from_int<rhi::TextureFormat>(info.at("format")),
+              .dims = {info.at("dims").at(0).get<uint32_t>(),
+                       info.at("dims").at(1).get<uint32_t>()},
+              .mip_levels = info.at("mip_levels").get<uint32_t>(),
+              .array_layers = info.at("array_layers").get<uint32_t>(),
+              .size_class = from_int<SizeClass>(info.at("size_class")),
+              .is_swapchain_tex = info.at("is_swapchain_tex").get<bool>(),
+              .temporal = info.at("temporal").get<bool>(),
+              .temporal_slot_mode = from_int<TemporalSlotMode>(info.at("temporal_slot_mode")),
+          };
+          break;
+        }
+        case RGCapture::ResourceKind::Buffer: {
+          const auto& info = r.at("info");
+          res.buf_info = BufferInfo{
+              .size = info.at("size").get<size_t>(),
+              .defer_reuse = info.at("defer_reuse").get<bool>(),
+              .temporal = info.at("temporal").get<bool>(),
+              .temporal_slot_mode = from_int<TemporalSlotMode>(info.at("temporal_slot_mode")),
+          };
+          break;
+        }
+        case RGCapture::ResourceKind::History:
+          res.history_of = r.at("history_of").get<uint32_t>();
+          break;
+        case RGCapture::ResourceKind::ExternalTexture: {
+          const auto& desc = r.at("desc");
+          res.ext_tex_desc = rhi::TextureDesc{
+              .format = from_int<rhi::TextureFormat>(desc.at("format")),
+              .usage = from_int<rhi::TextureUsage>(desc.at("usage")),
+              .dims = {desc.at("dims").at(0).get<uint32_t>(),
+                       desc.at("dims").at(1).get<uint32_t>(),
+                       desc.at("dims").at(2).get<uint32_t>()},
+              .mip_levels = desc.at("mip_levels").get<uint32_t>(),
+              .array_length = desc.at("array_length").get<uint32_t>(),
+              .flags = from_int<rhi::TextureDescFlags>(desc.at("flags")),
+              .name = nullptr,
+          };
+          res.swapchain = r.at("swapchain").get<bool>();
+          break;
+        }
+        case RGCapture::ResourceKind::ExternalBuffer: {
+          const auto& desc = r.at("desc");
+          res.ext_buf_desc = rhi::BufferDesc{
+              .usage = from_int<rhi::BufferUsage>(desc.at("usage")),
+              .size = desc.at("size").get<size_t>(),
+              .flags = from_int<rhi::BufferDescFlags>(desc.at("flags")),
+              .name = nullptr,
+          };
+          break;
+        }
+        default:
+          return make_unexpected(path.string() + ": unknown resource kind");
+      }
+      if (r.contains("initial_states")) {
+        for (const auto& s : r.at("initial_states")) {
+          res.initial_states.push_back(state_from_json(s));
+        }
+      }
+      if (res.kind == RGCapture::ResourceKind::History &&
+          res.history_of >= capture.resources.size()) {
+        return make_unexpected(path.string() + ": history resource precedes its temporal resource");
+      }
+      capture.resources.push_back(std::move(res));
+    }
+    for (const auto& p : root.at("passes")) {
+      RGCapture::Pass pass{
+          .name = p.at("name").get<std::string>(),
+          .type = from_int<RGPassType>(p.at("type")),
+          .queue = from_int<rhi::QueueType>(p.at("queue")),
+          .swapchain_write = p.at("swapchain_write").get<bool>(),
+          .external_reads = uses_from_json(p.at("external_reads")),
+          .external_writes = uses_from_json(p.at("external_writes")),
+          .internal_reads = uses_from_json(p.at("internal_reads")),
+          .internal_writes = uses_from_json(p.at("internal_writes")),
+      };
+      capture.passes.push_back(std::move(pass));
+    }
+    return capture;
+  } catch (const json::exception& e) {
+    return make_unexpected("failed to parse render graph capture " + path.string() + ": " +
+                           e.what());
+  }
+}
+
+}  // namespace gfx
+}  // namespace TENG_NAMESPACE
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "core/Result.hpp"
+#include "gfx/RenderGraph.hpp"
+
+namespace TENG_NAMESPACE {
+namespace gfx {
+
+// The declared state of one RenderGraph frame: resources in creation order and every pass with
+// its accesses. ExecuteFns and physical handles are not captured, so a capture replays against
+// any device (see RenderGraph::replay and apps/rg-bench).
+struct RGCapture {
+  enum class ResourceKind : uint8_t { Texture, Buffer, History, ExternalTexture, ExternalBuffer };
+
+  struct Resource {
+    ResourceKind kind{};
+    std::string name;
+    uint32_t latest_version{};
+    // Texture (transient or temporal)
+    AttachmentInfo tex_info;
+    // Buffer (transient or temporal)
+    BufferInfo buf_info;
+    // History: index of the temporal resource this is the history view of
+    uint32_t history_of{};
+    // ExternalTexture / ExternalBuffer: what was imported and its initial state(s), one per mip
+    // for textures imported with per-mip states.
+    rhi::TextureDesc ext_tex_desc;
+    rhi::BufferDesc ext_buf_desc;
+    std::vector<RGState> initial_states;
+    bool swapchain{};
+  };
+
+  struct Use {
+    uint32_t resource{};
+    uint32_t version{};
+    rhi::PipelineStage stage{};
+    rhi::AccessFlags access{};
+    bool is_swapchain_write{};
+    RgSubresourceRange subresource;
+  };
+
+  struct Pass {
+    std::string name;
+    RGPassType type{};
+    rhi::QueueType queue{rhi::QueueType::Graphics};
+    bool swapchain_write{};
+    std::vector<Use> external_reads;
+    std::vector<Use> external_writes;
+    std::vector<Use> internal_reads;
+    std::vector<Use> internal_writes;
+  };
+
+  glm::uvec2 fb_size{};
+  std::vector<Resource> resources;
+  std::vector<Pass> passes;
+};
+
+// Device resources standing in for a capture's external textures / buffers and swapchain.
+struct RGCaptureBindings {
+  // Indexed like RGCapture::resources; only external entries are valid.
+  std::vector<rhi::TextureHandleHolder> textures;
+  std::vector<rhi::BufferHandleHolder> buffers;
+  rhi::SwapchainHandleHolder swapchain;
+};
+
+[[nodiscard]] RGCaptureBindings create_capture_bindings(rhi::Device* device,
+                                                        const RGCapture& capture);
+
+[[nodiscard]] Result<void> write_rg_capture(const std::filesystem::path& path,
+                                            const RGCapture& capture);
+[[nodiscard]] Result<RGCapture> read_rg_capture(const std::filesystem::path& path);
+
+}  // namespace gfx
+}  // namespace TENG_NAMESPACE
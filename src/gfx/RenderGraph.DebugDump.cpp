@@ -10,6 +10,7 @@
 #include <vector>
 
 #include "core/Logger.hpp"
+#include "gfx/RenderGraph.Capture.hpp"
 #include "gfx/RenderGraph.Format.hpp"
 #include "gfx/renderer/RendererCVars.hpp"
 
@@ -208,6 +209,9 @@ void RenderGraph::bake_write_debug_dump_if_requested_(glm::uvec2 fb_size) {
         jf << ",\n";
         jf << std::format("      \"exec_order\": {}", exec_order_by_pass[pass_i]);
         jf << ",\n";
+        jf << std::format("      \"culled\": {}",
+                          exec_order_by_pass[pass_i] < 0 ? "true" : "false");
+        jf << ",\n";
         jf << std::format("      \"barrier_count_at_pass\": {}",
                           pass_barrier_infos_[pass_i].size());
         jf << "\n    }";
@@ -360,12 +364,49 @@ void RenderGraph::bake_write_debug_dump_if_requested_(glm::uvec2 fb_size) {
         jf << "  \"summary\": {\n";
         jf << std::format("    \"total_barrier_records\": {},\n", total_barrier_records);
         jf << std::format("    \"passes_declared\": {},\n", passes_.size());
-        jf << std::format("    \"passes_executed\": {}\n", pass_stack_.size());
+        jf << std::format("    \"passes_executed\": {},\n", pass_stack_.size());
+        const auto& mem = transient_mem_stats_;
+        jf << "    \"transient_memory\": {\n";
+        jf << std::format("      \"bytes_unaliased\": {},\n", mem.bytes_unaliased());
+        jf << std::format("      \"bytes_aliased\": {},\n", mem.bytes_aliased());
+        jf << std::format("      \"peak_live_bytes\": {},\n", mem.peak_live_bytes);
+        jf << std::format("      \"tex_bytes_unaliased\": {},\n", mem.tex_bytes_unaliased);
+        jf << std::format("      \"tex_bytes_aliased\": {},\n", mem.tex_bytes_aliased);
+        jf << std::format("      \"buf_bytes_unaliased\": {},\n", mem.buf_bytes_unaliased);
+        jf << std::format("      \"buf_bytes_aliased\": {},\n", mem.buf_bytes_aliased);
+        jf << std::format("      \"tex_aliased_count\": {},\n", mem.tex_aliased_count);
+        jf << std::format("      \"buf_aliased_count\": {}\n", mem.buf_aliased_count);
+        jf << "    },\n";
+        const auto& bs = bake_stats_;
+        jf << "    \"bake\": {\n";
+        jf << std::format("      \"last_bake_ms\": {:.4f},\n", bs.last_bake_ms);
+        jf << std::format("      \"avg_bake_ms\": {:.4f},\n", bs.avg_bake_ms());
+        jf << std::format("      \"bake_count\": {},\n", bs.bake_count);
+        jf << std::format("      \"topology_cache_hits\": {},\n", bs.topology_hits);
+        jf << std::format("      \"barrier_cache_hits\": {},\n", bs.barrier_hits);
+        jf << std::format("      \"topology_cache_hit_rate\": {:.4f}\n", bs.topology_hit_rate());
+        jf << "    },\n";
+        const auto& ps = pool_stats_;
+        jf << "    \"pool\": {\n";
+        jf << std::format("      \"pooled_bytes\": {},\n", ps.pooled_bytes);
+        jf << std::format("      \"hits\": {},\n", ps.hits);
+        jf << std::format("      \"misses\": {},\n", ps.misses);
+        jf << std::format("      \"evictions\": {},\n", ps.evictions);
+        jf << std::format("      \"evicted_bytes\": {}\n", ps.evicted_bytes);
+        jf << "    }\n";
         jf << "  }\n}\n";
       }
     }
   }
 
+  if (want_json) {
+    // Replayable with apps/rg-bench.
+    const auto capture_path = base_dir / std::format("rg_capture_{}.json", dump_index);
+    if (auto written = write_rg_capture(capture_path, capture(fb_size)); !written) {
+      LWARN("RenderGraph dump: {}", written.error());
+    }
+  }
+
   if (want_dot) {
     const auto dot_path = base_dir / std::format("rg_dump_{}.dot", dump_index);
     std::ofstream df(dot_path, std::ios::out | std::ios::trunc);
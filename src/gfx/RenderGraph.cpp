@@ -1,17 +1,20 @@
 #include "RenderGraph.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <span>
 #include <string>
 #include <string_view>
-#include <tracy/Tracy.hpp>
 #include <unordered_map>
 #include <vector>
 
 #include "core/Config.hpp"
 #include "core/EAssert.hpp"
+#include "core/JobSystem.hpp"
+#include "core/Profiler.hpp"
+#include "gfx/renderer/RendererCVars.hpp"
 #include "gfx/rhi/Barrier.hpp"
 #include "gfx/rhi/Buffer.hpp"
 #include "gfx/rhi/CmdEncoder.hpp"
@@ -70,7 +73,21 @@ const char* to_string(RGResourceType type) {
 }
 
 RenderGraph::Pass::Pass(NameId name_id, RenderGraph* rg, uint32_t pass_i, RGPassType type)
-    : rg_(rg), pass_i_(pass_i), name_id_(name_id), type_(type) {}
+    : external_reads_(rg->frame_memory_),
+      external_writes_(rg->frame_memory_),
+      internal_reads_(rg->frame_memory_),
+      internal_writes_(rg->frame_memory_),
+      rg_(rg),
+      pass_i_(pass_i),
+      name_id_(name_id),
+      type_(type) {}
+
+RenderGraph::Pass& RenderGraph::Pass::set_queue(rhi::QueueType queue) {
+  ALWAYS_ASSERT(queue == rhi::QueueType::Graphics || type_ == RGPassType::Compute ||
+                type_ == RGPassType::Transfer);
+  queue_ = queue;
+  return *this;
+}
 
 RenderGraph::Pass& RenderGraph::add_pass(std::string_view name, RGPassType type) {
   auto idx = static_cast<uint32_t>(passes_.size());
@@ -87,6 +104,234 @@ void RenderGraph::execute() {
 
 void RenderGraph::execute(rhi::CmdEncoder* enc) {
   ZoneScoped;
+  begin_record_();
+  if (queue_segments_.empty()) {
+    record_passes_(enc, 0, static_cast<uint32_t>(pass_stack_.size()), rhi::QueueType::Graphics,
+                   LayoutSeeding::None);
+  } else {
+    // `enc` is the prologue segment: passes go into encoders begun after it. Segments are recorded
+    // out of exec order, so they are begun as a batch (see begin_parallel_cmd_encoders) even though
+    // this thread records them one after another.
+    gch::small_vector<rhi::QueueType, 8> queues;
+    for (const auto& seg : queue_segments_) {
+      queues.emplace_back(seg.queue);
+    }
+    gch::small_vector<rhi::CmdEncoder*, 8> encoders(queue_segments_.size());
+    encoders[0] = enc;
+    const auto segment_encoders = std::span(encoders.data() + 1, encoders.size() - 1);
+    device_->begin_parallel_cmd_encoders(std::span(queues.data() + 1, queues.size() - 1),
+                                         segment_encoders);
+    record_queue_segments_(std::span(encoders.data(), encoders.size()), false);
+    device_->end_parallel_cmd_encoders(segment_encoders);
+  }
+  update_record_stats_();
+  reset_after_execute_();
+}
+
+void RenderGraph::execute_parallel(uint32_t max_chunks) {
+  ZoneScoped;
+  if (!has_flag(device_->get_graphics_capabilities(),
+                rhi::GraphicsCapability::ParallelCmdEncoding)) {
+    execute();
+    return;
+  }
+  if (!queue_segments_.empty()) {
+    // Queue segments already split the graph; record each one on its own thread.
+    gch::small_vector<rhi::QueueType, 8> queues;
+    for (const auto& seg : queue_segments_) {
+      queues.emplace_back(seg.queue);
+    }
+    gch::small_vector<rhi::CmdEncoder*, 8> encoders(queue_segments_.size());
+    device_->begin_parallel_cmd_encoders(std::span(queues.data(), queues.size()),
+                                         std::span(encoders.data(), encoders.size()));
+    begin_record_();
+    record_queue_segments_(std::span(encoders.data(), encoders.size()), true);
+    device_->end_parallel_cmd_encoders(std::span(encoders.data(), encoders.size()));
+    update_record_stats_();
+    reset_after_execute_();
+    return;
+  }
+  compute_record_chunks_(max_chunks);
+  if (record_chunk_ends_.size() < 2) {
+    execute();
+    return;
+  }
+
+  const auto chunk_count = static_cast<uint32_t>(record_chunk_ends_.size());
+  gch::small_vector<rhi::QueueType, 8> queues(chunk_count, rhi::QueueType::Graphics);
+  gch::small_vector<rhi::CmdEncoder*, 8> encoders(chunk_count);
+  device_->begin_parallel_cmd_encoders(std::span(queues.data(), queues.size()),
+                                       std::span(encoders.data(), encoders.size()));
+  begin_record_();
+
+  auto record_chunk = [this, &encoders](uint32_t chunk_i) {
+    ZoneScopedN("RG record chunk");
+    const uint32_t begin = chunk_i == 0 ? 0 : record_chunk_ends_[chunk_i - 1];
+    record_passes_(encoders[chunk_i], begin, record_chunk_ends_[chunk_i], rhi::QueueType::Graphics,
+                   LayoutSeeding::BeforePasses);
+    encoders[chunk_i]->end_encoding();
+  };
+  JobCounter counter;
+  for (uint32_t chunk_i = 1; chunk_i < chunk_count; ++chunk_i) {
+    JobSystem::get().run([&record_chunk, chunk_i] { record_chunk(chunk_i); }, &counter);
+  }
+  // The calling thread records the first chunk, then helps with the rest instead of idling.
+  record_chunk(0);
+  JobSystem::get().wait(counter);
+
+  device_->end_parallel_cmd_encoders(std::span(encoders.data(), encoders.size()));
+  update_record_stats_();
+  reset_after_execute_();
+}
+
+void RenderGraph::compute_record_chunks_(uint32_t max_chunks) {
+  record_chunk_ends_.clear();
+  const auto pass_count = static_cast<uint32_t>(pass_stack_.size());
+  const uint32_t chunk_count = std::min(max_chunks, pass_count / k_min_passes_per_record_chunk);
+  if (chunk_count < 2) {
+    return;
+  }
+
+  // Passes not measured yet cost the average of the measured ones (or 1 if none are).
+  float known_total = 0.f;
+  uint32_t known_count = 0;
+  for (uint32_t pass_i : pass_stack_) {
+    const NameId name_id = passes_[pass_i].get_name_id();
+    if (name_id < pass_record_cost_us_.size() && pass_record_cost_us_[name_id] > 0.f) {
+      known_total += pass_record_cost_us_[name_id];
+      known_count++;
+    }
+  }
+  const float default_cost = known_count ? known_total / static_cast<float>(known_count) : 1.f;
+  auto pass_cost = [&](uint32_t exec_i) {
+    const NameId name_id = passes_[pass_stack_[exec_i]].get_name_id();
+    if (name_id < pass_record_cost_us_.size() && pass_record_cost_us_[name_id] > 0.f) {
+      return pass_record_cost_us_[name_id];
+    }
+    return default_cost;
+  };
+
+  float total = 0.f;
+  for (uint32_t exec_i = 0; exec_i < pass_count; ++exec_i) {
+    total += pass_cost(exec_i);
+  }
+
+  // Greedy contiguous split: close a chunk once its running cost reaches the next even share,
+  // keeping at least one pass for every chunk still to come.
+  uint32_t exec_i = 0;
+  float acc = 0.f;
+  for (uint32_t chunk_i = 0; chunk_i + 1 < chunk_count; ++chunk_i) {
+    const float target = total * static_cast<float>(chunk_i + 1) / static_cast<float>(chunk_count);
+    const uint32_t max_end = pass_count - (chunk_count - 1 - chunk_i);
+    const uint32_t chunk_begin = exec_i;
+    while (exec_i < max_end) {
+      const float cost = pass_cost(exec_i);
+      if (exec_i != chunk_begin && acc + (cost * 0.5f) > target) {
+        break;
+      }
+      acc += cost;
+      exec_i++;
+    }
+    record_chunk_ends_.push_back(exec_i);
+  }
+  record_chunk_ends_.push_back(pass_count);
+}
+
+void RenderGraph::begin_record_() {
+  exec_record_us_.assign(pass_stack_.size(), 0.f);
+  exec_barrier_stats_.assign(pass_stack_.size(), {});
+  gpu_timer_.begin_frame(static_cast<uint32_t>(pass_stack_.size()),
+                         renderer_cv::developer_render_graph_gpu_timing.get() != 0);
+}
+
+void RenderGraph::update_record_stats_() {
+  constexpr float k_ema_alpha = 0.1f;
+  if (pass_record_cost_us_.size() < id_to_name_.size()) {
+    pass_record_cost_us_.resize(id_to_name_.size(), 0.f);
+  }
+  execute_stats_ = {};
+  for (uint32_t exec_i = 0; exec_i < pass_stack_.size(); ++exec_i) {
+    float& cost = pass_record_cost_us_[passes_[pass_stack_[exec_i]].get_name_id()];
+    const float sample = exec_record_us_[exec_i];
+    cost = cost > 0.f ? cost + (k_ema_alpha * (sample - cost)) : std::max(sample, 1e-3f);
+    execute_stats_.barrier_calls += exec_barrier_stats_[exec_i].barrier_calls;
+    execute_stats_.barriers += exec_barrier_stats_[exec_i].barriers;
+  }
+  if (gpu_timer_.active()) {
+    gch::small_vector<uint32_t, 64> pass_keys;
+    for (uint32_t pass_i : pass_stack_) {
+      pass_keys.push_back(passes_[pass_i].get_name_id());
+    }
+    gpu_timer_.end_frame(std::span(pass_keys.data(), pass_keys.size()));
+  }
+}
+
+GPUPassTimer::Stats RenderGraph::get_pass_gpu_stats(std::string_view pass_name) const {
+  auto it = name_to_id_.find(pass_name);
+  return it == name_to_id_.end() ? GPUPassTimer::Stats{} : gpu_timer_.get_stats(it->second);
+}
+
+void RenderGraph::on_imgui_gpu_timings() const {
+  gpu_timer_.on_imgui([this](uint32_t name_id) -> std::string_view { return debug_name(name_id); });
+}
+
+void RenderGraph::record_queue_segments_(std::span<rhi::CmdEncoder* const> encoders,
+                                         bool parallel) {
+  ASSERT(encoders.size() == queue_segments_.size());
+  auto record_segment = [this, encoders](size_t seg_i) {
+    ZoneScopedN("RG record queue segment");
+    const auto& seg = queue_segments_[seg_i];
+    // Segments interleave in exec order, so the last one to end the batch must also see the
+    // layouts left by passes after its own.
+    record_passes_(encoders[seg_i], seg.exec_begin, seg.exec_end, seg.queue,
+                   seg_i + 1 == queue_segments_.size() ? LayoutSeeding::BeforeAndAfterPasses
+                                                       : LayoutSeeding::BeforePasses);
+    encoders[seg_i]->end_encoding();
+  };
+  if (parallel) {
+    JobCounter counter;
+    for (size_t seg_i = 1; seg_i + 1 < queue_segments_.size(); ++seg_i) {
+      JobSystem::get().run([&record_segment, seg_i] { record_segment(seg_i); }, &counter);
+    }
+    record_segment(0);
+    if (queue_segments_.size() > 1) {
+      record_segment(queue_segments_.size() - 1);
+    }
+    JobSystem::get().wait(counter);
+  } else {
+    // The prologue belongs to the caller, who ends it.
+    for (size_t seg_i = 1; seg_i < queue_segments_.size(); ++seg_i) {
+      record_segment(seg_i);
+    }
+  }
+  for (size_t seg_i = 0; seg_i < queue_segments_.size(); ++seg_i) {
+    for (uint32_t wait_seg_i : queue_segments_[seg_i].waits) {
+      device_->cmd_encoder_wait_for(encoders[wait_seg_i], encoders[seg_i]);
+    }
+  }
+}
+
+void RenderGraph::seed_layouts_(rhi::CmdEncoder* enc, uint32_t exec_begin, uint32_t exec_end) {
+  for (uint32_t exec_i = exec_begin; exec_i < exec_end; ++exec_i) {
+    for (const auto& barrier : pass_barrier_infos_[pass_stack_[exec_i]]) {
+      const bool is_tex = barrier.resource.type == RGResourceType::Texture ||
+                          barrier.resource.type == RGResourceType::ExternalTexture;
+      // Swapchain images are transitioned by the encoder that presents them.
+      if (!is_tex || barrier.is_swapchain_write) {
+        continue;
+      }
+      const rhi::TextureHandle tex_handle = barrier.resource.type == RGResourceType::Texture
+                                                ? get_att_img(barrier.resource)
+                                                : get_external_tex(barrier.resource);
+      enc->set_assumed_layout(tex_handle, barrier.subresource.base_mip,
+                              barrier.subresource.mip_count, barrier.dst_state.layout);
+    }
+  }
+}
+
+void RenderGraph::record_passes_(rhi::CmdEncoder* enc, uint32_t exec_begin, uint32_t exec_end,
+                                 rhi::QueueType queue, LayoutSeeding seeding) {
+  gch::small_vector<rhi::GPUBarrier, 16> pass_barriers;
   gch::small_vector<rhi::GPUBarrier, 8> post_pass_barriers;
   auto is_final_swapchain_write = [&](uint32_t exec_pass_i, rhi::Swapchain* swapchain) {
     // if any later pass writes to the swapchain, this one isn't the last write.
@@ -99,19 +344,36 @@ void RenderGraph::execute(rhi::CmdEncoder* enc) {
     return true;
   };
 
-  for (uint32_t exec_i = 0; exec_i < pass_stack_.size(); ++exec_i) {
+  // In a batch, passes in [seeded_end, exec_i) not yet seeded were recorded by other encoders.
+  uint32_t seeded_end = 0;
+  for (uint32_t exec_i = exec_begin; exec_i < exec_end; ++exec_i) {
+    if (!exec_queues_.empty() && exec_queues_[exec_i] != queue) {
+      continue;
+    }
+    if (seeding != LayoutSeeding::None) {
+      seed_layouts_(enc, seeded_end, exec_i);
+      seeded_end = exec_i + 1;
+    }
+    const auto record_start = std::chrono::steady_clock::now();
     const auto pass_i = pass_stack_[exec_i];
+    pass_barriers.clear();
     post_pass_barriers.clear();
     auto& pass = passes_[pass_i];
     ZoneScopedN("Execute Pass");
+    const bool timed = gpu_timer_.active();
+    if (timed) {
+      enc->write_timestamp(gpu_timer_.query_pool(), GPUPassTimer::begin_query(exec_i));
+    }
+    // All of the pass's transitions go to the encoder as one batch.
     for (auto& barrier : pass_barrier_infos_[pass_i]) {
       if (barrier.resource.type == RGResourceType::Buffer ||
           barrier.resource.type == RGResourceType::ExternalBuffer) {
         auto buf_handle = barrier.resource.type == RGResourceType::Buffer
                               ? get_buf(barrier.resource)
                               : get_external_buf(barrier.resource);
-        enc->barrier(buf_handle, barrier.src_state.stage, barrier.src_state.access,
-                     barrier.dst_state.stage, barrier.dst_state.access);
+        pass_barriers.emplace_back(rhi::GPUBarrier::buf_barrier(
+            buf_handle, barrier.src_state.stage, barrier.src_state.access,
+            barrier.dst_state.stage, barrier.dst_state.access));
       } else {
         auto tex_handle = barrier.resource.type == RGResourceType::Texture
                               ? get_att_img(barrier.resource)
@@ -127,24 +389,43 @@ void RenderGraph::execute(rhi::CmdEncoder* enc) {
             device_->enqueue_swapchain_for_present(pass.swapchain_write_, enc);
           }
         }
-        enc->barrier(tex_handle, barrier.src_state.stage, barrier.src_state.access,
-                     barrier.dst_state.stage, barrier.dst_state.access, barrier.src_state.layout,
-                     barrier.dst_state.layout, static_cast<int32_t>(barrier.subresource.base_mip),
-                     static_cast<int32_t>(barrier.subresource.base_slice),
-                     barrier.subresource.mip_count, barrier.subresource.slice_count);
+        pass_barriers.emplace_back(rhi::GPUBarrier::tex_barrier(
+            tex_handle, barrier.src_state.stage, barrier.src_state.access,
+            barrier.dst_state.stage, barrier.dst_state.access, barrier.src_state.layout,
+            barrier.dst_state.layout, barrier.subresource.base_mip, barrier.subresource.base_slice,
+            barrier.subresource.mip_count, barrier.subresource.slice_count));
       }
     }
+    ExecuteStats& stats = exec_barrier_stats_[exec_i];
+    if (!pass_barriers.empty()) {
+      enc->barrier(pass_barriers.data(), pass_barriers.size());
+      stats.barrier_calls++;
+      stats.barriers += static_cast<uint32_t>(pass_barriers.size());
+    }
 
     enc->set_debug_name(pass.get_name().c_str());
     {
       ZoneScopedN("Execute Fn");
       pass.get_execute_fn()(enc);
     }
-    for (auto& b : post_pass_barriers) {
-      enc->barrier(&b);
+    if (!post_pass_barriers.empty()) {
+      enc->barrier(post_pass_barriers.data(), post_pass_barriers.size());
+      stats.barrier_calls++;
+      stats.barriers += static_cast<uint32_t>(post_pass_barriers.size());
     }
+    if (timed) {
+      enc->write_timestamp(gpu_timer_.query_pool(), GPUPassTimer::end_query(exec_i));
+    }
+    exec_record_us_[exec_i] = std::chrono::duration<float, std::micro>(
+                                  std::chrono::steady_clock::now() - record_start)
+                                  .count();
+  }
+  if (seeding == LayoutSeeding::BeforeAndAfterPasses) {
+    seed_layouts_(enc, seeded_end, static_cast<uint32_t>(pass_stack_.size()));
   }
+}
 
+void RenderGraph::reset_after_execute_() {
   {
     passes_.clear();
     for (auto& b : pass_barrier_infos_) {
@@ -154,26 +435,46 @@ void RenderGraph::execute(rhi::CmdEncoder* enc) {
   }
 
   for (size_t i = 0; i < tex_att_infos_.size(); i++) {
-    const rhi::TextureUsage usage = device_->get_tex(tex_att_handles_[i])->desc().usage;
-    free_atts_[TexPoolKey{tex_att_infos_[i], usage}].emplace_back(tex_att_handles_[i]);
+    if (tex_att_alias_of_[i] != k_no_alias) {
+      continue;  // shares its handle with an earlier slot, which returns it
+    }
+    const rhi::TextureDesc& desc = device_->get_tex(tex_att_handles_[i])->desc();
+    const bool shared = has_flag(desc.flags, rhi::TextureDescFlags::SharedAcrossQueues);
+    free_atts_[TexPoolKey{tex_att_infos_[i], desc.usage, shared}].push_back(
+        PooledTexture{.handle = tex_att_handles_[i],
+                      .bytes = tex_att_bytes_[i],
+                      .last_used_bake = pool_bake_index_});
+    pool_stats_.pooled_bytes += tex_att_bytes_[i];
   }
   // Deferred-pool buffers from the prior execute: safe to merge into the free list now.
   for (auto& [key, bufs] : defer_pool_pending_return_) {
     for (auto& buf : bufs) {
-      const rhi::BufferUsage usage = device_->get_buf(buf)->desc().usage;
-      free_bufs_[BufPoolKey{key.info, usage}].emplace_back(buf);
+      const rhi::BufferDesc& desc = device_->get_buf(buf)->desc();
+      const bool shared = has_flag(desc.flags, rhi::BufferDescFlags::SharedAcrossQueues);
+      free_bufs_[BufPoolKey{key.info, desc.usage, shared}].push_back(PooledBuffer{
+          .handle = buf, .bytes = key.info.size, .last_used_bake = pool_bake_index_ - 1});
+      pool_stats_.pooled_bytes += key.info.size;
     }
   }
   defer_pool_pending_return_.clear();
 
   for (size_t i = 0; i < buffer_infos_.size(); i++) {
+    if (buffer_alias_of_[i] != k_no_alias) {
+      continue;
+    }
     if (defer_pool_handles_by_slot_[i].is_valid()) {
-      const rhi::BufferUsage usage = device_->get_buf(defer_pool_handles_by_slot_[i])->desc().usage;
-      defer_pool_pending_return_[BufPoolKey{buffer_infos_[i], usage}].emplace_back(
+      const rhi::BufferDesc& desc = device_->get_buf(defer_pool_handles_by_slot_[i])->desc();
+      const bool shared = has_flag(desc.flags, rhi::BufferDescFlags::SharedAcrossQueues);
+      defer_pool_pending_return_[BufPoolKey{buffer_infos_[i], desc.usage, shared}].emplace_back(
           defer_pool_handles_by_slot_[i]);
     } else {
-      const rhi::BufferUsage usage = device_->get_buf(buffer_handles_[i])->desc().usage;
-      free_bufs_[BufPoolKey{buffer_infos_[i], usage}].emplace_back(buffer_handles_[i]);
+      const rhi::BufferDesc& desc = device_->get_buf(buffer_handles_[i])->desc();
+      const bool shared = has_flag(desc.flags, rhi::BufferDescFlags::SharedAcrossQueues);
+      free_bufs_[BufPoolKey{buffer_infos_[i], desc.usage, shared}].push_back(
+          PooledBuffer{.handle = buffer_handles_[i],
+                       .bytes = buffer_infos_[i].size,
+                       .last_used_bake = pool_bake_index_});
+      pool_stats_.pooled_bytes += buffer_infos_[i].size;
     }
   }
   for_each_temporal_record_([&](auto& record) { advance_temporal_slot_after_execute_(record); });
@@ -182,7 +483,6 @@ void RenderGraph::execute(rhi::CmdEncoder* enc) {
   buffer_infos_.clear();
   resources_.clear();
   resource_use_id_to_writer_pass_idx_.clear();
-  external_read_ids_.clear();
   external_buffers_.clear();
   external_textures_.clear();
   external_tex_handle_to_id_.clear();
@@ -229,6 +529,7 @@ std::string RenderGraph::debug_name(RGResourceId id) const {
 void RenderGraph::init(rhi::Device* device) {
   device_ = device;
   passes_.reserve(200);
+  gpu_timer_.init(device);
 }
 
 RGResourceId RenderGraph::create_texture(const AttachmentInfo& att_info,
@@ -658,14 +959,25 @@ void RenderGraph::shutdown() {
     }
     resource_map.clear();
   };
-  destroy(free_bufs_);
-  destroy(free_atts_);
+  auto destroy_pooled = [this](auto& pool) {
+    for (auto& [key, entries] : pool) {
+      (void)key;
+      for (const auto& entry : entries) {
+        device_->destroy(entry.handle);
+      }
+    }
+    pool.clear();
+  };
+  destroy_pooled(free_bufs_);
+  destroy_pooled(free_atts_);
+  pool_stats_.pooled_bytes = 0;
   destroy(defer_pool_pending_return_);
   for_each_temporal_record_([&](auto& record) { destroy_temporal_record_(record); });
   temporal_buffers_.clear();
   temporal_textures_.clear();
   temporal_buffers_by_key_.clear();
   temporal_textures_by_key_.clear();
+  gpu_timer_.shutdown();
 }
 
 void RGPass::add_read_usage(RGResourceId id, rhi::PipelineStage stage, rhi::AccessFlags access,
@@ -676,7 +988,6 @@ void RGPass::add_read_usage(RGResourceId id, rhi::PipelineStage stage, rhi::Acce
           : subresource;
   if (id.type == RGResourceType::ExternalTexture || id.type == RGResourceType::ExternalBuffer) {
     rg_->mark_temporal_use_(id, false);
-    rg_->add_external_read_id(id);
     external_reads_.emplace_back(NameAndAccess{.id = id,
                                                .stage = stage,
                                                .acc = access,
@@ -784,7 +1095,7 @@ RenderGraph::ResourceRecord RenderGraph::create_temporal_resource_record(
 template <typename Record, typename Info, typename DestroyFn>
 uint32_t RenderGraph::get_temporal_resource_index_(
     NameId debug_name, const Info& info, RGResourceType resource_type,
-    std::unordered_map<TemporalResourceKey, uint32_t, TemporalResourceKeyHash>& by_key,
+    FlatHashMap<TemporalResourceKey, uint32_t, TemporalResourceKeyHash>& by_key,
     std::vector<Record>& records, DestroyFn&& destroy) {
   const TemporalResourceKey key{.debug_name = debug_name, .type = resource_type};
   if (auto it = by_key.find(key); it != by_key.end()) {
@@ -3,6 +3,7 @@
 #include <array>
 #include <cstdint>
 #include <functional>
+#include <memory_resource>
 #include <span>
 #include <string>
 #include <string_view>
@@ -13,7 +14,9 @@
 #include <vector>
 
 #include "core/Config.hpp"
+#include "core/FlatHashMap.hpp"
 #include "core/Hash.hpp"
+#include "gfx/GPUPassTimer.hpp"
 #include "gfx/rhi/CmdEncoder.hpp"
 #include "gfx/rhi/Device.hpp"
 
@@ -61,50 +64,66 @@ struct BufferInfo {
   }
 };
 
-// Custom hash functors defined in your own namespace
+// Hash functors for the render graph's flat maps: fields are packed into 64-bit words and mixed
+// with hash_combine64, so the results are already well distributed (is_avalanching).
 struct AttachmentInfoHash {
+  using is_avalanching = void;
   size_t operator()(const AttachmentInfo& att_info) const {
-    auto h = std::make_tuple(static_cast<uint32_t>(att_info.size_class), att_info.array_layers,
-                             att_info.mip_levels, att_info.dims.x, att_info.dims.y,
-                             static_cast<uint32_t>(att_info.format), att_info.is_swapchain_tex,
-                             att_info.temporal, static_cast<uint32_t>(att_info.temporal_slot_mode));
-    return util::hash::tuple_hash<decltype(h)>{}(h);
+    const uint64_t dims = att_info.dims.x | (static_cast<uint64_t>(att_info.dims.y) << 32);
+    const uint64_t levels =
+        att_info.mip_levels | (static_cast<uint64_t>(att_info.array_layers) << 32);
+    const uint64_t bits = static_cast<uint64_t>(att_info.format) |
+                          (static_cast<uint64_t>(att_info.size_class) << 32) |
+                          (static_cast<uint64_t>(att_info.is_swapchain_tex) << 40) |
+                          (static_cast<uint64_t>(att_info.temporal) << 41) |
+                          (static_cast<uint64_t>(att_info.temporal_slot_mode) << 48);
+    return util::hash::hash_combine64(util::hash::hash_combine64(dims, levels), bits);
   }
 };
 
 struct BufferInfoHash {
+  using is_avalanching = void;
   size_t operator()(const BufferInfo& buff_info) const {
-    auto h = std::make_tuple(buff_info.size, buff_info.defer_reuse, buff_info.temporal,
-                             static_cast<uint32_t>(buff_info.temporal_slot_mode));
-    return util::hash::tuple_hash<decltype(h)>{}(h);
+    const uint64_t bits = static_cast<uint64_t>(buff_info.defer_reuse) |
+                          (static_cast<uint64_t>(buff_info.temporal) << 1) |
+                          (static_cast<uint64_t>(buff_info.temporal_slot_mode) << 8);
+    return util::hash::hash_combine64(buff_info.size, bits);
   }
 };
 
 struct TexPoolKey {
   AttachmentInfo info;
   rhi::TextureUsage usage{rhi::TextureUsage::None};
-  bool operator==(const TexPoolKey& o) const { return info == o.info && usage == o.usage; }
+  bool shared_across_queues{};
+  bool operator==(const TexPoolKey& o) const {
+    return info == o.info && usage == o.usage && shared_across_queues == o.shared_across_queues;
+  }
 };
 
 struct TexPoolKeyHash {
+  using is_avalanching = void;
   size_t operator()(const TexPoolKey& k) const {
-    using U = std::underlying_type_t<rhi::TextureUsage>;
-    auto h = std::make_tuple(AttachmentInfoHash{}(k.info), static_cast<U>(k.usage));
-    return util::hash::tuple_hash<decltype(h)>{}(h);
+    return util::hash::hash_combine64(
+        AttachmentInfoHash{}(k.info),
+        static_cast<uint64_t>(k.usage) | (static_cast<uint64_t>(k.shared_across_queues) << 32));
   }
 };
 
 struct BufPoolKey {
   BufferInfo info;
   rhi::BufferUsage usage{rhi::BufferUsage::None};
-  bool operator==(const BufPoolKey& o) const { return info == o.info && usage == o.usage; }
+  bool shared_across_queues{};
+  bool operator==(const BufPoolKey& o) const {
+    return info == o.info && usage == o.usage && shared_across_queues == o.shared_across_queues;
+  }
 };
 
 struct BufPoolKeyHash {
+  using is_avalanching = void;
   size_t operator()(const BufPoolKey& k) const {
-    using U = std::underlying_type_t<rhi::BufferUsage>;
-    auto h = std::make_tuple(BufferInfoHash{}(k.info), static_cast<U>(k.usage));
-    return util::hash::tuple_hash<decltype(h)>{}(h);
+    return util::hash::hash_combine64(
+        BufferInfoHash{}(k.info),
+        static_cast<uint64_t>(k.usage) | (static_cast<uint64_t>(k.shared_across_queues) << 32));
   }
 };
 
@@ -115,6 +134,8 @@ namespace gfx {
 using ExecuteFn = std::function<void(rhi::CmdEncoder* enc)>;
 
 class RenderGraph;
+struct RGCapture;
+struct RGCaptureBindings;
 
 enum class RGResourceType {
   Texture = 0,
@@ -195,17 +216,17 @@ inline bool operator==(const RGResourceId& lhs, const RGResourceId& rhs) {
 }
 
 struct RGResourceIdHash {
+  using is_avalanching = void;
   size_t operator()(const RGResourceId& id) const noexcept {
-    auto h = std::make_tuple(id.idx, static_cast<uint32_t>(id.type), id.version);
-    return util::hash::tuple_hash<decltype(h)>{}(h);
+    return util::hash::hash_combine64(id.idx | (static_cast<uint64_t>(id.type) << 32), id.version);
   }
 };
 
 // For maps keyed by logical external import: same GPU handle for all RGResourceId versions.
 struct RGResourceIdStableHash {
+  using is_avalanching = void;
   size_t operator()(RGResourceId id) const noexcept {
-    auto h = std::make_tuple(id.idx, static_cast<uint32_t>(id.type));
-    return util::hash::tuple_hash<decltype(h)>{}(h);
+    return util::hash::hash_u64(id.idx | (static_cast<uint64_t>(id.type) << 32));
   }
 };
 
@@ -221,6 +242,7 @@ enum class RGPassType { None, Compute, Graphics, Transfer };
 // - auto pass ordering based on resource dependencies
 // - auto attachment image creation
 // - auto barrier placement
+// - bake caching: pass order and barrier plan are reused while the graph structure is unchanged
 // - external resource integration
 // - first-class temporal buffer / texture history
 //
@@ -229,16 +251,43 @@ enum class RGPassType { None, Compute, Graphics, Transfer };
 // - `BufferInfo::defer_reuse` delays returning the same handle to the free list until the next
 //   execute completes (see `defer_pool_*` members); it is not shader-visible "history".
 // - Attachment textures are returned to the pool at the end of each execute (no defer path yet).
+// - Idle pooled resources beyond `render_graph_pool_budget_mb` are destroyed least recently used
+//   first at the start of bake; anything the previous bake used is kept.
+// - Within a bake, transients with disjoint lifetimes (first..last use in `pass_stack_`) and the
+//   same pool key alias one physical resource; the later occupant starts from a discard
+//   (Undefined layout) barrier that waits on the earlier occupant's last accesses.
 // - Temporal resources persist across frames and stay out of the transient pools entirely.
 // - Temporal slot policy chooses either explicit current/history double-buffering or a single
 //   persistent slot reused across frames while preserving logical history/current views.
 //
+// Async compute:
+// - Compute / transfer passes may ask for `QueueType::Compute` (`Pass::set_queue`). When the
+//   device has AsyncCompute and `render_graph_async_compute` is on, each queue's passes are
+//   recorded into their own encoders ("queue segments"). A segment waits on another queue's segment
+//   whenever one of its passes touches a resource (alias root) last used there; the first compute
+//   segment waits on the encoder preceding the graph, and graphics joins all compute work before
+//   the frame ends so pooled / temporal resources never overlap across frames.
+// - Resources are only concurrently shared between queue families when they need to be. The graph
+//   creates transient / temporal resources touched on both queues with `SharedAcrossQueues`; a
+//   pass touching an imported resource created without it stays on Graphics. Resources a compute
+//   queue pass reaches outside the graph (bindless, constant buffers) must carry the flag too.
+//
 // The following are TODOs
-// - multiple queues
 // - auto buffers
 //
+// Parallel recording:
+// - `execute_parallel` splits `pass_stack_` into contiguous chunks balanced by each pass's recent
+//   CPU record time, records them into separate encoders on worker threads and submits them in
+//   order. Barriers are still emitted per pass from the baked plan; ExecuteFns must be thread-safe.
+//
+// Culling:
+// - Passes that write the swapchain or an external / temporal resource are sinks. Passes no sink
+//   transitively depends on are culled: they get no barriers and their ExecuteFns never run. The
+//   culled set is logged when it changes and exposed via `get_culled_pass_names`.
+// - Pooled buffer usage is derived from the accesses passes declare on them.
+//
 // Misc notes:
-// - not thread safe
+// - not thread safe (apart from ExecuteFns running during `execute_parallel`)
 // - must acquire swapchain image before baking, since barriers depend on having the correct handle
 //
 class RenderGraph {
@@ -252,11 +301,90 @@ class RenderGraph {
   void request_debug_dump_once() { debug_dump_once_requested_ = true; }
   void execute();
   void execute(rhi::CmdEncoder* enc);
+  // Records into up to `max_chunks` encoders begun after any already open this frame. Falls back
+  // to `execute()` when the device lacks ParallelCmdEncoding or the graph is too small to split.
+  void execute_parallel(uint32_t max_chunks);
   void shutdown();
 
   /// Debug/CI: validates texture barrier coalescing invariants (returns false on failure).
   [[nodiscard]] static bool run_barrier_coalesce_self_tests();
 
+  // Transient memory footprint of the most recent bake. "unaliased" is what one resource per
+  // transient would cost; "aliased" is what the distinct physical resources actually cost.
+  struct TransientMemoryStats {
+    size_t tex_bytes_unaliased{};
+    size_t tex_bytes_aliased{};
+    size_t buf_bytes_unaliased{};
+    size_t buf_bytes_aliased{};
+    // Max bytes simultaneously live at any pass: lower bound reachable with placed-resource heaps.
+    size_t peak_live_bytes{};
+    uint32_t tex_aliased_count{};
+    uint32_t buf_aliased_count{};
+    [[nodiscard]] size_t bytes_unaliased() const {
+      return tex_bytes_unaliased + buf_bytes_unaliased;
+    }
+    [[nodiscard]] size_t bytes_aliased() const { return tex_bytes_aliased + buf_bytes_aliased; }
+  };
+  [[nodiscard]] const TransientMemoryStats& get_transient_memory_stats() const {
+    return transient_mem_stats_;
+  }
+
+  // Transient pool reuse since init. `pooled_bytes` is what currently sits idle in the free lists;
+  // while it exceeds `render_graph_pool_budget_mb`, bake destroys the least recently used entries
+  // that the previous bake did not use.
+  struct PoolStats {
+    size_t pooled_bytes{};
+    uint64_t hits{};
+    uint64_t misses{};
+    uint64_t evictions{};
+    size_t evicted_bytes{};
+  };
+  [[nodiscard]] const PoolStats& get_pool_stats() const { return pool_stats_; }
+
+  // Bake cost and reuse of the cached pass order / barrier plan across frames.
+  struct BakeStats {
+    uint64_t bake_count{};
+    uint64_t topology_hits{};
+    uint64_t barrier_hits{};
+    // Passes dropped by the last bake because no sink depends on them.
+    uint32_t culled_passes{};
+    double last_bake_ms{};
+    double total_bake_ms{};
+    [[nodiscard]] double topology_hit_rate() const {
+      return bake_count ? static_cast<double>(topology_hits) / static_cast<double>(bake_count)
+                        : 0.0;
+    }
+    [[nodiscard]] double avg_bake_ms() const {
+      return bake_count ? total_bake_ms / static_cast<double>(bake_count) : 0.0;
+    }
+  };
+  [[nodiscard]] const BakeStats& get_bake_stats() const { return bake_stats_; }
+  // Names of the passes the last bake culled: their ExecuteFns are not run.
+  [[nodiscard]] const std::vector<std::string>& get_culled_pass_names() const {
+    return culled_pass_names_;
+  }
+
+  // Barrier submission of the most recent execute: one CmdEncoder::barrier call per pass that
+  // needs transitions, plus one for a final swapchain present transition.
+  struct ExecuteStats {
+    uint32_t barrier_calls{};
+    uint32_t barriers{};
+  };
+  [[nodiscard]] const ExecuteStats& get_execute_stats() const { return execute_stats_; }
+
+  // Rolling GPU time of the pass named `pass_name` (see GPUPassTimer). Passes are only timed while
+  // renderer.developer.render_graph_gpu_timing is set; results lag a few frames.
+  [[nodiscard]] GPUPassTimer::Stats get_pass_gpu_stats(std::string_view pass_name) const;
+  [[nodiscard]] const GPUPassTimer& get_gpu_pass_timer() const { return gpu_timer_; }
+  void on_imgui_gpu_timings() const;
+
+  // Snapshot of the passes and resources declared so far this frame (RenderGraph.Capture.hpp).
+  // Valid any time before execute; dump mode 1/3 also writes one next to each JSON dump.
+  [[nodiscard]] RGCapture capture(glm::uvec2 fb_size) const;
+  // Re-declares a captured frame on an empty graph, with no-op ExecuteFns. `bindings` supplies
+  // the external resources and swapchain (see create_capture_bindings).
+  void replay(const RGCapture& capture, const RGCaptureBindings& bindings);
+
   class Pass {
    public:
     Pass() = default;
@@ -319,31 +447,36 @@ class RenderGraph {
       RgSubresourceRange subresource{RgSubresourceRange::all_mips_all_slices()};
     };
 
-    [[nodiscard]] const std::vector<NameAndAccess>& get_external_reads() const {
-      return external_reads_;
-    }
-    [[nodiscard]] const std::vector<NameAndAccess>& get_external_writes() const {
+    // Allocated from the graph's frame memory (see RenderGraph::set_frame_memory).
+    using NameAndAccessList = std::pmr::vector<NameAndAccess>;
+
+    [[nodiscard]] const NameAndAccessList& get_external_reads() const { return external_reads_; }
+    [[nodiscard]] const NameAndAccessList& get_external_writes() const {
       return external_writes_;
     }
-    [[nodiscard]] const std::vector<NameAndAccess>& get_internal_reads() const {
-      return internal_reads_;
-    }
-    [[nodiscard]] const std::vector<NameAndAccess>& get_internal_writes() const {
+    [[nodiscard]] const NameAndAccessList& get_internal_reads() const { return internal_reads_; }
+    [[nodiscard]] const NameAndAccessList& get_internal_writes() const {
       return internal_writes_;
     }
 
     rhi::Swapchain* swapchain_write_{nullptr};
-    std::vector<NameAndAccess> external_reads_;
-    std::vector<NameAndAccess> external_writes_;
+    NameAndAccessList external_reads_;
+    NameAndAccessList external_writes_;
 
-    std::vector<NameAndAccess> internal_reads_;
-    std::vector<NameAndAccess> internal_writes_;
+    NameAndAccessList internal_reads_;
+    NameAndAccessList internal_writes_;
 
     [[nodiscard]] uint32_t get_idx() const { return pass_i_; }
     void set_ex(auto&& f) { execute_fn_ = f; }
     [[nodiscard]] const std::string& get_name() const { return rg_->debug_name(name_id_); }
+    [[nodiscard]] NameId get_name_id() const { return name_id_; }
     [[nodiscard]] const ExecuteFn& get_execute_fn() const { return execute_fn_; }
     [[nodiscard]] RGPassType type() const { return type_; }
+    // Preferred queue; only compute / transfer passes may leave Graphics. Runs on Graphics when
+    // async compute is unavailable or disabled, or when the pass touches an imported resource not
+    // created with SharedAcrossQueues.
+    Pass& set_queue(rhi::QueueType queue);
+    [[nodiscard]] rhi::QueueType queue() const { return queue_; }
 
    private:
     void add_read_usage(RGResourceId id, rhi::PipelineStage stage, rhi::AccessFlags access,
@@ -357,8 +490,13 @@ class RenderGraph {
     uint32_t pass_i_{};
     const NameId name_id_{kInvalidNameId};
     RGPassType type_{};
+    rhi::QueueType queue_{rhi::QueueType::Graphics};
   };
 
+  // Memory for per-pass access lists. Passes are cleared at the end of execute(), so a frame arena
+  // that is rewound no earlier than the next frame is enough. Defaults to the global heap.
+  void set_frame_memory(std::pmr::memory_resource* memory) { frame_memory_ = memory; }
+
   Pass& add_compute_pass(std::string_view name) { return add_pass(name, RGPassType::Compute); }
   Pass& add_transfer_pass(std::string_view name) { return add_pass(name, RGPassType::Transfer); }
   Pass& add_graphics_pass(std::string_view name) { return add_pass(name, RGPassType::Graphics); }
@@ -424,7 +562,6 @@ class RenderGraph {
   // begin usually called by Pass
   void register_write(RGResourceId id, Pass& pass);
   RGResourceId next_version(RGResourceId id);
-  void add_external_read_id(RGResourceId id) { external_read_ids_.insert(id); }
   // end usually called by Pass
 
   NameId intern_name(std::string_view name);
@@ -450,10 +587,16 @@ class RenderGraph {
                   uint32_t pass);
 
   void bake_reset_and_gc_pools_(glm::uvec2 fb_size);
+  void bake_evict_pools_lru_();
   void bake_find_sink_passes_(bool verbose);
+  void bake_collect_culled_passes_(bool verbose);
   void bake_compute_pass_order_(bool verbose);
   void bake_accumulate_physical_access_(std::vector<rhi::AccessFlags>& tex_physical_access,
                                         std::vector<rhi::AccessFlags>& buf_physical_access);
+  void bake_compute_transient_lifetimes_();
+  void bake_encode_structure_(std::vector<uint64_t>& out) const;
+  void bake_encode_barrier_inputs_(std::vector<uint64_t>& out);
+  void bake_restore_cached_barriers_();
   void bake_allocate_transient_resources_(glm::uvec2 fb_size,
                                           const std::vector<rhi::AccessFlags>& tex_physical_access,
                                           const std::vector<rhi::AccessFlags>& buf_physical_access);
@@ -462,6 +605,29 @@ class RenderGraph {
   void bake_validate_();
   void bake_write_debug_dump_if_requested_(glm::uvec2 fb_size);
 
+  void bake_assign_queues_(bool verbose);
+  void bake_schedule_queues_(bool verbose);
+
+  // How an encoder of a begin_parallel_cmd_encoders batch learns the texture layouts left by
+  // passes recorded into the batch's other encoders (CmdEncoder::set_assumed_layout).
+  enum class LayoutSeeding : uint8_t {
+    None,          // not in a batch
+    BeforePasses,  // before each pass, from the passes since the previous one
+    // Also after the last pass, from all later passes, so the batch ends with the frame's layouts.
+    BeforeAndAfterPasses,
+  };
+  // Records the passes in [exec_begin, exec_end) that run on `queue`.
+  void record_passes_(rhi::CmdEncoder* enc, uint32_t exec_begin, uint32_t exec_end,
+                      rhi::QueueType queue, LayoutSeeding seeding);
+  // Tells `enc` the layouts the baked barriers of passes [exec_begin, exec_end) leave textures in.
+  void seed_layouts_(rhi::CmdEncoder* enc, uint32_t exec_begin, uint32_t exec_end);
+  void record_queue_segments_(std::span<rhi::CmdEncoder* const> encoders, bool parallel);
+  void compute_record_chunks_(uint32_t max_chunks);
+  // Resets per-execute record state; call once per execute before recording any pass.
+  void begin_record_();
+  void update_record_stats_();
+  void reset_after_execute_();
+
   struct DebugDumpOnceRequestScope {
     RenderGraph* rg{};
     explicit DebugDumpOnceRequestScope(RenderGraph* r) : rg(r) {}
@@ -478,19 +644,48 @@ class RenderGraph {
   // the handle into `defer_pool_pending_return_` instead of `free_bufs_`.
   std::vector<rhi::BufferHandle> defer_pool_handles_by_slot_;
 
+  // Execution-order interval [first, last] over `pass_stack_` in which a transient is used.
+  struct TransientLifetime {
+    static constexpr uint32_t k_unused = UINT32_MAX;
+    uint32_t first{k_unused};
+    uint32_t last{};
+    [[nodiscard]] bool used() const { return first != k_unused; }
+  };
+  static constexpr uint32_t k_no_alias = UINT32_MAX;
+  std::vector<TransientLifetime> tex_att_lifetimes_;
+  std::vector<TransientLifetime> buffer_lifetimes_;
+  // Previous physical slot sharing the same handle this bake, or `k_no_alias` when the slot owns
+  // its handle. Only owners are returned to the pools in execute teardown.
+  std::vector<uint32_t> tex_att_alias_of_;
+  std::vector<uint32_t> buffer_alias_of_;
+  TransientMemoryStats transient_mem_stats_{};
+
+  std::pmr::memory_resource* frame_memory_{std::pmr::get_default_resource()};
   std::vector<Pass> passes_;
   std::vector<std::vector<BarrierInfo>> pass_barrier_infos_;
   std::vector<std::unordered_set<uint32_t>> pass_dependencies_;
-  std::unordered_map<RGResourceId, uint32_t, RGResourceIdHash> resource_use_id_to_writer_pass_idx_;
-  std::unordered_set<RGResourceId, RGResourceIdHash> external_read_ids_;
+  FlatHashMap<RGResourceId, uint32_t, RGResourceIdHash> resource_use_id_to_writer_pass_idx_;
   std::vector<rhi::TextureHandle> external_textures_;
   std::vector<rhi::BufferHandle> external_buffers_;
   std::vector<rhi::TextureHandle> curr_submitted_swapchain_textures_;
 
-  std::unordered_map<TexPoolKey, std::vector<rhi::TextureHandle>, TexPoolKeyHash> free_atts_;
-  std::unordered_map<BufPoolKey, std::vector<rhi::BufferHandle>, BufPoolKeyHash> free_bufs_;
+  // Free-list entry, stamped with the last bake (`pool_bake_index_`) that used the resource.
+  template <typename HandleT>
+  struct PooledResource {
+    HandleT handle;
+    size_t bytes{};
+    uint64_t last_used_bake{};
+  };
+  using PooledTexture = PooledResource<rhi::TextureHandle>;
+  using PooledBuffer = PooledResource<rhi::BufferHandle>;
+  FlatHashMap<TexPoolKey, std::vector<PooledTexture>, TexPoolKeyHash> free_atts_;
+  FlatHashMap<BufPoolKey, std::vector<PooledBuffer>, BufPoolKeyHash> free_bufs_;
+  uint64_t pool_bake_index_{};
+  PoolStats pool_stats_{};
+  // Estimated bytes of each transient attachment slot, for pool budgeting.
+  std::vector<size_t> tex_att_bytes_;
   // Buffers waiting one execute boundary before merging into `free_bufs_` (see `defer_reuse`).
-  std::unordered_map<BufPoolKey, std::vector<rhi::BufferHandle>, BufPoolKeyHash>
+  FlatHashMap<BufPoolKey, std::vector<rhi::BufferHandle>, BufPoolKeyHash>
       defer_pool_pending_return_;
 
   struct BufferInfoAndHandle {
@@ -500,19 +695,20 @@ class RenderGraph {
 
   std::vector<uint32_t> sink_passes_;
   std::vector<uint32_t> pass_stack_;
+  std::vector<std::string> culled_pass_names_;
 
   std::unordered_map<std::string, NameId, StringHash, std::equal_to<>> name_to_id_;
   std::vector<std::string> id_to_name_;
 
-  std::unordered_map<uint64_t, RGResourceId> external_tex_handle_to_id_;
-  std::unordered_map<uint64_t, RGResourceId> external_buf_handle_to_id_;
-  std::unordered_map<RGResourceId, rhi::TextureHandle, RGResourceIdStableHash, RGResourceIdStableEq>
+  FlatHashMap<uint64_t, RGResourceId> external_tex_handle_to_id_;
+  FlatHashMap<uint64_t, RGResourceId> external_buf_handle_to_id_;
+  FlatHashMap<RGResourceId, rhi::TextureHandle, RGResourceIdStableHash, RGResourceIdStableEq>
       rg_id_to_external_texture_;
-  std::unordered_map<RGResourceId, rhi::BufferHandle, RGResourceIdStableHash, RGResourceIdStableEq>
+  FlatHashMap<RGResourceId, rhi::BufferHandle, RGResourceIdStableHash, RGResourceIdStableEq>
       rg_id_to_external_buffer_;
-  std::unordered_map<uint64_t, RGState> external_initial_states_;
+  FlatHashMap<uint64_t, RGState> external_initial_states_;
   /// Optional per-mip initial `RGState` for external textures (key: physical handle `to64()`).
-  std::unordered_map<uint64_t, std::vector<RGState>> external_tex_mip_initial_states_;
+  FlatHashMap<uint64_t, std::vector<RGState>> external_tex_mip_initial_states_;
 
   static constexpr uint32_t k_invalid_temporal_idx = UINT32_MAX;
 
@@ -525,9 +721,10 @@ class RenderGraph {
   };
 
   struct TemporalResourceKeyHash {
+    using is_avalanching = void;
     size_t operator()(const TemporalResourceKey& key) const noexcept {
-      auto h = std::make_tuple(key.debug_name, static_cast<uint32_t>(key.type));
-      return util::hash::tuple_hash<decltype(h)>{}(h);
+      return util::hash::hash_u64(static_cast<uint64_t>(key.debug_name) |
+                                  (static_cast<uint64_t>(key.type) << 32));
     }
   };
 
@@ -582,7 +779,7 @@ class RenderGraph {
   template <typename Record, typename Info, typename DestroyFn>
   uint32_t get_temporal_resource_index_(
       NameId debug_name, const Info& info, RGResourceType resource_type,
-      std::unordered_map<TemporalResourceKey, uint32_t, TemporalResourceKeyHash>& by_key,
+      FlatHashMap<TemporalResourceKey, uint32_t, TemporalResourceKeyHash>& by_key,
       std::vector<Record>& records, DestroyFn&& destroy);
   uint32_t get_temporal_buffer_index_(NameId debug_name, const BufferInfo& info);
   uint32_t get_temporal_texture_index_(NameId debug_name, const AttachmentInfo& info);
@@ -655,12 +852,63 @@ class RenderGraph {
   std::vector<uint32_t> intermed_pass_stack_;
   rhi::Device* device_{};
   size_t external_texture_count_{};
-  std::unordered_map<TemporalResourceKey, uint32_t, TemporalResourceKeyHash>
-      temporal_textures_by_key_;
-  std::unordered_map<TemporalResourceKey, uint32_t, TemporalResourceKeyHash>
-      temporal_buffers_by_key_;
+  FlatHashMap<TemporalResourceKey, uint32_t, TemporalResourceKeyHash> temporal_textures_by_key_;
+  FlatHashMap<TemporalResourceKey, uint32_t, TemporalResourceKeyHash> temporal_buffers_by_key_;
   std::vector<TemporalTextureRecord> temporal_textures_;
   std::vector<TemporalBufferRecord> temporal_buffers_;
+
+  // Results of the topology-dependent bake steps, reused while `bake_encode_structure_()` matches
+  // the previous bake's `structure_key`. The barrier plan additionally requires
+  // `bake_encode_barrier_inputs_()` (initial states of external / temporal resources) to match
+  // `barrier_input_key`, since those feed the first barriers.
+  struct BakeCache {
+    bool valid{};
+    bool barriers_valid{};
+    std::vector<uint64_t> structure_key;
+    std::vector<uint64_t> barrier_input_key;
+    std::vector<rhi::AccessFlags> tex_physical_access;
+    std::vector<rhi::AccessFlags> buf_physical_access;
+    std::vector<std::vector<BarrierInfo>> pass_barrier_infos;
+    // Final temporal slot states written back by barrier scheduling, keyed by `resources_` index.
+    std::vector<std::pair<uint32_t, RGState>> temporal_buf_final_states;
+    std::vector<std::pair<uint32_t, TemporalTextureState>> temporal_tex_final_states;
+  };
+  BakeCache bake_cache_;
+  // Reused by the key encoders so steady-state bakes don't allocate.
+  std::vector<uint64_t> bake_key_scratch_;
+  std::vector<uint64_t> bake_encode_keys_scratch_;
+  BakeStats bake_stats_;
+
+  // Fewer passes than this per chunk isn't worth another encoder + thread hop.
+  static constexpr uint32_t k_min_passes_per_record_chunk = 4;
+  // Per-pass CPU record time (us) of the current execute, indexed by `pass_stack_` position. Each
+  // recording thread writes only its own chunk's range.
+  std::vector<float> exec_record_us_;
+  // Per-pass barrier counts of the current execute, indexed and written like `exec_record_us_`.
+  std::vector<ExecuteStats> exec_barrier_stats_;
+  ExecuteStats execute_stats_;
+  GPUPassTimer gpu_timer_;
+  // EMA of record time per pass name (indexed by NameId, 0 = never measured). Drives chunk splits.
+  std::vector<float> pass_record_cost_us_;
+  // Exclusive end (into `pass_stack_`) of each record chunk for the current execute_parallel.
+  std::vector<uint32_t> record_chunk_ends_;
+
+  // Queue each `pass_stack_` entry runs on this bake.
+  std::vector<rhi::QueueType> exec_queues_;
+  // Transients / temporals touched on more than one queue this bake; created SharedAcrossQueues.
+  std::vector<bool> tex_att_shared_;
+  std::vector<bool> buffer_shared_;
+  std::vector<bool> temporal_tex_shared_;
+  std::vector<bool> temporal_buf_shared_;
+  // One encoder's worth of passes: those in [exec_begin, exec_end) on `queue`. Segment 0 is the
+  // pass-less prologue (the encoder preceding the graph). Empty when everything runs on Graphics.
+  struct QueueSegment {
+    rhi::QueueType queue{};
+    uint32_t exec_begin{};
+    uint32_t exec_end{};
+    std::vector<uint32_t> waits;  // segment indices on other queues that must complete first
+  };
+  std::vector<QueueSegment> queue_segments_;
 };
 
 template <typename RecordT>
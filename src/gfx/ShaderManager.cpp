@@ -5,13 +5,13 @@
 #include <filesystem>
 #include <fstream>
 #include <span>
-#include <tracy/Tracy.hpp>
 #include <vector>
 
 #include "core/Config.hpp"
 #include "core/EAssert.hpp"
 #include "core/Hash.hpp"
 #include "core/Logger.hpp"
+#include "core/Profiler.hpp"
 #include "gfx/rhi/Device.hpp"
 #include "shader_compiler/ShaderCompiler.hpp"
 
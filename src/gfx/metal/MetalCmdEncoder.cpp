@@ -5,7 +5,6 @@
 // clang-format off
 #include <Metal/MTLComputeCommandEncoder.hpp>
 #include <Metal/Metal.hpp>
-#include <tracy/Tracy.hpp>
 #include "core/Hash.hpp"
 #define IR_RUNTIME_METALCPP
 #include <metal_irconverter_runtime/metal_irconverter_runtime_wrapper.h>
@@ -15,6 +14,7 @@
 
 #include "core/Config.hpp"
 #include "core/EAssert.hpp"
+#include "core/Profiler.hpp"
 #include "gfx/metal/MetalDevice.hpp"
 #include "gfx/metal/MetalUtil.hpp"
 #include "gfx/rhi/GFXTypes.hpp"
@@ -624,12 +624,19 @@ template <bool UseMTL4>
 void CmdEncoderBase<UseMTL4>::barrier(rhi::GPUBarrier* gpu_barriers, size_t barrier_count) {
   for (size_t i = 0; i < barrier_count; i++) {
     auto& gpu_barrier = gpu_barriers[i];
-    auto src_mtl_stage = mtl::util::convert_stages(gpu_barrier.type == rhi::GPUBarrier::Type::Buffer
-                                                       ? gpu_barrier.buf.src_state
-                                                       : gpu_barrier.tex.src_layout);
-    auto dst_mtl_stage = mtl::util::convert_stages(gpu_barrier.type == rhi::GPUBarrier::Type::Buffer
-                                                       ? gpu_barrier.buf.dst_state
-                                                       : gpu_barrier.tex.dst_layout);
+    MTL::Stages src_mtl_stage;
+    MTL::Stages dst_mtl_stage;
+    if (gpu_barrier.has_sync) {
+      src_mtl_stage = mtl::util::convert_stage(gpu_barrier.sync.src_stage);
+      dst_mtl_stage = mtl::util::convert_stage(gpu_barrier.sync.dst_stage);
+    } else {
+      src_mtl_stage = mtl::util::convert_stages(gpu_barrier.type == rhi::GPUBarrier::Type::Buffer
+                                                    ? gpu_barrier.buf.src_state
+                                                    : gpu_barrier.tex.src_layout);
+      dst_mtl_stage = mtl::util::convert_stages(gpu_barrier.type == rhi::GPUBarrier::Type::Buffer
+                                                    ? gpu_barrier.buf.dst_state
+                                                    : gpu_barrier.tex.dst_layout);
+    }
     if (dst_mtl_stage & (MTL::StageDispatch | MTL::StageBlit)) {
       device_->compute_enc_flush_stages_ |= src_mtl_stage;
       device_->compute_enc_dst_stages_ |= dst_mtl_stage;
@@ -15,7 +15,6 @@
 #include <Metal/Metal.hpp>
 #include <QuartzCore/CAMetalLayer.hpp>
 #include <fstream>
-#include <tracy/Tracy.hpp>
 
 #include "Window.hpp"
 #include "core/Util.hpp"
@@ -29,6 +28,7 @@
 #include "MetalUtil.hpp"
 #include "core/Config.hpp"
 #include "core/EAssert.hpp"
+#include "core/Profiler.hpp"
 #include "gfx/metal/MetalCmdEncoder.hpp"
 #include "gfx/metal/MetalPipeline.hpp"
 #include "gfx/metal/MetalUtil.hpp"
@@ -152,12 +152,12 @@ class Device : public rhi::Device {
       const rhi::ShaderCreateInfo& shader_info);
 
   size_t curr_cmd_list_idx_{};
-  BlockPool<rhi::BufferHandle, Buffer> buffer_pool_{128, 1, true};
-  BlockPool<rhi::TextureHandle, Texture> texture_pool_{128, 1, true};
-  BlockPool<rhi::PipelineHandle, Pipeline> pipeline_pool_{20, 1, true};
-  BlockPool<rhi::SamplerHandle, Sampler> sampler_pool_{16, 1, true};
-  BlockPool<rhi::QueryPoolHandle, QueryPool> querypool_pool_{16, 1, true};
-  BlockPool<rhi::SwapchainHandle, Swapchain> swapchain_pool_{16, 1, true};
+  AtomicBlockPool<rhi::BufferHandle, Buffer> buffer_pool_{128, 1, true};
+  AtomicBlockPool<rhi::TextureHandle, Texture> texture_pool_{128, 1, true};
+  AtomicBlockPool<rhi::PipelineHandle, Pipeline> pipeline_pool_{20, 1, true};
+  AtomicBlockPool<rhi::SamplerHandle, Sampler> sampler_pool_{16, 1, true};
+  AtomicBlockPool<rhi::QueryPoolHandle, QueryPool> querypool_pool_{16, 1, true};
+  AtomicBlockPool<rhi::SwapchainHandle, Swapchain> swapchain_pool_{16, 1, true};
 
   Info info_{};
   std::filesystem::path metal_shader_dir_;
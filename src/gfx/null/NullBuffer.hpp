@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "core/Config.hpp"
+#include "gfx/rhi/Buffer.hpp"
+
+namespace TENG_NAMESPACE {
+
+namespace gfx::null {
+
+// Only CPU-visible buffers get host backing memory; everything else is a descriptor with a size.
+class NullBuffer final : public rhi::Buffer {
+ public:
+  NullBuffer(const rhi::BufferDesc& desc, uint32_t bindless_idx, bool cpu_visible)
+      : rhi::Buffer(desc, bindless_idx), cpu_visible_(cpu_visible) {
+    if (cpu_visible_) {
+      memory_.resize(desc.size);
+    }
+  }
+  NullBuffer() = default;
+  ~NullBuffer() = default;
+
+  void* contents() override { return memory_.empty() ? nullptr : memory_.data(); }
+  [[nodiscard]] const void* contents() const override {
+    return memory_.empty() ? nullptr : memory_.data();
+  }
+  [[nodiscard]] bool is_cpu_visible() const override { return cpu_visible_; }
+  [[nodiscard]] uint32_t raw_bindless_idx() const { return bindless_idx_; }
+
+  std::vector<std::byte> memory_;
+  bool cpu_visible_{};
+};
+
+}  // namespace gfx::null
+
+}  // namespace TENG_NAMESPACE
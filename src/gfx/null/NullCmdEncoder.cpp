@@ -0,0 +1,348 @@
+#include "NullCmdEncoder.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "core/EAssert.hpp"
+#include "gfx/null/NullDevice.hpp"
+
+namespace TENG_NAMESPACE {
+
+namespace gfx::null {
+
+const char* to_string(NullCmdType type) {
+  switch (type) {
+    case NullCmdType::BeginRendering:
+      return "BeginRendering";
+    case NullCmdType::EndRendering:
+      return "EndRendering";
+    case NullCmdType::BindPipeline:
+      return "BindPipeline";
+    case NullCmdType::SetState:
+      return "SetState";
+    case NullCmdType::PushConstants:
+      return "PushConstants";
+    case NullCmdType::Draw:
+      return "Draw";
+    case NullCmdType::DrawIndexed:
+      return "DrawIndexed";
+    case NullCmdType::DrawIndexedIndirect:
+      return "DrawIndexedIndirect";
+    case NullCmdType::DrawMeshThreadgroups:
+      return "DrawMeshThreadgroups";
+    case NullCmdType::DrawMeshThreadgroupsIndirect:
+      return "DrawMeshThreadgroupsIndirect";
+    case NullCmdType::DispatchCompute:
+      return "DispatchCompute";
+    case NullCmdType::Copy:
+      return "Copy";
+    case NullCmdType::FillBuffer:
+      return "FillBuffer";
+    case NullCmdType::Barrier:
+      return "Barrier";
+    case NullCmdType::Bind:
+      return "Bind";
+    case NullCmdType::DebugGroup:
+      return "DebugGroup";
+    case NullCmdType::Timestamp:
+      return "Timestamp";
+    case NullCmdType::QueryResolve:
+      return "QueryResolve";
+    default:
+      return "Unknown";
+  }
+}
+
+void NullCmdEncoder::reset(rhi::QueueType queue_type) {
+  cmds_.clear();
+  push_constant_data_.clear();
+  cmd_counts_ = {};
+  indexed_indirect_draw_id_ = 0;
+  queue_type_ = queue_type;
+  debug_group_depth_ = 0;
+  in_render_pass_ = false;
+  pipeline_bound_ = false;
+  encoding_ = true;
+}
+
+void NullCmdEncoder::check_buf(rhi::BufferHandle handle) const {
+  ALWAYS_ASSERT(device_->get_null_buf(handle));
+}
+
+void NullCmdEncoder::check_tex(rhi::TextureHandle handle) const {
+  ALWAYS_ASSERT(device_->get_null_tex(handle));
+}
+
+void NullCmdEncoder::begin_rendering(std::initializer_list<rhi::RenderAttInfo> attachments) {
+  ASSERT(encoding_);
+  ASSERT(!in_render_pass_);
+  for (const auto& att : attachments) {
+    check_tex(att.image);
+  }
+  in_render_pass_ = true;
+  record(NullCmdType::BeginRendering, static_cast<uint32_t>(attachments.size()));
+}
+
+void NullCmdEncoder::end_rendering() {
+  ASSERT(in_render_pass_);
+  in_render_pass_ = false;
+  record(NullCmdType::EndRendering);
+}
+
+void NullCmdEncoder::bind_pipeline(rhi::PipelineHandle handle) {
+  ALWAYS_ASSERT(device_->get_pipeline(handle));
+  pipeline_bound_ = true;
+  record(NullCmdType::BindPipeline, handle.get_idx());
+}
+
+void NullCmdEncoder::draw_primitives(rhi::PrimitiveTopology /*topology*/, size_t /*vertex_start*/,
+                                     size_t count, size_t /*instance_count*/) {
+  ASSERT(in_render_pass_ && pipeline_bound_);
+  record(NullCmdType::Draw, static_cast<uint32_t>(count));
+}
+
+void NullCmdEncoder::draw_indexed_primitives(rhi::PrimitiveTopology /*topology*/,
+                                             rhi::BufferHandle index_buf, size_t /*index_start*/,
+                                             size_t count, size_t /*instance_count*/,
+                                             size_t /*base_vertex*/, size_t /*base_instance*/,
+                                             rhi::IndexType /*index_type*/) {
+  ASSERT(in_render_pass_ && pipeline_bound_);
+  check_buf(index_buf);
+  record(NullCmdType::DrawIndexed, static_cast<uint32_t>(count));
+}
+
+void NullCmdEncoder::set_depth_stencil_state(rhi::CompareOp /*depth_compare_op*/,
+                                             bool /*depth_write_enabled*/) {
+  record(NullCmdType::SetState);
+}
+
+void NullCmdEncoder::set_wind_order(rhi::WindOrder /*wind_order*/) {
+  record(NullCmdType::SetState);
+}
+
+void NullCmdEncoder::set_cull_mode(rhi::CullMode /*cull_mode*/) { record(NullCmdType::SetState); }
+
+void NullCmdEncoder::push_constants(void* data, size_t size) {
+  ASSERT(data || size == 0);
+  const auto* bytes = static_cast<const uint8_t*>(data);
+  push_constant_data_.insert(push_constant_data_.end(), bytes, bytes + size);
+  record(NullCmdType::PushConstants, static_cast<uint32_t>(size));
+}
+
+void NullCmdEncoder::end_encoding() {
+  ASSERT(encoding_);
+  ASSERT(!in_render_pass_);
+  ASSERT(debug_group_depth_ == 0);
+  encoding_ = false;
+}
+
+void NullCmdEncoder::set_viewport(glm::ivec2 /*min*/, glm::ivec2 /*extent*/) {
+  record(NullCmdType::SetState);
+}
+
+void NullCmdEncoder::set_scissor(glm::uvec2 /*min*/, glm::uvec2 /*extent*/) {
+  record(NullCmdType::SetState);
+}
+
+void NullCmdEncoder::upload_texture_data(rhi::BufferHandle src_buf, size_t /*src_offset*/,
+                                         size_t /*src_bytes_per_row*/, rhi::TextureHandle dst_tex) {
+  check_buf(src_buf);
+  check_tex(dst_tex);
+  record(NullCmdType::Copy);
+}
+
+void NullCmdEncoder::upload_texture_data(rhi::BufferHandle src_buf, size_t /*src_offset*/,
+                                         size_t /*src_bytes_per_row*/, rhi::TextureHandle dst_tex,
+                                         glm::uvec3 /*src_size*/, glm::uvec3 /*dst_origin*/,
+                                         int mip_level) {
+  check_buf(src_buf);
+  check_tex(dst_tex);
+  ASSERT(mip_level >= 0 &&
+         static_cast<uint32_t>(mip_level) < device_->get_null_tex(dst_tex)->desc().mip_levels);
+  record(NullCmdType::Copy);
+}
+
+void NullCmdEncoder::copy_tex_to_buf(rhi::TextureHandle src_tex, size_t /*src_slice*/,
+                                     size_t /*src_level*/, rhi::BufferHandle dst_buf,
+                                     size_t /*dst_offset*/) {
+  check_tex(src_tex);
+  check_buf(dst_buf);
+  record(NullCmdType::Copy);
+}
+
+void NullCmdEncoder::copy_buffer_to_buffer(rhi::BufferHandle src_buf, size_t src_offset,
+                                           rhi::BufferHandle dst_buf, size_t dst_offset,
+                                           size_t size) {
+  auto* src = device_->get_null_buf(src_buf);
+  auto* dst = device_->get_null_buf(dst_buf);
+  ALWAYS_ASSERT(src && dst);
+  ASSERT(src_offset + size <= src->size());
+  ASSERT(dst_offset + size <= dst->size());
+  record(NullCmdType::Copy, static_cast<uint32_t>(size));
+}
+
+uint32_t NullCmdEncoder::prepare_indexed_indirect_draws(
+    rhi::BufferHandle indirect_buf, size_t /*offset*/, size_t /*tot_draw_cnt*/,
+    rhi::BufferHandle index_buf, size_t /*index_buf_offset*/, void* push_constant_data,
+    size_t push_constant_size, size_t /*vertex_stride*/) {
+  check_buf(indirect_buf);
+  check_buf(index_buf);
+  const auto* bytes = static_cast<const uint8_t*>(push_constant_data);
+  push_constant_data_.insert(push_constant_data_.end(), bytes, bytes + push_constant_size);
+  return indexed_indirect_draw_id_++;
+}
+
+void NullCmdEncoder::barrier(rhi::PipelineStage /*src_stage*/, rhi::AccessFlags /*src_access*/,
+                             rhi::PipelineStage /*dst_stage*/, rhi::AccessFlags /*dst_access*/) {
+  record(NullCmdType::Barrier, 1);
+}
+
+void NullCmdEncoder::barrier(rhi::BufferHandle buf, rhi::PipelineStage /*src_stage*/,
+                             rhi::AccessFlags /*src_access*/, rhi::PipelineStage /*dst_stage*/,
+                             rhi::AccessFlags /*dst_access*/) {
+  check_buf(buf);
+  record(NullCmdType::Barrier, 1);
+}
+
+void NullCmdEncoder::barrier(rhi::TextureHandle tex, rhi::PipelineStage /*src_stage*/,
+                             rhi::AccessFlags /*src_access*/, rhi::PipelineStage /*dst_stage*/,
+                             rhi::AccessFlags /*dst_access*/, rhi::ResourceLayout /*src_layout*/,
+                             rhi::ResourceLayout /*dst_layout*/, int32_t /*base_mip_level*/,
+                             int32_t /*base_array_layer*/, uint32_t /*mip_level_count*/,
+                             uint32_t /*array_layer_count*/) {
+  check_tex(tex);
+  record(NullCmdType::Barrier, 1);
+}
+
+void NullCmdEncoder::barrier(rhi::BufferHandle buf, rhi::PipelineStage /*src_stage*/,
+                             rhi::AccessFlags /*src_access*/, rhi::PipelineStage /*dst_stage*/,
+                             rhi::AccessFlags /*dst_access*/, size_t offset, size_t /*size*/) {
+  auto* b = device_->get_null_buf(buf);
+  ALWAYS_ASSERT(b);
+  ASSERT(offset <= b->size());
+  record(NullCmdType::Barrier, 1);
+}
+
+void NullCmdEncoder::barrier(rhi::GPUBarrier* gpu_barrier, size_t barrier_count) {
+  for (size_t i = 0; i < barrier_count; i++) {
+    const auto& b = gpu_barrier[i];
+    if (b.type == rhi::GPUBarrier::Type::Buffer) {
+      check_buf(b.buf.buffer);
+    } else {
+      check_tex(b.tex.texture);
+    }
+  }
+  record(NullCmdType::Barrier, static_cast<uint32_t>(barrier_count));
+}
+
+void NullCmdEncoder::draw_indexed_indirect(rhi::BufferHandle indirect_buf,
+                                           uint32_t indirect_buf_id, size_t draw_cnt,
+                                           size_t /*offset_i*/) {
+  ASSERT(in_render_pass_ && pipeline_bound_);
+  check_buf(indirect_buf);
+  ASSERT(indirect_buf_id < indexed_indirect_draw_id_);
+  record(NullCmdType::DrawIndexedIndirect, static_cast<uint32_t>(draw_cnt));
+}
+
+void NullCmdEncoder::draw_mesh_threadgroups(glm::uvec3 thread_groups,
+                                            glm::uvec3 /*threads_per_task_thread_group*/,
+                                            glm::uvec3 /*threads_per_mesh_thread_group*/) {
+  ASSERT(in_render_pass_ && pipeline_bound_);
+  record(NullCmdType::DrawMeshThreadgroups, thread_groups.x * thread_groups.y * thread_groups.z);
+}
+
+void NullCmdEncoder::draw_mesh_threadgroups_indirect(
+    rhi::BufferHandle indirect_buf, size_t /*indirect_buf_offset*/,
+    glm::uvec3 /*threads_per_task_thread_group*/, glm::uvec3 /*threads_per_mesh_thread_group*/) {
+  ASSERT(in_render_pass_ && pipeline_bound_);
+  check_buf(indirect_buf);
+  record(NullCmdType::DrawMeshThreadgroupsIndirect);
+}
+
+void NullCmdEncoder::dispatch_compute(glm::uvec3 thread_groups,
+                                      glm::uvec3 /*threads_per_threadgroup*/) {
+  ASSERT(!in_render_pass_ && pipeline_bound_);
+  record(NullCmdType::DispatchCompute, thread_groups.x * thread_groups.y * thread_groups.z);
+}
+
+void NullCmdEncoder::fill_buffer(rhi::BufferHandle handle, uint32_t offset_bytes, uint32_t size,
+                                 uint32_t value) {
+  auto* buf = device_->get_null_buf(handle);
+  ALWAYS_ASSERT(buf);
+  ASSERT(offset_bytes + size <= buf->size());
+  // Host-backed buffers get the fill so CPU readback of e.g. cleared counters stays sane.
+  if (auto* dst = static_cast<uint32_t*>(buf->contents())) {
+    std::fill_n(dst + offset_bytes / sizeof(uint32_t), size / sizeof(uint32_t), value);
+  }
+  record(NullCmdType::FillBuffer, size);
+}
+
+void NullCmdEncoder::push_debug_group(const char* /*name*/) {
+  debug_group_depth_++;
+  record(NullCmdType::DebugGroup);
+}
+
+void NullCmdEncoder::pop_debug_group() {
+  ASSERT(debug_group_depth_ > 0);
+  debug_group_depth_--;
+  record(NullCmdType::DebugGroup);
+}
+
+void NullCmdEncoder::bind_srv(rhi::TextureHandle texture, uint32_t slot, int /*subresource_id*/) {
+  check_tex(texture);
+  record(NullCmdType::Bind, slot);
+}
+
+void NullCmdEncoder::bind_srv(rhi::BufferHandle buffer, uint32_t slot, size_t /*offset_bytes*/) {
+  check_buf(buffer);
+  record(NullCmdType::Bind, slot);
+}
+
+void NullCmdEncoder::bind_uav(rhi::TextureHandle texture, uint32_t slot, int /*subresource_id*/) {
+  check_tex(texture);
+  record(NullCmdType::Bind, slot);
+}
+
+void NullCmdEncoder::bind_uav(rhi::BufferHandle buffer, uint32_t slot, size_t /*offset_bytes*/) {
+  check_buf(buffer);
+  record(NullCmdType::Bind, slot);
+}
+
+void NullCmdEncoder::bind_cbv(rhi::BufferHandle buffer, uint32_t slot, size_t offset_bytes,
+                              size_t size_bytes) {
+  auto* buf = device_->get_null_buf(buffer);
+  ALWAYS_ASSERT(buf);
+  ASSERT(offset_bytes + size_bytes <= buf->size());
+  record(NullCmdType::Bind, slot);
+}
+
+void NullCmdEncoder::write_timestamp(rhi::QueryPoolHandle query_pool, uint32_t query_index) {
+  auto* pool = device_->get_query_pool(query_pool);
+  ALWAYS_ASSERT(pool);
+  ALWAYS_ASSERT(query_index < pool->timestamps_.size());
+  pool->timestamps_[query_index] = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+  record(NullCmdType::Timestamp, query_index);
+}
+
+void NullCmdEncoder::query_resolve(rhi::QueryPoolHandle query_pool, uint32_t start_query,
+                                   uint32_t query_count, rhi::BufferHandle dst_buffer,
+                                   size_t dst_offset) {
+  auto* pool = device_->get_query_pool(query_pool);
+  auto* dst = device_->get_null_buf(dst_buffer);
+  ALWAYS_ASSERT(pool && dst);
+  ALWAYS_ASSERT(start_query + query_count <= pool->timestamps_.size());
+  ASSERT(dst_offset + query_count * sizeof(uint64_t) <= dst->size());
+  if (auto* contents = static_cast<uint8_t*>(dst->contents())) {
+    std::memcpy(contents + dst_offset, pool->timestamps_.data() + start_query,
+                query_count * sizeof(uint64_t));
+  }
+  record(NullCmdType::QueryResolve, query_count);
+}
+
+}  // namespace gfx::null
+
+}  // namespace TENG_NAMESPACE
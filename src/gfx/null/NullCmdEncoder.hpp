@@ -0,0 +1,166 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "core/Config.hpp"
+#include "gfx/rhi/CmdEncoder.hpp"
+#include "gfx/rhi/Queue.hpp"
+
+namespace TENG_NAMESPACE {
+
+namespace gfx::null {
+
+class NullDevice;
+
+enum class NullCmdType : uint8_t {
+  BeginRendering,
+  EndRendering,
+  BindPipeline,
+  SetState,
+  PushConstants,
+  Draw,
+  DrawIndexed,
+  DrawIndexedIndirect,
+  DrawMeshThreadgroups,
+  DrawMeshThreadgroupsIndirect,
+  DispatchCompute,
+  Copy,
+  FillBuffer,
+  Barrier,
+  Bind,
+  DebugGroup,
+  Timestamp,
+  QueryResolve,
+  Count,
+};
+
+const char* to_string(NullCmdType type);
+
+// One recorded command. `arg` is command specific: barrier count, push constant bytes, draw count,
+// attachment count or the bound resource's handle index.
+struct NullCmd {
+  NullCmdType type;
+  uint32_t arg;
+};
+
+using NullCmdCounts = std::array<uint64_t, static_cast<size_t>(NullCmdType::Count)>;
+
+// Records commands into memory; nothing is executed. Resource handles are validated against the
+// owning device so that use-after-destroy still trips asserts without a GPU.
+class NullCmdEncoder : public rhi::CmdEncoder {
+ public:
+  explicit NullCmdEncoder(NullDevice* device) : device_(device) {}
+
+  void set_debug_name(const char* /*name*/) override {}
+  void begin_rendering(std::initializer_list<rhi::RenderAttInfo> attachments) override;
+  void end_rendering() override;
+
+  using rhi::CmdEncoder::bind_pipeline;
+  void bind_pipeline(rhi::PipelineHandle handle) override;
+
+  using rhi::CmdEncoder::draw_indexed_primitives;
+  using rhi::CmdEncoder::draw_primitives;
+  void draw_primitives(rhi::PrimitiveTopology topology, size_t vertex_start, size_t count,
+                       size_t instance_count) override;
+  void draw_indexed_primitives(rhi::PrimitiveTopology topology, rhi::BufferHandle index_buf,
+                               size_t index_start, size_t count, size_t instance_count,
+                               size_t base_vertex, size_t base_instance,
+                               rhi::IndexType index_type) override;
+  void set_depth_stencil_state(rhi::CompareOp depth_compare_op, bool depth_write_enabled) override;
+  void set_wind_order(rhi::WindOrder wind_order) override;
+  void set_cull_mode(rhi::CullMode cull_mode) override;
+
+  void push_constants(void* data, size_t size) override;
+  void end_encoding() override;
+  void set_label(const std::string& /*label*/) override {}
+  void set_viewport(glm::ivec2 min, glm::ivec2 extent) override;
+  void set_scissor(glm::uvec2 min, glm::uvec2 extent) override;
+
+  void upload_texture_data(rhi::BufferHandle src_buf, size_t src_offset, size_t src_bytes_per_row,
+                           rhi::TextureHandle dst_tex) override;
+  void upload_texture_data(rhi::BufferHandle src_buf, size_t src_offset, size_t src_bytes_per_row,
+                           rhi::TextureHandle dst_tex, glm::uvec3 src_size, glm::uvec3 dst_origin,
+                           int mip_level) override;
+  void copy_tex_to_buf(rhi::TextureHandle src_tex, size_t src_slice, size_t src_level,
+                       rhi::BufferHandle dst_buf, size_t dst_offset) override;
+  void copy_buffer_to_buffer(rhi::BufferHandle src_buf, size_t src_offset,
+                             rhi::BufferHandle dst_buf, size_t dst_offset, size_t size) override;
+
+  [[nodiscard]] uint32_t prepare_indexed_indirect_draws(
+      rhi::BufferHandle indirect_buf, size_t offset, size_t tot_draw_cnt,
+      rhi::BufferHandle index_buf, size_t index_buf_offset, void* push_constant_data,
+      size_t push_constant_size, size_t vertex_stride) override;
+
+  using rhi::CmdEncoder::barrier;
+  void barrier(rhi::PipelineStage src_stage, rhi::AccessFlags src_access,
+               rhi::PipelineStage dst_stage, rhi::AccessFlags dst_access) override;
+  void barrier(rhi::BufferHandle buf, rhi::PipelineStage src_stage, rhi::AccessFlags src_access,
+               rhi::PipelineStage dst_stage, rhi::AccessFlags dst_access) override;
+  void barrier(rhi::TextureHandle tex, rhi::PipelineStage src_stage, rhi::AccessFlags src_access,
+               rhi::PipelineStage dst_stage, rhi::AccessFlags dst_access,
+               rhi::ResourceLayout src_layout, rhi::ResourceLayout dst_layout,
+               int32_t base_mip_level, int32_t base_array_layer, uint32_t mip_level_count,
+               uint32_t array_layer_count) override;
+  void barrier(rhi::BufferHandle buf, rhi::PipelineStage src_stage, rhi::AccessFlags src_access,
+               rhi::PipelineStage dst_stage, rhi::AccessFlags dst_access, size_t offset,
+               size_t size) override;
+  void barrier(rhi::GPUBarrier* gpu_barrier, size_t barrier_count) override;
+
+  void draw_indexed_indirect(rhi::BufferHandle indirect_buf, uint32_t indirect_buf_id,
+                             size_t draw_cnt, size_t offset_i) override;
+  void draw_mesh_threadgroups(glm::uvec3 thread_groups, glm::uvec3 threads_per_task_thread_group,
+                              glm::uvec3 threads_per_mesh_thread_group) override;
+  void draw_mesh_threadgroups_indirect(rhi::BufferHandle indirect_buf, size_t indirect_buf_offset,
+                                       glm::uvec3 threads_per_task_thread_group,
+                                       glm::uvec3 threads_per_mesh_thread_group) override;
+  void dispatch_compute(glm::uvec3 thread_groups, glm::uvec3 threads_per_threadgroup) override;
+  void fill_buffer(rhi::BufferHandle handle, uint32_t offset_bytes, uint32_t size,
+                   uint32_t value) override;
+  void push_debug_group(const char* name) override;
+  void pop_debug_group() override;
+
+  using rhi::CmdEncoder::bind_srv;
+  using rhi::CmdEncoder::bind_uav;
+  void bind_srv(rhi::TextureHandle texture, uint32_t slot, int subresource_id) override;
+  void bind_srv(rhi::BufferHandle buffer, uint32_t slot, size_t offset_bytes) override;
+  void bind_uav(rhi::TextureHandle texture, uint32_t slot, int subresource_id) override;
+  void bind_uav(rhi::BufferHandle buffer, uint32_t slot, size_t offset_bytes) override;
+  void bind_cbv(rhi::BufferHandle buffer, uint32_t slot, size_t offset_bytes,
+                size_t size_bytes) override;
+
+  void write_timestamp(rhi::QueryPoolHandle query_pool, uint32_t query_index) override;
+  void query_resolve(rhi::QueryPoolHandle query_pool, uint32_t start_query, uint32_t query_count,
+                     rhi::BufferHandle dst_buffer, size_t dst_offset) override;
+
+  [[nodiscard]] const std::vector<NullCmd>& cmds() const { return cmds_; }
+  [[nodiscard]] const NullCmdCounts& cmd_counts() const { return cmd_counts_; }
+  [[nodiscard]] rhi::QueueType queue_type() const { return queue_type_; }
+
+ private:
+  friend class NullDevice;
+  void reset(rhi::QueueType queue_type);
+  void record(NullCmdType type, uint32_t arg = 0) {
+    cmds_.emplace_back(NullCmd{.type = type, .arg = arg});
+    cmd_counts_[static_cast<size_t>(type)]++;
+  }
+  void check_buf(rhi::BufferHandle handle) const;
+  void check_tex(rhi::TextureHandle handle) const;
+
+  NullDevice* device_{};
+  std::vector<NullCmd> cmds_;
+  std::vector<uint8_t> push_constant_data_;
+  NullCmdCounts cmd_counts_{};
+  uint32_t indexed_indirect_draw_id_{};
+  rhi::QueueType queue_type_{rhi::QueueType::Graphics};
+  uint32_t debug_group_depth_{};
+  bool in_render_pass_{};
+  bool pipeline_bound_{};
+  bool encoding_{};
+};
+
+}  // namespace gfx::null
+
+}  // namespace TENG_NAMESPACE
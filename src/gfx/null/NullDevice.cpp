@@ -0,0 +1,344 @@
+#include "NullDevice.hpp"
+
+#include <algorithm>
+
+#include "core/EAssert.hpp"
+#include "core/Logger.hpp"
+#include "core/Profiler.hpp"
+#include "gfx/rhi/Config.hpp"
+#include "gfx/rhi/QueryPool.hpp"
+#include "imgui.h"
+
+namespace TENG_NAMESPACE {
+
+namespace gfx::null {
+
+namespace {
+
+constexpr uint32_t k_bindless_capacity = 1u << 20;
+constexpr uint32_t k_swapchain_image_count = 3;
+
+}  // namespace
+
+void NullDevice::init(const InitInfo& init_info) {
+  info_.frames_in_flight = init_info.frames_in_flight;
+  ALWAYS_ASSERT(info_.frames_in_flight >= k_min_frames_in_flight &&
+                info_.frames_in_flight <= k_max_frames_in_flight);
+  // write_timestamp records steady_clock nanoseconds.
+  info_.timestamp_frequency = 1'000'000'000;
+  // Encoders only touch their own state and the (thread-safe) resource pools.
+  capabilities_ |= rhi::GraphicsCapability::ParallelCmdEncoding;
+  // Queues are only labels here, but advertising them lets headless runs exercise queue scheduling.
+  if (init_info.async_compute) {
+    capabilities_ |= rhi::GraphicsCapability::AsyncCompute;
+  }
+  bindless_indices_.reserve(k_bindless_capacity);
+  // reserve the null descriptor slot
+  [[maybe_unused]] const uint32_t null_slot = bindless_indices_.alloc_idx();
+  ASSERT(null_slot == 0);
+  LINFO("[NullDevice] initialized headless device ({} frames in flight)", info_.frames_in_flight);
+}
+
+void NullDevice::shutdown() {
+  cmd_encoders_.clear();
+  immediate_encoder_.reset();
+  LINFO("[NullDevice] shutdown: {} buffers, {} textures, {} pipelines still alive",
+        buffer_pool_.size(), texture_pool_.size(), pipeline_pool_.size());
+}
+
+rhi::BufferHandle NullDevice::create_buf(const rhi::BufferDesc& desc) {
+  ALWAYS_ASSERT(desc.size > 0);
+  const uint32_t bindless_idx = has_flag(desc.flags, rhi::BufferDescFlags::NoBindless)
+                                    ? rhi::k_invalid_bindless_idx
+                                    : bindless_indices_.alloc_idx();
+  const bool cpu_visible = has_flag(desc.flags, rhi::BufferDescFlags::CPUAccessible);
+  return buffer_pool_.alloc(desc, bindless_idx, cpu_visible);
+}
+
+rhi::TextureHandle NullDevice::create_tex(const rhi::TextureDesc& desc) {
+  ALWAYS_ASSERT(desc.mip_levels > 0);
+  ALWAYS_ASSERT(desc.array_length > 0);
+  const uint32_t bindless_idx = has_flag(desc.flags, rhi::TextureDescFlags::NoBindless)
+                                    ? rhi::k_invalid_bindless_idx
+                                    : bindless_indices_.alloc_idx();
+  return texture_pool_.alloc(desc, bindless_idx, false);
+}
+
+rhi::TextureViewHandle NullDevice::create_tex_view(rhi::TextureHandle handle,
+                                                   uint32_t base_mip_level, uint32_t level_count,
+                                                   uint32_t base_array_layer,
+                                                   uint32_t layer_count) {
+  auto* tex = get_null_tex(handle);
+  ALWAYS_ASSERT(tex);
+  ALWAYS_ASSERT(!tex->is_swapchain_image_);
+  const rhi::TextureDesc& desc = tex->desc();
+  ALWAYS_ASSERT(level_count > 0);
+  ALWAYS_ASSERT(layer_count > 0);
+  ALWAYS_ASSERT(base_mip_level + level_count <= desc.mip_levels);
+  ALWAYS_ASSERT(base_array_layer + layer_count <= desc.array_length);
+
+  tex->tex_views.emplace_back(NullTexture::TexView{
+      .base_mip_level = base_mip_level,
+      .level_count = level_count,
+      .base_array_layer = base_array_layer,
+      .layer_count = layer_count,
+      .bindless_idx = bindless_indices_.alloc_idx(),
+      .live = true,
+  });
+  return static_cast<rhi::TextureViewHandle>(tex->tex_views.size() - 1);
+}
+
+rhi::QueryPoolHandle NullDevice::create_query_pool(const rhi::QueryPoolDesc& desc) {
+  ALWAYS_ASSERT(desc.count > 0);
+  return query_pool_pool_.alloc(desc.count);
+}
+
+rhi::SamplerHandle NullDevice::create_sampler(const rhi::SamplerDesc& desc) {
+  return sampler_pool_.alloc(desc, bindless_indices_.alloc_idx());
+}
+
+rhi::SwapchainHandle NullDevice::create_swapchain(const rhi::SwapchainDesc& desc) {
+  auto handle = swapchain_pool_.alloc();
+  auto* swapchain = swapchain_pool_.get(handle);
+  ALWAYS_ASSERT(swapchain);
+  recreate_swapchain(desc, swapchain);
+  return handle;
+}
+
+bool NullDevice::recreate_swapchain(const rhi::SwapchainDesc& desc, rhi::Swapchain* swapchain) {
+  auto* swap = static_cast<NullSwapchain*>(swapchain);
+  swap->desc_ = desc;
+  // There is no surface to query, so a zero sized window still gets a 1x1 image.
+  const uint32_t w = std::max(desc.width, 1u);
+  const uint32_t h = std::max(desc.height, 1u);
+  const rhi::TextureDesc tex_desc{
+      .format = rhi::TextureFormat::B8G8R8A8Srgb,
+      .usage = rhi::TextureUsage::ColorAttachment | rhi::TextureUsage::TransferSrc |
+               rhi::TextureUsage::TransferDst,
+      .dims = {w, h, 1},
+      .mip_levels = 1,
+      .array_length = 1,
+      .flags = rhi::TextureDescFlags::NoBindless | rhi::TextureDescFlags::DisableCPUAccessOnUMA,
+  };
+  swap->desc_.width = w;
+  swap->desc_.height = h;
+  for (uint32_t i = 0; i < swap->swapchain_tex_count_; i++) {
+    destroy(swap->textures_[i]);
+  }
+  swap->swapchain_tex_count_ = k_swapchain_image_count;
+  for (uint32_t i = 0; i < swap->swapchain_tex_count_; i++) {
+    swap->textures_[i] = texture_pool_.alloc(tex_desc, rhi::k_invalid_bindless_idx, true);
+  }
+  swap->curr_img_idx_ = 0;
+  return true;
+}
+
+rhi::PipelineHandle NullDevice::create_graphics_pipeline(
+    const rhi::GraphicsPipelineCreateInfo& cinfo) {
+  return pipeline_pool_.alloc(cinfo);
+}
+
+rhi::PipelineHandle NullDevice::create_compute_pipeline(const rhi::ShaderCreateInfo& cinfo) {
+  ALWAYS_ASSERT(cinfo.type == rhi::ShaderType::Compute);
+  return pipeline_pool_.alloc(cinfo);
+}
+
+bool NullDevice::replace_pipeline(rhi::PipelineHandle handle,
+                                  const rhi::GraphicsPipelineCreateInfo& cinfo) {
+  auto* pipeline = pipeline_pool_.get(handle);
+  if (!pipeline) {
+    return false;
+  }
+  *pipeline = NullPipeline{cinfo};
+  return true;
+}
+
+bool NullDevice::replace_compute_pipeline(rhi::PipelineHandle handle,
+                                          const rhi::ShaderCreateInfo& cinfo) {
+  auto* pipeline = pipeline_pool_.get(handle);
+  if (!pipeline) {
+    return false;
+  }
+  *pipeline = NullPipeline{cinfo};
+  return true;
+}
+
+uint32_t NullDevice::get_tex_view_bindless_idx(rhi::TextureHandle handle, int subresource_id) {
+  auto* tex = get_null_tex(handle);
+  ALWAYS_ASSERT(tex);
+  ALWAYS_ASSERT(subresource_id >= 0);
+  ALWAYS_ASSERT(subresource_id < static_cast<int>(tex->tex_views.size()));
+  const auto& tv = tex->tex_views[static_cast<size_t>(subresource_id)];
+  ALWAYS_ASSERT(tv.live);
+  return tv.bindless_idx;
+}
+
+void NullDevice::free_bindless_idx(uint32_t idx) {
+  if (idx != rhi::k_invalid_bindless_idx && idx != 0u) {
+    bindless_indices_.free_idx(idx);
+  }
+}
+
+void NullDevice::destroy(rhi::BufferHandle handle) {
+  auto* buf = get_null_buf(handle);
+  if (!buf) {
+    return;
+  }
+  free_bindless_idx(buf->raw_bindless_idx());
+  buffer_pool_.destroy(handle);
+}
+
+void NullDevice::destroy(rhi::TextureHandle tex_handle, int tex_view_handle) {
+  auto* tex = get_null_tex(tex_handle);
+  if (!tex) {
+    return;
+  }
+  ASSERT(tex_view_handle >= 0);
+  ASSERT(tex_view_handle < static_cast<int>(tex->tex_views.size()));
+  auto& tv = tex->tex_views[static_cast<size_t>(tex_view_handle)];
+  if (!tv.live) {
+    return;
+  }
+  free_bindless_idx(tv.bindless_idx);
+  tv = {};
+}
+
+void NullDevice::destroy(rhi::PipelineHandle handle) { pipeline_pool_.destroy(handle); }
+
+void NullDevice::destroy(rhi::QueryPoolHandle handle) { query_pool_pool_.destroy(handle); }
+
+void NullDevice::destroy(rhi::TextureHandle handle) {
+  auto* tex = get_null_tex(handle);
+  if (!tex) {
+    return;
+  }
+  for (int i = 0; i < static_cast<int>(tex->tex_views.size()); i++) {
+    destroy(handle, i);
+  }
+  free_bindless_idx(tex->raw_bindless_idx());
+  texture_pool_.destroy(handle);
+}
+
+void NullDevice::destroy(rhi::SamplerHandle handle) {
+  auto* sampler = sampler_pool_.get(handle);
+  if (!sampler) {
+    return;
+  }
+  free_bindless_idx(sampler->raw_bindless_idx());
+  sampler_pool_.destroy(handle);
+}
+
+void NullDevice::destroy(rhi::SwapchainHandle handle) {
+  auto* swapchain = swapchain_pool_.get(handle);
+  if (!swapchain) {
+    return;
+  }
+  for (uint32_t i = 0; i < swapchain->swapchain_tex_count_; i++) {
+    destroy(swapchain->textures_[i]);
+  }
+  swapchain_pool_.destroy(handle);
+}
+
+void NullDevice::cmd_encoder_wait_for(rhi::CmdEncoder* /*cmd_enc_first*/,
+                                      rhi::CmdEncoder* /*cmd_enc_second*/) {
+  // Encoders are never executed, so there is nothing to order.
+}
+
+rhi::CmdEncoder* NullDevice::begin_cmd_encoder(rhi::QueueType queue_type) {
+  if (curr_cmd_encoder_i_ >= cmd_encoders_.size()) {
+    cmd_encoders_.emplace_back(std::make_unique<NullCmdEncoder>(this));
+  }
+  auto& enc = *cmd_encoders_[curr_cmd_encoder_i_++];
+  enc.reset(queue_type);
+  return &enc;
+}
+
+void NullDevice::submit_frame() {
+  ZoneScoped;
+  FrameStats stats{};
+  for (size_t i = 0; i < curr_cmd_encoder_i_; i++) {
+    const auto& enc = *cmd_encoders_[i];
+    ASSERT(!enc.encoding_);
+    for (size_t t = 0; t < stats.cmd_counts.size(); t++) {
+      stats.cmd_counts[t] += enc.cmd_counts_[t];
+    }
+    stats.cmd_count += enc.cmds_.size();
+    stats.push_constant_bytes += enc.push_constant_data_.size();
+  }
+  stats.encoder_count = curr_cmd_encoder_i_;
+  last_frame_stats_ = stats;
+  curr_cmd_encoder_i_ = 0;
+  frame_num_++;
+}
+
+void NullDevice::immediate_submit(rhi::QueueType queue_type, ImmediateSubmitFn&& submit_fn) {
+  if (!immediate_encoder_) {
+    immediate_encoder_ = std::make_unique<NullCmdEncoder>(this);
+  }
+  immediate_encoder_->reset(queue_type);
+  submit_fn(immediate_encoder_.get());
+  if (immediate_encoder_->encoding_) {
+    immediate_encoder_->end_encoding();
+  }
+}
+
+void NullDevice::enqueue_swapchain_for_present(rhi::Swapchain* swapchain,
+                                               rhi::CmdEncoder* /*cmd_enc*/) {
+  ASSERT(swapchain);
+}
+
+void NullDevice::begin_swapchain_rendering(rhi::Swapchain* swapchain, rhi::CmdEncoder* cmd_enc,
+                                           glm::vec4* clear_color) {
+  enqueue_swapchain_for_present(swapchain, cmd_enc);
+  cmd_enc->begin_rendering({
+      rhi::RenderAttInfo{
+          .image = swapchain->get_current_texture(),
+          .load_op = clear_color ? rhi::LoadOp::Clear : rhi::LoadOp::DontCare,
+          .store_op = rhi::StoreOp::Store,
+          .clear_value = clear_color ? rhi::ClearValue{.color = *clear_color} : rhi::ClearValue{},
+      },
+  });
+}
+
+void NullDevice::acquire_next_swapchain_image(rhi::Swapchain* swapchain) {
+  auto* swap = static_cast<NullSwapchain*>(swapchain);
+  ASSERT(swap->swapchain_tex_count_ > 0);
+  swap->curr_img_idx_ = (swap->curr_img_idx_ + 1) % swap->swapchain_tex_count_;
+}
+
+void NullDevice::resolve_query_data(rhi::QueryPoolHandle query_pool, uint32_t start_query,
+                                    uint32_t query_count, std::span<uint64_t> out_timestamps) {
+  auto* pool = get_query_pool(query_pool);
+  ALWAYS_ASSERT(pool);
+  ALWAYS_ASSERT(start_query + query_count <= pool->timestamps_.size());
+  ALWAYS_ASSERT(out_timestamps.size() >= query_count);
+  std::copy_n(pool->timestamps_.begin() + start_query, query_count, out_timestamps.begin());
+}
+
+rhi::GpuAdapterInfo NullDevice::query_gpu_adapter_info() const {
+  return rhi::GpuAdapterInfo{
+      .name = "Null Device",
+      .kind = rhi::GpuAdapterKind::Cpu,
+      .api_version = "null",
+      .driver_version = "null",
+  };
+}
+
+void NullDevice::on_imgui() {
+  ImGui::Text(
+      "Active Textures: %zu\nActive Buffers: %zu\nActive Samplers: %zu\nActive Pipelines: %zu",
+      texture_pool_.size(), buffer_pool_.size(), sampler_pool_.size(), pipeline_pool_.size());
+  ImGui::Text("Last frame: %zu encoders, %zu commands, %zu push constant bytes",
+              last_frame_stats_.encoder_count, last_frame_stats_.cmd_count,
+              last_frame_stats_.push_constant_bytes);
+  for (size_t t = 0; t < last_frame_stats_.cmd_counts.size(); t++) {
+    if (last_frame_stats_.cmd_counts[t]) {
+      ImGui::Text("  %s: %llu", to_string(static_cast<NullCmdType>(t)),
+                  static_cast<unsigned long long>(last_frame_stats_.cmd_counts[t]));
+    }
+  }
+}
+
+}  // namespace gfx::null
+
+}  // namespace TENG_NAMESPACE
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "core/Allocator.hpp"
+#include "core/Config.hpp"
+#include "core/Pool.hpp"
+#include "gfx/rhi/Device.hpp"
+#include "gfx/rhi/GFXTypes.hpp"
+#include "gfx/rhi/Queue.hpp"
+#include "gfx/null/NullBuffer.hpp"
+#include "gfx/null/NullCmdEncoder.hpp"
+#include "gfx/null/NullPipeline.hpp"
+#include "gfx/null/NullQueryPool.hpp"
+#include "gfx/null/NullSampler.hpp"
+#include "gfx/null/NullSwapchain.hpp"
+#include "gfx/null/NullTexture.hpp"
+
+namespace TENG_NAMESPACE {
+
+namespace gfx::null {
+
+// Headless device: hands out real handles and bindless indices, keeps descriptors and records
+// commands into memory, but never touches a GPU. Used to profile and regression-test the CPU side
+// of a frame (render graph bake/execute, renderer recording) on machines without one.
+class NullDevice : public rhi::Device {
+ public:
+  using rhi::Device::get_buf;
+  using rhi::Device::get_pipeline;
+  using rhi::Device::get_swapchain;
+  using rhi::Device::get_tex;
+
+  // Totals for one submitted frame.
+  struct FrameStats {
+    NullCmdCounts cmd_counts{};
+    size_t cmd_count{};
+    size_t encoder_count{};
+    size_t push_constant_bytes{};
+  };
+
+  void init(const InitInfo& init_info) override;
+  void shutdown() override;
+  rhi::ShaderTarget get_supported_shader_targets() override { return rhi::ShaderTarget::Spirv; }
+  [[nodiscard]] void* get_native_device() const override { return nullptr; }
+
+  rhi::BufferHandle create_buf(const rhi::BufferDesc& desc) override;
+  rhi::TextureHandle create_tex(const rhi::TextureDesc& desc) override;
+  rhi::TextureViewHandle create_tex_view(rhi::TextureHandle handle, uint32_t base_mip_level,
+                                         uint32_t level_count, uint32_t base_array_layer,
+                                         uint32_t layer_count) override;
+  rhi::QueryPoolHandle create_query_pool(const rhi::QueryPoolDesc& desc) override;
+  rhi::SamplerHandle create_sampler(const rhi::SamplerDesc& desc) override;
+  rhi::SwapchainHandle create_swapchain(const rhi::SwapchainDesc& desc) override;
+  rhi::PipelineHandle create_graphics_pipeline(
+      const rhi::GraphicsPipelineCreateInfo& cinfo) override;
+  rhi::PipelineHandle create_compute_pipeline(const rhi::ShaderCreateInfo& cinfo) override;
+  bool replace_pipeline(rhi::PipelineHandle handle,
+                        const rhi::GraphicsPipelineCreateInfo& cinfo) override;
+  bool replace_compute_pipeline(rhi::PipelineHandle handle,
+                                const rhi::ShaderCreateInfo& cinfo) override;
+
+  uint32_t get_tex_view_bindless_idx(rhi::TextureHandle handle, int subresource_id) override;
+  rhi::Texture* get_tex(rhi::TextureHandle handle) override { return texture_pool_.get(handle); }
+  rhi::Buffer* get_buf(rhi::BufferHandle handle) override { return buffer_pool_.get(handle); }
+  rhi::Pipeline* get_pipeline(rhi::PipelineHandle handle) override {
+    return pipeline_pool_.get(handle);
+  }
+  rhi::Swapchain* get_swapchain(rhi::SwapchainHandle handle) override {
+    return swapchain_pool_.get(handle);
+  }
+  void get_all_buffers(std::vector<rhi::Buffer*>& out_buffers) override {
+    buffer_pool_.for_each([&out_buffers](const NullBuffer& buffer) {
+      out_buffers.emplace_back((rhi::Buffer*)&buffer);
+    });
+  }
+
+  void destroy(rhi::BufferHandle handle) override;
+  void destroy(rhi::TextureHandle tex_handle, int tex_view_handle) override;
+  void destroy(rhi::PipelineHandle handle) override;
+  void destroy(rhi::QueryPoolHandle handle) override;
+  void destroy(rhi::TextureHandle handle) override;
+  void destroy(rhi::SamplerHandle handle) override;
+  void destroy(rhi::SwapchainHandle handle) override;
+
+  void cmd_encoder_wait_for(rhi::CmdEncoder* cmd_enc_first,
+                            rhi::CmdEncoder* cmd_enc_second) override;
+  rhi::CmdEncoder* begin_cmd_encoder(rhi::QueueType queue_type) override;
+  void submit_frame() override;
+  void immediate_submit(rhi::QueueType queue_type, ImmediateSubmitFn&& submit_fn) override;
+
+  bool recreate_swapchain(const rhi::SwapchainDesc& desc, rhi::Swapchain* swapchain) override;
+  void enqueue_swapchain_for_present(rhi::Swapchain* swapchain, rhi::CmdEncoder* cmd_enc) override;
+  void begin_swapchain_rendering(rhi::Swapchain* swapchain, rhi::CmdEncoder* cmd_enc,
+                                 glm::vec4* clear_color) override;
+  void acquire_next_swapchain_image(rhi::Swapchain* swapchain) override;
+  void resolve_query_data(rhi::QueryPoolHandle query_pool, uint32_t start_query,
+                          uint32_t query_count, std::span<uint64_t> out_timestamps) override;
+
+  [[nodiscard]] const Info& get_info() const override { return info_; }
+  [[nodiscard]] rhi::GpuAdapterInfo query_gpu_adapter_info() const override;
+  void on_imgui() override;
+
+  [[nodiscard]] NullQueryPool* get_query_pool(rhi::QueryPoolHandle handle) {
+    return query_pool_pool_.get(handle);
+  }
+  [[nodiscard]] NullTexture* get_null_tex(rhi::TextureHandle handle) {
+    return texture_pool_.get(handle);
+  }
+  [[nodiscard]] NullBuffer* get_null_buf(rhi::BufferHandle handle) {
+    return buffer_pool_.get(handle);
+  }
+  [[nodiscard]] const FrameStats& get_last_frame_stats() const { return last_frame_stats_; }
+  [[nodiscard]] size_t get_frame_num() const { return frame_num_; }
+
+ private:
+  friend class NullCmdEncoder;
+
+  void free_bindless_idx(uint32_t idx);
+
+  Info info_{};
+  AtomicBlockPool<rhi::BufferHandle, NullBuffer> buffer_pool_{128, 1, true};
+  AtomicBlockPool<rhi::TextureHandle, NullTexture> texture_pool_{128, 1, true};
+  AtomicBlockPool<rhi::PipelineHandle, NullPipeline> pipeline_pool_{20, 1, true};
+  AtomicBlockPool<rhi::SamplerHandle, NullSampler> sampler_pool_{16, 1, true};
+  AtomicBlockPool<rhi::SwapchainHandle, NullSwapchain> swapchain_pool_{16, 1, true};
+  AtomicBlockPool<rhi::QueryPoolHandle, NullQueryPool> query_pool_pool_{16, 1, true};
+
+  // Shared bindless index space for buffers, textures, views and samplers. Index 0 is reserved as
+  // the null descriptor like on the GPU backends.
+  IndexAllocator bindless_indices_;
+  std::vector<std::unique_ptr<NullCmdEncoder>> cmd_encoders_;
+  size_t curr_cmd_encoder_i_{};
+  std::unique_ptr<NullCmdEncoder> immediate_encoder_;
+  FrameStats last_frame_stats_{};
+  size_t frame_num_{};
+};
+
+}  // namespace gfx::null
+
+}  // namespace TENG_NAMESPACE
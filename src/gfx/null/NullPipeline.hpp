@@ -0,0 +1,19 @@
+#pragma once
+
+#include "core/Config.hpp"
+#include "gfx/rhi/Pipeline.hpp"
+
+namespace TENG_NAMESPACE {
+
+namespace gfx::null {
+
+class NullPipeline : public rhi::Pipeline {
+ public:
+  NullPipeline() = default;
+  explicit NullPipeline(const rhi::GraphicsPipelineCreateInfo& ginfo) : rhi::Pipeline(ginfo) {}
+  explicit NullPipeline(const rhi::ShaderCreateInfo& cinfo) : rhi::Pipeline(cinfo) {}
+};
+
+}  // namespace gfx::null
+
+}  // namespace TENG_NAMESPACE
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "core/Config.hpp"
+#include "gfx/rhi/QueryPool.hpp"
+
+namespace TENG_NAMESPACE {
+
+namespace gfx::null {
+
+// Timestamps are CPU clock readings taken when the query is recorded.
+class NullQueryPool : public rhi::QueryPool {
+ public:
+  explicit NullQueryPool(uint32_t count) : timestamps_(count) {}
+  NullQueryPool() = default;
+
+  std::vector<uint64_t> timestamps_;
+};
+
+}  // namespace gfx::null
+
+}  // namespace TENG_NAMESPACE
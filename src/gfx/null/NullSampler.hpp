@@ -0,0 +1,23 @@
+#pragma once
+
+#include "core/Config.hpp"
+#include "gfx/rhi/Sampler.hpp"
+
+namespace TENG_NAMESPACE {
+
+namespace gfx::null {
+
+class NullSampler : public rhi::Sampler {
+ public:
+  explicit NullSampler(const rhi::SamplerDesc& desc,
+                       uint32_t bindless_idx = rhi::k_invalid_bindless_idx)
+      : rhi::Sampler(desc, bindless_idx) {}
+  NullSampler() = default;
+  ~NullSampler() = default;
+
+  [[nodiscard]] uint32_t raw_bindless_idx() const { return bindless_idx_; }
+};
+
+}  // namespace gfx::null
+
+}  // namespace TENG_NAMESPACE
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <array>
+
+#include "core/Config.hpp"
+#include "gfx/rhi/Config.hpp"
+#include "gfx/rhi/Swapchain.hpp"
+
+namespace TENG_NAMESPACE {
+
+namespace gfx::null {
+
+class NullSwapchain : public rhi::Swapchain {
+ public:
+  NullSwapchain() = default;
+  ~NullSwapchain() = default;
+
+  rhi::TextureHandle get_texture(uint32_t frame_index) override { return textures_[frame_index]; }
+  rhi::TextureHandle get_current_texture() override { return textures_[curr_img_idx_]; }
+
+  std::array<rhi::TextureHandle, k_max_swapchain_images> textures_;
+  uint32_t swapchain_tex_count_{};
+  uint32_t curr_img_idx_{};
+};
+
+}  // namespace gfx::null
+
+}  // namespace TENG_NAMESPACE
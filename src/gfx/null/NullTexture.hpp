@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+
+#include "core/Config.hpp"
+#include "gfx/rhi/Texture.hpp"
+
+namespace TENG_NAMESPACE {
+
+namespace gfx::null {
+
+class NullTexture : public rhi::Texture {
+ public:
+  NullTexture(const rhi::TextureDesc& desc, uint32_t bindless_idx, bool is_swapchain_image)
+      : rhi::Texture(desc, bindless_idx), is_swapchain_image_(is_swapchain_image) {}
+  NullTexture() = default;
+  ~NullTexture() = default;
+
+  [[nodiscard]] uint32_t raw_bindless_idx() const { return bindless_idx_; }
+
+  // Indices are stable handles; destroyed slots keep live == false (matches the Vulkan backend).
+  struct TexView {
+    uint32_t base_mip_level{};
+    uint32_t level_count{};
+    uint32_t base_array_layer{};
+    uint32_t layer_count{};
+    uint32_t bindless_idx{rhi::k_invalid_bindless_idx};
+    bool live{};
+  };
+  std::vector<TexView> tex_views;
+  bool is_swapchain_image_{false};
+};
+
+}  // namespace gfx::null
+
+}  // namespace TENG_NAMESPACE
@@ -1,5 +1,9 @@
 #include "InstanceMgr.hpp"
 
+#include <algorithm>
+#include <span>
+
+#include "core/Profiler.hpp"
 #include "gfx/rhi/Buffer.hpp"
 #include "gfx/rhi/CmdEncoder.hpp"
 #include "gfx/rhi/Device.hpp"
@@ -60,8 +64,9 @@ bool InstanceMgr::ensure_buffer_space(size_t element_count) {
         .size = sizeof(InstanceData) * element_count,
         // Don't enable CPU access for copying since this copy should be delayed until a copy
         // happens on the GPU timeline, otherwise artifacts can appear when the buffer is updated
-        // (objects added/removed).
-        .flags = rhi::BufferDescFlags::DisableCPUAccessOnUMA,
+        // (objects added/removed). Culling reads it on the async compute queue.
+        .flags = rhi::BufferDescFlags::DisableCPUAccessOnUMA |
+                 rhi::BufferDescFlags::SharedAcrossQueues,
         .name = "intance_data_buf",
     });
 
@@ -146,6 +151,19 @@ OffsetAllocator::Allocation InstanceMgr::allocate_instance_data(uint32_t element
   return alloc;
 }
 
+void InstanceMgr::flush_instance_writes() {
+  if (instance_writes_.empty()) {
+    return;
+  }
+  ZoneScoped;
+  instance_writes_.flush([this](uint32_t first, std::span<const InstanceData> run) {
+    buffer_copy_mgr_.copy_to_buffer(
+        run.data(), run.size_bytes(), instance_data_buf_.handle, first * sizeof(InstanceData),
+        rhi::PipelineStage::ComputeShader | rhi::PipelineStage::AllGraphics,
+        rhi::AccessFlags::ShaderRead);
+  });
+}
+
 void InstanceMgr::reserve_space(uint32_t instance_data_count) {
   if (instance_data_count == 0) {
     return;
@@ -1,9 +1,14 @@
 #pragma once
 
+#include <utility>
+#include <vector>
+
+#include "core/CoalescedWrites.hpp"
 #include "core/Config.hpp"
 #include "gfx/renderer/BufferResize.hpp"
 #include "gfx/rhi/Config.hpp"
 #include "hlsl/shared_indirect.h"
+#include "hlsl/shared_instance_data.h"
 #include "offsetAllocator.hpp"
 
 namespace TENG_NAMESPACE {
@@ -57,6 +62,14 @@ class InstanceMgr {
   [[nodiscard]] const Stats& stats() const { return stats_; }
 
   void reserve_space(uint32_t instance_data_count);
+  // Queues new contents for an allocated entry of the instance data buffer. Writes are kept on the
+  // CPU until flush_instance_writes(), where repeated writes to one entry collapse to the last and
+  // runs of adjacent entries go out as a single BufferCopyMgr copy.
+  void write_instance_data(uint32_t instance_data_i, const InstanceData& data) {
+    instance_writes_.write(instance_data_i, data);
+  }
+  // Call after the frame's allocations: copies target the buffer as it is after any resize.
+  void flush_instance_writes();
   [[nodiscard]] std::vector<IndexedIndirectDrawCmd>& cpu_draw_cmds() { return cpu_draw_cmds_; }
   [[nodiscard]] bool need_draw_cmds_on_cpu() const { return need_cpu_draws_; }
 
@@ -67,6 +80,7 @@ class InstanceMgr {
   std::vector<IndexedIndirectDrawCmd> cpu_draw_cmds_;
   bool need_cpu_draws_{true};
   bool ensure_buffer_space(size_t element_count);
+  CoalescedWrites<InstanceData> instance_writes_;
   OffsetAllocator::Allocator allocator_;
   rhi::BufferHandleHolder instance_data_buf_;
   rhi::BufferHandleHolder draw_cmd_buf_;
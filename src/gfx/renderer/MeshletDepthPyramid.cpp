@@ -51,6 +51,8 @@ void MeshletDepthPyramid::resize(glm::uvec2 source_dims) {
           rhi::TextureUsage::Storage | rhi::TextureUsage::ShaderWrite | rhi::TextureUsage::Sample,
       .dims = size,
       .mip_levels = mip_levels,
+      // Built on the async compute queue, sampled by graphics.
+      .flags = rhi::TextureDescFlags::SharedAcrossQueues,
       .name = "meshlet_depth_pyramid",
   })};
   tex_.views.reserve(mip_levels);
@@ -105,7 +107,8 @@ RGResourceId MeshletDepthPyramid::bake(RGResourceId depth_src_rg, std::string_vi
   RGResourceId final_depth_pyramid_rg{};
 
   for (uint32_t mip = 0; mip <= final_mip; mip++) {
-    auto& p = rg_.add_compute_pass(std::string(pass_prefix) + std::to_string(mip));
+    auto& p = rg_.add_compute_pass(std::string(pass_prefix) + std::to_string(mip))
+                  .set_queue(rhi::QueueType::Compute);
     RGResourceId depth_handle{};
     if (mip == 0) {
       depth_handle = p.sample_tex(depth_src_rg, rhi::PipelineStage::ComputeShader,
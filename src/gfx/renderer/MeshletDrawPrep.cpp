@@ -36,7 +36,7 @@ void GenerateTaskCmdComputePass::bake(
     const BufferSuballoc& cull_cb, RGResourceId& task_cmd_rg, RGResourceId& indirect_args_rg,
     RGResourceId& visible_object_count_rg, RGResourceId* instance_vis_current_rg,
     RGResourceId* final_depth_pyramid_rg, rhi::TextureHandle final_depth_pyramid_tex) {
-  auto& p = rg_.add_compute_pass(pass_name);
+  auto& p = rg_.add_compute_pass(pass_name).set_queue(rhi::QueueType::Compute);
   task_cmd_rg = p.write_buf(task_cmd_rg, PipelineStage::ComputeShader);
   indirect_args_rg = p.rw_buf(indirect_args_rg, PipelineStage::ComputeShader);
   visible_object_count_rg = p.rw_buf(visible_object_count_rg, PipelineStage::ComputeShader);
@@ -142,7 +142,7 @@ void MeshletDrawPrep::clear_indirect_args(std::string_view pass_name,
     return;
   }
 
-  auto& p = rg_.add_compute_pass(pass_name);
+  auto& p = rg_.add_compute_pass(pass_name).set_queue(rhi::QueueType::Compute);
   for (RGResourceId& id : indirect_args) {
     id = p.write_buf(id, rhi::PipelineStage::ComputeShader);
   }
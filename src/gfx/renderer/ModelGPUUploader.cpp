@@ -1,7 +1,6 @@
 #include "ModelGPUUploader.hpp"
 
-#include <tracy/Tracy.hpp>
-
+#include "core/Profiler.hpp"
 #include "core/Util.hpp"
 #include "gfx/BackedGPUAllocator.hpp"
 #include "gfx/DrawBatch.hpp"
@@ -128,7 +127,7 @@ void upload_model(ModelLoadResult& result, ModelInstance& model, rhi::Device& de
                   std::vector<GPUTexUpload>& pending_texture_uploads,
                   BackedGPUAllocator& materials_buf, BufferCopyMgr& buffer_copy_mgr,
                   GeometryBatch& draw_batch, ModelGPUHandle& out_handle,
-                  BlockPool<ModelGPUHandle, ModelGPUResources>& model_gpu_resource_pool) {
+                  AtomicBlockPool<ModelGPUHandle, ModelGPUResources>& model_gpu_resource_pool) {
   pending_texture_uploads.reserve(pending_texture_uploads.size() + result.texture_uploads.size());
 
   std::vector<uint32_t> img_upload_bindless_indices(result.texture_uploads.size(), 0);
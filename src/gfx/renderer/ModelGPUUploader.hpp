@@ -42,7 +42,7 @@ void upload_model(ModelLoadResult& result, ModelInstance& model, rhi::Device& de
                   std::vector<GPUTexUpload>& pending_texture_uploads,
                   BackedGPUAllocator& materials_buf, BufferCopyMgr& buffer_copy_mgr,
                   GeometryBatch& draw_batch, ModelGPUHandle& out_handle,
-                  BlockPool<ModelGPUHandle, ModelGPUResources>& model_gpu_resource_pool);
+                  AtomicBlockPool<ModelGPUHandle, ModelGPUResources>& model_gpu_resource_pool);
 
 struct GPUFrameAllocator3;
 void upload_texture_data(const GPUTexUpload& upload, rhi::Texture* tex, GPUFrameAllocator3& staging,
@@ -35,11 +35,40 @@ AutoCVarInt developer_render_graph_verbose{
 AutoCVarInt developer_render_graph_dump_mode{
     "renderer.developer.render_graph_dump_mode",
     "After each successful RenderGraph::bake: 0=off, 1=JSON, 2=GraphViz DOT, 3=JSON+DOT once per "
-    "ImGui \"Dump render graph\" request (requires render_graph_dump_dir).",
+    "ImGui \"Dump render graph\" request (requires render_graph_dump_dir). JSON dumps come with a "
+    "capture replayable by rg-bench.",
     0, CVarFlags::Advanced};
 AutoCVarString developer_render_graph_dump_dir{
     "renderer.developer.render_graph_dump_dir",
     "Directory for render graph dumps (required when render_graph_dump_mode is non-zero).", ""};
+AutoCVarInt developer_render_graph_bake_cache{
+    "renderer.developer.render_graph_bake_cache",
+    "Reuse the previous RenderGraph pass order and barrier plan when the graph structure is "
+    "unchanged.",
+    1,
+    static_cast<CVarFlags>(static_cast<uint16_t>(CVarFlags::EditCheckbox) |
+                           static_cast<uint16_t>(CVarFlags::Advanced))};
+AutoCVarInt developer_render_graph_record_chunks{
+    "renderer.developer.render_graph_record_chunks",
+    "Record RenderGraph passes into up to this many command encoders on worker threads (0/1 = "
+    "serial). Pass execute functions must be safe to run concurrently.",
+    0, CVarFlags::Advanced};
+AutoCVarInt developer_render_graph_async_compute{
+    "renderer.developer.render_graph_async_compute",
+    "Run RenderGraph passes marked for the compute queue on a dedicated async compute queue when "
+    "the device has one. The queue is created at startup, so enabling this needs a restart.",
+    0,
+    static_cast<CVarFlags>(static_cast<uint16_t>(CVarFlags::EditCheckbox) |
+                           static_cast<uint16_t>(CVarFlags::Advanced))};
+AutoCVarInt developer_render_graph_gpu_timing{
+    "renderer.developer.render_graph_gpu_timing",
+    "Wrap every RenderGraph pass in GPU timestamp queries and keep rolling per-pass stats.", 0,
+    CVarFlags::EditCheckbox};
+AutoCVarInt developer_render_graph_pool_budget_mb{
+    "renderer.developer.render_graph_pool_budget_mb",
+    "Idle RenderGraph transient textures/buffers kept pooled for reuse (MiB) before the least "
+    "recently used are destroyed.",
+    256, CVarFlags::Advanced};
 AutoCVarInt developer_collect_meshlet_draw_stats{
     "renderer.developer.collect_meshlet_draw_stats", "Record meshlet draw statistics for readback.",
     1,
@@ -19,6 +19,11 @@ extern AutoCVarInt ui_imgui_enabled;
 extern AutoCVarInt developer_render_graph_verbose;
 extern AutoCVarInt developer_render_graph_dump_mode;
 extern AutoCVarString developer_render_graph_dump_dir;
+extern AutoCVarInt developer_render_graph_bake_cache;
+extern AutoCVarInt developer_render_graph_record_chunks;
+extern AutoCVarInt developer_render_graph_async_compute;
+extern AutoCVarInt developer_render_graph_gpu_timing;
+extern AutoCVarInt developer_render_graph_pool_budget_mb;
 extern AutoCVarInt developer_collect_meshlet_draw_stats;
 
 }  // namespace renderer_cv
@@ -34,6 +34,18 @@ struct GPUBarrier {
     Buffer buf;
     Texture tex;
   };
+  // Explicit stage/access/layout, used instead of the ResourceState fields when `has_sync` is set.
+  // Texture mip/slice keep the k_gpu_barrier_*_all convention.
+  struct Sync {
+    PipelineStage src_stage;
+    AccessFlags src_access;
+    PipelineStage dst_stage;
+    AccessFlags dst_access;
+    ResourceLayout src_layout;
+    ResourceLayout dst_layout;
+  };
+  Sync sync{};
+  bool has_sync{};
 
   static GPUBarrier buf_barrier(BufferHandle handle, ResourceState src_state,
                                 ResourceState dst_state, size_t offset = 0,
@@ -65,6 +77,38 @@ struct GPUBarrier {
                     .array_layer_count = resolved_layer_cnt,
                     .aspect = aspect}};
   }
+
+  static GPUBarrier buf_barrier(BufferHandle handle, PipelineStage src_stage,
+                                AccessFlags src_access, PipelineStage dst_stage,
+                                AccessFlags dst_access, size_t offset = 0,
+                                size_t size = SIZE_MAX) {
+    GPUBarrier b = buf_barrier(handle, ResourceState::None, ResourceState::None, offset, size);
+    b.sync = {.src_stage = src_stage,
+              .src_access = src_access,
+              .dst_stage = dst_stage,
+              .dst_access = dst_access,
+              .src_layout = ResourceLayout::Undefined,
+              .dst_layout = ResourceLayout::Undefined};
+    b.has_sync = true;
+    return b;
+  }
+
+  static GPUBarrier tex_barrier(TextureHandle handle, PipelineStage src_stage,
+                                AccessFlags src_access, PipelineStage dst_stage,
+                                AccessFlags dst_access, ResourceLayout src_layout,
+                                ResourceLayout dst_layout, uint32_t mip, uint32_t slice,
+                                uint32_t mip_level_count, uint32_t array_layer_count) {
+    GPUBarrier b = tex_barrier(handle, ResourceState::None, ResourceState::None, mip, slice,
+                               ImageAspect_Color, mip_level_count, array_layer_count);
+    b.sync = {.src_stage = src_stage,
+              .src_access = src_access,
+              .dst_stage = dst_stage,
+              .dst_access = dst_access,
+              .src_layout = src_layout,
+              .dst_layout = dst_layout};
+    b.has_sync = true;
+    return b;
+  }
 };
 
 }  // namespace gfx::rhi
@@ -115,6 +115,12 @@ class CmdEncoder {
                        rhi::AccessFlags dst_access, size_t offset, size_t size) = 0;
   virtual void barrier(GPUBarrier* gpu_barrier, size_t barrier_count) = 0;
   virtual void barrier(GPUBarrier* gpu_barrier) { barrier(gpu_barrier, 1); }
+  // Between begin_parallel_cmd_encoders and end_parallel_cmd_encoders: mips
+  // [base_mip, base_mip + mip_count) of `tex` are in `layout` at this point of the encoder, as left
+  // by encoders earlier in the GPU timeline. Backends tracking image layouts use it for barriers
+  // that leave the old layout to them; applied with the encoder's own changes when the batch ends.
+  virtual void set_assumed_layout(rhi::TextureHandle /*tex*/, uint32_t /*base_mip*/,
+                                  uint32_t /*mip_count*/, rhi::ResourceLayout /*layout*/) {}
   virtual void draw_indexed_indirect(rhi::BufferHandle indirect_buf, uint32_t indirect_buf_id,
                                      size_t draw_cnt, size_t offset_i) = 0;
   virtual void draw_mesh_threadgroups(glm::uvec3 thread_groups,
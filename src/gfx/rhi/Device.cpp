@@ -1,6 +1,7 @@
 #include "Device.hpp"
 
 #include "core/Logger.hpp"  // IWYU pragma: keep
+#include "gfx/null/NullDevice.hpp"
 
 #ifdef METAL_BACKEND
 #include "gfx/metal/MetalDevice.hpp"
@@ -35,6 +36,8 @@ std::unique_ptr<Device> create_device(GfxAPI api) {
 #else
       return std::make_unique<gfx::vk::VulkanDevice>();
 #endif
+    case rhi::GfxAPI::Null:
+      return std::make_unique<gfx::null::NullDevice>();
   }
 }
 
@@ -31,6 +31,10 @@ class Swapchain;
 enum class GraphicsCapability : uint32_t {
   None = 0,
   CacheCoherentUMA = 1 << 0,  // CPU-GPU shared memory is cache coherent -> no staging buffers, etc.
+  // Encoders from begin_parallel_cmd_encoders may be recorded concurrently on different threads.
+  ParallelCmdEncoding = 1 << 1,
+  // QueueType::Compute runs on its own queue; order against other queues with cmd_encoder_wait_for.
+  AsyncCompute = 1 << 2,
 };
 
 AUGMENT_ENUM_CLASS(GraphicsCapability);
@@ -65,6 +69,8 @@ class Device {
     std::string app_name;
     bool validation_layers_enabled{true};
     size_t frames_in_flight{2};
+    // Create an async compute queue (GraphicsCapability::AsyncCompute) when the GPU has one.
+    bool async_compute{};
   };
   virtual ~Device() = default;
   virtual void init(const InitInfo &init_info) = 0;
@@ -131,9 +137,22 @@ class Device {
   virtual void destroy(SamplerHandle handle) = 0;
   virtual void destroy(SwapchainHandle handle) = 0;
 
+  // GPU work in `cmd_enc_second` starts only after `cmd_enc_first` completes. `cmd_enc_first` must
+  // have been begun earlier.
   virtual void cmd_encoder_wait_for(CmdEncoder *cmd_enc_first, CmdEncoder *cmd_enc_second) = 0;
   virtual CmdEncoder *begin_cmd_encoder(rhi::QueueType queue_type) = 0;
   CmdEncoder *begin_cmd_encoder() { return begin_cmd_encoder(rhi::QueueType::Graphics); }
+  // Begins one encoder per queue_types entry, submitted in span order after every encoder begun
+  // before them this frame. With GraphicsCapability::ParallelCmdEncoding each encoder may then be
+  // recorded and ended on its own thread; otherwise they must be recorded serially. Once all of
+  // them have ended, call end_parallel_cmd_encoders from the thread that began them.
+  virtual void begin_parallel_cmd_encoders(std::span<const rhi::QueueType> queue_types,
+                                           std::span<CmdEncoder *> out) {
+    for (size_t i = 0; i < out.size(); i++) {
+      out[i] = begin_cmd_encoder(queue_types[i]);
+    }
+  }
+  virtual void end_parallel_cmd_encoders(std::span<CmdEncoder *const> /*encoders*/) {}
   virtual void submit_frame() = 0;
   using ImmediateSubmitFn = std::function<void(rhi::CmdEncoder *)>;
   virtual void immediate_submit(rhi::QueueType queue_type, ImmediateSubmitFn &&submit_fn) = 0;
@@ -173,7 +192,8 @@ class Device {
   GraphicsCapability capabilities_{};
 };
 
-enum class GfxAPI { Vulkan, Metal };
+// Null is a headless backend that records commands without a GPU (see gfx/null).
+enum class GfxAPI { Vulkan, Metal, Null };
 
 std::unique_ptr<Device> create_device(GfxAPI api);
 
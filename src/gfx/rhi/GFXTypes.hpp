@@ -86,6 +86,7 @@ enum class TextureDescFlags : uint8_t {
   NoBindless = 1 << 1,
   CPUAccessible = 1 << 2,
   DisableCPUAccessOnUMA = 1 << 3,
+  SharedAcrossQueues = 1 << 4,  // used on the async compute queue and graphics alike
 };
 
 AUGMENT_ENUM_CLASS(TextureDescFlags);
@@ -118,6 +119,7 @@ enum class BufferDescFlags : uint8_t {
                              // relevant if CPUAccessible is set)
   NoBindless = 1 << 2,
   DisableCPUAccessOnUMA = 1 << 3,
+  SharedAcrossQueues = 1 << 4,  // used on the async compute queue and graphics alike
 };
 
 AUGMENT_ENUM_CLASS(BufferDescFlags);
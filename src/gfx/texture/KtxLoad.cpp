@@ -2,9 +2,12 @@
 
 #include <ktx.h>
 
+#include <string_view>
+
 #include "VkFormatEnum.hpp"
 #include "core/Config.hpp"
 #include "core/Logger.hpp"
+#include "core/MappedFile.hpp"
 #include "gfx/rhi/GFXTypes.hpp"
 
 namespace TENG_NAMESPACE {
@@ -29,15 +32,16 @@ rhi::TextureFormat convert(VkFormat format) {
   }
 }
 
-}  // namespace
-
-LoadKtxTextureResult load_ktx_texture(const std::filesystem::path &path) {
+// `source` only labels errors. With LOAD_IMAGE_DATA_BIT libktx copies the image data out of
+// `data`, so the caller may release it once this returns.
+LoadKtxTextureResult load_ktx_from_memory(const void *data, size_t data_size,
+                                          std::string_view source) {
   LoadKtxTextureResult load_result{};
   ktxTexture2 *&texture = load_result.texture;
-  KTX_error_code result = ktxTexture2_CreateFromNamedFile(
-      path.string().c_str(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texture);
+  KTX_error_code result = ktxTexture2_CreateFromMemory(
+      (ktx_uint8_t *)data, data_size, KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texture);
   if (result != KTX_SUCCESS) {
-    LERROR("Failed to load KTX texture from {}: {}", path.string(), ktxErrorString(result));
+    LERROR("Failed to load KTX texture from {}: {}", source, ktxErrorString(result));
     load_result.texture = nullptr;
     return load_result;
   }
@@ -45,45 +49,31 @@ LoadKtxTextureResult load_ktx_texture(const std::filesystem::path &path) {
   if (transcodable) {
     result = ktxTexture2_TranscodeBasis(texture, KTX_TTF_BC7_RGBA, KTX_TF_HIGH_QUALITY);
     if (result != KTX_SUCCESS) {
-      LERROR("Failed to transcode KTX texture from {}: {}", path.string(), ktxErrorString(result));
+      LERROR("Failed to transcode KTX texture from {}: {}", source, ktxErrorString(result));
       goto cleanup_failed_load;
     }
   }
-
   load_result.format = convert((VkFormat)texture->vkFormat);
-
   return load_result;
-
 cleanup_failed_load:
   ktxTexture2_Destroy(texture);
   load_result.texture = nullptr;
   return load_result;
 }
 
-LoadKtxTextureResult load_ktx_texture(const void *data, size_t data_size) {
-  LoadKtxTextureResult load_result{};
-  ktxTexture2 *&texture = load_result.texture;
-  KTX_error_code result = ktxTexture2_CreateFromMemory(
-      (ktx_uint8_t *)data, data_size, KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texture);
-  if (result != KTX_SUCCESS) {
-    LERROR("Failed to load KTX texture from memory: {}", ktxErrorString(result));
-    load_result.texture = nullptr;
-    return load_result;
-  }
-  auto transcodable = ktxTexture2_NeedsTranscoding(texture);
-  if (transcodable) {
-    result = ktxTexture2_TranscodeBasis(texture, KTX_TTF_BC7_RGBA, KTX_TF_HIGH_QUALITY);
-    if (result != KTX_SUCCESS) {
-      LERROR("Failed to transcode KTX texture from memory: {}", ktxErrorString(result));
-      goto cleanup_failed_load;
-    }
+}  // namespace
+
+LoadKtxTextureResult load_ktx_texture(const std::filesystem::path &path) {
+  const Result<MappedFile> file = MappedFile::open(path);
+  if (!file) {
+    LERROR("Failed to load KTX texture from {}: {}", path.string(), file.error());
+    return {};
   }
-  load_result.format = convert((VkFormat)texture->vkFormat);
-  return load_result;
-cleanup_failed_load:
-  ktxTexture2_Destroy(texture);
-  load_result.texture = nullptr;
-  return load_result;
+  return load_ktx_from_memory(file->data(), file->size(), path.string());
+}
+
+LoadKtxTextureResult load_ktx_texture(const void *data, size_t data_size) {
+  return load_ktx_from_memory(data, data_size, "memory");
 }
 
 }  // namespace gfx
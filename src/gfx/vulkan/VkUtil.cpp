@@ -186,6 +186,22 @@ void augment_memory_barrier2_stages_for_access(VkPipelineStageFlags2& src_stage,
   }
 }
 
+void restrict_barrier2_to_compute_queue(VkPipelineStageFlags2& stage, VkAccessFlags2& access) {
+  constexpr VkPipelineStageFlags2 k_compute_queue_stages =
+      VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT | VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT |
+      VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT |
+      VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT | VK_PIPELINE_STAGE_2_COPY_BIT |
+      VK_PIPELINE_STAGE_2_CLEAR_BIT | VK_PIPELINE_STAGE_2_HOST_BIT |
+      VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+  if ((stage & ~k_compute_queue_stages) == 0) {
+    return;
+  }
+  stage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+  if (access != VK_ACCESS_2_NONE) {
+    access = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+  }
+}
+
 VkPrimitiveTopology convert_prim_topology(rhi::PrimitiveTopology top) {
   switch (top) {
     default:
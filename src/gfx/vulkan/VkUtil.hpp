@@ -14,6 +14,9 @@ void augment_memory_barrier2_stages_for_access(VkPipelineStageFlags2& src_stage,
                                                VkAccessFlags2 src_access,
                                                VkPipelineStageFlags2& dst_stage,
                                                VkAccessFlags2 dst_access);
+// Compute-queue command buffers may not name graphics stages. Widens such a stage/access pair to
+// ALL_COMMANDS / MEMORY_*; cross-queue ordering itself comes from semaphores.
+void restrict_barrier2_to_compute_queue(VkPipelineStageFlags2& stage, VkAccessFlags2& access);
 VkPrimitiveTopology convert_prim_topology(rhi::PrimitiveTopology top);
 VkCullModeFlags convert(rhi::CullMode cull_mode);
 VkCompareOp convert_compare_op(rhi::CompareOp compare_op);
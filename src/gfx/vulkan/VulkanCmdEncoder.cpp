@@ -2,6 +2,9 @@
 
 #include <volk.h>
 
+#include <algorithm>
+#include <mutex>
+
 #include "core/Config.hpp"
 #include "core/Hash.hpp"
 #include "core/Logger.hpp"
@@ -309,6 +312,7 @@ void VulkanCmdEncoder::bind_pipeline(rhi::PipelineHandle handle) {
       new_desc.rendering = curr_render_target_info_;
       auto h = std::make_tuple(render_target_info_hash, handle.to64());
       auto hash = util::hash::tuple_hash<decltype(h)>()(h);
+      std::scoped_lock lock(device_->encoder_shared_mutex_);
       auto it = device_->all_pipelines_.find(hash);
       if (it == device_->all_pipelines_.end()) {
         auto new_pipeline = device_->create_graphics_pipeline(new_desc);
@@ -602,6 +606,7 @@ uint32_t VulkanCmdEncoder::prepare_indexed_indirect_draws(
   if (push_constant_size > 0) {
     ASSERT(push_constant_data);
   }
+  std::scoped_lock lock(device_->encoder_shared_mutex_);
   auto& slot = device_->indexed_indirect_pc_cache_[curr_frame_i_];
   slot.slots.emplace_back(VulkanDevice::IndexedIndirectPCSlots::Slot{
       .pc = std::vector<uint8_t>(push_constant_size),
@@ -618,9 +623,18 @@ void VulkanCmdEncoder::draw_indexed_indirect(rhi::BufferHandle indirect_buf,
                                              uint32_t indirect_buf_id, size_t draw_cnt,
                                              size_t offset_i) {
   flush_binds();
-  auto& slot = device_->indexed_indirect_pc_cache_[curr_frame_i_];
-  ASSERT(indirect_buf_id < slot.slots.size());
-  const std::vector<uint8_t>& pc = slot.slots[indirect_buf_id].pc;
+  // Copy out under the lock: other encoders may append slots concurrently.
+  std::vector<uint8_t> pc;
+  rhi::BufferHandle index_buf_handle;
+  size_t index_buf_offset{};
+  {
+    std::scoped_lock lock(device_->encoder_shared_mutex_);
+    auto& slot = device_->indexed_indirect_pc_cache_[curr_frame_i_];
+    ASSERT(indirect_buf_id < slot.slots.size());
+    pc = slot.slots[indirect_buf_id].pc;
+    index_buf_handle = slot.slots[indirect_buf_id].index_buf;
+    index_buf_offset = slot.slots[indirect_buf_id].index_buf_offset;
+  }
   if (!pc.empty()) {
     ASSERT(bound_pipeline_);
     ASSERT(bound_pipeline_->layout_);
@@ -630,10 +644,9 @@ void VulkanCmdEncoder::draw_indexed_indirect(rhi::BufferHandle indirect_buf,
   }
   auto* buf = static_cast<VulkanBuffer*>(device_->get_buf(indirect_buf));
   ASSERT(buf);
-  auto* index_buf =
-      static_cast<VulkanBuffer*>(device_->get_buf(slot.slots[indirect_buf_id].index_buf));
+  auto* index_buf = static_cast<VulkanBuffer*>(device_->get_buf(index_buf_handle));
   ASSERT(index_buf);
-  vkCmdBindIndexBuffer(cmd(), index_buf->buffer(), slot.slots[indirect_buf_id].index_buf_offset,
+  vkCmdBindIndexBuffer(cmd(), index_buf->buffer(), index_buf_offset,
                        // TODO: don't hard code u32
                        VK_INDEX_TYPE_UINT32);
   vkCmdSetPrimitiveTopologyEXT(cmd(), VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
@@ -682,6 +695,7 @@ void VulkanCmdEncoder::barrier(rhi::BufferHandle buf, rhi::PipelineStage src_sta
   VkPipelineStageFlags2 dst_st = convert(dst_stage);
   VkAccessFlags2 dst_acc = convert(dst_access);
   augment_memory_barrier2_stages_for_access(src_st, src_acc, dst_st, dst_acc);
+  restrict_barrier_to_queue(src_st, src_acc, dst_st, dst_acc);
   auto* buf_obj = device_->get_buf(buf);
   ASSERT(buf_obj);
   buf_barriers_.emplace_back(VkBufferMemoryBarrier2{
@@ -748,18 +762,19 @@ void VulkanCmdEncoder::barrier(rhi::TextureHandle tex, rhi::PipelineStage src_st
   const bool targets_all_layers = (base_array_layer < 0 || array_layer_count == UINT32_MAX);
   if (old_layout == VK_IMAGE_LAYOUT_UNDEFINED) {
     if (targets_all_layers && base_mip_level < 0) {
-      VkImageLayout uniform = texture->uniform_mip_layout_or_undefined();
+      VkImageLayout uniform = tracked_uniform_mip_layout_or_undefined(texture, tex);
       if (uniform != VK_IMAGE_LAYOUT_UNDEFINED) {
         old_layout = uniform;
       }
     } else if (targets_all_layers) {
-      VkImageLayout ml = texture->mip_layout(base_mip_u);
+      VkImageLayout ml = tracked_mip_layout(texture, tex, base_mip_u);
       if (ml != VK_IMAGE_LAYOUT_UNDEFINED) {
         old_layout = ml;
       }
     }
   }
 
+  restrict_barrier_to_queue(src_st, src_acc, dst_st, dst_acc);
   img_barriers_.emplace_back(VkImageMemoryBarrier2{
       .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
       .srcStageMask = src_st,
@@ -777,16 +792,74 @@ void VulkanCmdEncoder::barrier(rhi::TextureHandle tex, rhi::PipelineStage src_st
   });
   if (new_layout != VK_IMAGE_LAYOUT_UNDEFINED) {
     if (base_mip_level < 0) {
-      texture->set_all_mip_layouts(new_layout);
-    } else if (mip_level_count == UINT32_MAX) {
-      const uint32_t levels = texture->desc().mip_levels;
-      for (uint32_t m = base_mip_u; m < levels; ++m) {
-        texture->set_mip_layout(m, new_layout);
-      }
+      set_tracked_mip_layouts(texture, tex, 0, UINT32_MAX, new_layout);
     } else {
-      for (uint32_t i = 0; i < mip_level_count; ++i) {
-        texture->set_mip_layout(base_mip_u + i, new_layout);
-      }
+      set_tracked_mip_layouts(texture, tex, base_mip_u, mip_level_count, new_layout);
+    }
+  }
+}
+
+void VulkanCmdEncoder::restrict_barrier_to_queue(VkPipelineStageFlags2& src_stage,
+                                                 VkAccessFlags2& src_access,
+                                                 VkPipelineStageFlags2& dst_stage,
+                                                 VkAccessFlags2& dst_access) const {
+  if (queue_type_ == rhi::QueueType::Compute) {
+    restrict_barrier2_to_compute_queue(src_stage, src_access);
+    restrict_barrier2_to_compute_queue(dst_stage, dst_access);
+  }
+}
+
+void VulkanCmdEncoder::set_assumed_layout(rhi::TextureHandle tex, uint32_t base_mip,
+                                          uint32_t mip_count, rhi::ResourceLayout layout) {
+  ASSERT(in_parallel_batch_);
+  const VkImageLayout vk_layout = convert(layout);
+  auto* texture = (VulkanTexture*)device_->get_tex(tex);
+  if (!texture || vk_layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+    return;
+  }
+  set_tracked_mip_layouts(texture, tex, base_mip, mip_count, vk_layout);
+}
+
+VkImageLayout VulkanCmdEncoder::tracked_mip_layout(VulkanTexture* tex, rhi::TextureHandle handle,
+                                                   uint32_t mip) const {
+  if (in_parallel_batch_) {
+    auto it = parallel_layouts_.find(TrackedLayoutKey{.tex = handle.to64(), .mip = mip});
+    if (it != parallel_layouts_.end()) {
+      return it->second;
+    }
+  }
+  return tex->mip_layout(mip);
+}
+
+VkImageLayout VulkanCmdEncoder::tracked_uniform_mip_layout_or_undefined(
+    VulkanTexture* tex, rhi::TextureHandle handle) const {
+  if (!in_parallel_batch_) {
+    return tex->uniform_mip_layout_or_undefined();
+  }
+  const uint32_t levels = tex->desc().mip_levels;
+  if (levels == 0) {
+    return VK_IMAGE_LAYOUT_UNDEFINED;
+  }
+  const VkImageLayout u = tracked_mip_layout(tex, handle, 0);
+  for (uint32_t m = 1; m < levels; ++m) {
+    if (tracked_mip_layout(tex, handle, m) != u) {
+      return VK_IMAGE_LAYOUT_UNDEFINED;
+    }
+  }
+  return u;
+}
+
+void VulkanCmdEncoder::set_tracked_mip_layouts(VulkanTexture* tex, rhi::TextureHandle handle,
+                                               uint32_t base_mip, uint32_t mip_count,
+                                               VkImageLayout layout) {
+  const uint32_t levels = tex->desc().mip_levels;
+  const uint32_t end_mip =
+      mip_count == UINT32_MAX ? levels : std::min(levels, base_mip + mip_count);
+  for (uint32_t m = base_mip; m < end_mip; ++m) {
+    if (in_parallel_batch_) {
+      parallel_layouts_[TrackedLayoutKey{.tex = handle.to64(), .mip = m}] = layout;
+    } else {
+      tex->set_mip_layout(m, layout);
     }
   }
 }
@@ -824,13 +897,30 @@ void VulkanCmdEncoder::flush_barriers() {
 }
 
 void VulkanCmdEncoder::barrier(rhi::GPUBarrier* gpu_barrier, size_t barrier_count) {
+  // Everything lands in buf_barriers_ / img_barriers_, emitted as one vkCmdPipelineBarrier2 by the
+  // next flush_barriers().
   for (size_t i = 0; i < barrier_count; i++) {
     auto& gpu_barr = gpu_barrier[i];
+    if (gpu_barr.has_sync) {
+      const auto& s = gpu_barr.sync;
+      if (gpu_barr.type == rhi::GPUBarrier::Type::Buffer) {
+        barrier(gpu_barr.buf.buffer, s.src_stage, s.src_access, s.dst_stage, s.dst_access,
+                gpu_barr.buf.offset,
+                gpu_barr.buf.size == SIZE_MAX ? VK_WHOLE_SIZE : gpu_barr.buf.size);
+      } else {
+        barrier(gpu_barr.tex.texture, s.src_stage, s.src_access, s.dst_stage, s.dst_access,
+                s.src_layout, s.dst_layout, static_cast<int32_t>(gpu_barr.tex.mip),
+                static_cast<int32_t>(gpu_barr.tex.slice), gpu_barr.tex.mip_level_count,
+                gpu_barr.tex.array_layer_count);
+      }
+      continue;
+    }
     if (gpu_barr.type == rhi::GPUBarrier::Type::Buffer) {
       auto& buf_barr = gpu_barr.buf;
       auto [src_stage, src_access] = convert_pipeline_stage_and_access(buf_barr.src_state);
       auto [dst_stage, dst_access] = convert_pipeline_stage_and_access(buf_barr.dst_state);
       augment_memory_barrier2_stages_for_access(src_stage, src_access, dst_stage, dst_access);
+      restrict_barrier_to_queue(src_stage, src_access, dst_stage, dst_access);
       buf_barriers_.emplace_back(VkBufferMemoryBarrier2{
           .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
           .srcStageMask = src_stage,
@@ -846,6 +936,7 @@ void VulkanCmdEncoder::barrier(rhi::GPUBarrier* gpu_barrier, size_t barrier_coun
       auto [src_stage, src_access] = convert_pipeline_stage_and_access(img_barr.src_layout);
       auto [dst_stage, dst_access] = convert_pipeline_stage_and_access(img_barr.dst_layout);
       augment_memory_barrier2_stages_for_access(src_stage, src_access, dst_stage, dst_access);
+      restrict_barrier_to_queue(src_stage, src_access, dst_stage, dst_access);
       const VkImageLayout new_layout = convert_layout(img_barr.dst_layout);
       img_barriers_.emplace_back(VkImageMemoryBarrier2{
           .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
@@ -874,21 +965,37 @@ void VulkanCmdEncoder::barrier(rhi::GPUBarrier* gpu_barrier, size_t barrier_coun
       });
       auto* vk_tex = (VulkanTexture*)device_->get_tex(img_barr.texture);
       if (img_barr.mip == rhi::k_gpu_barrier_mip_all) {
-        vk_tex->set_all_mip_layouts(new_layout);
+        set_tracked_mip_layouts(vk_tex, img_barr.texture, 0, UINT32_MAX, new_layout);
       } else if (img_barr.mip_level_count == rhi::k_gpu_barrier_mip_all) {
-        const uint32_t levels = vk_tex->desc().mip_levels;
-        for (uint32_t m = img_barr.mip; m < levels; ++m) {
-          vk_tex->set_mip_layout(m, new_layout);
-        }
+        set_tracked_mip_layouts(vk_tex, img_barr.texture, img_barr.mip, UINT32_MAX, new_layout);
       } else {
-        for (uint32_t i = 0; i < img_barr.mip_level_count; ++i) {
-          vk_tex->set_mip_layout(img_barr.mip + i, new_layout);
-        }
+        set_tracked_mip_layouts(vk_tex, img_barr.texture, img_barr.mip, img_barr.mip_level_count,
+                                new_layout);
       }
     }
   }
 }
 
+void VulkanCmdEncoder::write_timestamp(rhi::QueryPoolHandle query_pool, uint32_t query_index) {
+  auto* pool = device_->get_vk_query_pool(query_pool);
+  ASSERT(pool);
+  ASSERT(query_index < pool->count_);
+  vkCmdWriteTimestamp2KHR(cmd(), VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, pool->pool_, query_index);
+}
+
+void VulkanCmdEncoder::query_resolve(rhi::QueryPoolHandle query_pool, uint32_t start_query,
+                                     uint32_t query_count, rhi::BufferHandle dst_buffer,
+                                     size_t dst_offset) {
+  flush_barriers();
+  auto* pool = device_->get_vk_query_pool(query_pool);
+  auto* buf = device_->get_vk_buf(dst_buffer);
+  ASSERT(pool && buf);
+  ASSERT(start_query + query_count <= pool->count_);
+  vkCmdCopyQueryPoolResults(cmd(), pool->pool_, start_query, query_count, buf->buffer(),
+                            dst_offset, sizeof(uint64_t),
+                            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+}
+
 void VulkanCmdEncoder::bind_uav(rhi::TextureHandle texture, uint32_t slot, int subresource_id) {
   binding_table_.UAV[slot] = texture.to64();
   binding_table_.UAV_subresources[slot] = subresource_id;
@@ -2,6 +2,8 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <unordered_map>
+
 #include "core/Config.hpp"
 #include "core/Logger.hpp"
 #include "gfx/rhi/CmdEncoder.hpp"
@@ -15,6 +17,7 @@ namespace TENG_NAMESPACE {
 namespace gfx::vk {
 class VulkanDevice;
 class VulkanPipeline;
+class VulkanTexture;
 
 struct DescriptorBinderPool {
   VkDescriptorPool pool{};
@@ -94,6 +97,8 @@ class VulkanCmdEncoder : public rhi::CmdEncoder {
                size_t size) override;
 
   void barrier(rhi::GPUBarrier* gpu_barrier, size_t barrier_count) override;
+  void set_assumed_layout(rhi::TextureHandle tex, uint32_t base_mip, uint32_t mip_count,
+                          rhi::ResourceLayout layout) override;
 
   void draw_indexed_indirect(rhi::BufferHandle indirect_buf, uint32_t indirect_buf_id,
                              size_t draw_cnt, size_t offset_i) override;
@@ -121,11 +126,10 @@ class VulkanCmdEncoder : public rhi::CmdEncoder {
   void bind_cbv(rhi::BufferHandle buffer, uint32_t slot, size_t offset_bytes,
                 size_t size_bytes) override;
 
-  void write_timestamp(rhi::QueryPoolHandle /*query_pool*/, uint32_t /*query_index*/) override {}
+  void write_timestamp(rhi::QueryPoolHandle query_pool, uint32_t query_index) override;
 
-  void query_resolve(rhi::QueryPoolHandle /*query_pool*/, uint32_t /*start_query*/,
-                     uint32_t /*query_count*/, rhi::BufferHandle /*dst_buffer*/,
-                     size_t /*dst_offset*/) override {}
+  void query_resolve(rhi::QueryPoolHandle query_pool, uint32_t start_query, uint32_t query_count,
+                     rhi::BufferHandle dst_buffer, size_t dst_offset) override;
 
  private:
   friend class VulkanDevice;
@@ -133,8 +137,22 @@ class VulkanCmdEncoder : public rhi::CmdEncoder {
   void flush_barriers();
   void flush_binds();
   [[nodiscard]] VkPipelineBindPoint get_bound_pipeline_bind_point() const;
+  void restrict_barrier_to_queue(VkPipelineStageFlags2& src_stage, VkAccessFlags2& src_access,
+                                 VkPipelineStageFlags2& dst_stage,
+                                 VkAccessFlags2& dst_access) const;
+  // Tracked mip layouts: read through / write to the texture, or to parallel_layouts_ while this
+  // encoder is part of a parallel batch.
+  [[nodiscard]] VkImageLayout tracked_mip_layout(VulkanTexture* tex, rhi::TextureHandle handle,
+                                                 uint32_t mip) const;
+  [[nodiscard]] VkImageLayout tracked_uniform_mip_layout_or_undefined(
+      VulkanTexture* tex, rhi::TextureHandle handle) const;
+  void set_tracked_mip_layouts(VulkanTexture* tex, rhi::TextureHandle handle, uint32_t base_mip,
+                               uint32_t mip_count, VkImageLayout layout);
 
   size_t curr_frame_i_{};
+  // One pool per encoder so encoders can be recorded on different threads.
+  VkCommandPool cmd_pools_[k_max_frames_in_flight]{};
+  uint32_t cmd_pool_family_idx_[k_max_frames_in_flight]{};
   VkCommandBuffer cmd_bufs_[k_max_frames_in_flight];
   VulkanPipeline* bound_pipeline_{};
   VulkanDevice* device_{};
@@ -155,6 +173,29 @@ class VulkanCmdEncoder : public rhi::CmdEncoder {
   std::vector<VkImageMemoryBarrier2> render_pass_end_img_barriers_;
 
   rhi::QueueType queue_type_{};
+  // Cross-queue sync (VulkanDevice::cmd_encoder_wait_for), resolved to timeline values at submit.
+  size_t submit_idx_{};
+  bool signals_timeline_{};
+  uint64_t signal_value_{};
+  std::vector<size_t> wait_for_encoders_;
+
+  // Set between begin_parallel_cmd_encoders and end_parallel_cmd_encoders. Layout changes stay
+  // local to the encoder (keyed by texture handle, mip) and are applied to the textures in
+  // submission order when the batch ends, so concurrent recording never touches shared tracking.
+  // Textures changed by earlier encoders of the batch read stale from the texture unless seeded
+  // with set_assumed_layout.
+  bool in_parallel_batch_{};
+  struct TrackedLayoutKey {
+    uint64_t tex;
+    uint32_t mip;
+    bool operator==(const TrackedLayoutKey&) const = default;
+  };
+  struct TrackedLayoutKeyHash {
+    size_t operator()(const TrackedLayoutKey& k) const {
+      return std::hash<uint64_t>{}(k.tex ^ (static_cast<uint64_t>(k.mip) << 58));
+    }
+  };
+  std::unordered_map<TrackedLayoutKey, VkImageLayout, TrackedLayoutKeyHash> parallel_layouts_;
 };
 
 }  // namespace gfx::vk
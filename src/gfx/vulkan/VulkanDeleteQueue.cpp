@@ -35,6 +35,8 @@ void DeleteQueue::flush(size_t frame_num) {
   });
   flush_queue(samplers_,
               [this](VkSampler sampler) { vkDestroySampler(device_, sampler, nullptr); });
+  flush_queue(query_pools_,
+              [this](VkQueryPool pool) { vkDestroyQueryPool(device_, pool, nullptr); });
 }
 
 }  // namespace gfx::vk
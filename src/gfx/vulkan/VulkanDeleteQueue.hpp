@@ -43,6 +43,7 @@ struct DeleteQueue {
   void enqueue(ImgEntry entry) { images_.emplace(entry, curr_frame_); }
   void enqueue(BufferEntry entry) { buffers_.emplace(entry, curr_frame_); }
   void enqueue(VkSampler entry) { samplers_.emplace(entry, curr_frame_); }
+  void enqueue(VkQueryPool entry) { query_pools_.emplace(entry, curr_frame_); }
 
  private:
   VmaAllocator allocator_{};
@@ -56,6 +57,7 @@ struct DeleteQueue {
   std::queue<Entry<ImgEntry>> images_;
   std::queue<Entry<BufferEntry>> buffers_;
   std::queue<Entry<VkSampler>> samplers_;
+  std::queue<Entry<VkQueryPool>> query_pools_;
 };
 
 }  // namespace gfx::vk
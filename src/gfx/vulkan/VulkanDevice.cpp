@@ -7,7 +7,6 @@
 #include <format>
 #include <fstream>
 #include <mutex>
-#include <tracy/Tracy.hpp>
 // clang-format on
 
 #include "VMAWrapper.hpp"  // IWYU pragma: keep
@@ -17,6 +16,7 @@
 #include "core/EAssert.hpp"
 #include "core/Hash.hpp"
 #include "core/Logger.hpp"
+#include "core/Profiler.hpp"
 #include "core/Util.hpp"
 #include "gfx/rhi/GFXTypes.hpp"
 #include "gfx/rhi/Texture.hpp"
@@ -272,10 +272,9 @@ vk_debug_callback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
   const char* ms = vkb::to_string_message_severity(messageSeverity);
   const char* mt = vkb::to_string_message_type(messageType);
   if (messageType & VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT) {
-    std::println("[{}: {}] - {}\n{}", ms, mt, pCallbackData->pMessageIdName,
-                 pCallbackData->pMessage);
+    LINFO("[{}: {}] - {}\n{}", ms, mt, pCallbackData->pMessageIdName, pCallbackData->pMessage);
   } else {
-    std::println("[{}: {}]\n{}", ms, mt, pCallbackData->pMessage);
+    LINFO("[{}: {}]\n{}", ms, mt, pCallbackData->pMessage);
   }
   if (messageSeverity & VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT) {
     ALWAYS_ASSERT(0);
@@ -342,6 +341,9 @@ void VulkanDevice::shutdown() {
   for (auto& cmd : cmd_encoders_) {
     for (uint32_t pool_i = 0; pool_i < frames_in_flight(); pool_i++) {
       cmd->binder_pools_[pool_i].destroy(*this);
+      if (cmd->cmd_pools_[pool_i]) {
+        vkDestroyCommandPool(device_, cmd->cmd_pools_[pool_i], nullptr);
+      }
     }
   }
   for (auto& [a, pipeline] : all_pipelines_) {
@@ -365,10 +367,12 @@ void VulkanDevice::shutdown() {
       vkDestroyFence(device_, frame_fence[frame_i], nullptr);
     }
   }
-
-  for (size_t i = 0; i < info_.frames_in_flight; i++) {
-    vkDestroyCommandPool(device_, command_pools_[i], nullptr);
+  for (auto& queue : queues_) {
+    if (queue.timeline) {
+      vkDestroySemaphore(device_, queue.timeline, nullptr);
+    }
   }
+
   vmaDestroyAllocator(allocator_);
   vkDestroyDevice(device_, nullptr);
   vkb::destroy_instance(vkb_inst_);
@@ -430,6 +434,8 @@ void VulkanDevice::init(const InitInfo& init_info) {
   feat12.descriptorBindingVariableDescriptorCount = VK_TRUE;
   feat12.runtimeDescriptorArray = VK_TRUE;
   feat12.scalarBlockLayout = VK_TRUE;
+  feat12.timelineSemaphore = VK_TRUE;
+  feat12.hostQueryReset = VK_TRUE;
   phys_device_selector.set_required_features_12(feat12);
 
   VkPhysicalDeviceVulkan13Features feat13{
@@ -498,6 +504,11 @@ void VulkanDevice::init(const InitInfo& init_info) {
         break;
     }
     LINFO("  Device Type: {}", deviceTypeStr);
+    // timestampPeriod is nanoseconds per tick.
+    if (props.limits.timestampComputeAndGraphics && props.limits.timestampPeriod > 0.f) {
+      info_.timestamp_frequency =
+          static_cast<size_t>(1'000'000'000.0 / static_cast<double>(props.limits.timestampPeriod));
+    }
   }
 
   vkb::DeviceBuilder device_builder{phys_ret.value()};
@@ -512,6 +523,7 @@ void VulkanDevice::init(const InitInfo& init_info) {
     const auto& queue_family = vkb_device_.queue_families[i];
     if (queue_family.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
       vkGetDeviceQueue(device_, i, 0, &queues_[(int)rhi::QueueType::Graphics].queue);
+      queues_[(int)rhi::QueueType::Graphics].family_idx = i;
       queue_family_indices_.push_back(i);
       found_graphics_queue = true;
       break;
@@ -523,6 +535,40 @@ void VulkanDevice::init(const InitInfo& init_info) {
     exit(1);
   }
 
+  // A compute-only family runs independently of graphics (async compute). Only requested when
+  // enabled: resources shared with it need concurrent sharing (SharedAcrossQueues).
+  for (uint32_t i = 0; init_info.async_compute &&
+                       i < static_cast<uint32_t>(vkb_device_.queue_families.size());
+       i++) {
+    const auto& queue_family = vkb_device_.queue_families[i];
+    if ((queue_family.queueFlags & VK_QUEUE_COMPUTE_BIT) &&
+        !(queue_family.queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+      auto& compute_queue = queues_[(int)rhi::QueueType::Compute];
+      vkGetDeviceQueue(device_, i, 0, &compute_queue.queue);
+      compute_queue.family_idx = i;
+      queue_family_indices_.push_back(i);
+      capabilities_ |= rhi::GraphicsCapability::AsyncCompute;
+      LINFO("Async compute queue family: {}", i);
+      break;
+    }
+  }
+
+  for (auto& queue : queues_) {
+    if (!queue.is_valid()) {
+      continue;
+    }
+    VkSemaphoreTypeCreateInfo type_cinfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = 0,
+    };
+    VkSemaphoreCreateInfo sem_cinfo{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &type_cinfo,
+    };
+    VK_CHECK(vkCreateSemaphore(device_, &sem_cinfo, nullptr, &queue.timeline));
+  }
+
   for (auto& frame_fence : frame_fences_) {
     for (size_t frame_i = 0; frame_i < info_.frames_in_flight; frame_i++) {
       VkFenceCreateInfo fence_cinfo{
@@ -551,6 +597,7 @@ void VulkanDevice::init(const InitInfo& init_info) {
       }
     }
   }
+  capabilities_ |= rhi::GraphicsCapability::ParallelCmdEncoding;
 
   VmaVulkanFunctions vma_funcs{};
   vma_funcs.vkGetInstanceProcAddr = vkGetInstanceProcAddr;
@@ -584,15 +631,6 @@ void VulkanDevice::init(const InitInfo& init_info) {
 
   volkLoadDevice(device_);
 
-  for (size_t i = 0; i < info_.frames_in_flight; i++) {
-    VkCommandPoolCreateInfo cinfo{
-        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
-        .queueFamilyIndex = queues_[(int)rhi::QueueType::Graphics].family_idx,
-    };
-    VK_CHECK(vkCreateCommandPool(device_, &cinfo, nullptr, &command_pools_[i]));
-  }
-
   del_q_.init(device_, allocator_, info_.frames_in_flight);
   {
     auto add_immutable_sampler = [&](const rhi::SamplerDesc& desc) {
@@ -690,13 +728,14 @@ rhi::SamplerHandle VulkanDevice::create_sampler(const rhi::SamplerDesc& desc) {
 }
 
 rhi::BufferHandle VulkanDevice::create_buf(const rhi::BufferDesc& desc) {
+  const bool concurrent = queue_family_indices_.size() > 1 &&
+                          has_flag(desc.flags, rhi::BufferDescFlags::SharedAcrossQueues);
   VkBufferCreateInfo cinfo{
       .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
       .size = desc.size,
-      .sharingMode = queue_family_indices_.size() == 1 ? VK_SHARING_MODE_EXCLUSIVE
-                                                       : VK_SHARING_MODE_CONCURRENT,
-      .queueFamilyIndexCount = (uint32_t)queue_family_indices_.size(),
-      .pQueueFamilyIndices = queue_family_indices_.data(),
+      .sharingMode = concurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
+      .queueFamilyIndexCount = concurrent ? (uint32_t)queue_family_indices_.size() : 0,
+      .pQueueFamilyIndices = concurrent ? queue_family_indices_.data() : nullptr,
   };
   if (has_flag(desc.usage, rhi::BufferUsage::Index)) {
     cinfo.usage |= VK_BUFFER_USAGE_2_INDEX_BUFFER_BIT;
@@ -779,7 +818,16 @@ rhi::TextureHandle VulkanDevice::create_tex(const rhi::TextureDesc& desc) {
   cinfo.samples = VK_SAMPLE_COUNT_1_BIT;
   cinfo.tiling = VK_IMAGE_TILING_OPTIMAL;
   cinfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-  cinfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  // Exclusive unless the image is used on both queues: concurrent sharing can cost compression,
+  // and exclusive images never change queue family ownership here.
+  if (queue_family_indices_.size() > 1 &&
+      has_flag(desc.flags, rhi::TextureDescFlags::SharedAcrossQueues)) {
+    cinfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+    cinfo.queueFamilyIndexCount = (uint32_t)queue_family_indices_.size();
+    cinfo.pQueueFamilyIndices = queue_family_indices_.data();
+  } else {
+    cinfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  }
   cinfo.usage = convert(desc.usage);
   cinfo.usage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
 
@@ -980,31 +1028,47 @@ void VulkanDevice::destroy(rhi::TextureHandle tex_handle, int tex_view_handle) {
 }
 
 rhi::CmdEncoder* VulkanDevice::begin_cmd_encoder(rhi::QueueType queue_type) {
+  if (!queues_[(int)queue_type].is_valid()) {
+    // No dedicated copy / compute queue: the graphics queue runs it in submission order.
+    queue_type = rhi::QueueType::Graphics;
+  }
   if (curr_cmd_encoder_i_ >= cmd_encoders_.size()) {
     // TODO: pipeline layout
-    auto& enc = cmd_encoders_.emplace_back(std::make_unique<VulkanCmdEncoder>(this));
-
-    for (size_t i = 0; i < frames_in_flight(); i++) {
-      VkCommandBufferAllocateInfo info{
-          .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-          .commandPool = command_pools_[i],
-          .commandBufferCount = 1,
-      };
-      VK_CHECK(vkAllocateCommandBuffers(device_, &info, &enc->cmd_bufs_[i]));
-    }
+    cmd_encoders_.emplace_back(std::make_unique<VulkanCmdEncoder>(this));
   }
 
   auto& enc = *cmd_encoders_[curr_cmd_encoder_i_];
   enc.curr_frame_i_ = frame_idx();
+  // Pools are per family. This frame slot's previous submission has retired, so its pool can be
+  // recreated if the encoder at this index moved to another queue.
+  const uint32_t family_idx = queues_[(int)queue_type].family_idx;
+  if (!enc.cmd_pools_[enc.curr_frame_i_] ||
+      enc.cmd_pool_family_idx_[enc.curr_frame_i_] != family_idx) {
+    if (enc.cmd_pools_[enc.curr_frame_i_]) {
+      vkDestroyCommandPool(device_, enc.cmd_pools_[enc.curr_frame_i_], nullptr);
+    }
+    VkCommandPoolCreateInfo cinfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .queueFamilyIndex = family_idx,
+    };
+    VK_CHECK(vkCreateCommandPool(device_, &cinfo, nullptr, &enc.cmd_pools_[enc.curr_frame_i_]));
+    enc.cmd_pool_family_idx_[enc.curr_frame_i_] = family_idx;
+    VkCommandBufferAllocateInfo info{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = enc.cmd_pools_[enc.curr_frame_i_],
+        .commandBufferCount = 1,
+    };
+    VK_CHECK(vkAllocateCommandBuffers(device_, &info, &enc.cmd_bufs_[enc.curr_frame_i_]));
+  }
   enc.submit_swapchains_.clear();
+  enc.in_parallel_batch_ = false;
+  enc.submit_idx_ = curr_cmd_encoder_i_;
+  enc.signals_timeline_ = false;
+  enc.wait_for_encoders_.clear();
   if (curr_cmd_encoder_i_ == 0) {
     indexed_indirect_pc_cache_[frame_idx()].slots.clear();
   }
-  static int i = 0;
-  if (i++ == 0) {
-    LWARN("Copy queue not supported yet, defaulting to graphics queue");
-    queue_type = rhi::QueueType::Graphics;
-  }
   enc.queue_type_ = queue_type;
 
   if (!enc.binder_pools_[enc.curr_frame_i_].pool) {
@@ -1031,6 +1095,32 @@ rhi::CmdEncoder* VulkanDevice::begin_cmd_encoder(rhi::QueueType queue_type) {
   return &enc;
 }
 
+void VulkanDevice::begin_parallel_cmd_encoders(std::span<const rhi::QueueType> queue_types,
+                                               std::span<rhi::CmdEncoder*> out) {
+  ASSERT(queue_types.size() == out.size());
+  for (size_t i = 0; i < out.size(); i++) {
+    out[i] = begin_cmd_encoder(queue_types[i]);
+    auto* vk_enc = static_cast<VulkanCmdEncoder*>(out[i]);
+    vk_enc->in_parallel_batch_ = true;
+    vk_enc->parallel_layouts_.clear();
+  }
+}
+
+void VulkanDevice::end_parallel_cmd_encoders(std::span<rhi::CmdEncoder* const> encoders) {
+  // Apply each encoder's layout changes in submission order so tracking matches the GPU timeline.
+  for (rhi::CmdEncoder* enc : encoders) {
+    auto* vk_enc = static_cast<VulkanCmdEncoder*>(enc);
+    ASSERT(vk_enc->in_parallel_batch_);
+    for (const auto& [key, layout] : vk_enc->parallel_layouts_) {
+      if (auto* tex = (VulkanTexture*)get_tex(rhi::TextureHandle{key.tex})) {
+        tex->set_mip_layout(key.mip, layout);
+      }
+    }
+    vk_enc->parallel_layouts_.clear();
+    vk_enc->in_parallel_batch_ = false;
+  }
+}
+
 rhi::PipelineHandle VulkanDevice::create_graphics_pipeline(
     const rhi::GraphicsPipelineCreateInfo& info) {
   std::array<VkPipelineShaderStageCreateInfo, 3> stages;
@@ -1244,12 +1334,35 @@ rhi::PipelineHandle VulkanDevice::create_graphics_pipeline(
 
 void VulkanDevice::submit_frame() {
   ZoneScoped;
-  // submit queues
+  // Encoders are submitted in begin order. Consecutive encoders on one queue share a
+  // vkQueueSubmit2; switching queues flushes the pending batch first, so a timeline signal is
+  // always submitted before any cross-queue wait on it.
+  int pending_queue = -1;
   for (size_t cmd_enc_i = 0; cmd_enc_i < curr_cmd_encoder_i_; cmd_enc_i++) {
     auto& enc = *cmd_encoders_[cmd_enc_i];
     ASSERT(enc.queue_type_ != rhi::QueueType::Copy);
     auto& queue = queues_[(int)enc.queue_type_];
     ASSERT(queue.is_valid());
+    if (pending_queue != -1 && pending_queue != (int)enc.queue_type_) {
+      queues_[pending_queue].submit(VK_NULL_HANDLE);
+    }
+    pending_queue = (int)enc.queue_type_;
+
+    // A wait or signal needs its own VkSubmitInfo2 boundary.
+    if (!enc.wait_for_encoders_.empty() && !queue.submit_cmd_bufs.empty()) {
+      queue.submit(VK_NULL_HANDLE);
+    }
+    for (size_t wait_idx : enc.wait_for_encoders_) {
+      ASSERT(wait_idx < cmd_enc_i);
+      const auto& signaler = *cmd_encoders_[wait_idx];
+      ASSERT(signaler.signal_value_ != 0);
+      queue.wait_semaphores.emplace_back(VkSemaphoreSubmitInfo{
+          .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+          .semaphore = queues_[(int)signaler.queue_type_].timeline,
+          .value = signaler.signal_value_,
+          .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+      });
+    }
 
     queue.submit_cmd_bufs.emplace_back(VkCommandBufferSubmitInfo{
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
@@ -1274,6 +1387,18 @@ void VulkanDevice::submit_frame() {
       queue.present_wait_semaphores.emplace_back(
           swapchain.ready_to_present_semaphores_[swapchain.curr_img_idx_]);
     }
+
+    enc.signal_value_ = 0;
+    if (enc.signals_timeline_) {
+      enc.signal_value_ = ++queue.timeline_value;
+      queue.signal_semaphores.emplace_back(VkSemaphoreSubmitInfo{
+          .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+          .semaphore = queue.timeline,
+          .value = enc.signal_value_,
+          .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+      });
+      queue.submit(VK_NULL_HANDLE);
+    }
   }
 
   for (size_t queue_t = 0; queue_t < (size_t)rhi::QueueType::Count; queue_t++) {
@@ -1393,6 +1518,50 @@ void VulkanDevice::destroy(rhi::SamplerHandle handle) {
   sampler_pool_.destroy(handle);
 }
 
+rhi::QueryPoolHandle VulkanDevice::create_query_pool(const rhi::QueryPoolDesc& desc) {
+  ALWAYS_ASSERT(desc.count > 0);
+  const VkQueryPoolCreateInfo cinfo{
+      .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+      .queryType = VK_QUERY_TYPE_TIMESTAMP,
+      .queryCount = desc.count,
+  };
+  VkQueryPool pool{};
+  VK_CHECK(vkCreateQueryPool(device_, &cinfo, nullptr, &pool));
+  // Queries start out undefined; reset them so the first resolve sees them as unavailable.
+  vkResetQueryPool(device_, pool, 0, desc.count);
+  if (!desc.name.empty()) {
+    set_vk_debug_name(VK_OBJECT_TYPE_QUERY_POOL, (uint64_t)pool, desc.name.c_str());
+  }
+  return query_pool_pool_.alloc(pool, desc.count);
+}
+
+void VulkanDevice::destroy(rhi::QueryPoolHandle handle) {
+  auto* pool = query_pool_pool_.get(handle);
+  if (pool) {
+    del_q_.enqueue(pool->pool_);
+  }
+  query_pool_pool_.destroy(handle);
+}
+
+void VulkanDevice::resolve_query_data(rhi::QueryPoolHandle query_pool, uint32_t start_query,
+                                      uint32_t query_count, std::span<uint64_t> out_timestamps) {
+  auto* pool = query_pool_pool_.get(query_pool);
+  ASSERT(pool);
+  ASSERT(start_query + query_count <= pool->count_);
+  ASSERT(out_timestamps.size() >= query_count);
+  // (value, availability) pairs, so unfinished queries don't make this wait.
+  std::vector<uint64_t> results(size_t{query_count} * 2);
+  const VkResult res = vkGetQueryPoolResults(
+      device_, pool->pool_, start_query, query_count, results.size() * sizeof(uint64_t),
+      results.data(), 2 * sizeof(uint64_t),
+      VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+  ASSERT(res == VK_SUCCESS || res == VK_NOT_READY);
+  for (uint32_t i = 0; i < query_count; i++) {
+    out_timestamps[i] = results[(i * 2) + 1] ? results[i * 2] : 0;
+  }
+  vkResetQueryPool(device_, pool->pool_, start_query, query_count);
+}
+
 VkImageView VulkanDevice::create_img_view(VulkanTexture& img, VkImageViewType type,
                                           const VkImageSubresourceRange& subresource_range) {
   VkImageViewCreateInfo cinfo;
@@ -1510,8 +1679,17 @@ std::string to_string(VkPresentModeKHR present_mode) {
 
 }  // namespace
 
-void VulkanDevice::cmd_encoder_wait_for(rhi::CmdEncoder* /*cmd_enc_first*/,
-                                        rhi::CmdEncoder* /*cmd_enc_second*/) {}
+void VulkanDevice::cmd_encoder_wait_for(rhi::CmdEncoder* cmd_enc_first,
+                                        rhi::CmdEncoder* cmd_enc_second) {
+  auto* first = (VulkanCmdEncoder*)cmd_enc_first;
+  auto* second = (VulkanCmdEncoder*)cmd_enc_second;
+  ASSERT(first->submit_idx_ < second->submit_idx_);
+  if (first->queue_type_ == second->queue_type_) {
+    return;  // same queue: submission order already covers it
+  }
+  first->signals_timeline_ = true;
+  second->wait_for_encoders_.push_back(first->submit_idx_);
+}
 
 bool VulkanDevice::recreate_swapchain(const rhi::SwapchainDesc& desc, rhi::Swapchain* swap) {
   auto* swapchain = (VulkanSwapchain*)swap;
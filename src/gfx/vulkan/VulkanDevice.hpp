@@ -18,6 +18,7 @@
 #include "gfx/vulkan/VulkanCmdEncoder.hpp"
 #include "gfx/vulkan/VulkanDeleteQueue.hpp"
 #include "gfx/vulkan/VulkanPipeline.hpp"
+#include "gfx/vulkan/VulkanQueryPool.hpp"
 #include "gfx/vulkan/VulkanSampler.hpp"
 #include "gfx/vulkan/VulkanSwapchain.hpp"
 #include "gfx/vulkan/VulkanTexture.hpp"
@@ -46,10 +47,7 @@ class VulkanDevice : public rhi::Device {
                                          uint32_t level_count, uint32_t base_array_layer,
                                          uint32_t layer_count) override;
 
-  rhi::QueryPoolHandle create_query_pool([[maybe_unused]] const rhi::QueryPoolDesc& desc) override {
-    LERROR("VulkanDevice::create_query_pool not implemented");
-    return {};
-  }
+  rhi::QueryPoolHandle create_query_pool(const rhi::QueryPoolDesc& desc) override;
 
   rhi::Texture* get_tex(rhi::TextureHandle handle) override { return texture_pool_.get(handle); }
   rhi::Buffer* get_buf(rhi::BufferHandle handle) override { return buffer_pool_.get(handle); }
@@ -75,9 +73,7 @@ class VulkanDevice : public rhi::Device {
   void destroy(rhi::SamplerHandle handle) override;
   void destroy(rhi::SwapchainHandle handle) override;
   void destroy(rhi::TextureHandle tex_handle, int tex_view_handle) override;
-  void destroy([[maybe_unused]] rhi::QueryPoolHandle handle) override {
-    LERROR("VulkanDevice::destroy(QueryPoolHandle) not implemented");
-  }
+  void destroy(rhi::QueryPoolHandle handle) override;
 
   rhi::PipelineHandle create_graphics_pipeline(
       const rhi::GraphicsPipelineCreateInfo& cinfo) override;
@@ -99,6 +95,9 @@ class VulkanDevice : public rhi::Device {
   [[nodiscard]] rhi::GpuAdapterInfo query_gpu_adapter_info() const override;
 
   rhi::CmdEncoder* begin_cmd_encoder(rhi::QueueType queue_type) override;
+  void begin_parallel_cmd_encoders(std::span<const rhi::QueueType> queue_types,
+                                   std::span<rhi::CmdEncoder*> out) override;
+  void end_parallel_cmd_encoders(std::span<rhi::CmdEncoder* const> encoders) override;
   void submit_frame() override;
   void immediate_submit(rhi::QueueType, ImmediateSubmitFn&&) override { ASSERT(0); }
 
@@ -111,11 +110,10 @@ class VulkanDevice : public rhi::Device {
   void begin_swapchain_rendering(rhi::Swapchain* swapchain, rhi::CmdEncoder* cmd_enc,
                                  glm::vec4* clear_color) override;
   void acquire_next_swapchain_image(rhi::Swapchain* swapchain) override;
-  void resolve_query_data(rhi::QueryPoolHandle /*query_pool*/, uint32_t /*start_query*/,
-                          uint32_t /*query_count*/,
-                          std::span<uint64_t> /*out_timestamps*/) override {
-    // ASSERT(0);
-  }
+  // Non-blocking: queries the GPU hasn't written yet read as 0. Resolved queries are reset on the
+  // host so they can be written again.
+  void resolve_query_data(rhi::QueryPoolHandle query_pool, uint32_t start_query,
+                          uint32_t query_count, std::span<uint64_t> out_timestamps) override;
 
   [[nodiscard]] void* get_native_device() const override { return device_; }
 
@@ -127,6 +125,9 @@ class VulkanDevice : public rhi::Device {
   VulkanBuffer* get_vk_buf(rhi::BufferHandle handle) {
     return static_cast<VulkanBuffer*>(get_buf(handle));
   }
+  VulkanQueryPool* get_vk_query_pool(rhi::QueryPoolHandle handle) {
+    return query_pool_pool_.get(handle);
+  }
 
  private:
   friend class VulkanCmdEncoder;
@@ -165,18 +166,21 @@ class VulkanDevice : public rhi::Device {
     std::vector<VkSwapchainKHR> present_swapchains;
     std::vector<VkSemaphore> present_wait_semaphores;
     std::vector<uint32_t> present_swapchain_img_indices;
+    // Signaled by encoders other queues wait on (cmd_encoder_wait_for); values only increase.
+    VkSemaphore timeline{};
+    uint64_t timeline_value{};
     [[nodiscard]] bool is_valid() const { return queue != VK_NULL_HANDLE; }
     void submit(VkFence fence);
   };
 
   Info info_{};
-  BlockPool<rhi::BufferHandle, VulkanBuffer> buffer_pool_{128, 1, true};
-  BlockPool<rhi::TextureHandle, VulkanTexture> texture_pool_{128, 1, true};
-  BlockPool<rhi::PipelineHandle, VulkanPipeline> pipeline_pool_{20, 1, true};
-  BlockPool<rhi::SamplerHandle, VulkanSampler> sampler_pool_{16, 1, true};
-  BlockPool<rhi::SwapchainHandle, VulkanSwapchain> swapchain_pool_{16, 1, true};
+  AtomicBlockPool<rhi::BufferHandle, VulkanBuffer> buffer_pool_{128, 1, true};
+  AtomicBlockPool<rhi::TextureHandle, VulkanTexture> texture_pool_{128, 1, true};
+  AtomicBlockPool<rhi::PipelineHandle, VulkanPipeline> pipeline_pool_{20, 1, true};
+  AtomicBlockPool<rhi::SamplerHandle, VulkanSampler> sampler_pool_{16, 1, true};
+  AtomicBlockPool<rhi::SwapchainHandle, VulkanSwapchain> swapchain_pool_{16, 1, true};
+  AtomicBlockPool<rhi::QueryPoolHandle, VulkanQueryPool> query_pool_pool_{8, 1, true};
   DeleteQueue del_q_{};
-  VkCommandPool command_pools_[k_max_frames_in_flight];
   vkb::Instance vkb_inst_;
   vkb::Device vkb_device_;
   VkInstance instance_{};
@@ -202,6 +206,9 @@ class VulkanDevice : public rhi::Device {
   };
 
   IndexedIndirectPCSlots indexed_indirect_pc_cache_[k_max_frames_in_flight]{};
+  // Guards device state encoders mutate while recording (indexed_indirect_pc_cache_ and the
+  // all_pipelines_ variant cache), since parallel encoders record on different threads.
+  std::mutex encoder_shared_mutex_;
   VmaAllocator allocator_;
   size_t frame_num_{};
   std::filesystem::path shader_lib_dir_;
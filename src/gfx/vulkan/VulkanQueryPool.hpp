@@ -0,0 +1,22 @@
+#pragma once
+
+#include "core/Config.hpp"
+#include "gfx/rhi/QueryPool.hpp"
+#include "vulkan/vulkan_core.h"
+
+namespace TENG_NAMESPACE {
+
+namespace gfx::vk {
+
+class VulkanQueryPool : public rhi::QueryPool {
+ public:
+  VulkanQueryPool(VkQueryPool pool, uint32_t count) : pool_(pool), count_(count) {}
+  VulkanQueryPool() = default;
+
+  VkQueryPool pool_{};
+  uint32_t count_{};
+};
+
+}  // namespace gfx::vk
+
+}  // namespace TENG_NAMESPACE
@@ -15,11 +15,16 @@ class RollingAvgCtr {
     ASSERT(history_size > 0);
   }
 
+  // Overwrites the oldest value once full instead of shifting the history.
   void add(float val) {
-    vals_.push_back(val);
-    if (vals_.size() > history_size_) {
-      vals_.erase(vals_.begin());
+    if (vals_.size() < history_size_) {
+      vals_.push_back(val);
+    } else {
+      sum_ -= vals_[next_];
+      vals_[next_] = val;
     }
+    sum_ += val;
+    next_ = (next_ + 1) % history_size_;
   }
 
   [[nodiscard]] float avg() const;
@@ -27,6 +32,8 @@ class RollingAvgCtr {
  private:
   std::vector<float> vals_;
   size_t history_size_;
+  size_t next_{};
+  double sum_{};
 };
 
 }  // namespace util
@@ -1,12 +1,12 @@
 #include "Chunk.hpp"
 
 #include <span>
-#include <tracy/Tracy.hpp>
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/string_cast.hpp>
 
 #include "core/Config.hpp"
+#include "core/Profiler.hpp"
 
 namespace TENG_NAMESPACE {
 
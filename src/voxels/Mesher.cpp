@@ -1,8 +1,7 @@
 #include "Mesher.hpp"
 
-#include <tracy/Tracy.hpp>
-
 #include "core/Config.hpp"
+#include "core/Profiler.hpp"
 
 namespace TENG_NAMESPACE {
 
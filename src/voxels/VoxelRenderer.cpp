@@ -9,8 +9,8 @@
 
 #include "chunk_shaders_shared.h"
 #include "core/Config.hpp"
+#include "core/JobSystem.hpp"
 #include "core/MathUtil.hpp"
-#include "core/ThreadPool.hpp"
 #include "gfx/GFXTypes.hpp"
 #include "gfx/RendererMetal.hpp"
 #include "gfx/metal/MetalUtil.hpp"
@@ -168,8 +168,8 @@ void Renderer::load_voxel_resources(VoxelDB& vdb, const std::filesystem::path& b
 
       std::vector<LoadData> tex_array_load_datas(to_load_tex_filenames_vec.size());
 
-      auto tex_load_fut = ThreadPool::get().submit_loop(
-          0ull, to_load_tex_filenames_vec.size(),
+      JobSystem::get().parallel_for(
+          0, to_load_tex_filenames_vec.size(), 1,
           [&to_load_tex_filenames_vec, &tex_array_load_datas, &block_tex_dir](size_t tex_i) {
             LoadData ld{};
             std::filesystem::path tex_path = block_tex_dir / to_load_tex_filenames_vec[tex_i];
@@ -181,8 +181,6 @@ void Renderer::load_voxel_resources(VoxelDB& vdb, const std::filesystem::path& b
             tex_array_load_datas[tex_i] = ld;
           });
 
-      tex_load_fut.get();
-
       int x0 = tex_array_load_datas[0].x;
       int y0 = tex_array_load_datas[0].y;
       int comp0 = tex_array_load_datas[0].comp;
@@ -1,11 +1,10 @@
 #include "VoxelWorld.hpp"
 
-#include <tracy/Tracy.hpp>
 
 #include "Camera.hpp"
 #include "chunk_shaders_shared.h"
 #include "core/EAssert.hpp"
-#include "core/ThreadPool.hpp"
+#include "core/JobSystem.hpp"
 #include "imgui.h"
 #include "voxels/Chunk.hpp"
 #include "voxels/TerrainGenerator.hpp"
@@ -17,6 +16,7 @@
 #define BM_IMPEMENTATION
 #include "Mesher.hpp"
 #include "core/Config.hpp"
+#include "core/Profiler.hpp"
 
 namespace TENG_NAMESPACE {
 
@@ -177,7 +177,7 @@ void World::update(float, Camera&) {
       TerrainGenTask terrain_task = to_terrain_gen_q_.front();
       to_terrain_gen_q_.pop();
       terrain_tasks_in_flight_++;
-      ThreadPool::get().detach_task([this, terrain_task]() {
+      JobSystem::get().run_background([this, terrain_task]() {
         Chunk* chunk = get(terrain_task.handle);
         ChunkKey key = terrain_task.key;
         if (chunk) {
@@ -235,7 +235,7 @@ void World::send_chunk_task(ChunkKey key) {
 
   meshes_in_flight_++;
 
-  ThreadPool::get().detach_task([this, key, handle, nei_chunk_arr_handle]() {
+  JobSystem::get().run_background([this, key, handle, nei_chunk_arr_handle]() {
     // TODO: vertices are malloced here
     ChunkUploadData gpu_upload_data{
         .key = key,
@@ -0,0 +1,149 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/CVar.hpp"
+
+namespace teng {
+
+// NOLINTBEGIN(misc-use-anonymous-namespace): Catch2 TEST_CASE expands to static functions.
+
+namespace {
+
+AutoCVarInt test_int{"test.cvar.int", "int cvar for tests", 1};
+AutoCVarFloat test_float{"test.cvar.float", "float cvar for tests", 0.5f};
+AutoCVarString test_string{"test.cvar.string", "string cvar for tests", "initial"};
+AutoCVarInt test_stress_a{"test.cvar.stress_a", "written together with stress_b", 0};
+AutoCVarInt test_stress_b{"test.cvar.stress_b", "written together with stress_a", 0};
+
+}  // namespace
+
+TEST_CASE("cvar writes become visible at the next frame boundary", "[cvar]") {
+  CVarSystem& cvars = CVarSystem::get();
+  test_int.set(1);
+  test_float.set(0.5f);
+  test_string.set(std::string("initial"));
+  cvars.apply_pending_changes();
+
+  test_int.set(7);
+  test_string.set(std::string("changed"));
+  CHECK(test_int.get() == 1);
+  CHECK(std::string(test_string.get()) == "initial");
+
+  cvars.apply_pending_changes();
+  CHECK(test_int.get() == 7);
+  CHECK(std::string(test_string.get()) == "changed");
+  CHECK(cvars.get_int_cvar(test_int.hashed_name()) == 7);
+  CHECK(cvars.get_float_cvar(test_float.hashed_name()) == 0.5f);
+  CHECK_FALSE(cvars.get_float_cvar(test_int.hashed_name()));
+  CHECK(cvars.get_string_cvar(util::hash::HashedString{"test.cvar.missing"}) == nullptr);
+
+  std::string error;
+  CHECK(cvars.set_cvar_from_string("test.cvar.float", "2.25", &error) == CVarApplyResult::Ok);
+  CHECK(test_float.get() == 0.5f);
+  cvars.apply_pending_changes();
+  CHECK(test_float.get() == 2.25f);
+}
+
+TEST_CASE("acquired cvar snapshots do not change", "[cvar]") {
+  CVarSystem& cvars = CVarSystem::get();
+  test_int.set(10);
+  cvars.apply_pending_changes();
+  const std::shared_ptr<const CVarSnapshot> before = cvars.acquire_snapshot();
+  REQUIRE(before);
+  CHECK(before->get(test_int) == 10);
+
+  test_int.set(11);
+  cvars.apply_pending_changes();
+  const std::shared_ptr<const CVarSnapshot> after = cvars.acquire_snapshot();
+  CHECK(before->get(test_int) == 10);
+  CHECK(after->get(test_int) == 11);
+  CHECK(after->generation() > before->generation());
+
+  // Nothing changed: no new snapshot.
+  cvars.apply_pending_changes();
+  CHECK(cvars.acquire_snapshot() == after);
+}
+
+TEST_CASE("cvar change callbacks run once per frame boundary", "[cvar]") {
+  CVarSystem& cvars = CVarSystem::get();
+  test_int.set(20);
+  cvars.apply_pending_changes();
+  // Callbacks cannot be removed, so the state outlives this test case.
+  struct CallbackState {
+    int calls{};
+    int32_t seen{};
+  };
+  auto state = std::make_shared<CallbackState>();
+  cvars.add_change_callback(test_int, [state] {
+    ++state->calls;
+    state->seen = test_int.get();
+  });
+
+  test_int.set(21);
+  test_int.set(22);
+  test_int.set(23);
+  CHECK(state->calls == 0);
+  cvars.apply_pending_changes();
+  CHECK(state->calls == 1);
+  CHECK(state->seen == 23);
+
+  // Set and reset within one frame: the value did not change, so no callback.
+  test_int.set(5);
+  test_int.set(23);
+  cvars.apply_pending_changes();
+  CHECK(state->calls == 1);
+}
+
+TEST_CASE("cvar readers on other threads see writes in order", "[cvar]") {
+  CVarSystem& cvars = CVarSystem::get();
+  test_stress_a.set(0);
+  test_stress_b.set(0);
+  cvars.apply_pending_changes();
+
+  std::atomic<bool> stop{false};
+  std::atomic<uint32_t> torn{0};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 3; ++t) {
+    readers.emplace_back([&] {
+      while (!stop.load(std::memory_order_relaxed)) {
+        // Writes are applied in queue order, so a boundary can fall between the writer's two
+        // sets but never reorder them.
+        const std::shared_ptr<const CVarSnapshot> snap = CVarSystem::get().acquire_snapshot();
+        const int32_t a = snap->get(test_stress_a);
+        const int32_t b = snap->get(test_stress_b);
+        if (b > a || a - b > 1) {
+          torn.fetch_add(1, std::memory_order_relaxed);
+        }
+        (void)test_stress_b.get();
+      }
+    });
+  }
+  std::thread writer([&] {
+    for (int32_t i = 1; i <= 2000; ++i) {
+      test_stress_a.set(i);
+      test_stress_b.set(i);
+    }
+  });
+  for (int frame = 0; frame < 500; ++frame) {
+    cvars.apply_pending_changes();
+    std::this_thread::yield();
+  }
+  writer.join();
+  cvars.apply_pending_changes();
+  stop = true;
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+  CHECK(test_stress_a.get() == 2000);
+  CHECK(test_stress_b.get() == 2000);
+  CHECK(torn.load() == 0);
+}
+
+// NOLINTEND(misc-use-anonymous-namespace)
+
+}  // namespace teng
@@ -0,0 +1,78 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <vector>
+
+#include "core/CoalescedWrites.hpp"
+
+namespace teng {
+
+// NOLINTBEGIN(misc-use-anonymous-namespace): Catch2 TEST_CASE expands to static functions.
+
+namespace {
+
+struct Run {
+  uint32_t first{};
+  std::vector<int> values;
+};
+
+std::vector<int> values(std::initializer_list<int> list) { return list; }
+
+std::vector<Run> flush_runs(CoalescedWrites<int>& writes) {
+  std::vector<Run> runs;
+  writes.flush([&runs](uint32_t first, std::span<const int> values) {
+    runs.push_back(Run{.first = first, .values = {values.begin(), values.end()}});
+  });
+  return runs;
+}
+
+}  // namespace
+
+TEST_CASE("coalesced writes merge adjacent entries into runs", "[coalesced_writes]") {
+  CoalescedWrites<int> writes;
+  CHECK(flush_runs(writes).empty());
+
+  // Queued out of order: 3..5 and 9..10 are adjacent, 7 stands alone.
+  writes.write(5, 50);
+  writes.write(9, 90);
+  writes.write(3, 30);
+  writes.write(7, 70);
+  writes.write(4, 40);
+  writes.write(10, 100);
+  CHECK(writes.pending_count() == 6);
+
+  const std::vector<Run> runs = flush_runs(writes);
+  REQUIRE(runs.size() == 3);
+  CHECK(runs[0].first == 3);
+  CHECK(runs[0].values == values({30, 40, 50}));
+  CHECK(runs[1].first == 7);
+  CHECK(runs[1].values == values({70}));
+  CHECK(runs[2].first == 9);
+  CHECK(runs[2].values == values({90, 100}));
+  CHECK(writes.empty());
+  CHECK(flush_runs(writes).empty());
+}
+
+TEST_CASE("coalesced writes keep the last write to an entry", "[coalesced_writes]") {
+  CoalescedWrites<int> writes;
+  writes.write(2, 1);
+  writes.write(1, 10);
+  writes.write(2, 2);
+  writes.write(3, 30);
+  writes.write(2, 3);
+  writes.write(1, 11);
+  writes.write(8, 80);
+  writes.write(8, 81);
+
+  const std::vector<Run> runs = flush_runs(writes);
+  REQUIRE(runs.size() == 2);
+  CHECK(runs[0].first == 1);
+  CHECK(runs[0].values == values({11, 3, 30}));
+  CHECK(runs[1].first == 8);
+  CHECK(runs[1].values == values({81}));
+}
+
+// NOLINTEND(misc-use-anonymous-namespace)
+
+}  // namespace teng
@@ -0,0 +1,161 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/FlatHashMap.hpp"
+
+namespace teng {
+
+// NOLINTBEGIN(misc-use-anonymous-namespace): Catch2 TEST_CASE expands to static functions.
+
+namespace {
+
+// Every key lands in the same bucket chain, so probing, tombstones and group wrap-around get
+// exercised with only a handful of elements.
+struct CollidingHash {
+  uint64_t operator()(uint64_t) const { return 0; }
+};
+
+}  // namespace
+
+TEST_CASE("flat hash map matches std::unordered_map under random churn", "[flat_hash_map]") {
+  FlatHashMap<uint64_t, uint64_t> flat;
+  std::unordered_map<uint64_t, uint64_t> reference;
+  std::mt19937_64 rng{7};
+  for (uint32_t step = 0; step < 200'000; ++step) {
+    const uint64_t key = rng() % 4096;
+    switch (rng() % 4) {
+      case 0:
+      case 1: {
+        const uint64_t value = rng();
+        const bool inserted = flat.try_emplace(key, value).second;
+        CHECK(inserted == reference.try_emplace(key, value).second);
+        break;
+      }
+      case 2:
+        CHECK(flat.erase(key) == reference.erase(key));
+        break;
+      default: {
+        const auto it = flat.find(key);
+        const auto ref_it = reference.find(key);
+        REQUIRE((it == flat.end()) == (ref_it == reference.end()));
+        if (it != flat.end()) {
+          CHECK(it->second == ref_it->second);
+        }
+      }
+    }
+  }
+  REQUIRE(flat.size() == reference.size());
+  size_t visited = 0;
+  for (const auto& [key, value] : flat) {
+    REQUIRE(reference.contains(key));
+    CHECK(reference[key] == value);
+    ++visited;
+  }
+  CHECK(visited == reference.size());
+}
+
+TEST_CASE("flat hash map handles full collisions and tombstone reuse", "[flat_hash_map]") {
+  FlatHashMap<uint64_t, uint32_t, CollidingHash> map;
+  for (uint32_t round = 0; round < 50; ++round) {
+    for (uint64_t k = 0; k < 20; ++k) {
+      map[k] = static_cast<uint32_t>(k + round);
+    }
+    for (uint64_t k = 0; k < 20; k += 2) {
+      CHECK(map.erase(k) == 1);
+    }
+    for (uint64_t k = 0; k < 20; ++k) {
+      CHECK(map.contains(k) == (k % 2 == 1));
+    }
+    for (uint64_t k = 1; k < 20; k += 2) {
+      CHECK(map.at(k) == k + round);
+    }
+  }
+  // Erase/insert churn reuses tombstones instead of growing without bound.
+  CHECK(map.capacity() <= 64);
+}
+
+TEST_CASE("flat hash map erase while iterating visits every element once", "[flat_hash_map]") {
+  FlatHashMap<uint32_t, std::vector<uint32_t>> map;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    map[i].push_back(i);
+  }
+  size_t visited = 0;
+  for (auto it = map.begin(); it != map.end();) {
+    ++visited;
+    it = it->first % 3 == 0 ? map.erase(it) : std::next(it);
+  }
+  CHECK(visited == 1000);
+  CHECK(map.size() == 666);
+  for (const auto& [key, values] : map) {
+    CHECK(key % 3 != 0);
+    CHECK(values.front() == key);
+  }
+}
+
+TEST_CASE("flat hash map owns non-trivial values across rehash, copy and clear",
+          "[flat_hash_map]") {
+  auto tracker = std::make_shared<int>(0);
+  {
+    FlatHashMap<std::string, std::shared_ptr<int>> map;
+    for (int i = 0; i < 500; ++i) {
+      map.emplace("key" + std::to_string(i), tracker);
+    }
+    CHECK(tracker.use_count() == 501);
+    FlatHashMap<std::string, std::shared_ptr<int>> copy = map;
+    CHECK(tracker.use_count() == 1001);
+    CHECK(copy.at("key123") == tracker);
+    FlatHashMap<std::string, std::shared_ptr<int>> moved = std::move(copy);
+    CHECK(tracker.use_count() == 1001);
+    const size_t capacity = map.capacity();
+    map.clear();
+    CHECK(map.empty());
+    CHECK(map.capacity() == capacity);
+    CHECK(tracker.use_count() == 501);
+  }
+  CHECK(tracker.use_count() == 1);
+}
+
+TEST_CASE("flat hash set inserts, finds and reserves", "[flat_hash_map]") {
+  FlatHashSet<uint32_t> set;
+  set.reserve(100);
+  const size_t capacity = set.capacity();
+  for (uint32_t i = 0; i < 100; ++i) {
+    CHECK(set.insert(i * 7).second);
+    CHECK_FALSE(set.insert(i * 7).second);
+  }
+  CHECK(set.capacity() == capacity);
+  CHECK(set.size() == 100);
+  CHECK(set.contains(693));
+  CHECK_FALSE(set.contains(694));
+}
+
+TEST_CASE("fast hashes are deterministic and spread sequential keys", "[flat_hash_map]") {
+  const std::string text = "render_graph_tex_att";
+  CHECK(util::hash::hash_bytes(text.data(), text.size()) ==
+        util::hash::FastHash<std::string>{}(text));
+  CHECK(util::hash::hash_bytes(text.data(), text.size()) !=
+        util::hash::hash_bytes(text.data(), text.size() - 1));
+  for (size_t len = 0; len <= 100; ++len) {
+    const std::string a(len, 'x');
+    std::string b = a;
+    if (len > 0) {
+      b[len / 2] = 'y';
+      CHECK(util::hash::hash_bytes(a.data(), len) != util::hash::hash_bytes(b.data(), len));
+    }
+  }
+  // Low bits pick the probe start: sequential ids must not cluster there.
+  FlatHashSet<uint64_t> low_bits;
+  for (uint64_t i = 0; i < 1024; ++i) {
+    low_bits.insert(util::hash::hash_u64(i) & 1023);
+  }
+  CHECK(low_bits.size() > 550);
+}
+
+// NOLINTEND(misc-use-anonymous-namespace)
+
+}  // namespace teng
@@ -0,0 +1,66 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "core/FrameArena.hpp"
+
+namespace teng {
+
+// NOLINTBEGIN(misc-use-anonymous-namespace): Catch2 TEST_CASE expands to static functions.
+
+TEST_CASE("linear arena honours alignment and rewinds on reset", "[frame_arena]") {
+  LinearArena arena{4096};
+  void* a = arena.allocate(3, 1);
+  void* b = arena.allocate(16, 64);
+  CHECK(reinterpret_cast<uintptr_t>(b) % 64 == 0);
+  CHECK(a != b);
+  CHECK(arena.bytes_used() >= 19);
+
+  arena.reset();
+  CHECK(arena.bytes_used() == 0);
+  CHECK(arena.allocate(3, 1) == a);
+}
+
+TEST_CASE("linear arena folds overflow into one block and stops allocating", "[frame_arena]") {
+  LinearArena arena{4096};
+  const auto fill_frame = [&arena] {
+    std::pmr::vector<uint64_t> values{&arena};
+    for (uint64_t i = 0; i < 10'000; ++i) {
+      values.push_back(i);
+    }
+  };
+  fill_frame();
+  const uint64_t first_frame_allocs = arena.heap_allocations();
+  CHECK(first_frame_allocs > 1);
+
+  arena.reset();
+  const uint64_t after_fold = arena.heap_allocations();
+  CHECK(arena.capacity() >= arena.high_water());
+  for (int frame = 0; frame < 4; ++frame) {
+    fill_frame();
+    arena.reset();
+  }
+  CHECK(arena.heap_allocations() == after_fold);
+}
+
+TEST_CASE("frame arena keeps the previous frame alive", "[frame_arena]") {
+  FrameArena frames{2, 4096};
+  std::pmr::vector<int> last_frame{frames.resource()};
+  last_frame.assign({1, 2, 3});
+  const FrameArena::Stats before = frames.get_stats();
+
+  frames.begin_frame();
+  std::pmr::vector<int> this_frame{frames.resource()};
+  this_frame.assign(64, 7);
+  CHECK(last_frame[2] == 3);
+  CHECK(frames.get_stats().last_frame_bytes >= 3 * sizeof(int));
+  CHECK(frames.get_stats().heap_allocations == before.heap_allocations);
+
+  frames.begin_frame();
+  CHECK(frames.curr_slot() == 0);
+}
+
+// NOLINTEND(misc-use-anonymous-namespace)
+
+}  // namespace teng
@@ -0,0 +1,106 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "core/IoService.hpp"
+#include "core/JobSystem.hpp"
+
+namespace teng {
+
+// NOLINTBEGIN(misc-use-anonymous-namespace): Catch2 TEST_CASE expands to static functions.
+
+namespace {
+
+std::filesystem::path write_temp_file(const std::string& name, const std::string& contents) {
+  const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+  return path;
+}
+
+std::string make_contents(size_t size, uint32_t seed) {
+  std::string contents(size, '\0');
+  for (size_t i = 0; i < size; ++i) {
+    contents[i] = static_cast<char>((i * 131) + seed);
+  }
+  return contents;
+}
+
+void check_backend(IoService& io) {
+  constexpr uint32_t k_files = 48;
+  std::vector<std::filesystem::path> paths;
+  std::vector<std::string> contents;
+  for (uint32_t i = 0; i < k_files; ++i) {
+    // Mix of empty, small and multi-megabyte files.
+    const size_t size = i == 0 ? 0 : (i % 8 == 0 ? (3u << 20) + i : 1000 * i);
+    contents.push_back(make_contents(size, i));
+    paths.push_back(write_temp_file(std::format("teng_io_test_{}.bin", i), contents.back()));
+  }
+  paths.push_back(std::filesystem::temp_directory_path() / "teng_io_test_missing.bin");
+
+  JobCounter counter;
+  std::vector<IoRequest> requests = io.read_batch(paths, &counter);
+  IoRequest single = io.read(paths[5]);
+  JobSystem::get().wait(counter);
+
+  REQUIRE(requests.size() == paths.size());
+  for (uint32_t i = 0; i < k_files; ++i) {
+    REQUIRE(requests[i].done());
+    Result<IoBuffer> buffer = requests[i].take();
+    REQUIRE(buffer);
+    CHECK(buffer->text() == contents[i]);
+    CHECK_FALSE(requests[i].take());
+  }
+  Result<IoBuffer> missing = requests.back().take();
+  CHECK_FALSE(missing);
+  CHECK(missing.error().find("teng_io_test_missing.bin") != std::string::npos);
+
+  Result<IoBuffer> single_buffer = single.take();
+  REQUIRE(single_buffer);
+  CHECK(single_buffer->text() == contents[5]);
+  CHECK(single.path() == paths[5]);
+
+  for (uint32_t i = 0; i < k_files; ++i) {
+    std::filesystem::remove(paths[i]);
+  }
+}
+
+}  // namespace
+
+TEST_CASE("io service reads batches through its native backend", "[io]") {
+  IoService io{IoService::CreateInfo{.queue_depth = 8}};
+  check_backend(io);
+}
+
+TEST_CASE("io service thread pool fallback reads batches", "[io]") {
+  IoService io{IoService::CreateInfo{.fallback_threads = 3, .force_thread_pool = true}};
+  CHECK(io.backend() == IoService::Backend::ThreadPool);
+  check_backend(io);
+}
+
+TEST_CASE("io service finishes queued reads on destruction", "[io]") {
+  const std::string contents = make_contents(1 << 16, 7);
+  const std::filesystem::path path = write_temp_file("teng_io_test_shutdown.bin", contents);
+  std::vector<IoRequest> requests;
+  {
+    IoService io{IoService::CreateInfo{.queue_depth = 4}};
+    for (int i = 0; i < 32; ++i) {
+      requests.push_back(io.read(path));
+    }
+  }
+  for (IoRequest& request : requests) {
+    CHECK(request.done());
+    Result<IoBuffer> buffer = request.take();
+    REQUIRE(buffer);
+    CHECK(buffer->size == contents.size());
+  }
+  std::filesystem::remove(path);
+}
+
+// NOLINTEND(misc-use-anonymous-namespace)
+
+}  // namespace teng
@@ -0,0 +1,102 @@
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "core/JobSystem.hpp"
+
+namespace teng {
+
+// NOLINTBEGIN(misc-use-anonymous-namespace): Catch2 TEST_CASE expands to static functions.
+
+TEST_CASE("job system parallel_for visits every index exactly once", "[job_system]") {
+  JobSystem jobs{3};
+  std::vector<std::atomic<int>> hits(10'000);
+  jobs.parallel_for(0, hits.size(), 0, [&](size_t i) { hits[i].fetch_add(1); });
+  for (const auto& hit : hits) {
+    REQUIRE(hit.load() == 1);
+  }
+}
+
+TEST_CASE("job system parallel_for handles empty and single-chunk ranges", "[job_system]") {
+  JobSystem jobs{2};
+  int calls = 0;
+  jobs.parallel_for(5, 5, 0, [&](size_t) { calls++; });
+  CHECK(calls == 0);
+  jobs.parallel_for(0, 4, 16, [&](size_t) { calls++; });
+  CHECK(calls == 4);
+}
+
+TEST_CASE("job system waits on counters for run jobs", "[job_system]") {
+  JobSystem jobs{2};
+  JobCounter counter;
+  std::atomic<int> sum{0};
+  for (int i = 1; i <= 100; ++i) {
+    jobs.run([&sum, i] { sum.fetch_add(i); }, &counter);
+  }
+  jobs.wait(counter);
+  CHECK(counter.done());
+  CHECK(sum.load() == 5050);
+}
+
+TEST_CASE("job system nested parallel_for completes with a single worker", "[job_system]") {
+  // The outer jobs wait on inner ones; helping in wait() keeps this from deadlocking.
+  JobSystem jobs{1};
+  std::atomic<size_t> total{0};
+  jobs.parallel_for(0, 8, 1, [&](size_t) {
+    jobs.parallel_for(0, 64, 4, [&](size_t) { total.fetch_add(1); });
+  });
+  CHECK(total.load() == 8 * 64);
+}
+
+TEST_CASE("job system fork_join runs every branch", "[job_system]") {
+  JobSystem jobs{2};
+  std::atomic<int> a{0};
+  std::atomic<int> b{0};
+  std::atomic<int> c{0};
+  jobs.fork_join([&] { a = 1; }, [&] { b = 2; }, [&] { c = 3; });
+  CHECK(a.load() + b.load() + c.load() == 6);
+}
+
+TEST_CASE("job system without workers runs everything on the caller", "[job_system]") {
+  JobSystem jobs{0};
+  JobCounter counter;
+  int value = 0;
+  jobs.run([&] { value = 42; }, &counter);
+  jobs.wait(counter);
+  CHECK(value == 42);
+}
+
+TEST_CASE("job system leaves background jobs to the workers", "[job_system]") {
+  JobSystem jobs{2};
+  const std::thread::id caller = std::this_thread::get_id();
+  std::atomic<bool> background_ran{false};
+  std::thread::id background_thread;
+  jobs.run_background([&] {
+    background_thread = std::this_thread::get_id();
+    background_ran = true;
+  });
+  // Whoever runs this job spins until the background job ran; with two workers one of them is
+  // always free to run it, while the caller's wait() must not.
+  JobCounter counter;
+  jobs.run(
+      [&] {
+        while (!background_ran) {
+          std::this_thread::yield();
+        }
+      },
+      &counter);
+  jobs.wait(counter);
+  CHECK(background_ran.load());
+  CHECK(background_thread != caller);
+
+  JobSystem inline_jobs{0};
+  bool ran_inline = false;
+  inline_jobs.run_background([&] { ran_inline = true; });
+  CHECK(ran_inline);
+}
+
+// NOLINTEND(misc-use-anonymous-namespace)
+
+}  // namespace teng
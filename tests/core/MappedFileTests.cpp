@@ -0,0 +1,73 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+
+#include "core/MappedFile.hpp"
+
+namespace teng {
+
+// NOLINTBEGIN(misc-use-anonymous-namespace): Catch2 TEST_CASE expands to static functions.
+
+namespace {
+
+std::filesystem::path write_temp_file(const std::string& name, const std::string& contents) {
+  const std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+  return path;
+}
+
+}  // namespace
+
+TEST_CASE("mapped and buffered files expose the same bytes", "[mapped_file]") {
+  std::string contents(100'000, '\0');
+  for (size_t i = 0; i < contents.size(); ++i) {
+    contents[i] = static_cast<char>(i * 31);
+  }
+  const std::filesystem::path path = write_temp_file("teng_mapped_file_test.bin", contents);
+
+  Result<MappedFile> mapped = MappedFile::open(path, FileAccessHint::Random);
+  REQUIRE(mapped);
+  CHECK(mapped->is_mapped());
+  CHECK(mapped->size() == contents.size());
+  CHECK(mapped->text() == contents);
+  mapped->advise(FileAccessHint::WillNeed, 70'000, 4096);
+  mapped->advise(FileAccessHint::Normal, 200'000);  // Past the end: ignored.
+
+  Result<MappedFile> buffered = MappedFile::open_buffered(path);
+  REQUIRE(buffered);
+  CHECK_FALSE(buffered->is_mapped());
+  CHECK(buffered->text() == contents);
+
+  MappedFile moved = std::move(*mapped);
+  CHECK(mapped->empty());
+  CHECK(mapped->data() == nullptr);
+  CHECK(moved.bytes().size() == contents.size());
+  CHECK(moved.bytes()[1] == static_cast<std::byte>(31));
+  moved = std::move(*buffered);
+  CHECK(moved.text() == contents);
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("mapped file handles empty and missing files", "[mapped_file]") {
+  const std::filesystem::path path = write_temp_file("teng_mapped_file_empty.bin", "");
+  Result<MappedFile> empty = MappedFile::open(path);
+  REQUIRE(empty);
+  CHECK(empty->empty());
+  CHECK_FALSE(empty->is_mapped());
+  CHECK(empty->text().empty());
+  std::filesystem::remove(path);
+
+  const Result<MappedFile> missing = MappedFile::open(path);
+  CHECK_FALSE(missing);
+  CHECK(missing.error().find(path.string()) != std::string::npos);
+  CHECK_FALSE(MappedFile::open_buffered(path));
+}
+
+// NOLINTEND(misc-use-anonymous-namespace)
+
+}  // namespace teng
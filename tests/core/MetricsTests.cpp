@@ -0,0 +1,119 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/Metrics.hpp"
+
+namespace teng {
+
+// NOLINTBEGIN(misc-use-anonymous-namespace): Catch2 TEST_CASE expands to static functions.
+
+namespace {
+
+bool within_relative(double value, double expected, double tolerance) {
+  return std::abs(value - expected) <= expected * tolerance;
+}
+
+}  // namespace
+
+TEST_CASE("log-linear histogram quantiles stay within bucket precision", "[metrics]") {
+  Histogram histogram{HistogramDesc{.lowest = 1e-3, .highest = 1e4, .sub_buckets = 32}};
+  for (uint32_t i = 1; i <= 10'000; ++i) {
+    histogram.record(static_cast<double>(i) * 0.01);  // 0.01 .. 100
+  }
+  const Histogram::Snapshot snap = histogram.snapshot();
+  CHECK(snap.count == 10'000);
+  CHECK(snap.min == 0.01);
+  CHECK(snap.max == 100.0);
+  CHECK(within_relative(snap.mean(), 50.005, 1e-9));
+  CHECK(within_relative(snap.quantile(0.50), 50.0, 1.0 / 32));
+  CHECK(within_relative(snap.quantile(0.95), 95.0, 1.0 / 32));
+  CHECK(within_relative(snap.quantile(0.99), 99.0, 1.0 / 32));
+  CHECK(snap.quantile(1.0) == 100.0);
+  CHECK(snap.quantile(0.0) >= 0.01);
+}
+
+TEST_CASE("histogram catches values outside its range and ignores NaN", "[metrics]") {
+  Histogram histogram{HistogramDesc{.lowest = 1.0, .highest = 100.0, .sub_buckets = 8}};
+  histogram.record(0.0);
+  histogram.record(-5.0);
+  histogram.record(1e9);
+  histogram.record(std::nan(""));
+  const Histogram::Snapshot snap = histogram.snapshot();
+  CHECK(snap.count == 3);
+  CHECK(snap.buckets.front() == 2);
+  CHECK(snap.buckets.back() == 1);
+  CHECK(snap.min == -5.0);
+  CHECK(snap.max == 1e9);
+  CHECK(snap.quantile(1.0) == 1e9);
+}
+
+TEST_CASE("fixed-bucket histogram interpolates within its bounds", "[metrics]") {
+  Histogram histogram{HistogramDesc{.bounds = {10.0, 20.0, 30.0}}};
+  CHECK(histogram.bucket_count() == 4);
+  for (int i = 0; i < 100; ++i) {
+    histogram.record(15.0);
+  }
+  const Histogram::Snapshot snap = histogram.snapshot();
+  CHECK(snap.buckets[1] == 100);
+  CHECK(snap.quantile(0.5) == 15.0);  // Clamped to the recorded min/max.
+  histogram.reset();
+  CHECK(histogram.snapshot().count == 0);
+  CHECK(histogram.snapshot().quantile(0.5) == 0.0);
+}
+
+TEST_CASE("histogram records from many threads without losing samples", "[metrics]") {
+  Histogram histogram;
+  constexpr uint32_t k_threads = 4;
+  constexpr uint32_t k_per_thread = 50'000;
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < k_threads; ++t) {
+    threads.emplace_back([&histogram, t] {
+      for (uint32_t i = 0; i < k_per_thread; ++i) {
+        histogram.record(static_cast<double>(t + 1));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const Histogram::Snapshot snap = histogram.snapshot();
+  CHECK(snap.count == k_threads * k_per_thread);
+  CHECK(snap.sum == static_cast<double>(k_per_thread) * (1 + 2 + 3 + 4));
+  CHECK(snap.min == 1.0);
+  CHECK(snap.max == 4.0);
+}
+
+TEST_CASE("metrics registry returns stable metrics and exports them", "[metrics]") {
+  MetricsRegistry registry;
+  Counter& loads = registry.counter("test.loads");
+  CHECK(&registry.counter("test.loads") == &loads);
+  loads.add(3);
+  registry.gauge("test.budget_mb").set(512.0);
+  Histogram& frame = registry.histogram("test.frame_ms");
+  frame.record(16.0);
+  frame.record(17.0);
+
+  const nlohmann::json json = nlohmann::json::parse(registry.to_json());
+  CHECK(json["counters"]["test.loads"] == 3);
+  CHECK(json["gauges"]["test.budget_mb"] == 512.0);
+  CHECK(json["histograms"]["test.frame_ms"]["count"] == 2);
+  CHECK(json["histograms"]["test.frame_ms"]["max"] == 17.0);
+
+  const std::string csv = registry.to_csv();
+  CHECK(csv.starts_with("name,type,count,value,mean,min,max,p50,p95,p99\n"));
+  CHECK(csv.find("test.loads,counter,,3,") != std::string::npos);
+  CHECK(csv.find("test.frame_ms,histogram,2,33,16.5,16,17,") != std::string::npos);
+
+  registry.reset();
+  CHECK(loads.value() == 0);
+  CHECK(frame.snapshot().count == 0);
+}
+
+// NOLINTEND(misc-use-anonymous-namespace)
+
+}  // namespace teng
@@ -0,0 +1,103 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "core/Handle.hpp"
+#include "core/Pool.hpp"
+
+namespace teng {
+
+// NOLINTBEGIN(misc-use-anonymous-namespace): Catch2 TEST_CASE expands to static functions.
+
+namespace {
+
+struct PoolTestObject {
+  uint32_t value{};
+};
+using PoolTestHandle = GenerationalHandle<PoolTestObject>;
+
+}  // namespace
+
+TEST_CASE("atomic block pool resolves live handles and rejects stale ones", "[pool]") {
+  AtomicBlockPool<PoolTestHandle, PoolTestObject> pool{4, 1, true};
+  const PoolTestHandle a = pool.alloc(7u);
+  REQUIRE(pool.get(a) != nullptr);
+  CHECK(pool.get(a)->value == 7);
+  CHECK(pool.size() == 1);
+
+  pool.destroy(a);
+  CHECK(pool.get(a) == nullptr);
+  CHECK(pool.empty());
+
+  // The slot is reused with a new generation; the old handle stays invalid.
+  const PoolTestHandle b = pool.alloc(9u);
+  CHECK(b.get_idx() == a.get_idx());
+  CHECK(b.get_gen() != a.get_gen());
+  CHECK(pool.get(a) == nullptr);
+  CHECK(pool.get(b)->value == 9);
+
+  pool.destroy(a);
+  CHECK(pool.get(b) != nullptr);
+  CHECK(pool.get(PoolTestHandle{}) == nullptr);
+}
+
+TEST_CASE("atomic block pool grows by blocks and visits live entries", "[pool]") {
+  AtomicBlockPool<PoolTestHandle, PoolTestObject> pool{4, 1, true};
+  std::vector<PoolTestHandle> handles;
+  for (uint32_t i = 0; i < 10; ++i) {
+    handles.push_back(pool.alloc(i));
+  }
+  CHECK(pool.num_blocks() == 3);
+  pool.destroy(handles[3]);
+
+  uint32_t sum = 0;
+  uint32_t count = 0;
+  pool.for_each([&](const PoolTestObject& obj) {
+    sum += obj.value;
+    count++;
+  });
+  CHECK(count == 9);
+  CHECK(sum == 45 - 3);
+  CHECK(pool.get_num_created() == 10);
+  CHECK(pool.get_num_destroyed() == 1);
+}
+
+TEST_CASE("atomic block pool hands out unique slots under concurrent churn", "[pool]") {
+  AtomicBlockPool<PoolTestHandle, PoolTestObject> pool{16, 1, true};
+  constexpr uint32_t k_threads = 4;
+  constexpr uint32_t k_per_thread = 500;
+  std::vector<std::vector<PoolTestHandle>> kept(k_threads);
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < k_threads; ++t) {
+    threads.emplace_back([&pool, &kept, t] {
+      for (uint32_t i = 0; i < k_per_thread; ++i) {
+        const PoolTestHandle h = pool.alloc(t);
+        if (i % 2 == 0) {
+          pool.destroy(h);
+        } else {
+          kept[t].push_back(h);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::set<uint32_t> indices;
+  for (uint32_t t = 0; t < k_threads; ++t) {
+    for (const PoolTestHandle h : kept[t]) {
+      REQUIRE(pool.get(h) != nullptr);
+      CHECK(pool.get(h)->value == t);
+      indices.insert(h.get_idx());
+    }
+  }
+  CHECK(indices.size() == k_threads * k_per_thread / 2);
+  CHECK(pool.size() == k_threads * k_per_thread / 2);
+}
+
+// NOLINTEND(misc-use-anonymous-namespace)
+
+}  // namespace teng
@@ -0,0 +1,140 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "core/Profiler.hpp"
+
+namespace teng {
+
+// NOLINTBEGIN(misc-use-anonymous-namespace): Catch2 TEST_CASE expands to static functions.
+
+namespace {
+
+void leaf_zone() { ZoneScopedN("leaf"); }
+
+void parent_zone() {
+  ZoneScopedN("parent");
+  leaf_zone();
+  leaf_zone();
+}
+
+const ProfileCapture::Thread* find_thread(const ProfileCapture& capture, std::string_view name) {
+  for (const ProfileCapture::Thread& thread : capture.threads) {
+    if (thread.name == name) {
+      return &thread;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+TEST_CASE("profiler records nothing outside a capture", "[profiler]") {
+  parent_zone();
+  Profiler& profiler = Profiler::get();
+  profiler.begin_capture();
+  const ProfileCapture capture = profiler.end_capture();
+  CHECK(capture.event_count() == 0);
+  CHECK_FALSE(Profiler::capturing());
+}
+
+TEST_CASE("profiler orders nested zones parent first", "[profiler]") {
+  Profiler::set_thread_name("profiler test main");
+  Profiler& profiler = Profiler::get();
+  profiler.begin_capture();
+  parent_zone();
+  const ProfileCapture capture = profiler.end_capture();
+
+  const ProfileCapture::Thread* thread = find_thread(capture, "profiler test main");
+  REQUIRE(thread != nullptr);
+  REQUIRE(thread->events.size() == 3);
+  const ProfileEvent& parent = thread->events[0];
+  CHECK(std::string_view(parent.name) == "parent");
+  for (size_t i = 1; i < 3; ++i) {
+    const ProfileEvent& leaf = thread->events[i];
+    CHECK(std::string_view(leaf.name) == "leaf");
+    CHECK(leaf.begin_ns >= parent.begin_ns);
+    CHECK(leaf.end_ns <= parent.end_ns);
+  }
+  CHECK(thread->events[1].end_ns <= thread->events[2].begin_ns);
+}
+
+TEST_CASE("profiler captures the requested number of frames from every thread", "[profiler]") {
+  constexpr uint32_t k_frames = 3;
+  constexpr uint32_t k_threads = 3;
+  Profiler& profiler = Profiler::get();
+  REQUIRE(profiler.request_capture(k_frames));
+  CHECK_FALSE(profiler.request_capture(1));
+  CHECK_FALSE(profiler.frame_mark().has_value());  // Starts the capture.
+
+  std::optional<ProfileCapture> capture;
+  for (uint32_t frame = 0; frame < k_frames; ++frame) {
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < k_threads; ++t) {
+      threads.emplace_back([t] {
+        Profiler::set_thread_name("profiler test worker " + std::to_string(t));
+        parent_zone();
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    capture = profiler.frame_mark();
+    CHECK(capture.has_value() == (frame == k_frames - 1));
+  }
+  REQUIRE(capture.has_value());
+  CHECK_FALSE(Profiler::capturing());
+  CHECK(capture->frame_begin_ns.size() == k_frames);
+  CHECK(capture->dropped_events == 0);
+  // Each frame spawns fresh threads, so every worker name appears once per frame.
+  for (uint32_t t = 0; t < k_threads; ++t) {
+    size_t events = 0;
+    for (const ProfileCapture::Thread& thread : capture->threads) {
+      if (thread.name == "profiler test worker " + std::to_string(t)) {
+        events += thread.events.size();
+      }
+    }
+    CHECK(events == 3 * k_frames);
+  }
+}
+
+TEST_CASE("profiler capture exports Chrome trace JSON", "[profiler]") {
+  Profiler::set_thread_name("profiler \"json\" thread");
+  Profiler& profiler = Profiler::get();
+  REQUIRE(profiler.request_capture(1));
+  profiler.frame_mark();
+  parent_zone();
+  const std::optional<ProfileCapture> capture = profiler.frame_mark();
+  REQUIRE(capture.has_value());
+
+  const nlohmann::json json = nlohmann::json::parse(capture->to_chrome_trace_json());
+  const nlohmann::json& events = json["traceEvents"];
+  REQUIRE(events.is_array());
+  size_t complete = 0;
+  bool named_thread = false;
+  bool frame_marker = false;
+  for (const nlohmann::json& event : events) {
+    const std::string ph = event["ph"];
+    if (ph == "X") {
+      ++complete;
+      CHECK(event["dur"].get<double>() >= 0.0);
+      CHECK(event["ts"].get<double>() >= 0.0);
+    } else if (ph == "M") {
+      named_thread = named_thread || event["args"]["name"] == "profiler \"json\" thread";
+    } else if (ph == "i") {
+      frame_marker = frame_marker || event["name"] == "frame 0";
+    }
+  }
+  CHECK(complete == 3);
+  CHECK(named_thread);
+  CHECK(frame_marker);
+}
+
+// NOLINTEND(misc-use-anonymous-namespace)
+
+}  // namespace teng
@@ -0,0 +1,79 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "core/RadixSort.hpp"
+
+namespace teng {
+
+// NOLINTBEGIN(misc-use-anonymous-namespace): Catch2 TEST_CASE expands to static functions.
+
+namespace {
+
+struct Item {
+  uint64_t key{};
+  int32_t layer{};
+  uint32_t original_index{};
+};
+
+}  // namespace
+
+TEST_CASE("radix sort matches a stable comparison sort", "[radix_sort]") {
+  std::mt19937_64 rng{1234};
+  for (const size_t count : {0u, 1u, 2u, 17u, 1000u, 70'000u}) {
+    std::vector<Item> items(count);
+    for (uint32_t i = 0; i < count; ++i) {
+      // Few distinct values in the low bits and a wide spread in the high ones, so both skipped
+      // and full passes run and equal keys exercise stability.
+      items[i] = Item{.key = (rng() & 0xffff'0000'0000'0000ull) | (rng() % 8), .original_index = i};
+    }
+    std::vector<Item> expected = items;
+    std::ranges::stable_sort(expected, {}, &Item::key);
+
+    std::vector<Item> scratch(count);
+    radix_sort(std::span(items), std::span(scratch), [](const Item& item) { return item.key; });
+    REQUIRE(items.size() == expected.size());
+    for (size_t i = 0; i < count; ++i) {
+      CHECK(items[i].key == expected[i].key);
+      CHECK(items[i].original_index == expected[i].original_index);
+    }
+  }
+}
+
+TEST_CASE("radix sort orders signed keys and chains secondary keys", "[radix_sort]") {
+  std::vector<Item> items;
+  const int32_t layers[] = {3, -1, 0, -2'000'000'000, 2'000'000'000, -1, 3};
+  for (uint32_t i = 0; i < std::size(layers); ++i) {
+    items.push_back(Item{.key = 100u - i, .layer = layers[i], .original_index = i});
+  }
+  std::vector<Item> scratch(items.size());
+  // Secondary key first, then the primary key on top of it.
+  radix_sort(std::span(items), std::span(scratch), [](const Item& item) { return item.key; });
+  radix_sort(std::span(items), std::span(scratch),
+             [](const Item& item) { return uint64_t{radix_key(item.layer)}; });
+
+  CHECK(std::ranges::is_sorted(items, [](const Item& a, const Item& b) {
+    return a.layer != b.layer ? a.layer < b.layer : a.key < b.key;
+  }));
+  CHECK(items.front().layer == -2'000'000'000);
+  CHECK(items.back().layer == 2'000'000'000);
+}
+
+TEST_CASE("radix sort skips keys that are equal everywhere", "[radix_sort]") {
+  std::vector<Item> items(300);
+  for (uint32_t i = 0; i < items.size(); ++i) {
+    items[i] = Item{.key = 42, .original_index = i};
+  }
+  std::vector<Item> scratch(items.size());
+  radix_sort(std::span(items), std::span(scratch), [](const Item& item) { return item.key; });
+  for (uint32_t i = 0; i < items.size(); ++i) {
+    CHECK(items[i].original_index == i);
+  }
+}
+
+// NOLINTEND(misc-use-anonymous-namespace)
+
+}  // namespace teng
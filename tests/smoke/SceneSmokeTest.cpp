@@ -2,7 +2,9 @@
 
 #include <GLFW/glfw3.h>
 
+#include <algorithm>
 #include <cmath>
+#include <span>
 
 #include "TestHelpers.hpp"
 #include "core/Logger.hpp"
@@ -20,6 +22,19 @@ namespace {
 
 bool nearly_equal(float a, float b) { return std::abs(a - b) < 0.0001f; }
 
+bool contains_guid(std::span<const EntityGuid> guids, EntityGuid guid) {
+  return std::ranges::find(guids, guid) != guids.end();
+}
+
+bool contains_mesh(std::span<const RenderMesh> meshes, EntityGuid guid) {
+  return std::ranges::any_of(meshes,
+                             [guid](const RenderMesh& mesh) { return mesh.entity == guid; });
+}
+
+bool delta_empty(const RenderSceneMeshDelta& delta) {
+  return delta.added.empty() && delta.changed.empty() && delta.removed.empty();
+}
+
 bool matrix_nearly_equal(const auto& a, const auto& b) {
   for (int col = 0; col < 4; ++col) {
     for (int row = 0; row < 4; ++row) {
@@ -208,6 +223,82 @@ bool run_render_scene_extraction_smoke_test() {
   return true;
 }
 
+bool run_incremental_render_scene_extraction_smoke_test() {
+  FlecsComponentContext component_ctx = make_scene_component_context();
+  SceneManager scenes(component_ctx);
+  Scene& scene = scenes.create_scene("incremental render extraction");
+
+  const AssetId model = AssetId::from_path("models/a.gltf");
+  const EntityGuid moving_guid{10};
+  const EntityGuid invalidated_guid{20};
+  const EntityGuid destroyed_guid{30};
+  for (const EntityGuid guid : {moving_guid, invalidated_guid, destroyed_guid}) {
+    scene.create_entity(guid).set<MeshRenderable>({.model = model});
+  }
+  if (!scene.tick(1.f / 60.f)) {
+    return false;
+  }
+
+  RenderSceneMeshDelta delta;
+  RenderScene render_scene = extract_render_scene_delta(scene, delta);
+  if (!render_scene.meshes.empty() || delta.added.size() != 3 || !delta.changed.empty() ||
+      !delta.removed.empty()) {
+    return false;
+  }
+
+  // Nothing was written: neither extraction nor a tick report changes.
+  (void)extract_render_scene_delta(scene, delta);
+  if (!delta_empty(delta)) {
+    return false;
+  }
+  if (!scene.tick(1.f / 60.f)) {
+    return false;
+  }
+  (void)extract_render_scene_delta(scene, delta);
+  if (!delta_empty(delta)) {
+    return false;
+  }
+
+  Transform moved;
+  moved.translation = {0.f, 2.f, 0.f};
+  scene.find_entity(moving_guid).set<Transform>(moved);
+  if (!scene.tick(1.f / 60.f)) {
+    return false;
+  }
+  (void)extract_render_scene_delta(scene, delta);
+  if (!delta.added.empty() || !delta.removed.empty()) {
+    return false;
+  }
+  bool found_moved{};
+  for (const RenderMesh& mesh : delta.changed) {
+    if (mesh.entity == moving_guid) {
+      found_moved = matrix_nearly_equal(mesh.local_to_world, transform_to_matrix(moved));
+    }
+  }
+  if (!found_moved) {
+    return false;
+  }
+
+  scene.find_entity(invalidated_guid).set<MeshRenderable>({});
+  scene.destroy_entity(destroyed_guid);
+  (void)extract_render_scene_delta(scene, delta);
+  if (delta.removed.size() != 2 || !contains_guid(delta.removed, invalidated_guid) ||
+      !contains_guid(delta.removed, destroyed_guid) || !delta.added.empty()) {
+    return false;
+  }
+
+  // The invalidated mesh comes back as added once it has a model again.
+  scene.find_entity(invalidated_guid).set<MeshRenderable>({.model = model});
+  (void)extract_render_scene_delta(scene, delta);
+  if (delta.added.size() != 1 || !contains_mesh(delta.added, invalidated_guid)) {
+    return false;
+  }
+
+  (void)extract_render_scene_delta(scene, delta, {}, true);
+  return delta.added.size() == 2 && contains_mesh(delta.added, moving_guid) &&
+         contains_mesh(delta.added, invalidated_guid) && delta.removed.empty();
+}
+
 bool run_fps_camera_system_smoke_test() {
   FlecsComponentContext component_ctx = make_scene_component_context();
   SceneManager scenes(component_ctx);
@@ -4,6 +4,7 @@ namespace teng::engine {
 
 [[nodiscard]] bool run_scene_foundation_smoke_test();
 [[nodiscard]] bool run_render_scene_extraction_smoke_test();
+[[nodiscard]] bool run_incremental_render_scene_extraction_smoke_test();
 [[nodiscard]] bool run_fps_camera_system_smoke_test();
 
 }  // namespace teng::engine